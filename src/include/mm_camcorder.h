@@ -127,6 +127,48 @@
 		<td>PREPARED</td>
 		<td>SYNC</td>
 	</tr>
+	<tr>
+		<td>mm_camcorder_realize_async()</td>
+		<td>NULL</td>
+		<td>READY</td>
+		<td>ASYNC</td>
+	</tr>
+	<tr>
+		<td>mm_camcorder_unrealize_async()</td>
+		<td>READY</td>
+		<td>NULL</td>
+		<td>ASYNC</td>
+	</tr>
+	<tr>
+		<td>mm_camcorder_start_async()</td>
+		<td>READY</td>
+		<td>PREPARED</td>
+		<td>ASYNC</td>
+	</tr>
+	<tr>
+		<td>mm_camcorder_stop_async()</td>
+		<td>PREPARED</td>
+		<td>READY</td>
+		<td>ASYNC</td>
+	</tr>
+	<tr>
+		<td>mm_camcorder_commit_async()</td>
+		<td>RECORDING/PAUSED</td>
+		<td>PREPARED</td>
+		<td>ASYNC</td>
+	</tr>
+	<tr>
+		<td>mm_camcorder_wait_completion()</td>
+		<td>N/A</td>
+		<td>N/A</td>
+		<td>SYNC</td>
+	</tr>
+	<tr>
+		<td>mm_camcorder_release_completion()</td>
+		<td>N/A</td>
+		<td>N/A</td>
+		<td>SYNC</td>
+	</tr>
 	<tr>
 		<td>mm_camcorder_set_message_callback()</td>
 		<td>N/A</td>
@@ -139,6 +181,42 @@
 		<td>N/A</td>
 		<td>SYNC</td>
 	</tr>
+	<tr>
+		<td>mm_camcorder_set_video_stream_planar_callback()</td>
+		<td>N/A</td>
+		<td>N/A</td>
+		<td>SYNC</td>
+	</tr>
+	<tr>
+		<td>mm_camcorder_get_video_stream_dispatch_stats()</td>
+		<td>READY/PREPARED/RECORDING/PAUSED/CAPTURING</td>
+		<td>N/A</td>
+		<td>SYNC</td>
+	</tr>
+	<tr>
+		<td>mm_camcorder_get_video_frame_statistics()</td>
+		<td>READY/PREPARED/RECORDING/PAUSED/CAPTURING</td>
+		<td>N/A</td>
+		<td>SYNC</td>
+	</tr>
+	<tr>
+		<td>mm_camcorder_get_message_stats()</td>
+		<td>NULL/READY/PREPARED/RECORDING/PAUSED/CAPTURING</td>
+		<td>N/A</td>
+		<td>SYNC</td>
+	</tr>
+	<tr>
+		<td>mm_camcorder_get_audio_level()</td>
+		<td>PREPARED/RECORDING/PAUSED</td>
+		<td>N/A</td>
+		<td>SYNC</td>
+	</tr>
+	<tr>
+		<td>mm_camcorder_get_pre_record_statistics()</td>
+		<td>PREPARED/RECORDING/PAUSED</td>
+		<td>N/A</td>
+		<td>SYNC</td>
+	</tr>
 	<tr>
 		<td>mm_camcorder_set_video_capture_callback()</td>
 		<td>N/A</td>
@@ -358,6 +436,14 @@
 		<td>#MMCAM_TARGET_TIME_LIMIT</td>
 		<td>Time limit of recording file. If the elapsed time of recording reaches this value.</td>
 	</tr>
+	<tr>
+		<td>#MMCAM_TARGET_SEGMENT_TIME_LIMIT</td>
+		<td>Duration of a segment of recording file. If this is set, file is written as a sequence of fragments.</td>
+	</tr>
+	<tr>
+		<td>#MMCAM_TARGET_PRE_RECORD_TIME</td>
+		<td>Duration of video which is kept before recording is started. This should be set before preview is started.</td>
+	</tr>
 </table>
 </div>
 
@@ -512,6 +598,26 @@
 		<td>#MMCAM_CAPTURE_BREAK_CONTINUOUS_SHOT</td>
 		<td>Set this as true when you want to stop multishot immediately</td>
 	</tr>
+	<tr>
+		<td>#MMCAM_CAPTURE_SEGMENTED</td>
+		<td>Set this as true when you want to get captured image by segments without copy</td>
+	</tr>
+	<tr>
+		<td>#MMCAM_VIDEO_STREAM_DISPATCH_MODE</td>
+		<td>Dispatch mode of video stream callback</td>
+	</tr>
+	<tr>
+		<td>#MMCAM_VIDEO_STREAM_QUEUE_LENGTH</td>
+		<td>Maximum number of frames in dispatch queue of video stream callback</td>
+	</tr>
+	<tr>
+		<td>#MMCAM_VIDEO_STREAM_CALLBACK_FPS</td>
+		<td>Maximum frame rate of video stream callback</td>
+	</tr>
+	<tr>
+		<td>#MMCAM_VIDEO_STREAM_CALLBACK_INTERVAL</td>
+		<td>Interval of frames which are delivered to video stream callback</td>
+	</tr>
 	<tr>
 		<td>#MMCAM_DISPLAY_RECT_X</td>
 		<td>X position of display rectangle (This is only available when MMCAM_DISPLAY_GEOMETRY_METHOD is MM_CAMCORDER_CUSTOM_ROI)</td>
@@ -933,15 +1039,26 @@ extern "C" {
  */
 #define MMCAM_CAPTURE_BREAK_CONTINUOUS_SHOT     "capture-break-cont-shot"
 
+/**
+ * Enable to deliver captured image by segments. If this is TRUE, JPEG with EXIF is delivered as
+ * header, EXIF and JPEG image segments without copying them into one buffer.
+ * Then data of MMCamcorderCaptureDataType is NULL, and segment and segment_num should be used instead.
+ * Other images are delivered as one segment which is same as data.
+ */
+#define MMCAM_CAPTURE_SEGMENTED                 "capture-segmented"
+
 /**
  * Raw data of captured image which resolution is same as preview.
  * This is READ-ONLY attribute and only available in capture callback.
  * This should be used after casted as MMCamcorderCaptureDataType.
+ * Its data points captured buffer without copy, so it's valid only inside capture callback.
  */
 #define MMCAM_CAPTURED_SCREENNAIL               "captured-screennail"
 
 /**
  * Raw data of EXIF. This is READ-ONLY attribute and only available in capture callback.
+ * It points EXIF of camcorder handle without copy, so the pointer is valid only inside capture callback,
+ * and the data is overwritten by next capture. Copy it in capture callback if it's needed after callback returns.
  */
 #define MMCAM_CAPTURED_EXIF_RAW_DATA            "captured-exif-raw-data"
 
@@ -1061,6 +1178,24 @@ extern "C" {
  */
 #define MMCAM_TARGET_TIME_LIMIT                 "target-time-limit"
 
+/**
+ * Duration(Second) of a segment of video recording. 0 means that segmented recording is not used.
+ * If this is set, the file is written as fragmented MP4 which is closed every segment,
+ * so data which is already recorded is not lost even if recording is not finished normally.
+ * Whenever muxer finishes writing a segment to file, camcorder will send 'MM_MESSAGE_CAMCORDER_RECORDING_SEGMENT' message.
+ * This is only available for MM_FILE_FORMAT_3GP and MM_FILE_FORMAT_MP4 with muxer which supports fragment.
+ */
+#define MMCAM_TARGET_SEGMENT_TIME_LIMIT         "target-segment-time-limit"
+
+/**
+ * Duration(Second) of video which is kept before recording is started. 0 means that pre-recording is not used.
+ * If this is set, encoder runs from preview start and encoded frames of the last N seconds are kept
+ * in memory which is limited by PreRecordMemoryLimit of ini. When recording is started,
+ * they are written to the file first from a key frame. This should be set before preview is started,
+ * and it's not available in slow motion recording.
+ */
+#define MMCAM_TARGET_PRE_RECORD_TIME            "target-pre-record-time"
+
 /**
  * Enable to write tags. If this value is FALSE, none of tag information will be written to captured file.
  */
@@ -1190,6 +1325,46 @@ extern "C" {
  */
 #define MMCAM_CAMERA_FACE_ZOOM_MODE                   "camera-face-zoom-mode"
 
+/**
+ * Dispatch mode of video stream callback.
+ * This should be set before mm_camcorder_realize().
+ * @see		MMCamcorderVideoStreamDispatchMode
+ */
+#define MMCAM_VIDEO_STREAM_DISPATCH_MODE              "video-stream-dispatch-mode"
+
+/**
+ * Maximum number of frames which wait for video stream callback in dispatch queue.
+ * This is only available when #MMCAM_VIDEO_STREAM_DISPATCH_MODE is not MM_CAMCORDER_VIDEO_STREAM_DISPATCH_SYNC.
+ * This should be set before mm_camcorder_realize().
+ */
+#define MMCAM_VIDEO_STREAM_QUEUE_LENGTH               "video-stream-queue-length"
+
+/**
+ * Maximum frame rate of video stream callback.
+ * Frames over this rate are displayed, but they are not delivered to video stream callback.
+ * 0 means that every frame is delivered.
+ */
+#define MMCAM_VIDEO_STREAM_CALLBACK_FPS               "video-stream-callback-fps"
+
+/**
+ * Interval of frames which are delivered to video stream callback.
+ * If this is N, only one of every N frames is delivered to video stream callback.
+ * 0 or 1 means that every frame is delivered.
+ */
+#define MMCAM_VIDEO_STREAM_CALLBACK_INTERVAL          "video-stream-callback-interval"
+
+/**
+ * Base of message ids which are defined by camcorder itself, not by mm_message.h.
+ * This range is reserved for camcorder private messages, and ids in mm_message.h should be kept below it.
+ */
+#define MM_MESSAGE_CAMCORDER_PRIVATE_BASE             0x10000
+
+/**
+ * Message which is sent when a segment of segmented recording is written to file. (see #MMCAM_TARGET_SEGMENT_TIME_LIMIT)
+ * 'data' of MMMessageParamType points MMCamcorderRecordingSegmentInfo, and it's valid only in message callback.
+ */
+#define MM_MESSAGE_CAMCORDER_RECORDING_SEGMENT        (MM_MESSAGE_CAMCORDER_PRIVATE_BASE + 0x01)
+
 
 /*=======================================================================================
 | ENUM DEFINITIONS									|
@@ -1488,6 +1663,16 @@ enum MMCamcorderPreviewType {
 	MM_CAMCORDER_PREVIEW_TYPE_WIDE,         /**< wide ratio like 16:9 */
 };
 
+/**
+ * An enumeration for dispatch mode of video stream callback.
+ */
+enum MMCamcorderVideoStreamDispatchMode {
+	MM_CAMCORDER_VIDEO_STREAM_DISPATCH_SYNC = 0,    /**< call video stream callback in the context of gstreamer */
+	MM_CAMCORDER_VIDEO_STREAM_DISPATCH_DROP_OLDEST, /**< call it in dispatch thread, drop the oldest frame in queue when queue is full */
+	MM_CAMCORDER_VIDEO_STREAM_DISPATCH_DROP_NEWEST, /**< call it in dispatch thread, drop the new frame when queue is full */
+	MM_CAMCORDER_VIDEO_STREAM_DISPATCH_BLOCK,       /**< call it in dispatch thread, wait for free slot when queue is full */
+};
+
 
 /**********************************
 *          Attribute info         *
@@ -1586,16 +1771,37 @@ typedef struct {
 
 
 /* General Structure */
+/**
+ * Structure for a segment of captured image.
+ */
+typedef struct {
+	void *data;			/**< pointer of segment */
+	unsigned int length;		/**< length of segment (in byte) */
+} MMCamcorderCaptureSegmentType;
+
+/**
+ * Structure for a segment of segmented recording. (see #MM_MESSAGE_CAMCORDER_RECORDING_SEGMENT)
+ */
+typedef struct {
+	int index;			/**< sequence number of the segment which starts from 0 */
+	unsigned int start_time;	/**< start time of the segment (millisecond) */
+	unsigned int end_time;		/**< end time of the segment (millisecond) */
+	unsigned long long offset;	/**< offset of the segment in recording file (byte) */
+	unsigned long long size;	/**< size of the segment (byte). The first one includes file header. */
+} MMCamcorderRecordingSegmentInfo;
+
 /**
  * Structure for capture data.
  */
 typedef struct {
-	void *data;			/**< pointer of captured image */
+	void *data;			/**< pointer of captured image. NULL if image is delivered by segments. */
 	unsigned int length;		/**< length of captured image (in byte)*/
 	MMPixelFormatType format;	/**< image format */
 	int width;			/**< width of captured image */
 	int height;			/**< height of captured image */
 	int encoder_type;		/**< encoder type */
+	MMCamcorderCaptureSegmentType *segment;	/**< segments of captured image in order. Only set if #MMCAM_CAPTURE_SEGMENTED is TRUE. */
+	int segment_num;		/**< number of segments */
 } MMCamcorderCaptureDataType;
 
 
@@ -1612,6 +1818,78 @@ typedef struct {
 } MMCamcorderVideoStreamDataType;
 
 
+/**
+ * Maximum number of planes of planar video stream data.
+ */
+#define MM_CAMCORDER_STREAM_PLANE_MAX	4
+
+
+/**
+ * Structure for planar video stream data.
+ * Each plane points to the memory of the video source directly, so no copy is made.
+ */
+typedef struct _MMCamcorderVideoStreamPlanarDataType {
+	unsigned int num_planes;				/**< number of valid planes */
+	void *data[MM_CAMCORDER_STREAM_PLANE_MAX];		/**< pointer of each plane */
+	int stride[MM_CAMCORDER_STREAM_PLANE_MAX];		/**< stride of each plane (in byte) */
+	int elevation[MM_CAMCORDER_STREAM_PLANE_MAX];		/**< number of lines of each plane */
+	MMPixelFormatType format;				/**< image format */
+	int width;						/**< width of video buffer */
+	int height;						/**< height of video buffer */
+	unsigned int timestamp;					/**< timestamp of stream buffer (msec)*/
+	void (*release)(struct _MMCamcorderVideoStreamPlanarDataType *stream);	/**< release function. Call it once when planes are no longer used. */
+	void *priv;						/**< internal data for release function. Do not touch. */
+} MMCamcorderVideoStreamPlanarDataType;
+
+
+/**
+ * Structure for statistics of preview frames.
+ * Frame interval is measured with monotonic clock.
+ */
+typedef struct {
+	unsigned int frame_count;		/**< number of measured frame intervals */
+	unsigned int interval_p50;		/**< 50th percentile of frame interval (usec) */
+	unsigned int interval_p95;		/**< 95th percentile of frame interval (usec) */
+	unsigned int interval_p99;		/**< 99th percentile of frame interval (usec) */
+	unsigned int interval_max;		/**< maximum frame interval (usec) */
+	unsigned int drop_by_vframe;		/**< number of frames dropped when recording starts */
+	unsigned int drop_by_stability;		/**< number of frames dropped until camera is stable */
+	unsigned int drop_by_probe;		/**< number of frames dropped because they are invalid */
+} MMCamcorderVideoFrameStatistics;
+
+
+/**
+ * Structure for statistics of pre-record buffer.
+ * Encoded frames are kept in pre-record buffer until recording is started. (see #MMCAM_TARGET_PRE_RECORD_TIME)
+ */
+typedef struct {
+	unsigned int video_count;		/**< number of buffered video frames */
+	unsigned int audio_count;		/**< number of buffered audio frames */
+	unsigned int buffered_time;		/**< duration of buffered video frames (msec) */
+	unsigned int buffered_size;		/**< size of buffered frames (Kbyte) */
+	unsigned int peak_size;			/**< maximum of buffered size (Kbyte) */
+	unsigned int max_size;			/**< memory limit of pre-record buffer (Kbyte) */
+	unsigned int drop_video;		/**< number of video frames dropped from pre-record buffer */
+	unsigned int drop_audio;		/**< number of audio frames dropped from pre-record buffer */
+} MMCamcorderPreRecordStatistics;
+
+
+/**
+ * Maximum number of channels of audio level
+ */
+#define MM_CAMCORDER_AUDIO_LEVEL_CHANNEL_MAX	2
+
+/**
+ * Structure for level of recording audio.
+ * Level is measured for each channel over the integration window (AudioMeterInterval in ini).
+ */
+typedef struct {
+	int channel;						/**< number of valid channels */
+	float rms_dB[MM_CAMCORDER_AUDIO_LEVEL_CHANNEL_MAX];	/**< RMS level of each channel. 0 dB is RMS of full scale sine wave. */
+	float peak_dB[MM_CAMCORDER_AUDIO_LEVEL_CHANNEL_MAX];	/**< peak level of each channel. 0 dB is full scale. */
+} MMCamcorderAudioLevel;
+
+
 /**
  * Structure for audio stream data.
  */
@@ -1658,13 +1936,18 @@ typedef struct _MMCamFaceInfo {
  */
 typedef struct _MMCamFaceDetectInfo {
 	int num_of_faces;                       /**< number of detected faces */
-	MMCamFaceInfo *face_info;               /**< face information, this should be freed after use it. */
+	MMCamFaceInfo *face_info;               /**< face information, this is valid only in message callback. Do not free it. */
 } MMCamFaceDetectInfo;
 
 
 /*=======================================================================================
 | TYPE DEFINITIONS									|
 ========================================================================================*/
+/**
+ *	Handle to wait for completion of command which is requested asynchronously.
+ */
+typedef void *MMCamcorderCompletionHandle;
+
 /**
  *	Function definition for video stream callback.
  *  Be careful! In this function, you can't call functions that change the state of camcorder such as mm_camcorder_stop(), 
@@ -1676,11 +1959,29 @@ typedef struct _MMCamFaceDetectInfo {
  *	@param[in]	stream			Reference pointer to video stream data
  *	@param[in]	user_param		User parameter which is received from user when callback function was set
  *	@return		This function returns true on success, or false on failure.
- *	@remarks		This function is issued in the context of gstreamer (video sink thread).
+ *	@remarks		This function is issued in the context of gstreamer (video sink thread),
+ *			or in the context of dispatch thread if #MMCAM_VIDEO_STREAM_DISPATCH_MODE is not MM_CAMCORDER_VIDEO_STREAM_DISPATCH_SYNC.
  */
 typedef gboolean (*mm_camcorder_video_stream_callback)(MMCamcorderVideoStreamDataType *stream, void *user_param);
 
 
+/**
+ *	Function definition for planar video stream callback.
+ *  Unlike '#mm_camcorder_video_stream_callback', the planes of the frame are not copied into a contiguous buffer.
+ *  They point to the buffer of the video source, and they are valid until 'release' of the stream is called.
+ *  'release' MUST be called exactly once for each frame, in this function or later in other context.
+ *  If you want to keep the frame after this function returns, copy the structure and call 'release' of the copy.
+ *  The video source has a limited number of buffers, so holding frames for long may stop preview.
+ *  The same restrictions as '#mm_camcorder_video_stream_callback' are applied to this function.
+ *
+ *	@param[in]	stream			Reference pointer to planar video stream data
+ *	@param[in]	user_param		User parameter which is received from user when callback function was set
+ *	@return		This function returns true on success, or false on failure.
+ *	@remarks		This function is issued in the context of gstreamer (video sink thread).
+ */
+typedef gboolean (*mm_camcorder_video_stream_planar_callback)(MMCamcorderVideoStreamPlanarDataType *stream, void *user_param);
+
+
 /**
  *	Function definition for audio stream callback.
  *  Be careful! In this function, you can't call functions that change the state of camcorder such as mm_camcorder_stop(),
@@ -2589,6 +2890,262 @@ gboolean record_and_cancel_video_file()
 int mm_camcorder_cancel(MMHandleType camcorder);
 
 
+/**
+ *	mm_camcorder_realize_async:\n
+ *    Request mm_camcorder_realize() to the command thread and return immediately.
+ *	Commands are executed in requested order. Realize request which is the next one to be executed
+ *	is cancelled by following mm_camcorder_unrealize_async() if current state is MM_CAMCORDER_STATE_NULL.
+ *	Neither is executed then, and both are completed with MM_ERROR_CAMCORDER_CMD_IS_RUNNING.
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[out]	completion	Handle to wait for the result. It can be NULL if result is not needed.
+ *	@return		This function returns zero(MM_ERROR_NONE) on success, or negative value with error code.\n
+ *			Please refer 'mm_error.h' to know the exact meaning of the error.
+ *	@see		mm_camcorder_realize, mm_camcorder_wait_completion, mm_camcorder_release_completion
+ *	@pre		Previous state of mm-camcorder should be MM_CAMCORDER_STATE_NULL
+ *	@post		Next state of mm-camcorder will be MM_CAMCORDER_STATE_READY when command is completed successfully
+ *	@remarks	Completion handle should be released with mm_camcorder_release_completion(). It's valid even after mm_camcorder_destroy().
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean realize_and_start_async()
+{
+	int err;
+	int result = MM_ERROR_NONE;
+	MMCamcorderCompletionHandle completion = NULL;
+
+	mm_camcorder_realize_async(hcam, NULL);
+
+	err = mm_camcorder_start_async(hcam, &completion);
+	if (err < 0) {
+		printf("Fail to call mm_camcorder_start_async  = %x\n", err);
+		return FALSE;
+	}
+
+	// Do something else...
+
+	err = mm_camcorder_wait_completion(hcam, completion, 3000, &result);
+	mm_camcorder_release_completion(hcam, completion);
+	if (err < 0 || result < 0) {
+		printf("Fail to start preview = %x, %x\n", err, result);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+ *	@endcode
+ */
+int mm_camcorder_realize_async(MMHandleType camcorder, MMCamcorderCompletionHandle *completion);
+
+
+/**
+ *	mm_camcorder_unrealize_async:\n
+ *    Request mm_camcorder_unrealize() to the command thread and return immediately.
+ *	It cancels realize request which is the next one to be executed, if current state is MM_CAMCORDER_STATE_NULL.
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[out]	completion	Handle to wait for the result. It can be NULL if result is not needed.
+ *	@return		This function returns zero(MM_ERROR_NONE) on success, or negative value with error code.\n
+ *			Please refer 'mm_error.h' to know the exact meaning of the error.
+ *	@see		mm_camcorder_unrealize, mm_camcorder_realize_async, mm_camcorder_wait_completion, mm_camcorder_release_completion
+ *	@pre		Previous state of mm-camcorder should be MM_CAMCORDER_STATE_READY
+ *	@post		Next state of mm-camcorder will be MM_CAMCORDER_STATE_NULL when command is completed successfully
+ *	@remarks	Completion handle should be released with mm_camcorder_release_completion(). It's valid even after mm_camcorder_destroy().
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean unrealize_async()
+{
+	int result = MM_ERROR_NONE;
+	MMCamcorderCompletionHandle completion = NULL;
+
+	mm_camcorder_unrealize_async(hcam, &completion);
+
+	mm_camcorder_wait_completion(hcam, completion, -1, &result);
+	mm_camcorder_release_completion(hcam, completion);
+
+	return TRUE;
+}
+ *	@endcode
+ */
+int mm_camcorder_unrealize_async(MMHandleType camcorder, MMCamcorderCompletionHandle *completion);
+
+
+/**
+ *	mm_camcorder_start_async:\n
+ *    Request mm_camcorder_start() to the command thread and return immediately.
+ *	Start request which is the next one to be executed is cancelled by following mm_camcorder_stop_async()
+ *	if current state is MM_CAMCORDER_STATE_READY. Neither is executed then,
+ *	and both are completed with MM_ERROR_CAMCORDER_CMD_IS_RUNNING.
+ *	mm_camcorder_stop() in sync state change mode does not cancel it, because it does not use the command thread.
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[out]	completion	Handle to wait for the result. It can be NULL if result is not needed.
+ *	@return		This function returns zero(MM_ERROR_NONE) on success, or negative value with error code.\n
+ *			Please refer 'mm_error.h' to know the exact meaning of the error.
+ *	@see		mm_camcorder_start, mm_camcorder_wait_completion, mm_camcorder_release_completion
+ *	@pre		Previous state of mm-camcorder should be MM_CAMCORDER_STATE_READY
+ *	@post		Next state of mm-camcorder will be MM_CAMCORDER_STATE_PREPARE when command is completed successfully
+ *	@remarks	Completion handle should be released with mm_camcorder_release_completion(). It's valid even after mm_camcorder_destroy().
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean start_async()
+{
+	MMCamcorderCompletionHandle completion = NULL;
+
+	mm_camcorder_start_async(hcam, &completion);
+
+	return TRUE;
+}
+ *	@endcode
+ */
+int mm_camcorder_start_async(MMHandleType camcorder, MMCamcorderCompletionHandle *completion);
+
+
+/**
+ *	mm_camcorder_stop_async:\n
+ *    Request mm_camcorder_stop() to the command thread and return immediately.
+ *	It cancels start request which is the next one to be executed, if current state is MM_CAMCORDER_STATE_READY.
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[out]	completion	Handle to wait for the result. It can be NULL if result is not needed.
+ *	@return		This function returns zero(MM_ERROR_NONE) on success, or negative value with error code.\n
+ *			Please refer 'mm_error.h' to know the exact meaning of the error.
+ *	@see		mm_camcorder_stop, mm_camcorder_start_async, mm_camcorder_wait_completion, mm_camcorder_release_completion
+ *	@pre		Previous state of mm-camcorder should be MM_CAMCORDER_STATE_PREPARE
+ *	@post		Next state of mm-camcorder will be MM_CAMCORDER_STATE_READY when command is completed successfully
+ *	@remarks	Completion handle should be released with mm_camcorder_release_completion(). It's valid even after mm_camcorder_destroy().
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean stop_async()
+{
+	MMCamcorderCompletionHandle completion = NULL;
+
+	mm_camcorder_stop_async(hcam, &completion);
+
+	// Do something else...
+
+	mm_camcorder_release_completion(hcam, completion);
+
+	return TRUE;
+}
+ *	@endcode
+ */
+int mm_camcorder_stop_async(MMHandleType camcorder, MMCamcorderCompletionHandle *completion);
+
+
+/**
+ *	mm_camcorder_commit_async:\n
+ *    Request mm_camcorder_commit() to the command thread and return immediately.
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[out]	completion	Handle to wait for the result. It can be NULL if result is not needed.
+ *	@return		This function returns zero(MM_ERROR_NONE) on success, or negative value with error code.\n
+ *			Please refer 'mm_error.h' to know the exact meaning of the error.
+ *	@see		mm_camcorder_commit, mm_camcorder_wait_completion, mm_camcorder_release_completion
+ *	@pre		Previous state of mm-camcorder should be MM_CAMCORDER_STATE_RECORDING or MM_CAMCORDER_STATE_PAUSED
+ *	@post		Next state of mm-camcorder will be MM_CAMCORDER_STATE_PREPARE when command is completed successfully
+ *	@remarks	Completion handle should be released with mm_camcorder_release_completion(). It's valid even after mm_camcorder_destroy().
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean commit_async()
+{
+	int result = MM_ERROR_NONE;
+	MMCamcorderCompletionHandle completion = NULL;
+
+	mm_camcorder_commit_async(hcam, &completion);
+
+	// Wait until recorded file is saved
+	mm_camcorder_wait_completion(hcam, completion, -1, &result);
+	mm_camcorder_release_completion(hcam, completion);
+
+	return TRUE;
+}
+ *	@endcode
+ */
+int mm_camcorder_commit_async(MMHandleType camcorder, MMCamcorderCompletionHandle *completion);
+
+
+/**
+ *	mm_camcorder_wait_completion:\n
+ *    Wait until the command which is requested asynchronously is completed.
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[in]	completion	Completion handle from mm_camcorder_xxx_async().
+ *	@param[in]	timeout_ms	Timeout in milliseconds. Negative value means infinite wait.
+ *	@param[out]	result		Result of the command. It is valid only when this function returns MM_ERROR_NONE.
+ *	@return		This function returns zero(MM_ERROR_NONE) when the command is completed,
+ *			MM_ERROR_CAMCORDER_RESPONSE_TIMEOUT if it is not completed in timeout,
+ *			or negative value with error code.\n
+ *			Please refer 'mm_error.h' to know the exact meaning of the error.
+ *	@see		mm_camcorder_release_completion
+ *	@pre		None
+ *	@post		None
+ *	@remarks	Completion handle is still valid after this function returns. Release it with mm_camcorder_release_completion().
+ *			Commands which are not executed yet when mm_camcorder_destroy() is called are completed with MM_ERROR_CAMCORDER_INVALID_CONDITION,
+ *			and completion handle can be waited and released after mm_camcorder_destroy().
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean wait_completion(MMCamcorderCompletionHandle completion)
+{
+	int result = MM_ERROR_NONE;
+
+	while (mm_camcorder_wait_completion(hcam, completion, 100, &result) == MM_ERROR_CAMCORDER_RESPONSE_TIMEOUT) {
+		// Do something while waiting
+	}
+
+	mm_camcorder_release_completion(hcam, completion);
+
+	return TRUE;
+}
+ *	@endcode
+ */
+int mm_camcorder_wait_completion(MMHandleType camcorder, MMCamcorderCompletionHandle completion, int timeout_ms, int *result);
+
+
+/**
+ *	mm_camcorder_release_completion:\n
+ *    Release completion handle. The command is executed even if its completion handle is released.
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[in]	completion	Completion handle from mm_camcorder_xxx_async().
+ *	@return		None
+ *	@see		mm_camcorder_wait_completion
+ *	@pre		None
+ *	@post		None
+ *	@remarks	None
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean release_completion(MMCamcorderCompletionHandle completion)
+{
+	mm_camcorder_release_completion(hcam, completion);
+
+	return TRUE;
+}
+ *	@endcode
+ */
+void mm_camcorder_release_completion(MMHandleType camcorder, MMCamcorderCompletionHandle completion);
+
+
 /**
  *    mm_camcorder_set_message_callback:\n
  *  Set callback for receiving messages from camcorder. Through this callback function, camcorder
@@ -2657,6 +3214,229 @@ gboolean setting_video_stream_callback()
 int mm_camcorder_set_video_stream_callback(MMHandleType camcorder, mm_camcorder_video_stream_callback callback, void *user_data);
 
 
+/**
+ *    mm_camcorder_set_video_stream_planar_callback:\n
+ *  Set callback for user defined planar video stream callback function.
+ *  Users can retrieve video frame using registered callback without copying it.
+ *  Each plane of the frame is delivered with its pointer, stride and elevation,
+ *  so that zero copy format(NV12, I420) frames of the video source can be used as they are.
+ *  This callback can be used with the callback of mm_camcorder_set_video_stream_callback() at the same time.
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[in]	callback	Function pointer of callback function.
+ *	@param[in]	user_data	User parameter for passing to callback function.
+ *	@return		This function returns zero(MM_ERROR_NONE) on success, or negative value with error code.\n
+ *			Please refer 'mm_error.h' to know the exact meaning of the error.
+ *	@see		mm_camcorder_video_stream_planar_callback, mm_camcorder_set_video_stream_callback
+ *	@pre		None
+ *	@post		None
+ *	@remarks	registered 'callback' is called on internal thread of camcorder. Regardless of the status of main loop, this function will be called.
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean camcordertest_video_stream_planar_cb(MMCamcorderVideoStreamPlanarDataType *stream, void *user_param)
+{
+	// use stream->data[i] with stream->stride[i] and stream->elevation[i]
+
+	stream->release(stream);
+
+	return TRUE;
+}
+
+gboolean setting_video_stream_planar_callback()
+{
+	//set callback
+	mm_camcorder_set_video_stream_planar_callback(hcam, (mm_camcorder_video_stream_planar_callback)camcordertest_video_stream_planar_cb, (void*)hcam);
+
+	return TRUE;
+}
+ *	@endcode
+ */
+int mm_camcorder_set_video_stream_planar_callback(MMHandleType camcorder, mm_camcorder_video_stream_planar_callback callback, void *user_data);
+
+
+/**
+ *    mm_camcorder_get_video_stream_dispatch_stats:\n
+ *  Get statistics of dispatch queue of video stream callback.
+ *  When #MMCAM_VIDEO_STREAM_DISPATCH_MODE is not MM_CAMCORDER_VIDEO_STREAM_DISPATCH_SYNC,
+ *  video stream callback is called in dispatch thread and frames wait for it in dispatch queue.
+ *  This function returns the number of frames in the queue now and
+ *  the number of frames dropped because the queue was full since mm_camcorder_realize().
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[out]	queue_depth	Number of frames in dispatch queue.
+ *	@param[out]	dropped_count	Number of dropped frames.
+ *	@return		This function returns zero(MM_ERROR_NONE) on success, or negative value with error code.\n
+ *			Please refer 'mm_error.h' to know the exact meaning of the error.
+ *	@see		mm_camcorder_set_video_stream_callback, MMCamcorderVideoStreamDispatchMode
+ *	@pre		Previous state of mm-camcorder should be MM_CAMCORDER_STATE_READY or upper.
+ *	@post		None
+ *	@remarks	None
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean get_video_stream_dispatch_stats()
+{
+	unsigned int queue_depth = 0;
+	unsigned int dropped_count = 0;
+
+	mm_camcorder_get_video_stream_dispatch_stats(hcam, &queue_depth, &dropped_count);
+
+	return TRUE;
+}
+ *	@endcode
+ */
+int mm_camcorder_get_video_stream_dispatch_stats(MMHandleType camcorder, unsigned int *queue_depth, unsigned int *dropped_count);
+
+
+/**
+ *    mm_camcorder_get_video_frame_statistics:\n
+ *  Get statistics of preview frames since preview was started.
+ *  Interval between preview frames is measured with monotonic clock,
+ *  and its percentiles are calculated from histogram of 500 usec resolution.
+ *  Frames dropped by camcorder are counted by the reason.
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[out]	stats		Statistics of preview frames.
+ *	@return		This function returns zero(MM_ERROR_NONE) on success, or negative value with error code.\n
+ *			Please refer 'mm_error.h' to know the exact meaning of the error.
+ *	@see		MMCamcorderVideoFrameStatistics
+ *	@pre		Previous state of mm-camcorder should be MM_CAMCORDER_STATE_READY or upper.
+ *	@post		None
+ *	@remarks	None
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean get_video_frame_statistics()
+{
+	MMCamcorderVideoFrameStatistics stats;
+
+	mm_camcorder_get_video_frame_statistics(hcam, &stats);
+
+	printf("p50 %u, p95 %u, p99 %u usec\n", stats.interval_p50, stats.interval_p95, stats.interval_p99);
+
+	return TRUE;
+}
+ *	@endcode
+ */
+int mm_camcorder_get_video_frame_statistics(MMHandleType camcorder, MMCamcorderVideoFrameStatistics *stats);
+
+
+/**
+ *    mm_camcorder_get_message_stats:\n
+ *  Get statistics of messages for the message callback.
+ *  Messages which carry only the latest value (MM_MESSAGE_CAMCORDER_CURRENT_VOLUME,
+ *  MM_MESSAGE_CAMCORDER_RECORDING_STATUS and MM_MESSAGE_CAMCORDER_FACE_DETECT_INFO
+ *  when FaceDetectDropStale is set in ini) replace the pending one of same type,
+ *  and the replaced one is counted as dropped.
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[in]	message_id	Message id. (MM_MESSAGE_CAMCORDER_XXX)
+ *	@param[out]	enqueue_count	Number of messages which were sent.
+ *	@param[out]	drop_count	Number of messages which were not delivered to application.
+ *	@return		This function returns zero(MM_ERROR_NONE) on success, or negative value with error code.\n
+ *			Please refer 'mm_error.h' to know the exact meaning of the error.
+ *	@see		mm_camcorder_set_message_callback
+ *	@pre		None
+ *	@post		None
+ *	@remarks	None
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean get_message_stats()
+{
+	unsigned int enqueue_count = 0;
+	unsigned int drop_count = 0;
+
+	mm_camcorder_get_message_stats(hcam, MM_MESSAGE_CAMCORDER_RECORDING_STATUS, &enqueue_count, &drop_count);
+
+	return TRUE;
+}
+ *	@endcode
+ */
+int mm_camcorder_get_message_stats(MMHandleType camcorder, int message_id, unsigned int *enqueue_count, unsigned int *drop_count);
+
+
+/**
+ *    mm_camcorder_get_audio_level:\n
+ *  Get level of recording audio which was measured for the last integration window.
+ *  RMS and peak level are measured for each channel,
+ *  and MM_MESSAGE_CAMCORDER_CURRENT_VOLUME carries RMS level of the loudest channel
+ *  once per integration window.
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[out]	level		Level of recording audio.
+ *	@return		This function returns zero(MM_ERROR_NONE) on success, or negative value with error code.\n
+ *			Please refer 'mm_error.h' to know the exact meaning of the error.
+ *	@see		MMCamcorderAudioLevel
+ *	@pre		Previous state of mm-camcorder should be MM_CAMCORDER_STATE_PREPARE or upper, and mode should be audio.
+ *	@post		None
+ *	@remarks	Level is -96 dB until the first integration window is completed or when input is silent.
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean get_audio_level()
+{
+	int i = 0;
+	MMCamcorderAudioLevel level;
+
+	mm_camcorder_get_audio_level(hcam, &level);
+
+	for (i = 0 ; i < level.channel ; i++) {
+		printf("channel %d : rms %f dB, peak %f dB\n", i, level.rms_dB[i], level.peak_dB[i]);
+	}
+
+	return TRUE;
+}
+ *	@endcode
+ */
+int mm_camcorder_get_audio_level(MMHandleType camcorder, MMCamcorderAudioLevel *level);
+
+
+/**
+ *    mm_camcorder_get_pre_record_statistics:\n
+ *  Get statistics of pre-record buffer which keeps encoded frames before recording is started.
+ *
+ *	@param[in]	camcorder	A handle of camcorder.
+ *	@param[out]	stats		Statistics of pre-record buffer.
+ *	@return		This function returns zero(MM_ERROR_NONE) on success, or negative value with error code.\n
+ *			Please refer 'mm_error.h' to know the exact meaning of the error.
+ *	@see		MMCamcorderPreRecordStatistics, MMCAM_TARGET_PRE_RECORD_TIME
+ *	@pre		Preview should be started with MMCAM_TARGET_PRE_RECORD_TIME in video mode.
+ *	@post		None
+ *	@remarks	After recording is started, frames in pre-record buffer are moved to the file,
+ *			then buffered count and size become zero.
+ *	@par example
+ *	@code
+
+#include <mm_camcorder.h>
+
+gboolean get_pre_record_statistics()
+{
+	MMCamcorderPreRecordStatistics stats;
+
+	mm_camcorder_get_pre_record_statistics(hcam, &stats);
+
+	printf("%u ms buffered, %u/%u KB (peak %u KB)\n",
+	       stats.buffered_time, stats.buffered_size, stats.max_size, stats.peak_size);
+
+	return TRUE;
+}
+ *	@endcode
+ */
+int mm_camcorder_get_pre_record_statistics(MMHandleType camcorder, MMCamcorderPreRecordStatistics *stats);
+
+
 /**
  *    mm_camcorder_set_video_capture_callback:\n
  *  Set callback for user defined video capture callback function.  (Image mode only)
@@ -27,6 +27,7 @@
 ========================================================================================*/
 #include <mm_types.h>
 #include <stdarg.h>
+#include <glib.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -168,6 +169,13 @@ typedef enum
 	MM_CAM_CAPTURED_EXIF_RAW_DATA,
 	MM_CAM_DISPLAY_EVAS_SURFACE_SINK,
 	MM_CAM_DISPLAY_EVAS_DO_SCALING,
+	MM_CAM_VIDEO_STREAM_DISPATCH_MODE,
+	MM_CAM_VIDEO_STREAM_QUEUE_LENGTH,
+	MM_CAM_VIDEO_STREAM_CALLBACK_FPS,
+	MM_CAM_VIDEO_STREAM_CALLBACK_INTERVAL,
+	MM_CAM_TARGET_SEGMENT_TIME_LIMIT,
+	MM_CAM_TARGET_PRE_RECORD_TIME,
+	MM_CAM_CAPTURE_SEGMENTED,
 	MM_CAM_NUM
 }MMCamcorderAttrsID;
 
@@ -196,6 +204,17 @@ typedef struct {
 	mmf_cam_commit_func_t attr_commit;
 } mm_cam_attr_construct_info;
 
+/**
+ * Attribute values which are read by streaming thread for every buffer.
+ * They are updated by commit function and read without lock.
+ */
+typedef struct {
+	volatile gint audio_mute;               /**< whether audio volume is 0 */
+	volatile gint audio_format;             /**< audio format */
+	volatile gint audio_channel;            /**< audio channel */
+	volatile gint capture_break_cont_shot;  /**< whether continuous shot should be stopped */
+} _MMCamcorderHotAttrs;
+
 /*=======================================================================================
 | CONSTANT DEFINITIONS									|
 ========================================================================================*/
@@ -277,6 +296,17 @@ int _mmcamcorder_get_attribute_info(MMHandleType handle, const char *attr_name,
 /*=======================================================================================
 | CAMCORDER INTERNAL LOCAL								|
 ========================================================================================*/
+/**
+ * This function initializes snapshot of attributes which are read by streaming thread.
+ * After this, the snapshot is updated by commit functions.
+ *
+ * @param[in]	handle		Handle of camcorder.
+ * @return	None
+ * @remarks
+ * @see		_MMCamcorderHotAttrs
+ */
+void _mmcamcorder_init_hot_attributes(MMHandleType handle);
+
 /**
  * A commit function to set camcorder attributes
  * If the attribute needs actual setting, this function handles that activity.
@@ -314,6 +344,8 @@ bool _mmcamcorder_commit_capture_height(MMHandleType handle, int attr_idx, const
 bool _mmcamcorder_commit_capture_break_cont_shot(MMHandleType handle, int attr_idx, const mmf_value_t *value);
 bool _mmcamcorder_commit_capture_count(MMHandleType handle, int attr_idx, const mmf_value_t *value);
 bool _mmcamcorder_commit_capture_sound_enable(MMHandleType handle, int attr_idx, const mmf_value_t *value);
+bool _mmcamcorder_commit_audio_format(MMHandleType handle, int attr_idx, const mmf_value_t *value);
+bool _mmcamcorder_commit_audio_channel(MMHandleType handle, int attr_idx, const mmf_value_t *value);
 bool _mmcamcorder_commit_audio_volume(MMHandleType handle, int attr_idx, const mmf_value_t *value);
 bool _mmcamcorder_commit_audio_input_route(MMHandleType handle, int attr_idx, const mmf_value_t *value);
 bool _mmcamcorder_commit_audio_disable(MMHandleType handle, int attr_idx, const mmf_value_t *value);
@@ -344,6 +376,8 @@ bool _mmcamcorder_commit_display_geometry_method(MMHandleType handle, int attr_i
 bool _mmcamcorder_commit_display_rect(MMHandleType handle, int attr_idx, const mmf_value_t *value);
 bool _mmcamcorder_commit_display_scale(MMHandleType handle, int attr_idx, const mmf_value_t *value);
 bool _mmcamcorder_commit_display_evas_do_scaling(MMHandleType handle, int attr_idx, const mmf_value_t *value);
+bool _mmcamcorder_commit_video_stream_dispatch(MMHandleType handle, int attr_idx, const mmf_value_t *value);
+bool _mmcamcorder_commit_video_stream_rate(MMHandleType handle, int attr_idx, const mmf_value_t *value);
 bool _mmcamcorder_commit_strobe(MMHandleType handle, int attr_idx, const mmf_value_t *value);
 bool _mmcamcorder_commit_detect(MMHandleType handle, int attr_idx, const mmf_value_t *value);
 bool _mmcamcorder_commit_camera_flip_horizontal(MMHandleType handle, int attr_idx, const mmf_value_t *value);
@@ -22,6 +22,11 @@
 #ifndef __MM_CAMCORDER_CONFIGURE_H__
 #define __MM_CAMCORDER_CONFIGURE_H__
 
+/*=======================================================================================
+| INCLUDE FILES										|
+========================================================================================*/
+#include <glib.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -141,6 +146,7 @@ typedef struct _conf_info conf_info;
 struct _conf_info {
 	int count;
 	void **detail_info;
+	GHashTable *index;	/* detail_info by name, built once after parsing */
 };
 
 typedef struct _conf_info_table conf_info_table;
@@ -171,18 +177,32 @@ struct _camera_conf {
  * @param[in]	ConfFile	ini file path.
  * @param[out]	configure_info	configure structure to be got.
  * @return	This function returns MM_ERROR_NONE on success, or others on failure.
- * @remarks
+ * @remarks	Parsed configure is cached in process by path and modified time of file,
+ *		and it's shared by handles. It should not be changed.
  * @see		_mmcamcorder_conf_release_info()
  *
  */
 int _mmcamcorder_conf_get_info(int type, char *ConfFile, camera_conf **configure_info);
 
+/**
+ * This function creates configure info structure from ini file of absolute path.
+ *
+ * @param[in]	type		configure type(MAIN or CTRL).
+ * @param[in]	conf_path	absolute path of ini file.
+ * @param[out]	configure_info	configure structure to be got.
+ * @return	This function returns MM_ERROR_NONE on success, or others on failure.
+ * @remarks	Cached configure is parsed again when modified time or size of file is changed.
+ * @see		_mmcamcorder_conf_get_info(), _mmcamcorder_conf_release_info()
+ *
+ */
+int _mmcamcorder_conf_get_info_from_path(int type, const char *conf_path, camera_conf **configure_info);
+
 /**
  * This function releases configure info.
  *
  * @param[in]	configure_info	configure structure to be released.
  * @return	void
- * @remarks
+ * @remarks	Cached configure is kept for next handle while its file is not changed.
  * @see		_mmcamcorder_conf_get_info()
  *
  */
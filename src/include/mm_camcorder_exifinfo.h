@@ -30,6 +30,7 @@
 #include <libexif/exif-format.h>
 #include <libexif/exif-data.h>
 #include <libexif/mnote-samsung-tag.h>
+#include <sys/uio.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,6 +47,60 @@ typedef struct {
 	unsigned int size;		/**< size of saved exif data*/
 } mm_exif_info_t;
 
+/**
+ * Maximum number of entries which can be patched in exif template.
+ */
+#define MM_EXIF_TEMPLATE_ENTRY_MAX	64
+
+/**
+ * Structure for entry of exif template.
+ */
+typedef struct {
+	ExifIfd ifd;			/**< ifd of entry*/
+	ExifTag tag;			/**< exif tag*/
+	ExifFormat format;		/**< exif format*/
+	unsigned long components;	/**< number of components*/
+	unsigned int offset;		/**< offset of value in saved exif data*/
+	int keep;			/**< value is rewritten by libexif, so keep the value of template*/
+	int patched;			/**< entry is patched in current image*/
+} mm_exif_template_entry_t;
+
+/**
+ * Structure for exif template.
+ * The template is saved once, and then only values of entries are patched for each image.
+ */
+typedef struct {
+	void *data;			/**< saved exif data of template*/
+	unsigned int size;		/**< size of saved exif data*/
+	ExifByteOrder order;		/**< byte order of saved exif data*/
+	mm_exif_template_entry_t entry[MM_EXIF_TEMPLATE_ENTRY_MAX];	/**< entries which can be patched*/
+	int entry_num;			/**< number of entries*/
+	int cursor;			/**< index of next entry which is expected to be patched*/
+	int mismatch;			/**< entries of image are different from template*/
+	mm_exif_info_t *info;		/**< exif info which is patched now*/
+} mm_exif_template_t;
+
+/**
+ * Length of SOI marker, APP1 marker and length of APP1 which are put in front of exif.
+ */
+#define MM_EXIF_JPEG_HEADER_LENGTH	6
+
+/**
+ * Number of segments of jpeg with exif. (header, exif and image)
+ */
+#define MM_EXIF_JPEG_SEGMENT_NUM	3
+
+/**
+ * Structure for jpeg with exif which is kept as separated segments.
+ * Segments point exif info and jpeg image as they are, so they should be valid while segments are used.
+ */
+typedef struct {
+	unsigned char header[MM_EXIF_JPEG_HEADER_LENGTH];	/**< SOI, APP1 and length of APP1*/
+	struct iovec segment[MM_EXIF_JPEG_SEGMENT_NUM];		/**< header, exif and image without SOI*/
+	int segment_num;		/**< number of segments*/
+	unsigned int length;		/**< total length of segments*/
+} mm_exif_jpeg_t;
+
 /*=======================================================================================
 | GLOBAL FUNCTION PROTOTYPES								|
 ========================================================================================*/
@@ -113,6 +168,20 @@ int mm_exif_set_add_entry(ExifData *exif, ExifIfd ifd, ExifTag tag,
 int mm_exif_add_thumbnail_info(mm_exif_info_t *info, void *thumbnail,
 			       int width, int height, int len);
 
+/**
+ * Make exif info with thumbnail data. Source exif info is not changed.
+ * If thumbnail is too large to be inserted, output is not changed.
+ * @param[out] out exif info with thumbnail. Previous data of it is released.
+ * @param[in] info source exif info.
+ * @param[in] thumbnail image thumbnail data.
+ * @param[in] width width of thumbnail image.
+ * @param[in] height height of thumbnail image.
+ * @param[in] length length of thumbnail image.
+ * @return return int.
+ */
+int mm_exif_make_thumbnail_info(mm_exif_info_t *out, mm_exif_info_t *info, void *thumbnail,
+				int width, int height, int len);
+
 /**
  * create ExifMnoteDataSamsung and set up related function pointers
  * @param[in/out] info exif info.
@@ -155,6 +224,71 @@ int mm_exif_write_exif_jpeg_to_memory(void **mem, unsigned int *length,
 				      mm_exif_info_t *info, void *jpeg,
 				      unsigned int jpeg_len);
 
+/**
+ * Make segments of jpeg with exif without copying exif and jpeg image.
+ * @param[out] out segments of jpeg with exif.
+ * @param[in] info exif info.
+ * @param[in] jpeg jpeg image data.
+ * @param[in] jpeg_len length of jpeg image.
+ * @return return int.
+ */
+int mm_exif_make_exif_jpeg_segment(mm_exif_jpeg_t *out, mm_exif_info_t *info,
+				   void *jpeg, unsigned int jpeg_len);
+
+/**
+ * Create exif template.
+ * @param[out] tmpl exif template.
+ * @return return int.
+ */
+int mm_exif_template_create(mm_exif_template_t **tmpl);
+
+/**
+ * Destroy exif template.
+ * @param[in] tmpl exif template.
+ * @return void
+ */
+void mm_exif_template_destroy(mm_exif_template_t *tmpl);
+
+/**
+ * Set one tag information with exif template.
+ * If exif is not NULL, the tag is added into exif and it is remembered as an entry of template.
+ * Otherwise, the value of the tag is patched into the exif info given by mm_exif_template_begin_patch().
+ * @param[in] tmpl exif template.
+ * @param[in] exif ExifData to build template, or NULL to patch.
+ * @param[in] ifd ifd of the tag.
+ * @param[in] tag exif tag.
+ * @param[in] format tag format.
+ * @param[in] components the number of the component.
+ * @param[in] data the pointer of the tag data.
+ * @return return int.
+ */
+int mm_exif_template_set_entry(mm_exif_template_t *tmpl, ExifData *exif, ExifIfd ifd, ExifTag tag,
+			       ExifFormat format, unsigned long components, unsigned char *data);
+
+/**
+ * Save exif info as template, and find offsets of entries set by mm_exif_template_set_entry().
+ * @param[in] tmpl exif template.
+ * @param[in] info exif info which has saved exif data.
+ * @return return int.
+ */
+int mm_exif_template_save(mm_exif_template_t *tmpl, mm_exif_info_t *info);
+
+/**
+ * Copy saved exif data of template into exif info to patch entries.
+ * @param[in] tmpl exif template.
+ * @param[in/out] info exif info.
+ * @return return int.
+ */
+int mm_exif_template_begin_patch(mm_exif_template_t *tmpl, mm_exif_info_t *info);
+
+/**
+ * Check that all entries of template are patched.
+ * If not, the template can not be used for the image and it should be saved again.
+ * @param[in] tmpl exif template.
+ * @return return int.
+ */
+int mm_exif_template_end_patch(mm_exif_template_t *tmpl);
+
 #ifdef __cplusplus
 }
 #endif
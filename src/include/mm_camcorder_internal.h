@@ -251,6 +251,18 @@ extern "C" {
  */
 #define _MMCAMCORDER_AUDIO_TIME_MARGIN (300)
 
+/**
+ *	Frame interval histogram of KPI measurement : 256 buckets of 500 usec (0 ~ 128 msec)
+ */
+#define _MMCAMCORDER_KPI_INTERVAL_BUCKET_NUM	256
+#define _MMCAMCORDER_KPI_INTERVAL_BUCKET_USEC	500
+
+/**
+ *	Default and maximum length of video stream dispatch queue
+ */
+#define _MMCAMCORDER_VSTREAM_QUEUE_DEFAULT	3
+#define _MMCAMCORDER_VSTREAM_QUEUE_MAX		8
+
 /**
  *	Functions related with LOCK and WAIT
  */
@@ -501,10 +513,54 @@ typedef struct {
 	int average_fps;		/**< average fps  */
 	unsigned int video_framecount;	/**< total number of video frame */
 	unsigned int last_framecount;	/**< total number of video frame in last measurement */
-	struct timeval init_video_time;	/**< time when start to measure */
-	struct timeval last_video_time;	/**< last measurement time */
+	gint64 init_video_time;		/**< monotonic time when start to measure (usec) */
+	gint64 last_video_time;		/**< monotonic time of last fps measurement (usec) */
+	gint64 last_frame_time;		/**< monotonic time of last frame (usec) */
+	unsigned int interval_count;	/**< number of measured frame intervals */
+	unsigned int interval_max;	/**< maximum frame interval (usec) */
+	unsigned int interval_histogram[_MMCAMCORDER_KPI_INTERVAL_BUCKET_NUM];	/**< histogram of frame interval */
+	unsigned int drop_by_vframe;	/**< number of frames dropped by drop_vframe */
+	unsigned int drop_by_stability;	/**< number of frames dropped by cam_stability_count */
+	unsigned int drop_by_probe;	/**< number of frames dropped by video sink probe */
 } _MMCamcorderKPIMeasure;
 
+/**
+ * MMCamcorder frame of video stream dispatch queue
+ */
+typedef struct {
+	MMCamcorderVideoStreamDataType stream;	/**< stream data for video stream callback */
+	GstBuffer *buffer;			/**< referenced buffer which stream data points to */
+	void *converted_data;			/**< converted data from buffer pool. stream data points to this if it's not NULL */
+} _MMCamcorderVStreamFrame;
+
+/**
+ * MMCamcorder information for video stream dispatch thread
+ */
+typedef struct {
+	pthread_t thread;			/**< dispatch thread */
+	GMutex *lock;				/**< lock for queue */
+	GCond *cond;				/**< signalled when frame is pushed or popped */
+	gboolean running;			/**< whether dispatch thread is running */
+	int mode;				/**< MMCamcorderVideoStreamDispatchMode */
+	int length;				/**< maximum number of frames in queue */
+	int head;				/**< index of the oldest frame in queue */
+	int depth;				/**< number of frames in queue */
+	unsigned int dropped_count;		/**< number of frames dropped because queue was full */
+	_MMCamcorderVStreamFrame frame[_MMCAMCORDER_VSTREAM_QUEUE_MAX];	/**< ring of frames */
+} _MMCamcorderVStreamDispatch;
+
+/**
+ * MMCamcorder information of negotiated video stream format
+ */
+typedef struct {
+	GstCaps *caps;			/**< caps which cached information was parsed from */
+	gboolean need_update;		/**< cached information should be parsed again with next buffer */
+	int width;			/**< width of video stream */
+	int height;			/**< height of video stream */
+	unsigned int fourcc;		/**< fourcc of video stream */
+	int format;			/**< MMPixelFormatType of video stream */
+} _MMCamcorderVideoFormat;
+
 /**
  * MMCamcorder information for Multi-Thread Safe
  */
@@ -526,15 +582,24 @@ typedef struct {
 typedef struct {
 	pthread_t pCommandThread;											/**< Command loop handle */
 	GQueue *cmd_queue;													/**< Queue for Command loop */
-	sem_t sema;														/**< Semaphore for Command loop */
+	GMutex *lock;														/**< Mutex for command queue */
+	GCond *cond;														/**< Condition signalled when command is queued */
+	unsigned int coalesced_count;										/**< Number of command pairs cancelled each other */
+	gboolean executing;													/**< Whether command thread is executing a command */
 } _MMCamcorderCommand;
 
 /**
- * MMCamcorder command information
+ * MMCamcorder command information.
+ * It's also completion handle, so it has own lock not to refer camcorder handle which could be destroyed.
  */
 typedef struct {
 	MMHandleType handle;												/**< camcorder handle */
 	_MMCamcorderCommandType type;										/**< Type of command */
+	GMutex *lock;														/**< Mutex for reference count and completion */
+	GCond *cond;														/**< Condition signalled when command is completed */
+	int ref_count;														/**< Reference count (command queue and completion handle) */
+	gboolean done;														/**< Whether command is completed */
+	int result;															/**< Result of command */
 } __MMCamcorderCmdInfo;
 
 /**
@@ -563,12 +628,33 @@ typedef struct {
 	int drop_vframe;                        /**< When this value is bigger than zero and pass_first_vframe is zero, MSL will drop video frame though cam_stability count is bigger then zero. */
 	int pass_first_vframe;                  /**< When this value is bigger than zero, MSL won't drop video frame though "drop_vframe" is bigger then zero. */
 
+	/* For limiting rate of video stream callback */
+	int vstream_cb_fps;                     /**< maximum frame rate of video stream callback. 0 means no limit */
+	int vstream_cb_interval;                /**< deliver only one of every vstream_cb_interval frames. 0 or 1 means all */
+	unsigned int vstream_frame_count;       /**< frame counter for vstream_cb_interval */
+	GstClockTime vstream_next_time;         /**< timestamp of next frame which will be delivered for vstream_cb_fps */
+
 	/* INI information */
 	unsigned int fourcc;                    /**< Get fourcc value of camera INI file */
 	void *info;                             /**< extra information for camcorder */
 
 	_MMCamcorderGstElement *element;        /**< array of Gstreamer element */
 	_MMCamcorderKPIMeasure kpi;             /**< information related with performance measurement */
+	_MMCamcorderBufferPool vstream_pool;    /**< recycled buffers for converting video stream callback data */
+	_MMCamcorderVideoFormat vstream_format; /**< negotiated format of video stream callback data */
+	_MMCamcorderVStreamDispatch vstream_dispatch;   /**< dispatch thread of video stream callback */
+	_MMCamcorderStorageMonitor storage_monitor;     /**< free space monitor of recording storage */
+	unsigned int storage_sequence;          /**< sequence of storage information whose error was counted last */
+	_MMCamcorderAudioMeter audio_meter;     /**< level meter of recording audio */
+	_MMCamcorderSilenceBuffer silence;      /**< shared silence data for audio mute */
+	_MMCamcorderFrameNotifier frame_notifier;       /**< notify frame arrival to command waiting for frames */
+	_MMCamcorderPreRecordBuffer pre_record;         /**< encoded frames of the last N seconds before recording */
+	_MMCamcorderSegmentTracker segment;             /**< segments of segmented recording written by muxer */
+	_MMCamcorderEncodePool encode_pool;             /**< worker threads which encode multi shot frames in parallel */
+	mm_exif_template_t *exif_template;              /**< EXIF which is built once and patched for each image */
+	mm_exif_info_t capture_exif;                    /**< EXIF with thumbnail of captured JPEG */
+	mm_exif_jpeg_t capture_jpeg;                    /**< segments of captured JPEG with EXIF */
+	MMCamcorderCaptureSegmentType capture_segment[MM_EXIF_JPEG_SEGMENT_NUM];  /**< segments of captured image for application */
 
 	type_element *VideosinkElement;         /**< configure data of videosink element */
 	gboolean SensorEncodedCapture;          /**< whether camera sensor support encoded image capture */
@@ -594,7 +680,9 @@ typedef struct mmf_camcorder {
 	GList *event_probes;                   /**< a list of event probe handle */
 	GList *data_probes;                    /**< a list of data probe handle */
 	GList *signals;                        /**< a list of signal handle */
-	GList *msg_data;                       /**< a list of msg data */
+	_MMCamcorderMsgQueue msg_queue;        /**< queue of msg data */
+	_MMCamcorderFaceDetectPool fd_pool;    /**< pool of face detect info */
+	_MMCamcorderHotAttrs hot_attrs;        /**< attributes which are read by streaming thread */
 	camera_conf *conf_main;                /**< Camera configure Main structure */
 	camera_conf *conf_ctrl;                /**< Camera configure Control structure */
 	int asm_handle;                        /**< Audio session manager handle */
@@ -607,6 +695,8 @@ typedef struct mmf_camcorder {
 	void *msg_cb_param;                                     /**< message callback parameter */
 	mm_camcorder_video_stream_callback vstream_cb;          /**< Video stream callback */
 	void *vstream_cb_param;                                 /**< Video stream callback parameter */
+	mm_camcorder_video_stream_planar_callback vstream_planar_cb;     /**< Planar video stream callback */
+	void *vstream_planar_cb_param;                          /**< Planar video stream callback parameter */
 	mm_camcorder_audio_stream_callback astream_cb;          /**< Audio stream callback */
 	void *astream_cb_param;                                 /**< Audio stream callback parameter */
 	mm_camcorder_video_capture_callback vcapture_cb;        /**< Video capture callback */
@@ -854,6 +944,34 @@ int _mmcamcorder_set_video_stream_callback(MMHandleType hcamcorder,
 					   mm_camcorder_video_stream_callback callback,
 					   void *user_data);
 
+/**
+ *	This function is to set callback for planar video stream.
+ *
+ *	@param[in]	hcamcorder	Specifies the camcorder  handle
+ *	@param[in]	callback	Specifies the function pointer of callback function
+ *	@param[in]	user_data	Specifies the user poiner for passing to callback function
+ *
+ *	@return		This function returns zero on success, or negative value with error code.
+ *	@see		mmcamcorder_error_type
+ */
+int _mmcamcorder_set_video_stream_planar_callback(MMHandleType hcamcorder,
+						  mm_camcorder_video_stream_planar_callback callback,
+						  void *user_data);
+
+/**
+ *	This function is to get statistics of video stream dispatch queue.
+ *
+ *	@param[in]	hcamcorder	Specifies the camcorder  handle
+ *	@param[out]	queue_depth	Number of frames in queue
+ *	@param[out]	dropped_count	Number of frames dropped because queue was full
+ *
+ *	@return		This function returns zero on success, or negative value with error code.
+ *	@see		mmcamcorder_error_type
+ */
+int _mmcamcorder_get_video_stream_dispatch_stats(MMHandleType hcamcorder,
+						 unsigned int *queue_depth,
+						 unsigned int *dropped_count);
+
 /**
  *	This function is to set callback for audio stream.
  *
@@ -1115,13 +1233,26 @@ int _mmcamcorder_read_vidsrc_info(int videodevidx, camera_conf **configure_info)
 void _mmcamcorder_video_current_framerate_init(MMHandleType handle);
 int _mmcamcorder_video_current_framerate(MMHandleType handle);
 int _mmcamcorder_video_average_framerate(MMHandleType handle);
+int _mmcamcorder_get_video_frame_statistics(MMHandleType handle, MMCamcorderVideoFrameStatistics *stats);
+int _mmcamcorder_get_audio_level(MMHandleType handle, MMCamcorderAudioLevel *level);
+int _mmcamcorder_get_pre_record_statistics(MMHandleType handle, MMCamcorderPreRecordStatistics *stats);
+
+/* video stream dispatch */
+int _mmcamcorder_create_vstream_dispatch(MMHandleType handle);
+void _mmcamcorder_destroy_vstream_dispatch(_MMCamcorderSubContext *sc);
+gboolean _mmcamcorder_push_vstream_frame(MMHandleType handle, MMCamcorderVideoStreamDataType *stream,
+                                         GstBuffer *buffer, void *converted_data);
 
 /* command */
+__MMCamcorderCmdInfo *_mmcamcorder_new_command_info(MMHandleType handle, _MMCamcorderCommandType type);
 void _mmcamcorder_delete_command_info(__MMCamcorderCmdInfo *cmdinfo);
 int _mmcamcorder_create_command_loop(MMHandleType handle);
 int _mmcamcorder_destroy_command_loop(MMHandleType handle);
 int _mmcamcorder_append_command(MMHandleType handle, __MMCamcorderCmdInfo *info);
 int _mmcamcorder_append_simple_command(MMHandleType handle, _MMCamcorderCommandType type);
+int _mmcamcorder_append_async_command(MMHandleType handle, _MMCamcorderCommandType type, MMCamcorderCompletionHandle *completion);
+int _mmcamcorder_wait_command(MMCamcorderCompletionHandle completion, int timeout_ms, int *result);
+void _mmcamcorder_release_command(MMCamcorderCompletionHandle completion);
 void *_mmcamcorder_command_loop_thread(void *arg);
 
 #ifdef __cplusplus
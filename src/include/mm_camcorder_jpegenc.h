@@ -0,0 +1,75 @@
+/*
+ * libmm-camcorder
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jeongmo Yang <jm80.yang@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __MM_CAMCORDER_JPEGENC_H__
+#define __MM_CAMCORDER_JPEGENC_H__
+
+/*=======================================================================================
+| INCLUDE FILES										|
+========================================================================================*/
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*=======================================================================================
+| MACRO DEFINITIONS									|
+========================================================================================*/
+#define _MMCAMCORDER_JPEGENC_SLICE_MAX          16
+
+/*=======================================================================================
+| GLOBAL FUNCTION PROTOTYPES								|
+========================================================================================*/
+/**
+ * Check whether built-in JPEG encoder accepts the format.
+ * NV12, I420, YUYV and UYVY are supported.
+ *
+ * @param[in]	src_format	MMPixelFormatType of source.
+ * @return	TRUE if supported.
+ */
+gboolean _mmcamcorder_jpegenc_is_supported(int src_format);
+
+/**
+ * Encode a frame to baseline JPEG with built-in encoder.
+ * The frame is split into horizontal slices which are encoded in parallel.
+ * Every MCU row is a restart interval, so that slices are concatenated as they are.
+ *
+ * @param[in]	src_data	Source frame. Planes should be packed without padding.
+ * @param[in]	src_width	Width of source.
+ * @param[in]	src_height	Height of source.
+ * @param[in]	src_format	MMPixelFormatType of source.
+ * @param[in]	src_length	Length of source.
+ * @param[in]	jpeg_quality	Quality of JPEG, 1 ~ 100.
+ * @param[in]	slice_num	Number of slices which are encoded in parallel.
+ * @param[out]	result_data	Encoded data. It should be released by free().
+ * @param[out]	result_length	Length of encoded data.
+ * @return	TRUE on success.
+ */
+gboolean _mmcamcorder_jpegenc_encode(void *src_data, unsigned int src_width, unsigned int src_height,
+                                     int src_format, unsigned int src_length, unsigned int jpeg_quality,
+                                     int slice_num, void **result_data, unsigned int *result_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MM_CAMCORDER_JPEGENC_H__ */
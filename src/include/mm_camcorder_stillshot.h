@@ -40,8 +40,7 @@ extern "C" {
 /*=======================================================================================
 | MACRO DEFINITIONS									|
 ========================================================================================*/
-#define _MMCAMCORDER_CAPTURE_STOP_CHECK_INTERVAL	5000
-#define _MMCAMCORDER_CAPTURE_STOP_CHECK_COUNT		600
+#define _MMCAMCORDER_CAPTURE_STOP_TIMEOUT		3000	/* msec */
 #define _MNOTE_VALUE_NONE				0
 
 /*=======================================================================================
@@ -125,6 +124,7 @@ int _mmcamcorder_set_resize_property(MMHandleType handle, int capture_width, int
 int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int image_height);
 void __mmcamcorder_init_stillshot_info(MMHandleType handle);
 void __mmcamcorder_get_capture_data_from_buffer(MMCamcorderCaptureDataType *capture_data, int pixtype, GstBuffer *buffer);
+void __mmcamcorder_set_capture_segment(MMHandleType handle, MMCamcorderCaptureDataType *dest);
 void __mmcamcorder_release_jpeg_data(MMHandleType handle, MMCamcorderCaptureDataType *dest);
 int __mmcamcorder_capture_save_exifinfo(MMHandleType handle, MMCamcorderCaptureDataType *original, MMCamcorderCaptureDataType *thumbnail);
 int __mmcamcorder_set_jpeg_data(MMHandleType handle, MMCamcorderCaptureDataType *dest, MMCamcorderCaptureDataType *thumbnail);
@@ -137,6 +137,20 @@ do { \
 	} \
 } while(0);
 
+#define _MMCAMCORDER_BUFFER_POOL_MAX     4
+#define _MMCAMCORDER_MSG_QUEUE_MAX       64
+#define _MMCAMCORDER_MSG_STATS_MAX       32
+#define _MMCAMCORDER_MSG_DISPATCH_MAX    16
+#define _MMCAMCORDER_STORAGE_CHECK_INTERVAL 200    /* msec */
+#define _MMCAMCORDER_FD_POOL_SLOT_NUM    4
+#define _MMCAMCORDER_FD_MAX_FACES_DEFAULT 10
+#define _MMCAMCORDER_BOX_INDEX_MAX       64
+#define _MMCAMCORDER_AUDIO_METER_INTERVAL     100     /* msec */
+#define _MMCAMCORDER_AUDIO_METER_INTERVAL_MIN 20      /* msec */
+#define _MMCAMCORDER_AUDIO_METER_DB_MIN       -96.0
+#define _MMCAMCORDER_PRE_RECORD_MEMORY_LIMIT  8192    /* Kbyte */
+#define _MMCAMCORDER_ENCODE_POOL_THREAD_MAX    8
+
 #define MMCAM_FOURCC(a,b,c,d)  (guint32)((a)|(b)<<8|(c)<<16|(d)<<24)
 #define MMCAM_FOURCC_ARGS(fourcc) \
         ((gchar)((fourcc)&0xff)), \
@@ -180,6 +194,31 @@ typedef struct {
 	gint32 altitude;
 } _MMCamcorderLocationInfo;
 
+/**
+ * Structure of ISO base media file format box in index
+ */
+typedef struct {
+	guint32 fourcc;                                 /**< type of box */
+	guint64 offset;                                 /**< file offset of box header */
+	guint64 size;                                   /**< size of box including header, 0 if box extends to end of file */
+	int header_size;                                /**< 8, or 16 with 64bit largesize */
+	int parent;                                     /**< index of parent box, -1 for top level box */
+} _MMCamcorderBoxInfo;
+
+/**
+ * Structure of box index of ISO base media file.
+ * Top level boxes and children of 'moov' are indexed.
+ */
+typedef struct {
+	int fd;                                         /**< file descriptor */
+	guint64 file_size;                              /**< current size of file */
+	guchar *map;                                    /**< mapped area which contains 'moov' box */
+	guint64 map_offset;                             /**< file offset of mapped area (page aligned) */
+	size_t map_size;                                /**< size of mapped area */
+	int box_num;                                    /**< number of indexed boxes */
+	_MMCamcorderBoxInfo box[_MMCAMCORDER_BOX_INDEX_MAX];  /**< indexed boxes */
+} _MMCamcorderBoxIndex;
+
 /**
  * Structure of handler item
  */
@@ -198,6 +237,30 @@ typedef struct {
 	MMMessageParamType param;	/**< message parameter */
 } _MMCamcorderMsgItem;
 
+/**
+ * Structure of message statistics
+ */
+typedef struct {
+	int id;				/**< message id */
+	unsigned int enqueue_count;	/**< number of sent messages */
+	unsigned int drop_count;	/**< number of messages replaced by newer one or dropped */
+} _MMCamcorderMsgStats;
+
+/**
+ * Structure of message queue
+ */
+typedef struct {
+	GMutex *lock;						/**< lock of queue */
+	MMHandleType handle;					/**< handle */
+	guint idle_id;						/**< event source ID of dispatcher */
+	int head;						/**< index of the oldest message */
+	int count;						/**< number of queued messages */
+	_MMCamcorderMsgItem item[_MMCAMCORDER_MSG_QUEUE_MAX];	/**< ring of messages */
+	GList *overflow;					/**< messages which could not be queued in ring */
+	int stats_num;						/**< number of used statistics entries */
+	_MMCamcorderMsgStats stats[_MMCAMCORDER_MSG_STATS_MAX];	/**< statistics per message id */
+} _MMCamcorderMsgQueue;
+
 /**
  * Structure of zero copy image buffer
  */
@@ -251,6 +314,180 @@ typedef struct
 	int data[16];
 } SCMN_IMGB;
 
+/**
+ * Structure of recycled buffer pool
+ */
+typedef struct {
+	GMutex *lock;                                   /**< lock of pool */
+	unsigned int buffer_size;                       /**< size of each buffer in pool */
+	int count;                                      /**< number of free buffers in pool */
+	void *buffer[_MMCAMCORDER_BUFFER_POOL_MAX];     /**< free buffers */
+	guint64 hit_count;                              /**< number of requests which were served from pool */
+	guint64 miss_count;                             /**< number of requests which needed new allocation */
+} _MMCamcorderBufferPool;
+
+/**
+ * Structure of face detect info slot
+ */
+typedef struct {
+	gboolean in_use;                                /**< whether slot is sent with message */
+	MMCamFaceDetectInfo info;                       /**< face detect info */
+} _MMCamcorderFaceDetectSlot;
+
+/**
+ * Structure of face detect info pool
+ */
+typedef struct {
+	GMutex *lock;                                   /**< lock of pool */
+	int max_faces;                                  /**< maximum number of faces in a slot */
+	int drop_stale;                                 /**< replace face detect info which is not delivered yet */
+	MMCamFaceInfo *face_info;                       /**< face info array for all slots */
+	_MMCamcorderFaceDetectSlot slot[_MMCAMCORDER_FD_POOL_SLOT_NUM];  /**< slots */
+	unsigned int drop_count;                        /**< number of results dropped because no slot is free */
+} _MMCamcorderFaceDetectPool;
+
+/**
+ * Structure of storage information published by storage monitor
+ */
+typedef struct {
+	int status;                                     /**< result of _mmcamcorder_get_freespace(), 0 if not checked yet */
+	unsigned int sequence;                          /**< sequence number of check */
+	guint64 free_space;                             /**< free space (byte) */
+	guint64 write_rate;                             /**< consumed space per second (byte) */
+	gint64 check_time;                              /**< monotonic time of check (usec) */
+} _MMCamcorderStorageInfo;
+
+/**
+ * Structure of storage monitor
+ */
+typedef struct {
+	pthread_t thread;                               /**< monitor thread */
+	GMutex *lock;                                   /**< lock for path and thread control */
+	GCond *cond;                                    /**< condition to wake up monitor thread */
+	gboolean running;                               /**< whether monitor thread is running */
+	char *path;                                     /**< directory of recording file to check, NULL to stop checking */
+	unsigned int generation;                        /**< increased whenever path is changed */
+	_MMCamcorderStorageInfo info[2];                /**< double buffer of published information */
+	volatile gint index;                            /**< index of published information */
+	volatile gint publish_count;                    /**< increased before information is written, readers retry if it's changed */
+} _MMCamcorderStorageMonitor;
+
+/**
+ * Structure of audio level meter
+ */
+typedef struct {
+	GMutex *lock;                                   /**< lock of published level */
+	int format;                                     /**< audio format of accumulated samples */
+	int channel;                                    /**< number of channels of accumulated samples */
+	unsigned int window_frames;                     /**< number of frames in an integration window */
+	unsigned int frame_count;                       /**< number of accumulated frames in current window */
+	guint64 square_sum[MM_CAMCORDER_AUDIO_LEVEL_CHANNEL_MAX];  /**< sum of squared samples of each channel */
+	int peak[MM_CAMCORDER_AUDIO_LEVEL_CHANNEL_MAX];  /**< maximum absolute sample of each channel */
+	MMCamcorderAudioLevel last;                     /**< level of the last window, used by streaming thread only */
+	MMCamcorderAudioLevel level;                    /**< level of the last window, published with lock */
+} _MMCamcorderAudioMeter;
+
+/**
+ * Structure of shared silence data for audio mute
+ */
+typedef struct {
+	guint8 *data;                                   /**< zero filled data, never written after allocation */
+	unsigned int size;                              /**< size of data */
+	GList *retired;                                 /**< smaller data which could be still referred by buffers */
+} _MMCamcorderSilenceBuffer;
+
+/**
+ * Function to check whether waiting condition for frames is satisfied
+ */
+typedef gboolean (*_MMCamcorderFrameCheckFunc)(gpointer data);
+
+/**
+ * Structure to notify arrival of frames to waiting thread
+ */
+typedef struct {
+	GMutex *lock;                                   /**< lock of condition */
+	GCond *cond;                                    /**< condition signalled by streaming thread */
+	volatile gint waiting;                          /**< number of waiting threads */
+} _MMCamcorderFrameNotifier;
+
+/**
+ * Stream type of pre-record buffer
+ */
+typedef enum {
+	_MMCAMCORDER_PRE_RECORD_VIDEO = 0,
+	_MMCAMCORDER_PRE_RECORD_AUDIO,
+	_MMCAMCORDER_PRE_RECORD_STREAM_NUM
+} _MMCamcorderPreRecordStream;
+
+/**
+ * Structure of pre-record buffer which keeps encoded frames of the last N seconds.
+ * Video is always started with key frame, and it's dropped by GOP.
+ */
+typedef struct {
+	GMutex *lock;                                   /**< lock of queues, it lives as long as sub context */
+	gboolean active;                                /**< whether frames are kept, between init and deinit */
+	GQueue queue[_MMCAMCORDER_PRE_RECORD_STREAM_NUM];       /**< buffered GstBuffer of each stream */
+	guint64 size;                                   /**< total size of buffered frames */
+	guint64 peak_size;                              /**< maximum of total size */
+	guint64 max_size;                               /**< hard limit of total size */
+	GstClockTime duration;                          /**< duration to keep */
+	unsigned int drop[_MMCAMCORDER_PRE_RECORD_STREAM_NUM];  /**< number of dropped frames of each stream */
+} _MMCamcorderPreRecordBuffer;
+
+/**
+ * Structure of segment tracker which finds segments of segmented recording from output of fragmented MP4 muxer.
+ * Every segment except the first one starts with moof, and the first one includes file header.
+ */
+typedef struct {
+	int index;                                      /**< sequence number of segment which is being written */
+	guint64 start_time;                             /**< start time of segment which is being written (msec) */
+	guint64 end_time;                               /**< end time of segment which is being written, known when its moof is written (msec) */
+	guint64 start_offset;                           /**< file offset where segment which is being written starts */
+	int moof_count;                                 /**< number of moof boxes written by muxer */
+	guint64 position;                               /**< write position of muxer output */
+	guint64 size;                                   /**< size of file written by muxer */
+} _MMCamcorderSegmentTracker;
+
+/**
+ * Structure of a job in encode pool
+ */
+typedef struct {
+	unsigned int seq;                               /**< sequence of submission */
+	gpointer job;                                   /**< data of job */
+	gboolean result;                                /**< result of encode function */
+} _MMCamcorderEncodeJob;
+
+/**
+ * Function to encode a job on worker thread of encode pool
+ */
+typedef gboolean (*_MMCamcorderEncodeFunc)(gpointer job);
+
+/**
+ * Function to deliver an encoded job. It's called in order of submission, one by one.
+ */
+typedef void (*_MMCamcorderEncodeDeliverFunc)(gpointer job, gboolean result, gpointer user_data);
+
+/**
+ * Structure of encode pool which encodes jobs in parallel and delivers them in order.
+ */
+typedef struct {
+	pthread_t thread[_MMCAMCORDER_ENCODE_POOL_THREAD_MAX];  /**< worker threads */
+	int thread_num;                                 /**< number of worker threads */
+	GMutex *lock;                                   /**< lock of queues and counters */
+	GCond *cond;                                    /**< signalled when job is pushed, delivered or pool is stopped */
+	gboolean running;                               /**< whether worker threads are running */
+	GQueue pending;                                 /**< jobs waiting for worker */
+	GQueue done;                                    /**< encoded jobs waiting for delivery, sorted by sequence */
+	unsigned int push_seq;                          /**< sequence of next pushed job */
+	unsigned int deliver_seq;                       /**< sequence of next delivered job */
+	int in_flight;                                  /**< number of jobs pushed but not delivered yet */
+	int max_in_flight;                              /**< push is blocked while in_flight reaches it */
+	gboolean delivering;                            /**< whether a worker is delivering now */
+	_MMCamcorderEncodeFunc encode;                  /**< encode function */
+	_MMCamcorderEncodeDeliverFunc deliver;          /**< deliver function */
+	gpointer user_data;                             /**< user data of deliver function */
+} _MMCamcorderEncodePool;
+
 /*=======================================================================================
 | CONSTANT DEFINITIONS									|
 ========================================================================================*/
@@ -274,25 +511,97 @@ gboolean _mmcamcorder_link_elements(GList *element_list);
 gboolean _mmcamcroder_msg_callback(void *data);
 gboolean _mmcamcroder_send_message(MMHandleType handle, _MMCamcorderMsgItem *data);
 void _mmcamcroder_remove_message_all(MMHandleType handle);
+gboolean _mmcamcorder_msg_queue_init(_MMCamcorderMsgQueue *queue, MMHandleType handle);
+void _mmcamcorder_msg_queue_deinit(_MMCamcorderMsgQueue *queue);
+int _mmcamcorder_get_message_stats(MMHandleType handle, int message_id, unsigned int *enqueue_count, unsigned int *drop_count);
+
+/* Face detect info pool */
+gboolean _mmcamcorder_fd_pool_init(_MMCamcorderFaceDetectPool *pool, int max_faces, int drop_stale);
+void _mmcamcorder_fd_pool_deinit(_MMCamcorderFaceDetectPool *pool);
+MMCamFaceDetectInfo *_mmcamcorder_fd_pool_get(_MMCamcorderFaceDetectPool *pool);
+void _mmcamcorder_fd_pool_put(_MMCamcorderFaceDetectPool *pool, MMCamFaceDetectInfo *info);
+
+/* Storage monitor */
+gboolean _mmcamcorder_storage_monitor_start(_MMCamcorderStorageMonitor *monitor);
+void _mmcamcorder_storage_monitor_stop(_MMCamcorderStorageMonitor *monitor);
+void _mmcamcorder_storage_monitor_set_path(_MMCamcorderStorageMonitor *monitor, const char *path);
+void _mmcamcorder_storage_monitor_get_info(_MMCamcorderStorageMonitor *monitor, _MMCamcorderStorageInfo *info);
+unsigned int _mmcamcorder_storage_monitor_get_remained_time(_MMCamcorderStorageMonitor *monitor, guint64 reserved_size);
+
+/* Audio level meter */
+gboolean _mmcamcorder_audio_meter_init(_MMCamcorderAudioMeter *meter, int samplerate, int interval);
+void _mmcamcorder_audio_meter_deinit(_MMCamcorderAudioMeter *meter);
+gboolean _mmcamcorder_audio_meter_process(_MMCamcorderAudioMeter *meter, const unsigned char *data, unsigned int size,
+                                          int format, int channel, MMCamcorderAudioLevel *level);
+void _mmcamcorder_audio_meter_get_level(_MMCamcorderAudioMeter *meter, MMCamcorderAudioLevel *level);
+
+/* Audio mute */
+gboolean _mmcamcorder_silence_buffer_apply(_MMCamcorderSilenceBuffer *silence, GstBuffer *buffer);
+void _mmcamcorder_silence_buffer_deinit(_MMCamcorderSilenceBuffer *silence);
+
+/* Frame notifier */
+gboolean _mmcamcorder_frame_notifier_init(_MMCamcorderFrameNotifier *notifier);
+void _mmcamcorder_frame_notifier_deinit(_MMCamcorderFrameNotifier *notifier);
+void _mmcamcorder_frame_notifier_signal(_MMCamcorderFrameNotifier *notifier);
+gboolean _mmcamcorder_frame_notifier_wait(_MMCamcorderFrameNotifier *notifier, _MMCamcorderFrameCheckFunc check,
+                                          gpointer data, int timeout);
+
+/* Pre-record buffer */
+gboolean _mmcamcorder_pre_record_buffer_create(_MMCamcorderPreRecordBuffer *pre_record);
+void _mmcamcorder_pre_record_buffer_destroy(_MMCamcorderPreRecordBuffer *pre_record);
+gboolean _mmcamcorder_pre_record_buffer_init(_MMCamcorderPreRecordBuffer *pre_record, int duration, unsigned int max_size);
+void _mmcamcorder_pre_record_buffer_deinit(_MMCamcorderPreRecordBuffer *pre_record);
+void _mmcamcorder_pre_record_buffer_push(_MMCamcorderPreRecordBuffer *pre_record, _MMCamcorderPreRecordStream stream, GstBuffer *buffer);
+GstBuffer *_mmcamcorder_pre_record_buffer_pop(_MMCamcorderPreRecordBuffer *pre_record, _MMCamcorderPreRecordStream stream);
+GstClockTime _mmcamcorder_pre_record_buffer_get_start_time(_MMCamcorderPreRecordBuffer *pre_record);
+gboolean _mmcamcorder_pre_record_buffer_get_statistics(_MMCamcorderPreRecordBuffer *pre_record, MMCamcorderPreRecordStatistics *stats);
+
+/* Segment tracker */
+void _mmcamcorder_segment_tracker_reset(_MMCamcorderSegmentTracker *tracker);
+gboolean _mmcamcorder_segment_tracker_write(_MMCamcorderSegmentTracker *tracker, const guint8 *data, unsigned int size,
+                                            guint64 input_time, MMCamcorderRecordingSegmentInfo *segment);
+void _mmcamcorder_segment_tracker_seek(_MMCamcorderSegmentTracker *tracker, guint64 position);
+void _mmcamcorder_segment_tracker_finish(_MMCamcorderSegmentTracker *tracker, guint64 input_time, MMCamcorderRecordingSegmentInfo *segment);
+
+/* Encode pool */
+gboolean _mmcamcorder_encode_pool_start(_MMCamcorderEncodePool *pool, int thread_num, int max_in_flight,
+                                        _MMCamcorderEncodeFunc encode, _MMCamcorderEncodeDeliverFunc deliver, gpointer user_data);
+void _mmcamcorder_encode_pool_stop(_MMCamcorderEncodePool *pool);
+gboolean _mmcamcorder_encode_pool_push(_MMCamcorderEncodePool *pool, gpointer job);
+void _mmcamcorder_encode_pool_drain(_MMCamcorderEncodePool *pool);
 
 /* Pixel format */
 int _mmcamcorder_get_pixel_format(GstBuffer *buffer);
 int _mmcamcorder_get_pixtype(unsigned int fourcc);
 unsigned int _mmcamcorder_get_fourcc(int pixtype, int codectype, int use_zero_copy_format);
 
+/* Buffer pool */
+gboolean _mmcamcorder_buffer_pool_init(_MMCamcorderBufferPool *pool, unsigned int buffer_size, int count);
+void _mmcamcorder_buffer_pool_deinit(_MMCamcorderBufferPool *pool);
+void *_mmcamcorder_buffer_pool_get(_MMCamcorderBufferPool *pool, unsigned int size);
+void _mmcamcorder_buffer_pool_put(_MMCamcorderBufferPool *pool, void *buffer, unsigned int size);
+void _mmcamcorder_buffer_pool_get_stats(_MMCamcorderBufferPool *pool, guint64 *hit_count, guint64 *miss_count);
+
 /* JPEG encode */
 gboolean _mmcamcorder_encode_jpeg(void *src_data, unsigned int src_width, unsigned int src_height,
                                   int src_format, unsigned int src_length, unsigned int jpeg_quality,
                                   void **result_data, unsigned int *result_length);
+gboolean _mmcamcorder_encode_jpeg_with_slice(void *src_data, unsigned int src_width, unsigned int src_height,
+                                             int src_format, unsigned int src_length, unsigned int jpeg_quality,
+                                             int slice_num, void **result_data, unsigned int *result_length);
 
 /* Recording */
-/* find top level tag only, do not use this function for finding sub level tags.
-   tag_fourcc is Four-character-code (FOURCC) */
-gint _mmcamcorder_find_tag(FILE *f, guint32 tag_fourcc);
+/* box index opens file, and indexes top level boxes and children of 'moov'.
+   box is index of _MMCamcorderBoxIndex.box, and -1 means top level. */
+gboolean _mmcamcorder_box_index_open(_MMCamcorderBoxIndex *index, const char *filename);
+void _mmcamcorder_box_index_close(_MMCamcorderBoxIndex *index);
+int _mmcamcorder_box_index_find(_MMCamcorderBoxIndex *index, int parent, guint32 fourcc);
+gboolean _mmcamcorder_box_index_append(_MMCamcorderBoxIndex *index, int box, const guchar *data, guint32 size);
 gint32 _mmcamcorder_double_to_fix(gdouble d_number);
-gboolean _mmcamcorder_update_size(FILE *f, gint64 prev_pos, gint64 curr_pos);
-gboolean _mmcamcorder_write_loci(FILE *f, _MMCamcorderLocationInfo info);
-gboolean _mmcamcorder_write_udta(FILE *f, _MMCamcorderLocationInfo info);
+GByteArray *_mmcamcorder_make_loci(_MMCamcorderLocationInfo info);
+GByteArray *_mmcamcorder_make_udta(_MMCamcorderLocationInfo info);
+gboolean _mmcamcorder_write_loci(_MMCamcorderBoxIndex *index, int udta, _MMCamcorderLocationInfo info);
+gboolean _mmcamcorder_write_udta(_MMCamcorderBoxIndex *index, int moov, _MMCamcorderLocationInfo info);
 gulong _mmcamcorder_get_container_size(const guchar *size);
 
 /* File system */
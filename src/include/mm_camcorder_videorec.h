@@ -58,6 +58,15 @@ typedef struct {
 	guint64 filesize;		/**< current file size */
 	guint64 max_time;		/**< max recording time */
 	int fileformat;			/**< recording file format */
+	gboolean location_by_mux;	/**< location tags are written by muxer with trailer */
+	guint64 segment_duration;	/**< duration of segment (msec). 0 means not segmented */
+	guint64 segment_input_time;	/**< time of the last video frame which is sent to muxer (msec) */
+	volatile gint pre_recording;	/**< encoded frames are kept in pre-record buffer instead of muxer */
+	volatile gint pre_record_flush_video;	/**< video frames in pre-record buffer should be sent to muxer */
+	volatile gint pre_record_flush_audio;	/**< audio frames in pre-record buffer should be sent to muxer */
+	guint64 pre_record_base;	/**< timestamp(nsec) which becomes start of recording file */
+	volatile gint pre_record_wait_key;	/**< video delta frames are dropped until key frame after pre-recording */
+	gboolean pre_record_key_requested;	/**< key frame is requested to encoder while waiting for it */
 /*
 	guint checker_id;
 	guint checker_count;
@@ -289,6 +289,88 @@ int mm_camcorder_cancel(MMHandleType camcorder)
 }
 
 
+int mm_camcorder_realize_async(MMHandleType camcorder, MMCamcorderCompletionHandle *completion)
+{
+	int error = MM_ERROR_NONE;
+
+	mmf_return_val_if_fail((void *)camcorder, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	error = _mmcamcorder_append_async_command(camcorder, _MMCAMCORDER_CMD_REALIZE, completion);
+
+	return error;
+}
+
+
+int mm_camcorder_unrealize_async(MMHandleType camcorder, MMCamcorderCompletionHandle *completion)
+{
+	int error = MM_ERROR_NONE;
+
+	mmf_return_val_if_fail((void *)camcorder, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	error = _mmcamcorder_append_async_command(camcorder, _MMCAMCORDER_CMD_UNREALIZE, completion);
+
+	return error;
+}
+
+
+int mm_camcorder_start_async(MMHandleType camcorder, MMCamcorderCompletionHandle *completion)
+{
+	int error = MM_ERROR_NONE;
+
+	mmf_return_val_if_fail((void *)camcorder, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	error = _mmcamcorder_append_async_command(camcorder, _MMCAMCORDER_CMD_START, completion);
+
+	return error;
+}
+
+
+int mm_camcorder_stop_async(MMHandleType camcorder, MMCamcorderCompletionHandle *completion)
+{
+	int error = MM_ERROR_NONE;
+
+	mmf_return_val_if_fail((void *)camcorder, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	error = _mmcamcorder_append_async_command(camcorder, _MMCAMCORDER_CMD_STOP, completion);
+
+	return error;
+}
+
+
+int mm_camcorder_commit_async(MMHandleType camcorder, MMCamcorderCompletionHandle *completion)
+{
+	int error = MM_ERROR_NONE;
+
+	mmf_return_val_if_fail((void *)camcorder, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	error = _mmcamcorder_append_async_command(camcorder, _MMCAMCORDER_CMD_COMMIT, completion);
+
+	return error;
+}
+
+
+int mm_camcorder_wait_completion(MMHandleType camcorder, MMCamcorderCompletionHandle completion, int timeout_ms, int *result)
+{
+	int error = MM_ERROR_NONE;
+
+	mmf_return_val_if_fail((void *)camcorder, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	error = _mmcamcorder_wait_command(completion, timeout_ms, result);
+
+	return error;
+}
+
+
+void mm_camcorder_release_completion(MMHandleType camcorder, MMCamcorderCompletionHandle completion)
+{
+	mmf_return_if_fail((void *)camcorder);
+
+	_mmcamcorder_release_command(completion);
+
+	return;
+}
+
+
 int mm_camcorder_set_message_callback(MMHandleType  camcorder, MMMessageCallback callback, void *user_data)
 {
 	int error = MM_ERROR_NONE;
@@ -313,6 +395,78 @@ int mm_camcorder_set_video_stream_callback(MMHandleType camcorder, mm_camcorder_
 }
 
 
+int mm_camcorder_set_video_stream_planar_callback(MMHandleType camcorder, mm_camcorder_video_stream_planar_callback callback, void* user_data)
+{
+	int error = MM_ERROR_NONE;
+
+	mmf_return_val_if_fail((void *)camcorder, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	error = _mmcamcorder_set_video_stream_planar_callback(camcorder, callback, user_data);
+
+	return error;
+}
+
+
+int mm_camcorder_get_video_stream_dispatch_stats(MMHandleType camcorder, unsigned int *queue_depth, unsigned int *dropped_count)
+{
+	int error = MM_ERROR_NONE;
+
+	mmf_return_val_if_fail((void *)camcorder, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	error = _mmcamcorder_get_video_stream_dispatch_stats(camcorder, queue_depth, dropped_count);
+
+	return error;
+}
+
+
+int mm_camcorder_get_video_frame_statistics(MMHandleType camcorder, MMCamcorderVideoFrameStatistics *stats)
+{
+	int error = MM_ERROR_NONE;
+
+	mmf_return_val_if_fail((void *)camcorder, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	error = _mmcamcorder_get_video_frame_statistics(camcorder, stats);
+
+	return error;
+}
+
+
+int mm_camcorder_get_message_stats(MMHandleType camcorder, int message_id, unsigned int *enqueue_count, unsigned int *drop_count)
+{
+	int error = MM_ERROR_NONE;
+
+	mmf_return_val_if_fail((void *)camcorder, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	error = _mmcamcorder_get_message_stats(camcorder, message_id, enqueue_count, drop_count);
+
+	return error;
+}
+
+
+int mm_camcorder_get_audio_level(MMHandleType camcorder, MMCamcorderAudioLevel *level)
+{
+	int error = MM_ERROR_NONE;
+
+	mmf_return_val_if_fail((void *)camcorder, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	error = _mmcamcorder_get_audio_level(camcorder, level);
+
+	return error;
+}
+
+
+int mm_camcorder_get_pre_record_statistics(MMHandleType camcorder, MMCamcorderPreRecordStatistics *stats)
+{
+	int error = MM_ERROR_NONE;
+
+	mmf_return_val_if_fail((void *)camcorder, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	error = _mmcamcorder_get_pre_record_statistics(camcorder, stats);
+
+	return error;
+}
+
+
 int mm_camcorder_set_audio_stream_callback(MMHandleType camcorder, mm_camcorder_audio_stream_callback callback, void* user_data)
 {
 	int error = MM_ERROR_NONE;
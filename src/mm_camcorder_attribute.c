@@ -186,7 +186,7 @@ mm_cam_attr_construct_info cam_attrs_const_info[] ={
 		MM_ATTRS_VALID_TYPE_INT_ARRAY,
 		(int)depth,
 		ARRAY_SIZE(depth),
-		NULL,
+		_mmcamcorder_commit_audio_format,
 	},
 	//10
 	{
@@ -198,7 +198,7 @@ mm_cam_attr_construct_info cam_attrs_const_info[] ={
 		MM_ATTRS_VALID_TYPE_INT_RANGE,
 		1,
 		2,
-		NULL,
+		_mmcamcorder_commit_audio_channel,
 	},
 	//11
 	{
@@ -1423,6 +1423,90 @@ mm_cam_attr_construct_info cam_attrs_const_info[] ={
 		FALSE,
 		TRUE,
 		_mmcamcorder_commit_display_evas_do_scaling,
+	},
+	//115
+	{
+		MM_CAM_VIDEO_STREAM_DISPATCH_MODE,
+		"video-stream-dispatch-mode",
+		MMF_VALUE_TYPE_INT,
+		MM_ATTRS_FLAG_RW,
+		{(void*)MM_CAMCORDER_VIDEO_STREAM_DISPATCH_SYNC},
+		MM_ATTRS_VALID_TYPE_INT_RANGE,
+		MM_CAMCORDER_VIDEO_STREAM_DISPATCH_SYNC,
+		MM_CAMCORDER_VIDEO_STREAM_DISPATCH_BLOCK,
+		_mmcamcorder_commit_video_stream_dispatch,
+	},
+	//116
+	{
+		MM_CAM_VIDEO_STREAM_QUEUE_LENGTH,
+		"video-stream-queue-length",
+		MMF_VALUE_TYPE_INT,
+		MM_ATTRS_FLAG_RW,
+		{(void*)_MMCAMCORDER_VSTREAM_QUEUE_DEFAULT},
+		MM_ATTRS_VALID_TYPE_INT_RANGE,
+		1,
+		_MMCAMCORDER_VSTREAM_QUEUE_MAX,
+		_mmcamcorder_commit_video_stream_dispatch,
+	},
+	//117
+	{
+		MM_CAM_VIDEO_STREAM_CALLBACK_FPS,
+		"video-stream-callback-fps",
+		MMF_VALUE_TYPE_INT,
+		MM_ATTRS_FLAG_RW,
+		{(void*)0},
+		MM_ATTRS_VALID_TYPE_INT_RANGE,
+		0,
+		_MMCAMCORDER_MAX_INT,
+		_mmcamcorder_commit_video_stream_rate,
+	},
+	//118
+	{
+		MM_CAM_VIDEO_STREAM_CALLBACK_INTERVAL,
+		"video-stream-callback-interval",
+		MMF_VALUE_TYPE_INT,
+		MM_ATTRS_FLAG_RW,
+		{(void*)0},
+		MM_ATTRS_VALID_TYPE_INT_RANGE,
+		0,
+		_MMCAMCORDER_MAX_INT,
+		_mmcamcorder_commit_video_stream_rate,
+	},
+	//119
+	{
+		MM_CAM_TARGET_SEGMENT_TIME_LIMIT,
+		"target-segment-time-limit",
+		MMF_VALUE_TYPE_INT,
+		MM_ATTRS_FLAG_RW,
+		{(void*)0},
+		MM_ATTRS_VALID_TYPE_INT_RANGE,
+		0,
+		_MMCAMCORDER_MAX_INT,
+		NULL,
+	},
+	//120
+	{
+		MM_CAM_TARGET_PRE_RECORD_TIME,
+		"target-pre-record-time",
+		MMF_VALUE_TYPE_INT,
+		MM_ATTRS_FLAG_RW,
+		{(void*)0},
+		MM_ATTRS_VALID_TYPE_INT_RANGE,
+		0,
+		_MMCAMCORDER_MAX_INT,
+		NULL,
+	},
+	//121
+	{
+		MM_CAM_CAPTURE_SEGMENTED,
+		"capture-segmented",
+		MMF_VALUE_TYPE_INT,
+		MM_ATTRS_FLAG_RW,
+		{(void*)FALSE},
+		MM_ATTRS_VALID_TYPE_INT_RANGE,
+		0,
+		1,
+		NULL,
 	}
 };
 
@@ -1738,6 +1822,35 @@ _mmcamcorder_commit_camcorder_attrs (int attr_idx, const char *attr_name, const
 }
 
 
+void _mmcamcorder_init_hot_attributes(MMHandleType handle)
+{
+	int format = MM_CAMCORDER_AUDIO_FORMAT_PCM_S16_LE;
+	int channel = 2;
+	int break_cont_shot = FALSE;
+	double volume = 1.0;
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+
+	mmf_return_if_fail(hcamcorder);
+
+	mm_camcorder_get_attributes(handle, NULL,
+	                            MMCAM_AUDIO_VOLUME, &volume,
+	                            MMCAM_AUDIO_FORMAT, &format,
+	                            MMCAM_AUDIO_CHANNEL, &channel,
+	                            MMCAM_CAPTURE_BREAK_CONTINUOUS_SHOT, &break_cont_shot,
+	                            NULL);
+
+	g_atomic_int_set(&(hcamcorder->hot_attrs.audio_mute), (volume == 0.0));
+	g_atomic_int_set(&(hcamcorder->hot_attrs.audio_format), format);
+	g_atomic_int_set(&(hcamcorder->hot_attrs.audio_channel), channel);
+	g_atomic_int_set(&(hcamcorder->hot_attrs.capture_break_cont_shot), break_cont_shot);
+
+	_mmcam_dbg_log("mute %d, format %d, channel %d, break cont shot %d",
+	               (volume == 0.0), format, channel, break_cont_shot);
+
+	return;
+}
+
+
 int __mmcamcorder_set_conf_to_valid_info(MMHandleType handle)
 {
 	int *format = NULL;
@@ -1879,6 +1992,9 @@ bool _mmcamcorder_commit_capture_break_cont_shot (MMHandleType handle, int attr_
 
 	char* videosrc_name = NULL;
 
+	/* capture callback checks this value for every frame */
+	g_atomic_int_set(&(hcamcorder->hot_attrs.capture_break_cont_shot), ivalue);
+
 	_mmcamcorder_conf_get_element(hcamcorder->conf_main,
 	                              CONFIGURE_CATEGORY_MAIN_VIDEO_INPUT,
 	                              "VideosrcElement",
@@ -1980,12 +2096,42 @@ bool _mmcamcorder_commit_capture_sound_enable(MMHandleType handle, int attr_idx,
 }
 
 
+bool _mmcamcorder_commit_audio_format(MMHandleType handle, int attr_idx, const mmf_value_t *value)
+{
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+
+	mmf_return_val_if_fail(hcamcorder, FALSE);
+
+	g_atomic_int_set(&(hcamcorder->hot_attrs.audio_format), value->value.i_val);
+
+	return TRUE;
+}
+
+
+bool _mmcamcorder_commit_audio_channel(MMHandleType handle, int attr_idx, const mmf_value_t *value)
+{
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+
+	mmf_return_val_if_fail(hcamcorder, FALSE);
+
+	g_atomic_int_set(&(hcamcorder->hot_attrs.audio_channel), value->value.i_val);
+
+	return TRUE;
+}
+
+
 bool _mmcamcorder_commit_audio_volume (MMHandleType handle, int attr_idx, const mmf_value_t *value)
 {
 	int current_state = MM_CAMCORDER_STATE_NONE;
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
 	_MMCamcorderSubContext *sc = NULL;
 	bool bret = FALSE;
 
+	mmf_return_val_if_fail(hcamcorder, FALSE);
+
+	/* audio data probe checks mute for every buffer */
+	g_atomic_int_set(&(hcamcorder->hot_attrs.audio_mute), (value->value.d_val == 0.0));
+
 	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
 	if (!sc)
 		return TRUE;
@@ -3588,6 +3734,52 @@ bool _mmcamcorder_commit_display_evas_do_scaling(MMHandleType handle, int attr_i
 }
 
 
+bool _mmcamcorder_commit_video_stream_dispatch(MMHandleType handle, int attr_idx, const mmf_value_t *value)
+{
+	int current_state = MM_CAMCORDER_STATE_NONE;
+
+	mmf_return_val_if_fail(handle, FALSE);
+
+	/* dispatch thread is prepared in realize, so it can not be changed after that */
+	current_state = _mmcamcorder_get_state(handle);
+	if (current_state > MM_CAMCORDER_STATE_NULL) {
+		_mmcam_dbg_warn("Can NOT change video stream dispatch. invalid state %d", current_state);
+		return FALSE;
+	}
+
+	_mmcam_dbg_log("attr[%d] - value[%d]", attr_idx, value->value.i_val);
+
+	return TRUE;
+}
+
+
+bool _mmcamcorder_commit_video_stream_rate(MMHandleType handle, int attr_idx, const mmf_value_t *value)
+{
+	_MMCamcorderSubContext *sc = NULL;
+
+	mmf_return_val_if_fail(handle, FALSE);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
+	if (!sc) {
+		_mmcam_dbg_log("NOT initialized. this will be applied later");
+		return TRUE;
+	}
+
+	_mmcam_dbg_log("attr[%d] - value[%d]", attr_idx, value->value.i_val);
+
+	/* probe of video stream reads these values, not attributes */
+	if (attr_idx == MM_CAM_VIDEO_STREAM_CALLBACK_FPS) {
+		sc->vstream_cb_fps = value->value.i_val;
+		sc->vstream_next_time = GST_CLOCK_TIME_NONE;
+	} else {
+		sc->vstream_cb_interval = value->value.i_val;
+		sc->vstream_frame_count = 0;
+	}
+
+	return TRUE;
+}
+
+
 bool _mmcamcorder_commit_strobe (MMHandleType handle, int attr_idx, const mmf_value_t *value)
 {
 	bool bret = FALSE;
@@ -24,7 +24,6 @@
 =======================================================================================*/
 #include "mm_camcorder_internal.h"
 #include "mm_camcorder_audiorec.h"
-#include <math.h>
 
 /*---------------------------------------------------------------------------------------
 |    GLOBAL VARIABLE DEFINITIONS for internal						|
@@ -37,9 +36,7 @@
 #define RESET_PAUSE_TIME                        0
 #define _MMCAMCORDER_AUDIO_MINIMUM_SPACE        (100*1024)
 #define _MMCAMCORDER_AUDIO_MARGIN_SPACE         (1*1024)
-#define _MMCAMCORDER_RETRIAL_COUNT              10
-#define _MMCAMCORDER_FRAME_WAIT_TIME            20000 /* micro second */
-#define _MMCAMCORDER_FREE_SPACE_CHECK_INTERVAL  10
+#define _MMCAMCORDER_FRAME_WAIT_TIMEOUT         200 /* msec */
 /*---------------------------------------------------------------------------------------
 |    LOCAL FUNCTION PROTOTYPES:								|
 ---------------------------------------------------------------------------------------*/
@@ -48,6 +45,7 @@ static gboolean __mmcamcorder_audio_dataprobe_voicerecorder(GstPad *pad, GstBuff
 static gboolean __mmcamcorder_audio_dataprobe_record(GstPad *pad, GstBuffer *buffer, gpointer u_data);
 static int __mmcamcorder_create_audiop_with_encodebin(MMHandleType handle);
 static void __mmcamcorder_audiorec_pad_added_cb(GstElement *element, GstPad *pad, MMHandleType handle);
+static gboolean __mmcamcorder_check_enough_frames(gpointer data);
 
 /*=======================================================================================
 |  FUNCTION DEFINITIONS									|
@@ -60,6 +58,8 @@ static void __mmcamcorder_audiorec_pad_added_cb(GstElement *element, GstPad *pad
 static int __mmcamcorder_create_audiop_with_encodebin(MMHandleType handle)
 {
 	int err = MM_ERROR_NONE;
+	int samplerate = 0;
+	int meter_interval = _MMCAMCORDER_AUDIO_METER_INTERVAL;
 	char *aenc_name = NULL;
 	char *mux_name = NULL;
 
@@ -225,6 +225,16 @@ static int __mmcamcorder_create_audiop_with_encodebin(MMHandleType handle)
 	}	
 
 
+	/* audio level meter */
+	mm_camcorder_get_attributes(handle, NULL,
+	                            MMCAM_AUDIO_SAMPLERATE, &samplerate,
+	                            NULL);
+	_mmcamcorder_conf_get_value_int(hcamcorder->conf_main,
+	                                CONFIGURE_CATEGORY_MAIN_AUDIO_INPUT,
+	                                "AudioMeterInterval",
+	                                &meter_interval);
+	_mmcamcorder_audio_meter_init(&(sc->audio_meter), samplerate, meter_interval);
+
 	//set data probe function
 	srcpad = gst_element_get_static_pad(sc->element[_MMCAMCORDER_AUDIOSRC_SRC].gst, "src");
 	MMCAMCORDER_ADD_BUFFER_PROBE(srcpad, _MMCAMCORDER_HANDLER_AUDIOREC,
@@ -433,6 +443,11 @@ _mmcamcorder_audio_command(MMHandleType handle, int command)
 
 				MMCAMCORDER_G_OBJECT_SET( sc->element[_MMCAMCORDER_ENCSINK_SINK].gst, "location", info->filename);
 
+				/* free space is checked by storage monitor thread while recording */
+				_mmcamcorder_storage_monitor_start(&(sc->storage_monitor));
+				_mmcamcorder_storage_monitor_set_path(&(sc->storage_monitor), info->filename);
+				sc->storage_sequence = 0;
+
 				sc->ferror_send = FALSE;
 				sc->ferror_count = 0;
 				sc->bget_eos = FALSE;
@@ -482,32 +497,19 @@ _mmcamcorder_audio_command(MMHandleType handle, int command)
 		case _MMCamcorder_CMD_PAUSE:
 			{
 				GstClock *clock = NULL;
-				int count = 0;
-				
+
 				if (info->b_commiting)
 				{
 					_mmcam_dbg_warn("now on commiting previous file!!(cmd : %d)", cmd);
 					return MM_ERROR_CAMCORDER_CMD_IS_RUNNING;
 				}
 
-				for(count=0; count <= _MMCAMCORDER_RETRIAL_COUNT ; count++)
-				{
-					if(info->filesize > 0)
-					{
-						break;
-					}
-					else if(count == _MMCAMCORDER_RETRIAL_COUNT)
-					{
-						_mmcam_dbg_err("Pause fail, we are waiting for 100 milisecond, but still file size is %" G_GUINT64_FORMAT "", 
-									info->filesize);
-						return MM_ERROR_CAMCORDER_INVALID_CONDITION;
-					}
-					else
-					{
-						_mmcam_dbg_warn("Pause is Waiting for enough audio frame, retrial count[%d], file size is %" G_GUINT64_FORMAT "", 
-									count, info->filesize);					
-					}
-					usleep(_MMCAMCORDER_FRAME_WAIT_TIME);
+				/* wait until data probe signals that audio data is recorded */
+				if (!_mmcamcorder_frame_notifier_wait(&(sc->frame_notifier), __mmcamcorder_check_enough_frames,
+				                                      info, _MMCAMCORDER_FRAME_WAIT_TIMEOUT)) {
+					_mmcam_dbg_err("Pause fail, we are waiting for %d milisecond, but still file size is %" G_GUINT64_FORMAT "",
+					               _MMCAMCORDER_FRAME_WAIT_TIMEOUT, info->filesize);
+					return MM_ERROR_CAMCORDER_INVALID_CONDITION;
 				}
 
 				ret = _mmcamcorder_gst_set_state(handle, pipeline, GST_STATE_PAUSED);
@@ -555,12 +557,12 @@ _mmcamcorder_audio_command(MMHandleType handle, int command)
 				unlink(info->filename);
 				g_free(info->filename);
 				info->filename = NULL;					
+				_mmcamcorder_storage_monitor_set_path(&(sc->storage_monitor), NULL);
 			}
 
 			break;
 		case _MMCamcorder_CMD_COMMIT:
 		{
-			int count = 0;
 			g_print("\n\n _MMCamcorder_CMD_COMMIT\n\n");
 
 			if (info->b_commiting)
@@ -574,27 +576,15 @@ _mmcamcorder_audio_command(MMHandleType handle, int command)
 				info->b_commiting = TRUE;
 			}			
 			
-			for(count=0; count <= _MMCAMCORDER_RETRIAL_COUNT ; count++)
-			{
-				if(info->filesize > 0)
-				{
-					break;
-				}
-				else if(count == _MMCAMCORDER_RETRIAL_COUNT)
-				{
-					_mmcam_dbg_err("Commit fail, we are waiting for 100 milisecond, but still file size is %" G_GUINT64_FORMAT "", 
-								info->filesize);
-					info->b_commiting = FALSE;
-					return MM_ERROR_CAMCORDER_INVALID_CONDITION;						
-				}
-				else
-				{
-					_mmcam_dbg_warn("Commit is Waiting for enough audio frame, retrial count[%d], file size is %" G_GUINT64_FORMAT "", 
-								count, info->filesize);					
-				}
-				usleep(_MMCAMCORDER_FRAME_WAIT_TIME);
+			/* wait until data probe signals that audio data is recorded */
+			if (!_mmcamcorder_frame_notifier_wait(&(sc->frame_notifier), __mmcamcorder_check_enough_frames,
+			                                      info, _MMCAMCORDER_FRAME_WAIT_TIMEOUT)) {
+				_mmcam_dbg_err("Commit fail, we are waiting for %d milisecond, but still file size is %" G_GUINT64_FORMAT "",
+				               _MMCAMCORDER_FRAME_WAIT_TIMEOUT, info->filesize);
+				info->b_commiting = FALSE;
+				return MM_ERROR_CAMCORDER_INVALID_CONDITION;
 			}
-			
+
 			if (audioSrc) {
 				GstPad *pad = gst_element_get_static_pad (audioSrc, "src");
 //				gst_pad_push_event (pad, gst_event_new_eos());
@@ -741,6 +731,7 @@ _mmcamcorder_audio_handle_eos(MMHandleType handle)
 
 	g_free(info->filename);
 	info->filename = NULL;
+	_mmcamcorder_storage_monitor_set_path(&(sc->storage_monitor), NULL);
 
 	_mmcam_dbg_err("_MMCamcorder_CMD_COMMIT : end");
 
@@ -750,99 +741,49 @@ _mmcamcorder_audio_handle_eos(MMHandleType handle)
 }
 
 
-static float
-__mmcamcorder_get_decibel(unsigned char* raw, int size, MMCamcorderAudioFormat format)
-{
-	#define MAX_AMPLITUDE_MEAN_16BIT 23170.115738161934
-	#define MAX_AMPLITUDE_MEAN_08BIT    89.803909382810
-
-	int i = 0;
-	int depthByte = 0;
-	int count = 0;
-
-	short* pcm16 = 0;
-	char* pcm8 = 0;
-
-	float db = 0.0;
-	float rms = 0.0;
-	unsigned long long square_sum = 0;
-
-	if (format == MM_CAMCORDER_AUDIO_FORMAT_PCM_S16_LE)
-		depthByte = 2;
-	else		//MM_CAMCORDER_AUDIO_FORMAT_PCM_U8
-		depthByte = 1;
-
-	for( ; i < size ; i += (depthByte<<1) )
-	{
-		if (depthByte == 1)
-		{
-			pcm8 = (char *)(raw + i);
-			square_sum += (*pcm8)*(*pcm8);
-		}
-		else		//2byte
-		{
-			pcm16 = (short*)(raw + i);
-			square_sum += (*pcm16)*(*pcm16);
-		}
-
-		count++;
-	}
-
-	rms = sqrt( square_sum/count );
-
-	if (depthByte == 1)
-		db = 20 * log10( rms/MAX_AMPLITUDE_MEAN_08BIT );
-	else
-		db = 20 * log10( rms/MAX_AMPLITUDE_MEAN_16BIT );
-
-	/*
-	_mmcam_dbg_log("size[%d],depthByte[%d],count[%d],rms[%f],db[%f]",
-	               size, depthByte, count, rms, db);
-	*/
-
-	return db;
-}
-
-
 static gboolean
 __mmcamcorder_audio_dataprobe_voicerecorder(GstPad *pad, GstBuffer *buffer, gpointer u_data)
 {
-	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(u_data);
-	double volume = 0.0;
+	int i = 0;
 	int format = 0;
 	int channel = 0;
-	float curdcb = 0.0;
+	int mute = FALSE;
+	float curdcb = _MMCAMCORDER_AUDIO_METER_DB_MIN;
+	gboolean completed = FALSE;
+	MMCamcorderAudioLevel level;
 	_MMCamcorderMsgItem msg;
-	int err = MM_ERROR_UNKNOWN;
-	char *err_name = NULL;
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(u_data);
+	_MMCamcorderSubContext *sc = NULL;
 
 	mmf_return_val_if_fail(hcamcorder, FALSE);
 
-	/* Set volume to audio input */
-	err = mm_camcorder_get_attributes((MMHandleType)hcamcorder, &err_name,
-									MMCAM_AUDIO_VOLUME, &volume,
-									MMCAM_AUDIO_FORMAT, &format,
-									MMCAM_AUDIO_CHANNEL, &channel,
-									NULL);
-	if (err < 0) 
-	{
-		_mmcam_dbg_warn("Get attrs fail. (%s:%x)", err_name, err);
-		SAFE_FREE (err_name);
-		return err;
+	sc = MMF_CAMCORDER_SUBCONTEXT(hcamcorder);
+	mmf_return_val_if_fail(sc, FALSE);
+
+	/* Get attributes from snapshot without lock */
+	format = g_atomic_int_get(&(hcamcorder->hot_attrs.audio_format));
+	channel = g_atomic_int_get(&(hcamcorder->hot_attrs.audio_channel));
+
+	/* Replace data with shared silence data, source buffer is not touched */
+	mute = g_atomic_int_get(&(hcamcorder->hot_attrs.audio_mute));
+	if (mute) {
+		_mmcamcorder_silence_buffer_apply(&(sc->silence), buffer);
 	}
-	
-	if(volume == 0) //mute
-		    memset (GST_BUFFER_DATA(buffer), 0,  GST_BUFFER_SIZE(buffer));
 
-	/* Get current volume level of real input stream */
-//	currms = __mmcamcorder_get_RMS(GST_BUFFER_DATA(buffer), GST_BUFFER_SIZE(buffer), depth);
-	__ta__( "__mmcamcorder_get_decibel",
-	curdcb = __mmcamcorder_get_decibel(GST_BUFFER_DATA(buffer), GST_BUFFER_SIZE(buffer), format);
-	);
+	/* Get current volume level of real input stream.
+	   Message is sent once per integration window, with level of the loudest channel. */
+	memset(&level, 0x00, sizeof(MMCamcorderAudioLevel));
+	completed = _mmcamcorder_audio_meter_process(&(sc->audio_meter), mute ? NULL : GST_BUFFER_DATA(buffer),
+	                                             GST_BUFFER_SIZE(buffer), format, channel, &level);
+	for (i = 0 ; i < level.channel ; i++) {
+		curdcb = MAX(curdcb, level.rms_dB[i]);
+	}
 
-	msg.id = MM_MESSAGE_CAMCORDER_CURRENT_VOLUME;
-	msg.param.rec_volume_dB = curdcb;
-	_mmcamcroder_send_message((MMHandleType)hcamcorder, &msg);
+	if (completed) {
+		msg.id = MM_MESSAGE_CAMCORDER_CURRENT_VOLUME;
+		msg.param.rec_volume_dB = curdcb;
+		_mmcamcroder_send_message((MMHandleType)hcamcorder, &msg);
+	}
 
 	/* CALL audio stream callback */
 	if ((hcamcorder->astream_cb) && buffer && GST_BUFFER_DATA(buffer))
@@ -902,20 +843,28 @@ __mmcamcorder_audiorec_pad_added_cb(GstElement *element, GstPad *pad,  MMHandleT
 }
 
 
+static gboolean __mmcamcorder_check_enough_frames(gpointer data)
+{
+	_MMCamcorderAudioInfo *info = (_MMCamcorderAudioInfo *)data;
+
+	mmf_return_val_if_fail(info, FALSE);
+
+	return (info->filesize > 0);
+}
+
+
 static gboolean __mmcamcorder_audio_dataprobe_record(GstPad *pad, GstBuffer *buffer, gpointer u_data)
 {
-	static int count = 0;
 	guint64 rec_pipe_time = 0;
-	guint64 free_space = 0;
 	guint64 buffer_size = 0;
 	guint64 trailer_size = 0;
-	char *filename = NULL;
 	unsigned int remained_time = 0;
 
 	_MMCamcorderSubContext *sc = NULL;
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(u_data);
 	_MMCamcorderAudioInfo *info = NULL;
 	_MMCamcorderMsgItem msg;
+	_MMCamcorderStorageInfo storage;
 
 	mmf_return_val_if_fail(hcamcorder, FALSE);
 	mmf_return_val_if_fail(buffer, FALSE);
@@ -940,6 +889,7 @@ static gboolean __mmcamcorder_audio_dataprobe_record(GstPad *pad, GstBuffer *buf
 		}
 
 		info->filesize += buffer_size;
+		_mmcamcorder_frame_notifier_signal(&(sc->frame_notifier));
 		return TRUE;
 	}
 
@@ -958,23 +908,24 @@ static gboolean __mmcamcorder_audio_dataprobe_record(GstPad *pad, GstBuffer *buf
 		trailer_size = 0; /* no trailer */
 	}
 
-	filename = info->filename;
-
-	/* to minimizing free space check overhead */
-	count = count % _MMCAMCORDER_FREE_SPACE_CHECK_INTERVAL;
-	if (count++ == 0) {
-		gint free_space_ret = _mmcamcorder_get_freespace(filename, &free_space);
+	/* get free space which is published by storage monitor thread */
+	_mmcamcorder_storage_monitor_get_info(&(sc->storage_monitor), &storage);
 
-		/*_mmcam_dbg_log("check free space for recording");*/
+	/* check free space which is predicted with write rate for every buffer */
+	switch (storage.status) {
+	case 0: /* not checked yet */
+		break;
+	case -2: /* file not exist */
+	case -1: /* failed to get free space */
+		/* count error only once for each check of storage monitor */
+		if (storage.sequence != sc->storage_sequence) {
+			sc->storage_sequence = storage.sequence;
 
-		switch (free_space_ret) {
-		case -2: /* file not exist */
-		case -1: /* failed to get free space */
-			_mmcam_dbg_err("Error occured. [%d]", free_space_ret);
+			_mmcam_dbg_err("Error occured. [%d]", storage.status);
 			if (sc->ferror_count == 2 && sc->ferror_send == FALSE) {
 				sc->ferror_send = TRUE;
 				msg.id = MM_MESSAGE_CAMCORDER_ERROR;
-				if (free_space_ret == -2) {
+				if (storage.status == -2) {
 					msg.param.code = MM_ERROR_FILE_NOT_FOUND;
 				} else {
 					msg.param.code = MM_ERROR_FILE_READ;
@@ -983,16 +934,19 @@ static gboolean __mmcamcorder_audio_dataprobe_record(GstPad *pad, GstBuffer *buf
 			} else {
 				sc->ferror_count++;
 			}
+		}
 
-			return FALSE; /* skip this buffer */
+		return FALSE; /* skip this buffer */
 
-		default: /* succeeded to get free space */
-			/* check free space for recording */
-			if (free_space < (guint64)(_MMCAMCORDER_AUDIO_MINIMUM_SPACE + buffer_size + trailer_size)) {
-				_mmcam_dbg_warn("No more space for recording!!!");
-				_mmcam_dbg_warn("Free Space : [%" G_GUINT64_FORMAT "], file size : [%" G_GUINT64_FORMAT "]",
-				                free_space, info->filesize);
+	default: /* succeeded to get free space */
+		/* check free space which is predicted with write rate */
+		if (storage.free_space < (guint64)(_MMCAMCORDER_AUDIO_MINIMUM_SPACE + buffer_size + trailer_size)) {
+			_mmcam_dbg_warn("No more space for recording!!!");
+			_mmcam_dbg_warn("Free Space : [%" G_GUINT64_FORMAT "], file size : [%" G_GUINT64_FORMAT "]",
+			                storage.free_space, info->filesize);
 
+			/* buffers could come until pipeline is blocked, so notify once */
+			if (!sc->isMaxsizePausing) {
 				if (info->bMuxing) {
 					MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_ENCSINK_ENCBIN].gst, "block", TRUE);
 				} else {
@@ -1002,11 +956,11 @@ static gboolean __mmcamcorder_audio_dataprobe_record(GstPad *pad, GstBuffer *buf
 				sc->isMaxsizePausing = TRUE;
 				msg.id = MM_MESSAGE_CAMCORDER_NO_FREE_SPACE;
 				_mmcamcroder_send_message((MMHandleType)hcamcorder, &msg);
-
-				return FALSE; /* skip this buffer */
 			}
-			break;
+
+			return FALSE; /* skip this buffer */
 		}
+		break;
 	}
 
 	if (!GST_CLOCK_TIME_IS_VALID(GST_BUFFER_TIMESTAMP(buffer))) {
@@ -1016,8 +970,11 @@ static gboolean __mmcamcorder_audio_dataprobe_record(GstPad *pad, GstBuffer *buf
 
 	rec_pipe_time = GST_TIME_AS_MSECONDS(GST_BUFFER_TIMESTAMP(buffer));
 
-	if (info->max_time > 0 && info->max_time < (remained_time + rec_pipe_time)) {
-		remained_time = info->max_time - rec_pipe_time;
+	/* time remained until storage is full or time limit */
+	remained_time = _mmcamcorder_storage_monitor_get_remained_time(&(sc->storage_monitor), _MMCAMCORDER_AUDIO_MINIMUM_SPACE + trailer_size);
+	if (info->max_time > 0 && rec_pipe_time < info->max_time &&
+	    (remained_time == 0 || info->max_time - rec_pipe_time < remained_time)) {
+		remained_time = (unsigned int)(info->max_time - rec_pipe_time);
 	}
 
 	/*_mmcam_dbg_log("remained time : %u", remained_time);*/
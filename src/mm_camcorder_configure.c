@@ -26,6 +26,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <sys/stat.h>
 
 #include "mm_camcorder_internal.h"
 #include "mm_camcorder_configure.h"
@@ -49,6 +50,30 @@ static int conf_ctrl_category_size[CONFIGURE_CATEGORY_CTRL_NUM] = { 0, };
 static conf_info_table* conf_main_info_table[CONFIGURE_CATEGORY_MAIN_NUM] = { NULL, };
 static conf_info_table* conf_ctrl_info_table[CONFIGURE_CATEGORY_CTRL_NUM] = { NULL, };
 
+/* default value tables indexed by name, they are built once in _mmcamcorder_conf_init */
+static GHashTable* conf_main_info_index[CONFIGURE_CATEGORY_MAIN_NUM] = { NULL, };
+static GHashTable* conf_ctrl_info_index[CONFIGURE_CATEGORY_CTRL_NUM] = { NULL, };
+
+/* parsed configure which is shared by handles in process */
+typedef struct {
+	int type;
+	char *path;             /* path of parsed file */
+	time_t mtime;           /* modified time of parsed file */
+	off_t size;             /* size of parsed file */
+	int ref_count;          /* number of handles which use it, it's kept in cache even if 0 */
+	gboolean stale;         /* file is changed, then it's released with the last reference */
+	camera_conf *conf;
+} conf_cache_item;
+
+static GList *conf_cache = NULL;
+G_LOCK_DEFINE_STATIC(conf_cache);
+
+static void __mmcamcorder_conf_free_info(camera_conf **configure_info);
+static GHashTable *__mmcamcorder_conf_make_table_index(conf_info_table *table, int size);
+static void __mmcamcorder_conf_make_detail_index(conf_info *info);
+static void *__mmcamcorder_conf_find_detail(camera_conf *configure_info, int category, const char *name);
+static conf_info_table *__mmcamcorder_conf_find_table_info(int type, int category, const char *name);
+
 /*
  * Videosrc element default value
  */
@@ -682,6 +707,7 @@ static conf_info_table conf_main_video_input_table[] = {
 	{ "UseVideoscale",      CONFIGURE_VALUE_INT,            {0} },
 	{ "VideoscaleElement",  CONFIGURE_VALUE_ELEMENT,        {(type_element*)&_videoscale_element_default} },
 	{ "UseZeroCopyFormat",  CONFIGURE_VALUE_INT,            {0} },
+	{ "FaceDetectDropStale", CONFIGURE_VALUE_INT,           {0} },
 };
 
 /*
@@ -690,6 +716,7 @@ static conf_info_table conf_main_video_input_table[] = {
 static conf_info_table conf_main_audio_input_table[] = {
 	{ "AudiosrcElement",	CONFIGURE_VALUE_ELEMENT,	{(type_element*)&_audiosrc_element_default} },
 	{ "AudiomodemsrcElement",	CONFIGURE_VALUE_ELEMENT,	{(type_element*)&_audiomodemsrc_element_default} },
+	{ "AudioMeterInterval",	CONFIGURE_VALUE_INT,	{_MMCAMCORDER_AUDIO_METER_INTERVAL} },
 };
 
 /*
@@ -715,6 +742,9 @@ static conf_info_table conf_main_capture_table[] = {
 	{ "UseCaptureMode",         CONFIGURE_VALUE_INT,     {0} },
 	{ "VideoscaleElement",      CONFIGURE_VALUE_ELEMENT, {(type_element*)&_videoscale_element_default} },
 	{ "PlayCaptureSound",       CONFIGURE_VALUE_INT,     {1} },
+	{ "EncodeThread",           CONFIGURE_VALUE_INT,     {0} },
+	{ "EncodeMaxInFlight",      CONFIGURE_VALUE_INT,     {0} },
+	{ "EncodeSlice",            CONFIGURE_VALUE_INT,     {0} },
 };
 
 /*
@@ -739,6 +769,7 @@ static conf_info_table conf_main_record_table[] = {
 	{ "UseNoiseSuppressor",     CONFIGURE_VALUE_INT,     {0} },
 	{ "DropVideoFrame",         CONFIGURE_VALUE_INT,     {0} },
 	{ "PassFirstVideoFrame",    CONFIGURE_VALUE_INT,     {0} },
+	{ "PreRecordMemoryLimit",   CONFIGURE_VALUE_INT,     {_MMCAMCORDER_PRE_RECORD_MEMORY_LIMIT} },
 };
 
 /*
@@ -932,6 +963,12 @@ void _mmcamcorder_conf_init(int type, camera_conf** configure_info)
 		conf_main_category_size[CONFIGURE_CATEGORY_MAIN_IMAGE_ENCODER] = sizeof( conf_main_image_encoder_table ) / info_table_size;
 		conf_main_category_size[CONFIGURE_CATEGORY_MAIN_MUX]           = sizeof( conf_main_mux_table ) / info_table_size;
 
+		for (i = 0 ; i < CONFIGURE_CATEGORY_MAIN_NUM ; i++) {
+			if (conf_main_info_index[i] == NULL) {
+				conf_main_info_index[i] = __mmcamcorder_conf_make_table_index(conf_main_info_table[i], conf_main_category_size[i]);
+			}
+		}
+
 		(*configure_info)->info = (conf_info**)g_malloc0( sizeof( conf_info* ) * CONFIGURE_CATEGORY_MAIN_NUM );
 
 		for (i = 0 ; i < CONFIGURE_CATEGORY_MAIN_NUM ; i++) {
@@ -952,6 +989,12 @@ void _mmcamcorder_conf_init(int type, camera_conf** configure_info)
 		conf_ctrl_category_size[CONFIGURE_CATEGORY_CTRL_CAPTURE]    = sizeof( conf_ctrl_capture_table ) / info_table_size;
 		conf_ctrl_category_size[CONFIGURE_CATEGORY_CTRL_DETECT]     = sizeof( conf_ctrl_detect_table ) / info_table_size;
 
+		for (i = 0 ; i < CONFIGURE_CATEGORY_CTRL_NUM ; i++) {
+			if (conf_ctrl_info_index[i] == NULL) {
+				conf_ctrl_info_index[i] = __mmcamcorder_conf_make_table_index(conf_ctrl_info_table[i], conf_ctrl_category_size[i]);
+			}
+		}
+
 		(*configure_info)->info = (conf_info**)g_malloc0( sizeof( conf_info* ) * CONFIGURE_CATEGORY_CTRL_NUM );
 
 		for (i = 0 ; i < CONFIGURE_CATEGORY_CTRL_NUM ; i++) {
@@ -969,8 +1012,8 @@ int
 _mmcamcorder_conf_get_info( int type, char* ConfFile, camera_conf** configure_info )
 {
 	int ret         = MM_ERROR_NONE;
-	FILE* fd        = NULL;
 	char* conf_path = NULL;
+	struct stat st;
 
 	_mmcam_dbg_log( "Opening...[%s]", ConfFile );
 
@@ -987,20 +1030,84 @@ _mmcamcorder_conf_get_info( int type, char* ConfFile, camera_conf** configure_in
 	snprintf( conf_path, strlen(ConfFile)+strlen(CONFIGURE_PATH)+2, "%s/%s", CONFIGURE_PATH, ConfFile );
 	_mmcam_dbg_log( "Try open Configure File[%s]", conf_path );
 
-	fd = fopen( conf_path, "r" );
-	if( fd == NULL )
+	if( stat( conf_path, &st ) != 0 )
 	{
 		_mmcam_dbg_warn( "File open failed.[%s] retry...", conf_path );
 		snprintf( conf_path, strlen(ConfFile)+strlen(CONFIGURE_PATH_RETRY)+2, "%s/%s", CONFIGURE_PATH_RETRY, ConfFile );
 		_mmcam_dbg_log( "Try open Configure File[%s]", conf_path );
-		fd = fopen( conf_path, "r" );
-		if( fd == NULL )
+		if( stat( conf_path, &st ) != 0 )
 		{
 			_mmcam_dbg_warn( "File open failed.[%s] But keep going... All value will be returned as default.Type[%d]", 
 				conf_path, type );
+			free( conf_path );
+			return MM_ERROR_CAMCORDER_CREATE_CONFIGURE;
+		}
+	}
+
+	ret = _mmcamcorder_conf_get_info_from_path( type, conf_path, configure_info );
+
+	free( conf_path );
+	conf_path = NULL;
+
+	_mmcam_dbg_log( "Leave..." );
+
+	return ret;
+}
+
+int
+_mmcamcorder_conf_get_info_from_path( int type, const char* conf_path, camera_conf** configure_info )
+{
+	int ret         = MM_ERROR_NONE;
+	FILE* fd        = NULL;
+	char* item_path = NULL;
+	struct stat st;
+	GList *list = NULL;
+	conf_cache_item *item = NULL;
+
+	mmf_return_val_if_fail( conf_path && configure_info, MM_ERROR_CAMCORDER_INVALID_ARGUMENT );
+
+	if( stat( conf_path, &st ) != 0 )
+	{
+		_mmcam_dbg_warn( "File open failed.[%s]", conf_path );
+		return MM_ERROR_CAMCORDER_CREATE_CONFIGURE;
+	}
+
+	G_LOCK( conf_cache );
+
+	/* parsed configure is reused while file is not changed */
+	for( list = conf_cache ; list ; list = g_list_next( list ) )
+	{
+		item = (conf_cache_item*)list->data;
+		if( item->stale || item->type != type || strcmp( item->path, conf_path ) )
+		{
+			continue;
 		}
+
+		if( item->mtime == st.st_mtime && item->size == st.st_size )
+		{
+			item->ref_count++;
+			*configure_info = item->conf;
+
+			G_UNLOCK( conf_cache );
+
+			_mmcam_dbg_log( "Cached configure is used.[%s] ref %d", conf_path, item->ref_count );
+			return MM_ERROR_NONE;
+		}
+
+		/* file is changed. it's released with the last reference */
+		_mmcam_dbg_log( "Configure file is changed.[%s]", conf_path );
+		item->stale = TRUE;
+		if( item->ref_count == 0 )
+		{
+			conf_cache = g_list_delete_link( conf_cache, list );
+			__mmcamcorder_conf_free_info( &item->conf );
+			free( item->path );
+			free( item );
+		}
+		break;
 	}
 
+	fd = fopen( conf_path, "r" );
 	if( fd != NULL )
 	{
 		ret = _mmcamcorder_conf_parse_info( type, fd, configure_info );
@@ -1008,16 +1115,40 @@ _mmcamcorder_conf_get_info( int type, char* ConfFile, camera_conf** configure_in
 	}
 	else
 	{
+		_mmcam_dbg_warn( "File open failed.[%s]", conf_path );
 		ret = MM_ERROR_CAMCORDER_CREATE_CONFIGURE;
 	}
 
-	if( conf_path != NULL )
+	if( ret == MM_ERROR_NONE && *configure_info )
 	{
-		free( conf_path );
-		conf_path = NULL;
+		item = (conf_cache_item*)malloc( sizeof(conf_cache_item) );
+		item_path = strdup( conf_path );
+		if( item && item_path )
+		{
+			item->type = type;
+			item->path = item_path;
+			item->mtime = st.st_mtime;
+			item->size = st.st_size;
+			item->ref_count = 1;
+			item->stale = FALSE;
+			item->conf = *configure_info;
+			conf_cache = g_list_prepend( conf_cache, item );
+		}
+		else
+		{
+			_mmcam_dbg_warn( "Failed to alloc cache item. configure is not shared." );
+			if( item )
+			{
+				free( item );
+			}
+			if( item_path )
+			{
+				free( item_path );
+			}
+		}
 	}
 
-	_mmcam_dbg_log( "Leave..." );
+	G_UNLOCK( conf_cache );
 
 	return ret;
 }
@@ -1259,6 +1390,49 @@ _mmcamcorder_conf_parse_info( int type, FILE* fd, camera_conf** configure_info )
 
 void
 _mmcamcorder_conf_release_info( camera_conf** configure_info )
+{
+	GList *list = NULL;
+	conf_cache_item *item = NULL;
+
+	mmf_return_if_fail( configure_info && *configure_info );
+
+	G_LOCK( conf_cache );
+
+	for( list = conf_cache ; list ; list = g_list_next( list ) )
+	{
+		item = (conf_cache_item*)list->data;
+		if( item->conf != *configure_info )
+		{
+			continue;
+		}
+
+		item->ref_count--;
+		_mmcam_dbg_log( "Release cached configure.[%s] ref %d", item->path, item->ref_count );
+
+		/* keep it for next handle unless file is changed */
+		if( item->ref_count <= 0 && item->stale )
+		{
+			conf_cache = g_list_delete_link( conf_cache, list );
+			__mmcamcorder_conf_free_info( &item->conf );
+			free( item->path );
+			free( item );
+		}
+
+		G_UNLOCK( conf_cache );
+
+		*configure_info = NULL;
+		return;
+	}
+
+	G_UNLOCK( conf_cache );
+
+	/* not cached */
+	__mmcamcorder_conf_free_info( configure_info );
+}
+
+
+static void
+__mmcamcorder_conf_free_info( camera_conf** configure_info )
 {
 	int i, j, k, type, count, category_num;
 	camera_conf* temp_conf = (*configure_info);
@@ -1288,6 +1462,13 @@ _mmcamcorder_conf_release_info( camera_conf** configure_info )
 	{
 		if( temp_conf->info[i] )
 		{
+			/* keys of index are owned by details */
+			if( temp_conf->info[i]->index )
+			{
+				g_hash_table_destroy( temp_conf->info[i]->index );
+				temp_conf->info[i]->index = NULL;
+			}
+
 			for( j = 0 ; j < temp_conf->info[i]->count ; j++ )
 			{
 				if( temp_conf->info[i]->detail_info[j] == NULL )
@@ -1393,11 +1574,106 @@ _mmcamcorder_conf_release_info( camera_conf** configure_info )
 	_mmcam_dbg_log( "Done." );
 }
 
+static GHashTable *
+__mmcamcorder_conf_make_table_index( conf_info_table* table, int size )
+{
+	int i = 0;
+	GHashTable* info_index = NULL;
+
+	mmf_return_val_if_fail( table, NULL );
+
+	info_index = g_hash_table_new( g_str_hash, g_str_equal );
+
+	for( i = 0 ; i < size ; i++ )
+	{
+		/* first one is found as linear search did */
+		if( g_hash_table_lookup( info_index, table[i].name ) == NULL )
+		{
+			g_hash_table_insert( info_index, (gpointer)table[i].name, (gpointer)&table[i] );
+		}
+	}
+
+	return info_index;
+}
+
+static void
+__mmcamcorder_conf_make_detail_index( conf_info* info )
+{
+	int i = 0;
+	char* name = NULL;
+
+	mmf_return_if_fail( info );
+
+	info->index = g_hash_table_new( g_str_hash, g_str_equal );
+
+	for( i = 0 ; i < info->count ; i++ )
+	{
+		if( info->detail_info[i] == NULL )
+		{
+			continue;
+		}
+
+		/* every detail type starts with name */
+		name = ((type_int*)(info->detail_info[i]))->name;
+		if( name && g_hash_table_lookup( info->index, name ) == NULL )
+		{
+			g_hash_table_insert( info->index, (gpointer)name, info->detail_info[i] );
+		}
+	}
+
+	return;
+}
+
+static void *
+__mmcamcorder_conf_find_detail( camera_conf* configure_info, int category, const char* name )
+{
+	conf_info* info = NULL;
+
+	if( configure_info->type == CONFIGURE_TYPE_MAIN )
+	{
+		mmf_return_val_if_fail( category >= 0 && category < CONFIGURE_CATEGORY_MAIN_NUM, NULL );
+	}
+	else
+	{
+		mmf_return_val_if_fail( category >= 0 && category < CONFIGURE_CATEGORY_CTRL_NUM, NULL );
+	}
+
+	info = configure_info->info[category];
+	if( info == NULL || info->index == NULL )
+	{
+		return NULL;
+	}
+
+	return g_hash_table_lookup( info->index, name );
+}
+
+static conf_info_table *
+__mmcamcorder_conf_find_table_info( int type, int category, const char* name )
+{
+	GHashTable* info_index = NULL;
+
+	if( type == CONFIGURE_TYPE_MAIN )
+	{
+		info_index = conf_main_info_index[category];
+	}
+	else
+	{
+		info_index = conf_ctrl_info_index[category];
+	}
+
+	if( info_index == NULL )
+	{
+		return NULL;
+	}
+
+	return (conf_info_table*)g_hash_table_lookup( info_index, name );
+}
+
 int
 _mmcamcorder_conf_get_value_type( int type, int category, char* name, int* value_type )
 {
-	int i = 0;
 	int count_value = 0;
+	conf_info_table* table_info = NULL;
 
 	/*_mmcam_dbg_log( "Entered..." );*/
 
@@ -1411,29 +1687,12 @@ _mmcamcorder_conf_get_value_type( int type, int category, char* name, int* value
 
 	/*_mmcam_dbg_log( "Number of value : [%d]", count_value );*/
 
-	if( type == CONFIGURE_TYPE_MAIN )
+	table_info = __mmcamcorder_conf_find_table_info( type, category, name );
+	if( table_info )
 	{
-		for( i = 0 ; i < count_value ; i++ )
-		{
-			if( !strcmp( conf_main_info_table[category][i].name, name ) )
-			{
-				*value_type = conf_main_info_table[category][i].value_type;
-				/*_mmcam_dbg_log( "Category[%d],Name[%s],Type[%d]", category, name, *value_type );*/
-				return TRUE;
-			}
-		}
-	}
-	else
-	{
-		for( i = 0 ; i < count_value ; i++ )
-		{
-			if( !strcmp( conf_ctrl_info_table[category][i].name, name ) )
-			{
-				*value_type = conf_ctrl_info_table[category][i].value_type;
-				/*_mmcam_dbg_log( "Category[%d],Name[%s],Type[%d]", category, name, *value_type );*/
-				return TRUE;
-			}
-		}
+		*value_type = table_info->value_type;
+		/*_mmcam_dbg_log( "Category[%d],Name[%s],Type[%d]", category, name, *value_type );*/
+		return TRUE;
 	}
 
 	return FALSE;
@@ -1704,6 +1963,8 @@ _mmcamcorder_conf_add_info( int type, conf_info** info, char** buffer_details, i
 		}
 	}
 
+	__mmcamcorder_conf_make_detail_index( *info );
+
 	return TRUE;
 }
 
@@ -2005,6 +2266,8 @@ _mmcamcorder_conf_add_info_with_caps( int type, conf_info** info, char** buffer_
 		}		
 	}
 
+	__mmcamcorder_conf_make_detail_index( *info );
+
 	//_mmcam_dbg_log( "Done." );
 
 	return TRUE;
@@ -2014,33 +2277,19 @@ _mmcamcorder_conf_add_info_with_caps( int type, conf_info** info, char** buffer_
 int
 _mmcamcorder_conf_get_value_int( camera_conf* configure_info, int category, char* name, int* value )
 {
-	int i, count;
-	conf_info* info;
+	void* detail = NULL;
 
 	//_mmcam_dbg_log( "Entered... category[%d],name[%s]", category, name );
 
 	mmf_return_val_if_fail( configure_info, FALSE );
 	mmf_return_val_if_fail( name, FALSE );
 
-	if( configure_info->info[category] )
+	detail = __mmcamcorder_conf_find_detail( configure_info, category, name );
+	if( detail )
 	{
-		count	= configure_info->info[category]->count;
-		info	= configure_info->info[category];
-		
-		for( i = 0 ; i < count ; i++ )
-		{
-			if( info->detail_info[i] == NULL )
-			{
-				continue;
-			}
-			
-			if( !strcmp( ((type_int*)(info->detail_info[i]))->name , name ) )
-			{
-				*value = ((type_int*)(info->detail_info[i]))->value;
-				//_mmcam_dbg_log( "Get[%s] int[%d]", name, *value );
-				return TRUE;
-			}
-		}
+		*value = ((type_int*)detail)->value;
+		//_mmcam_dbg_log( "Get[%s] int[%d]", name, *value );
+		return TRUE;
 	}
 
 	if( _mmcamcorder_conf_get_default_value_int( configure_info->type, category, name, value ) )
@@ -2057,36 +2306,22 @@ _mmcamcorder_conf_get_value_int( camera_conf* configure_info, int category, char
 int
 _mmcamcorder_conf_get_value_int_range( camera_conf* configure_info, int category, char* name, type_int_range** value )
 {
-	int i, count;
-	conf_info* info;
+	void* detail = NULL;
 
 	//_mmcam_dbg_log( "Entered... category[%d],name[%s]", category, name );
 
 	mmf_return_val_if_fail( configure_info, FALSE );
 	mmf_return_val_if_fail( name, FALSE );
 
-	if( configure_info->info[category] )
+	detail = __mmcamcorder_conf_find_detail( configure_info, category, name );
+	if( detail )
 	{
-		count	= configure_info->info[category]->count;
-		info	= configure_info->info[category];
-		
-		for( i = 0 ; i < count ; i++ )
-		{
-			if( info->detail_info[i] == NULL )
-			{
-				continue;
-			}
-			
-			if( !strcmp( ((type_int_range*)(info->detail_info[i]))->name , name ) )
-			{
-				*value = (type_int_range*)(info->detail_info[i]);
-				/*
-				_mmcam_dbg_log( "Get[%s] int range - min[%d],max[%d],default[%d]", 
-						name, (*value)->min, (*value)->max, (*value)->default_value );
-				*/
-				return TRUE;
-			}
-		}
+		*value = (type_int_range*)detail;
+		/*
+		_mmcam_dbg_log( "Get[%s] int range - min[%d],max[%d],default[%d]", 
+				name, (*value)->min, (*value)->max, (*value)->default_value );
+		*/
+		return TRUE;
 	}
 
 	*value = NULL;
@@ -2099,36 +2334,22 @@ _mmcamcorder_conf_get_value_int_range( camera_conf* configure_info, int category
 int
 _mmcamcorder_conf_get_value_int_array( camera_conf* configure_info, int category, char* name, type_int_array** value )
 {
-	int i, count;
-	conf_info* info;
+	void* detail = NULL;
 
 	//_mmcam_dbg_log( "Entered... category[%d],name[%s]", category, name );
 
 	mmf_return_val_if_fail( configure_info, FALSE );
 	mmf_return_val_if_fail( name, FALSE );
 
-	if( configure_info->info[category] )
+	detail = __mmcamcorder_conf_find_detail( configure_info, category, name );
+	if( detail )
 	{
-		count	= configure_info->info[category]->count;
-		info	= configure_info->info[category];
-
-		for( i = 0 ; i < count ; i++ )
-		{
-			if( info->detail_info[i] == NULL )
-			{
-				continue;
-			}
-			
-			if( !strcmp( ((type_int_array*)(info->detail_info[i]))->name , name ) )
-			{
-				*value = (type_int_array*)(info->detail_info[i]);
-				/*
-				_mmcam_dbg_log( "Get[%s] int array - [%x],count[%d],default[%d]", 
-						name, (*value)->value, (*value)->count, (*value)->default_value );
-				*/
-				return TRUE;
-			}
-		}
+		*value = (type_int_array*)detail;
+		/*
+		_mmcam_dbg_log( "Get[%s] int array - [%x],count[%d],default[%d]", 
+				name, (*value)->value, (*value)->count, (*value)->default_value );
+		*/
+		return TRUE;
 	}
 
 	*value = NULL;
@@ -2141,37 +2362,23 @@ _mmcamcorder_conf_get_value_int_array( camera_conf* configure_info, int category
 int
 _mmcamcorder_conf_get_value_int_pair_array( camera_conf* configure_info, int category, char* name, type_int_pair_array** value )
 {
-	int i, count;
-	conf_info* info;
+	void* detail = NULL;
 
 	//_mmcam_dbg_log( "Entered... category[%d],name[%s]", category, name );
 
 	mmf_return_val_if_fail( configure_info, FALSE );
 	mmf_return_val_if_fail( name, FALSE );
 
-	if( configure_info->info[category] )
+	detail = __mmcamcorder_conf_find_detail( configure_info, category, name );
+	if( detail )
 	{
-		count	= configure_info->info[category]->count;
-		info	= configure_info->info[category];
-		
-		for( i = 0 ; i < count ; i++ )
-		{
-			if( info->detail_info[i] == NULL )
-			{
-				continue;
-			}
-			
-			if( !strcmp( ((type_int_pair_array*)(info->detail_info[i]))->name , name ) )
-			{
-				*value = (type_int_pair_array*)(info->detail_info[i]);
-				/*
-				_mmcam_dbg_log( "Get[%s] int pair array - [%x][%x],count[%d],default[%d][%d]", 
-						name, (*value)->value[0], (*value)->value[1], (*value)->count, 
-						(*value)->default_value[0], (*value)->default_value[1] );
-				*/
-				return TRUE;
-			}
-		}
+		*value = (type_int_pair_array*)detail;
+		/*
+		_mmcam_dbg_log( "Get[%s] int pair array - [%x][%x],count[%d],default[%d][%d]", 
+				name, (*value)->value[0], (*value)->value[1], (*value)->count, 
+				(*value)->default_value[0], (*value)->default_value[1] );
+		*/
+		return TRUE;
 	}
 
 	*value = NULL;
@@ -2184,33 +2391,19 @@ _mmcamcorder_conf_get_value_int_pair_array( camera_conf* configure_info, int cat
 int
 _mmcamcorder_conf_get_value_string( camera_conf* configure_info, int category, char* name, char** value )
 {
-	int i, count;
-	conf_info* info;
+	void* detail = NULL;
 	
 	//_mmcam_dbg_log( "Entered... category[%d],name[%s]", category, name );
 
 	mmf_return_val_if_fail( configure_info, FALSE );
 	mmf_return_val_if_fail( name, FALSE );
 	
-	if( configure_info->info[category] )
+	detail = __mmcamcorder_conf_find_detail( configure_info, category, name );
+	if( detail )
 	{
-		count	= configure_info->info[category]->count;
-		info	= configure_info->info[category];
-		
-		for( i = 0 ; i < count ; i++ )
-		{
-			if( info->detail_info[i] == NULL )
-			{
-				continue;
-			}
-			
-			if( !strcmp( ((type_string*)(info->detail_info[i]))->name , name ) )
-			{
-				*value = ((type_string*)(info->detail_info[i]))->value;
-				//_mmcam_dbg_log( "Get[%s] string[%s]", name, *value );
-				return TRUE;
-			}
-		}
+		*value = ((type_string*)detail)->value;
+		//_mmcam_dbg_log( "Get[%s] string[%s]", name, *value );
+		return TRUE;
 	}
 
 	if( _mmcamcorder_conf_get_default_value_string( configure_info->type, category, name, value ) )
@@ -2227,36 +2420,22 @@ _mmcamcorder_conf_get_value_string( camera_conf* configure_info, int category, c
 int
 _mmcamcorder_conf_get_value_string_array    ( camera_conf* configure_info, int category, char* name, type_string_array** value )
 {
-	int i, count;
-	conf_info* info;
+	void* detail = NULL;
 
 	//_mmcam_dbg_log( "Entered... category[%d],name[%s]", category, name );
 
 	mmf_return_val_if_fail( configure_info, FALSE );
 	mmf_return_val_if_fail( name, FALSE );
 
-	if( configure_info->info[category] )
+	detail = __mmcamcorder_conf_find_detail( configure_info, category, name );
+	if( detail )
 	{
-		count	= configure_info->info[category]->count;
-		info	= configure_info->info[category];
-
-		for( i = 0 ; i < count ; i++ )
-		{
-			if( info->detail_info[i] == NULL )
-			{
-				continue;
-			}
-			
-			if( !strcmp( ((type_string_array*)(info->detail_info[i]))->name , name ) )
-			{
-				*value = (type_string_array*)(info->detail_info[i]);
-				/*
-				_mmcam_dbg_log( "Get[%s] string array - [%x],count[%d],default[%s]", 
-						name, (*value)->value, (*value)->count, (*value)->default_value );
-				*/
-				return TRUE;
-			}
-		}
+		*value = (type_string_array*)detail;
+		/*
+		_mmcam_dbg_log( "Get[%s] string array - [%x],count[%d],default[%s]", 
+				name, (*value)->value, (*value)->count, (*value)->default_value );
+		*/
+		return TRUE;
 	}
 
 	*value = NULL;
@@ -2269,33 +2448,19 @@ _mmcamcorder_conf_get_value_string_array    ( camera_conf* configure_info, int c
 int
 _mmcamcorder_conf_get_element( camera_conf* configure_info, int category, char* name, type_element** element )
 {
-	int i, count;
-	conf_info* info;
+	void* detail = NULL;
 	
 	//_mmcam_dbg_log( "Entered... category[%d],name[%s]", category, name );
 
 	mmf_return_val_if_fail( configure_info, FALSE );
 	mmf_return_val_if_fail( name, FALSE );
 
-	if( configure_info->info[category] )
+	detail = __mmcamcorder_conf_find_detail( configure_info, category, name );
+	if( detail )
 	{
-		count	= configure_info->info[category]->count;
-		info	= configure_info->info[category];
-		
-		for( i = 0 ; i < count ; i++ )
-		{
-			if( info->detail_info[i] == NULL )
-			{
-				continue;
-			}
-			
-			if( !strcmp( ((type_element*)(info->detail_info[i]))->name , name ) )
-			{
-				*element = (type_element*)(info->detail_info[i]);
-				//_mmcam_dbg_log( "Get[%s] element[%x]", name, *element );
-				return TRUE;
-			}
-		}
+		*element = (type_element*)detail;
+		//_mmcam_dbg_log( "Get[%s] element[%x]", name, *element );
+		return TRUE;
 	}
 
 	if( _mmcamcorder_conf_get_default_element( configure_info->type, category, name, element ) )
@@ -2439,8 +2604,8 @@ _mmcamcorder_conf_set_value_element_property( GstElement* gst, type_element* ele
 int
 _mmcamcorder_conf_get_default_value_int( int type, int category, char* name, int* value )
 {
-	int i = 0;
 	int count_value = 0;
+	conf_info_table* table_info = NULL;
 
 	//_mmcam_dbg_log( "Entered..." );
 	
@@ -2452,27 +2617,11 @@ _mmcamcorder_conf_get_default_value_int( int type, int category, char* name, int
 		return FALSE;		
 	}
 
-	if( type == CONFIGURE_TYPE_MAIN )
-	{
-		for( i = 0 ; i < count_value ; i++ )
-		{
-			if( !strcmp( conf_main_info_table[category][i].name, name ) )
-			{
-				*value = conf_main_info_table[category][i].value_int;
-				return TRUE;
-			}
-		}
-	}
-	else
+	table_info = __mmcamcorder_conf_find_table_info( type, category, name );
+	if( table_info )
 	{
-		for( i = 0 ; i < count_value ; i++ )
-		{
-			if( !strcmp( conf_ctrl_info_table[category][i].name, name ) )
-			{
-				*value = conf_ctrl_info_table[category][i].value_int;
-				return TRUE;
-			}
-		}		
+		*value = table_info->value_int;
+		return TRUE;
 	}
 
 	_mmcam_dbg_warn( "Failed to get default int... check it... Type[%d],Category[%d],Name[%s]", type, category, name );
@@ -2483,8 +2632,8 @@ _mmcamcorder_conf_get_default_value_int( int type, int category, char* name, int
 int
 _mmcamcorder_conf_get_default_value_string( int type, int category, char* name, char** value )
 {
-	int i = 0;
 	int count_value = 0;
+	conf_info_table* table_info = NULL;
 
 	//_mmcam_dbg_log( "Entered..." );
 	
@@ -2496,29 +2645,12 @@ _mmcamcorder_conf_get_default_value_string( int type, int category, char* name,
 		return FALSE;		
 	}
 
-	if( type == CONFIGURE_TYPE_MAIN )
+	table_info = __mmcamcorder_conf_find_table_info( type, category, name );
+	if( table_info )
 	{
-		for( i = 0 ; i < count_value ; i++ )
-		{
-			if( !strcmp( conf_main_info_table[category][i].name, name ) )
-			{
-				*value = conf_main_info_table[category][i].value_string;
-				_mmcam_dbg_log( "Get[%s] default string[%s]", name, *value );
-				return TRUE;
-			}
-		}
-	}
-	else
-	{
-		for( i = 0 ; i < count_value ; i++ )
-		{
-			if( !strcmp( conf_ctrl_info_table[category][i].name, name ) )
-			{
-				*value = conf_ctrl_info_table[category][i].value_string;
-				_mmcam_dbg_log( "Get[%s] default string[%s]", name, *value );
-				return TRUE;
-			}
-		}
+		*value = table_info->value_string;
+		_mmcam_dbg_log( "Get[%s] default string[%s]", name, *value );
+		return TRUE;
 	}
 
 	_mmcam_dbg_warn( "Failed to get default string... check it... Type[%d],Category[%d],Name[%s]", type, category, name );
@@ -2529,8 +2661,8 @@ _mmcamcorder_conf_get_default_value_string( int type, int category, char* name,
 int
 _mmcamcorder_conf_get_default_element( int type, int category, char* name, type_element** element )
 {
-	int i = 0;
 	int count_value = 0;
+	conf_info_table* table_info = NULL;
 
 	//_mmcam_dbg_log( "Entered..." );
 	
@@ -2542,29 +2674,12 @@ _mmcamcorder_conf_get_default_element( int type, int category, char* name, type_
 		return FALSE;		
 	}
 
-	if( type == CONFIGURE_TYPE_MAIN )
-	{
-		for( i = 0 ; i < count_value ; i++ )
-		{
-			if( !strcmp( conf_main_info_table[category][i].name, name ) )
-			{
-				*element = conf_main_info_table[category][i].value_element;
-				_mmcam_dbg_log( "Get[%s] element[%p]", name, *element );
-				return TRUE;
-			}
-		}
-	}
-	else
+	table_info = __mmcamcorder_conf_find_table_info( type, category, name );
+	if( table_info )
 	{
-		for( i = 0 ; i < count_value ; i++ )
-		{
-			if( !strcmp( conf_ctrl_info_table[category][i].name, name ) )
-			{
-				*element = conf_ctrl_info_table[category][i].value_element;
-				_mmcam_dbg_log( "Get[%s] element[%p]", name, *element );
-				return TRUE;
-			}
-		}
+		*element = table_info->value_element;
+		_mmcam_dbg_log( "Get[%s] element[%p]", name, *element );
+		return TRUE;
 	}
 
 	_mmcam_dbg_warn( "Failed to get default element... check it... Type[%d],Category[%d],Name[%s]", type, category, name );
@@ -29,6 +29,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
 #include <mm_debug.h>
 #include <mm_error.h>
 #include <glib.h>
@@ -40,6 +43,9 @@
 #define EXIF_MARKER_SOI_LENGTH                  2
 #define EXIF_MARKER_APP1_LENGTH                 2
 #define EXIF_APP1_LENGTH                        2
+#define EXIF_TIFF_HEADER_OFFSET                 6
+#define EXIF_IFD_ENTRY_SIZE                     12
+#define EXIF_TEMPLATE_IFD_DEPTH_MAX             4
 
 #if MM_EXIFINFO_USE_BINARY_EXIFDATA
 /**
@@ -136,6 +142,126 @@ _exif_get_jpeg_marker_offset (void *jpeg, int jpeg_size, unsigned short marker)
 }
 
 
+static mm_exif_template_entry_t *
+_exif_template_get_entry (mm_exif_template_t *tmpl, ExifIfd ifd, ExifTag tag)
+{
+	int i;
+
+	/* entries are set in the same order for each image, so check next one first */
+	if (tmpl->cursor < tmpl->entry_num &&
+	    tmpl->entry[tmpl->cursor].ifd == ifd && tmpl->entry[tmpl->cursor].tag == tag) {
+		return &tmpl->entry[tmpl->cursor++];
+	}
+
+	for (i = 0 ; i < tmpl->entry_num ; i++) {
+		if (tmpl->entry[i].ifd == ifd && tmpl->entry[i].tag == tag) {
+			tmpl->cursor = i + 1;
+			return &tmpl->entry[i];
+		}
+	}
+
+	return NULL;
+}
+
+
+static int
+_exif_template_load_ifd (mm_exif_template_t *tmpl, ExifIfd ifd, unsigned int ifd_offset, int depth)
+{
+	unsigned char *tiff = (unsigned char *)tmpl->data + EXIF_TIFF_HEADER_OFFSET;
+	unsigned int tiff_size = tmpl->size - EXIF_TIFF_HEADER_OFFSET;
+	unsigned char *e = NULL;
+	unsigned int entry_num = 0;
+	unsigned int value_offset = 0;
+	unsigned int value_size = 0;
+	unsigned int next_offset = 0;
+	unsigned int i = 0;
+	int k = 0;
+	int ret = MM_ERROR_NONE;
+
+	ExifTag tag;
+	ExifFormat format;
+	unsigned long components;
+
+	/* number of entries(2), entries and offset of next ifd(4) */
+	if (depth > EXIF_TEMPLATE_IFD_DEPTH_MAX || ifd_offset > tiff_size - 6) {
+		mmf_debug (MMF_DEBUG_ERROR,"[%05d][%s] wrong ifd %d offset %u\n", __LINE__, __func__, ifd, ifd_offset);
+		return MM_ERROR_CAMCORDER_INTERNAL;
+	}
+
+	entry_num = exif_get_short(tiff + ifd_offset, tmpl->order);
+	if (entry_num > (tiff_size - ifd_offset - 6) / EXIF_IFD_ENTRY_SIZE) {
+		mmf_debug (MMF_DEBUG_ERROR,"[%05d][%s] wrong entry number %u of ifd %d\n", __LINE__, __func__, entry_num, ifd);
+		return MM_ERROR_CAMCORDER_INTERNAL;
+	}
+
+	for (i = 0 ; i < entry_num && ret == MM_ERROR_NONE ; i++) {
+		e = tiff + ifd_offset + 2 + (i * EXIF_IFD_ENTRY_SIZE);
+		tag = exif_get_short(e, tmpl->order);
+		format = exif_get_short(e + 2, tmpl->order);
+		components = exif_get_long(e + 4, tmpl->order);
+
+		switch (tag) {
+		case EXIF_TAG_EXIF_IFD_POINTER:
+			ret = _exif_template_load_ifd(tmpl, EXIF_IFD_EXIF, exif_get_long(e + 8, tmpl->order), depth + 1);
+			continue;
+		case EXIF_TAG_GPS_INFO_IFD_POINTER:
+			ret = _exif_template_load_ifd(tmpl, EXIF_IFD_GPS, exif_get_long(e + 8, tmpl->order), depth + 1);
+			continue;
+		case EXIF_TAG_INTEROPERABILITY_IFD_POINTER:
+			ret = _exif_template_load_ifd(tmpl, EXIF_IFD_INTEROPERABILITY, exif_get_long(e + 8, tmpl->order), depth + 1);
+			continue;
+		default:
+			break;
+		}
+
+		for (k = 0 ; k < tmpl->entry_num ; k++) {
+			if (tmpl->entry[k].ifd == ifd && tmpl->entry[k].tag == tag) {
+				break;
+			}
+		}
+		if (k == tmpl->entry_num) {
+			/* static entry */
+			continue;
+		}
+
+		if (components > tiff_size) {
+			mmf_debug (MMF_DEBUG_ERROR,"[%05d][%s] wrong components %lu of tag %x\n", __LINE__, __func__, components, tag);
+			return MM_ERROR_CAMCORDER_INTERNAL;
+		}
+
+		value_size = exif_format_get_size(format) * components;
+		if (value_size > 4) {
+			value_offset = exif_get_long(e + 8, tmpl->order);
+		} else {
+			value_offset = e + 8 - tiff;
+		}
+
+		if (value_offset > tiff_size || value_size > tiff_size - value_offset) {
+			mmf_debug (MMF_DEBUG_ERROR,"[%05d][%s] wrong value offset %u of tag %x\n", __LINE__, __func__, value_offset, tag);
+			return MM_ERROR_CAMCORDER_INTERNAL;
+		}
+
+		/* libexif writes some values by itself(ex. maker note), then the value of template is kept */
+		if (tmpl->entry[k].format != format || tmpl->entry[k].components != components) {
+			tmpl->entry[k].format = format;
+			tmpl->entry[k].components = components;
+			tmpl->entry[k].keep = 1;
+		}
+
+		tmpl->entry[k].offset = value_offset + EXIF_TIFF_HEADER_OFFSET;
+	}
+
+	if (ret == MM_ERROR_NONE && ifd == EXIF_IFD_0) {
+		next_offset = exif_get_long(tiff + ifd_offset + 2 + (entry_num * EXIF_IFD_ENTRY_SIZE), tmpl->order);
+		if (next_offset) {
+			ret = _exif_template_load_ifd(tmpl, EXIF_IFD_1, next_offset, depth + 1);
+		}
+	}
+
+	return ret;
+}
+
+
 ExifData*
 mm_exif_get_exif_data_from_data (mm_exif_info_t *info)
 {
@@ -357,6 +483,13 @@ mm_exif_destory_exif_info (mm_exif_info_t *info)
 
 int
 mm_exif_add_thumbnail_info (mm_exif_info_t *info, void *thumbnail, int width, int height, int len)
+{
+	return mm_exif_make_thumbnail_info(info, info, thumbnail, width, height, len);
+}
+
+
+int
+mm_exif_make_thumbnail_info (mm_exif_info_t *out, mm_exif_info_t *info, void *thumbnail, int width, int height, int len)
 {
 	ExifData *ed = NULL;
 	static ExifLong elong[10];
@@ -403,7 +536,7 @@ mm_exif_add_thumbnail_info (mm_exif_info_t *info, void *thumbnail, int width, in
 		goto exit;
 	}
 
-	ret = mm_exif_set_exif_to_info (info, ed);
+	ret = mm_exif_set_exif_to_info (out, ed);
 	if (ret != MM_ERROR_NONE) {
 		goto exit;
 	}
@@ -529,46 +662,117 @@ int mm_exif_mnote_set_add_entry (ExifData *exif, MnoteSamsungTag tag, int index,
 
 
 int
-mm_exif_write_exif_jpeg_to_file (char *filename, mm_exif_info_t *info,  void *jpeg, int jpeg_len)
+mm_exif_make_exif_jpeg_segment (mm_exif_jpeg_t *out, mm_exif_info_t *info,  void *jpeg, unsigned int jpeg_len)
 {
-	FILE *fp = NULL;
 	unsigned short head[2] = {0,};
 	unsigned short head_len = 0;
-	unsigned char *eb = NULL;
-	unsigned int ebs;
 
 	mmf_debug (MMF_DEBUG_LOG,"[%05d][%s]\n", __LINE__, __func__);
 
-	eb = info->data;
-	ebs = info->size;
+	if (out == NULL || info == NULL || info->data == NULL || jpeg == NULL) {
+		mmf_debug (MMF_DEBUG_ERROR, "%s(), MM_ERROR_CAMCORDER_INVALID_ARGUMENT out=%p, info=%p, jpeg=%p\n", __func__, out, info, jpeg);
+		return MM_ERROR_CAMCORDER_INVALID_ARGUMENT;
+	}
 
-	/*create file*/
-	fp = fopen (filename, "wb");
-	if (!fp) {
-		mmf_debug (MMF_DEBUG_ERROR, "%s(), fopen() failed [%s].\n", __func__, filename);
-		return MM_ERROR_IMAGE_FILEOPEN;
+	if (jpeg_len <= JPEG_DATA_OFFSET || jpeg_len > JPEG_MAX_SIZE) {
+		mmf_debug (MMF_DEBUG_ERROR, "%s(),jpeg_len is worng jpeg_len=%d\n", __func__, jpeg_len);
+		return MM_ERROR_CAMCORDER_DEVICE_WRONG_JPEG;
+	}
+
+	/*APP1 can not be larger than 64KB*/
+	if (info->size + EXIF_APP1_LENGTH > 0xffff) {
+		mmf_debug (MMF_DEBUG_ERROR, "%s(), exif is too large size=%d\n", __func__, info->size);
+		return MM_ERROR_CAMCORDER_INVALID_ARGUMENT;
 	}
 
 	/*set SOI, APP1*/
 	_exif_set_uint16 (0, &head[0], 0xffd8);
 	_exif_set_uint16 (0, &head[1], 0xffe1);
 	/*set header length*/
-	_exif_set_uint16 (0, &head_len, (unsigned short)(ebs + 2));
-
-	if(head[0]==0 || head[1]==0 || head_len==0)
-	{
+	_exif_set_uint16 (0, &head_len, (unsigned short)(info->size + EXIF_APP1_LENGTH));
+	if (head[0] == 0 || head[1] == 0 || head_len == 0) {
 		mmf_debug (MMF_DEBUG_ERROR,"[%05d][%s]setting error\n", __LINE__, __func__);
-		fclose (fp);
-		return -1;
+		return MM_ERROR_CAMCORDER_INVALID_ARGUMENT;
 	}
 
-	fwrite (&head[0], 1, EXIF_MARKER_SOI_LENGTH, fp);       /*SOI marker*/
-	fwrite (&head[1], 1, EXIF_MARKER_APP1_LENGTH, fp);      /*APP1 marker*/
-	fwrite (&head_len, 1, EXIF_APP1_LENGTH, fp);            /*length of APP1*/
-	fwrite (eb, 1, ebs, fp);                                /*EXIF*/
-	fwrite (jpeg + JPEG_DATA_OFFSET, 1, jpeg_len - JPEG_DATA_OFFSET, fp);   /*IMAGE*/
+	/*SOI marker*/
+	memcpy(out->header, &head[0], EXIF_MARKER_SOI_LENGTH);
+	/*APP1 marker*/
+	memcpy(out->header + EXIF_MARKER_SOI_LENGTH,
+	       &head[1], EXIF_MARKER_APP1_LENGTH);
+	/*length of APP1*/
+	memcpy(out->header + EXIF_MARKER_SOI_LENGTH + EXIF_MARKER_APP1_LENGTH,
+	       &head_len, EXIF_APP1_LENGTH);
 
-	fclose (fp);
+	/*HEADER*/
+	out->segment[0].iov_base = out->header;
+	out->segment[0].iov_len = MM_EXIF_JPEG_HEADER_LENGTH;
+	/*EXIF*/
+	out->segment[1].iov_base = info->data;
+	out->segment[1].iov_len = info->size;
+	/*IMAGE*/
+	out->segment[2].iov_base = (unsigned char *)jpeg + JPEG_DATA_OFFSET;
+	out->segment[2].iov_len = jpeg_len - JPEG_DATA_OFFSET;
+
+	out->segment_num = MM_EXIF_JPEG_SEGMENT_NUM;
+	out->length = MM_EXIF_JPEG_HEADER_LENGTH + info->size + jpeg_len - JPEG_DATA_OFFSET;
+
+	return MM_ERROR_NONE;
+}
+
+
+int
+mm_exif_write_exif_jpeg_to_file (char *filename, mm_exif_info_t *info,  void *jpeg, int jpeg_len)
+{
+	int fd = -1;
+	int ret = MM_ERROR_NONE;
+	int index = 0;
+	ssize_t written = 0;
+	mm_exif_jpeg_t out;
+
+	mmf_debug (MMF_DEBUG_LOG,"[%05d][%s]\n", __LINE__, __func__);
+
+	if (filename == NULL || jpeg_len < 0) {
+		mmf_debug (MMF_DEBUG_ERROR, "%s(), MM_ERROR_CAMCORDER_INVALID_ARGUMENT filename=%p, jpeg_len=%d\n", __func__, filename, jpeg_len);
+		return MM_ERROR_CAMCORDER_INVALID_ARGUMENT;
+	}
+
+	ret = mm_exif_make_exif_jpeg_segment(&out, info, jpeg, (unsigned int)jpeg_len);
+	if (ret != MM_ERROR_NONE) {
+		return ret;
+	}
+
+	/*create file*/
+	fd = open (filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		mmf_debug (MMF_DEBUG_ERROR, "%s(), open() failed [%s].\n", __func__, filename);
+		return MM_ERROR_IMAGE_FILEOPEN;
+	}
+
+	/*write all segments at once, and continue from where it stopped if partially written*/
+	while (index < out.segment_num) {
+		written = writev (fd, &out.segment[index], out.segment_num - index);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			mmf_debug (MMF_DEBUG_ERROR, "%s(), writev() failed [%s] errno %d.\n", __func__, filename, errno);
+			close (fd);
+			return MM_ERROR_FILE_WRITE;
+		}
+
+		while (index < out.segment_num && (size_t)written >= out.segment[index].iov_len) {
+			written -= out.segment[index].iov_len;
+			index++;
+		}
+
+		if (index < out.segment_num) {
+			out.segment[index].iov_base = (unsigned char *)out.segment[index].iov_base + written;
+			out.segment[index].iov_len -= written;
+		}
+	}
+
+	close (fd);
 
 	return MM_ERROR_NONE;
 }
@@ -576,75 +780,290 @@ mm_exif_write_exif_jpeg_to_file (char *filename, mm_exif_info_t *info,  void *jp
 int
 mm_exif_write_exif_jpeg_to_memory (void **mem, unsigned int *length, mm_exif_info_t *info,  void *jpeg, unsigned int jpeg_len)
 {
-	unsigned short head[2] = {0,};
-	unsigned short head_len = 0;
-	unsigned char *eb = NULL;
-	unsigned int ebs;
+	int ret = MM_ERROR_NONE;
+	int i = 0;
+	mm_exif_jpeg_t out;
 
 	/*output*/
 	unsigned char *m = NULL;
-	int m_len = 0;
+	unsigned char *p = NULL;
 
 	mmf_debug (MMF_DEBUG_LOG,"[%05d][%s]\n", __LINE__, __func__);
 
-	if(info==NULL || jpeg==NULL)
-	{
-		mmf_debug (MMF_DEBUG_ERROR, "%s(), MM_ERROR_CAMCORDER_INVALID_ARGUMENT info=%p, jpeg=%p\n", __func__,info,jpeg);
+	if (mem == NULL || length == NULL) {
+		mmf_debug (MMF_DEBUG_ERROR, "%s(), MM_ERROR_CAMCORDER_INVALID_ARGUMENT mem=%p, length=%p\n", __func__, mem, length);
 		return MM_ERROR_CAMCORDER_INVALID_ARGUMENT;
 	}
 
-	if(jpeg_len>JPEG_MAX_SIZE)
-	{
-		mmf_debug (MMF_DEBUG_ERROR, "%s(),jpeg_len is worng jpeg_len=%d\n", __func__,jpeg_len);
-		return MM_ERROR_CAMCORDER_DEVICE_WRONG_JPEG;	
+	ret = mm_exif_make_exif_jpeg_segment(&out, info, jpeg, jpeg_len);
+	if (ret != MM_ERROR_NONE) {
+		return ret;
 	}
 
-	eb = info->data;
-	ebs = info->size;
-
-	/*length of output image*/
-	/*SOI + APP1 + length of APP1 + length of EXIF + IMAGE*/
-	m_len = EXIF_MARKER_SOI_LENGTH + EXIF_MARKER_APP1_LENGTH + EXIF_APP1_LENGTH + ebs + (jpeg_len - JPEG_DATA_OFFSET);
 	/*alloc output image*/
-	m = malloc (m_len);
+	m = malloc (out.length);
 	if (!m) {
 		mmf_debug (MMF_DEBUG_ERROR, "%s(), malloc() failed.\n", __func__);
-		return MM_ERROR_CAMCORDER_LOW_MEMORY;	
-	}
-
-	/*set SOI, APP1*/
-	_exif_set_uint16 (0, &head[0], 0xffd8);
-	_exif_set_uint16 (0, &head[1], 0xffe1);
-	/*set header length*/
-	_exif_set_uint16 (0, &head_len, (unsigned short)(ebs + 2));
-	if (head[0] == 0 || head[1] == 0 || head_len == 0) {
-		mmf_debug (MMF_DEBUG_ERROR,"[%05d][%s]setting error\n", __LINE__, __func__);
-		free(m);
-		return MM_ERROR_CAMCORDER_INVALID_ARGUMENT;
+		return MM_ERROR_CAMCORDER_LOW_MEMORY;
 	}
 
 	/* Complete JPEG+EXIF */
-	/*SOI marker*/
-	memcpy(m, &head[0], EXIF_MARKER_SOI_LENGTH);
-	/*APP1 marker*/
-	memcpy(m + EXIF_MARKER_SOI_LENGTH,
-	       &head[1], EXIF_MARKER_APP1_LENGTH);
-	/*length of APP1*/
-	memcpy(m + EXIF_MARKER_SOI_LENGTH + EXIF_MARKER_APP1_LENGTH,
-	       &head_len, EXIF_APP1_LENGTH);
-	/*EXIF*/
-	memcpy(m + EXIF_MARKER_SOI_LENGTH + EXIF_MARKER_APP1_LENGTH + EXIF_APP1_LENGTH,
-	       eb, ebs);
-	/*IMAGE*/
-	memcpy(m + EXIF_MARKER_SOI_LENGTH + EXIF_MARKER_APP1_LENGTH + EXIF_APP1_LENGTH + ebs,
-	       jpeg + JPEG_DATA_OFFSET, jpeg_len - JPEG_DATA_OFFSET);
+	for (i = 0, p = m ; i < out.segment_num ; i++) {
+		memcpy(p, out.segment[i].iov_base, out.segment[i].iov_len);
+		p += out.segment[i].iov_len;
+	}
 
 	mmf_debug(MMF_DEBUG_LOG,"[%05d][%s] JPEG+EXIF Copy DONE(original:%d, copied:%d)\n",
 	                        __LINE__, __func__, jpeg_len, jpeg_len - JPEG_DATA_OFFSET);
 
 	/*set ouput param*/
 	*mem    = m;
-	*length = m_len;
+	*length = out.length;
+
+	return MM_ERROR_NONE;
+}
+
+
+int
+mm_exif_template_create (mm_exif_template_t **tmpl)
+{
+	mm_exif_template_t *x = NULL;
+
+	if (!tmpl) {
+		mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s] NULL pointer\n", __LINE__, __func__);
+		return MM_ERROR_CAMCORDER_INVALID_ARGUMENT;
+	}
+
+	x = (mm_exif_template_t *)malloc(sizeof(mm_exif_template_t));
+	if (!x) {
+		mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s]malloc error\n", __LINE__, __func__);
+		return MM_ERROR_CAMCORDER_LOW_MEMORY;
+	}
+
+	memset(x, 0x00, sizeof(mm_exif_template_t));
+
+	*tmpl = x;
+
+	return MM_ERROR_NONE;
+}
+
+
+void
+mm_exif_template_destroy (mm_exif_template_t *tmpl)
+{
+	if (tmpl) {
+		if (tmpl->data) {
+			free(tmpl->data);
+		}
+		free(tmpl);
+	}
+}
+
+
+int
+mm_exif_template_set_entry (mm_exif_template_t *tmpl, ExifData *exif, ExifIfd ifd, ExifTag tag,
+                            ExifFormat format, unsigned long components, unsigned char *data)
+{
+	mm_exif_template_entry_t *entry = NULL;
+	int ret = MM_ERROR_NONE;
+
+	if (tmpl == NULL) {
+		mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s] NULL template\n", __LINE__, __func__);
+		return MM_ERROR_CAMCORDER_INVALID_ARGUMENT;
+	}
+
+	if (exif) {
+		/* build template */
+		ret = mm_exif_set_add_entry(exif, ifd, tag, format, components, data);
+		if (ret != MM_ERROR_NONE) {
+			return ret;
+		}
+
+		entry = _exif_template_get_entry(tmpl, ifd, tag);
+		if (entry == NULL) {
+			if (tmpl->entry_num >= MM_EXIF_TEMPLATE_ENTRY_MAX) {
+				mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s] too many entries, tag %x\n", __LINE__, __func__, tag);
+				tmpl->mismatch = 1;
+				return MM_ERROR_NONE;
+			}
+			entry = &tmpl->entry[tmpl->entry_num++];
+			tmpl->cursor = tmpl->entry_num;
+		}
+
+		memset(entry, 0x00, sizeof(mm_exif_template_entry_t));
+		entry->ifd = ifd;
+		entry->tag = tag;
+		entry->format = format;
+		entry->components = components;
+
+		return MM_ERROR_NONE;
+	}
+
+	/* patch value of entry */
+	if (tmpl->info == NULL || tmpl->info->data == NULL || data == NULL) {
+		mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s] invalid argument info=%p data=%p\n", __LINE__, __func__, tmpl->info, data);
+		return MM_ERROR_CAMCORDER_INVALID_ARGUMENT;
+	}
+
+	entry = _exif_template_get_entry(tmpl, ifd, tag);
+	if (entry == NULL || entry->patched) {
+		mmf_debug(MMF_DEBUG_LOG,"[%05d][%s] tag %x of ifd %d is not in template\n", __LINE__, __func__, tag, ifd);
+		tmpl->mismatch = 1;
+		return MM_ERROR_NONE;
+	}
+
+	entry->patched = 1;
+
+	if (entry->keep) {
+		return MM_ERROR_NONE;
+	}
+
+	if (entry->format != format || entry->components != components) {
+		mmf_debug(MMF_DEBUG_LOG,"[%05d][%s] tag %x is changed, format %d -> %d, components %lu -> %lu\n",
+		                        __LINE__, __func__, tag, entry->format, format, entry->components, components);
+		tmpl->mismatch = 1;
+		return MM_ERROR_NONE;
+	}
+
+	memcpy((unsigned char *)tmpl->info->data + entry->offset, data, exif_format_get_size(format) * components);
+
+	return MM_ERROR_NONE;
+}
+
+
+int
+mm_exif_template_save (mm_exif_template_t *tmpl, mm_exif_info_t *info)
+{
+	unsigned char *d = NULL;
+	int ret = MM_ERROR_NONE;
+	int i = 0;
+
+	if (tmpl == NULL || info == NULL || info->data == NULL) {
+		mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s] invalid argument tmpl=%p info=%p\n", __LINE__, __func__, tmpl, info);
+		return MM_ERROR_CAMCORDER_INVALID_ARGUMENT;
+	}
+
+	if (tmpl->mismatch) {
+		mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s] some entries are not remembered\n", __LINE__, __func__);
+		return MM_ERROR_CAMCORDER_INTERNAL;
+	}
+
+	/* Exif header(6), byte order(2), 42(2) and offset of IFD 0(4) */
+	d = (unsigned char *)info->data;
+	if (info->size < EXIF_TIFF_HEADER_OFFSET + 8 || memcmp(d, "Exif\0\0", EXIF_TIFF_HEADER_OFFSET)) {
+		mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s] invalid exif data, size %u\n", __LINE__, __func__, info->size);
+		return MM_ERROR_CAMCORDER_INTERNAL;
+	}
+
+	if (tmpl->data) {
+		free(tmpl->data);
+		tmpl->data = NULL;
+		tmpl->size = 0;
+	}
+
+	tmpl->data = malloc(info->size);
+	if (tmpl->data == NULL) {
+		mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s]malloc error\n", __LINE__, __func__);
+		return MM_ERROR_CAMCORDER_LOW_MEMORY;
+	}
+
+	memcpy(tmpl->data, info->data, info->size);
+	tmpl->size = info->size;
+
+	if (d[EXIF_TIFF_HEADER_OFFSET] == 'I' && d[EXIF_TIFF_HEADER_OFFSET + 1] == 'I') {
+		tmpl->order = EXIF_BYTE_ORDER_INTEL;
+	} else {
+		tmpl->order = EXIF_BYTE_ORDER_MOTOROLA;
+	}
+
+	ret = _exif_template_load_ifd(tmpl, EXIF_IFD_0,
+	                              exif_get_long(d + EXIF_TIFF_HEADER_OFFSET + 4, tmpl->order), 0);
+	if (ret == MM_ERROR_NONE) {
+		for (i = 0 ; i < tmpl->entry_num ; i++) {
+			if (tmpl->entry[i].offset == 0) {
+				mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s] tag %x is not found\n", __LINE__, __func__, tmpl->entry[i].tag);
+				ret = MM_ERROR_CAMCORDER_INTERNAL;
+				break;
+			}
+		}
+	}
+
+	if (ret != MM_ERROR_NONE) {
+		free(tmpl->data);
+		tmpl->data = NULL;
+		tmpl->size = 0;
+		return ret;
+	}
+
+	mmf_debug(MMF_DEBUG_LOG,"[%05d][%s] template size %u, entries %d\n", __LINE__, __func__, tmpl->size, tmpl->entry_num);
+
+	return MM_ERROR_NONE;
+}
+
+
+int
+mm_exif_template_begin_patch (mm_exif_template_t *tmpl, mm_exif_info_t *info)
+{
+	void *data = NULL;
+	int i = 0;
+
+	if (tmpl == NULL || tmpl->data == NULL || info == NULL) {
+		mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s] invalid argument tmpl=%p info=%p\n", __LINE__, __func__, tmpl, info);
+		return MM_ERROR_CAMCORDER_INVALID_ARGUMENT;
+	}
+
+	/* buffer of exif info is reused when the size is same */
+	if (info->data == NULL || info->size != tmpl->size) {
+		data = malloc(tmpl->size);
+		if (data == NULL) {
+			mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s]malloc error\n", __LINE__, __func__);
+			return MM_ERROR_CAMCORDER_LOW_MEMORY;
+		}
+
+		if (info->data) {
+			free(info->data);
+		}
+
+		info->data = data;
+		info->size = tmpl->size;
+	}
+
+	memcpy(info->data, tmpl->data, tmpl->size);
+
+	for (i = 0 ; i < tmpl->entry_num ; i++) {
+		tmpl->entry[i].patched = 0;
+	}
+
+	tmpl->cursor = 0;
+	tmpl->mismatch = 0;
+	tmpl->info = info;
+
+	return MM_ERROR_NONE;
+}
+
+
+int
+mm_exif_template_end_patch (mm_exif_template_t *tmpl)
+{
+	int i = 0;
+
+	if (tmpl == NULL) {
+		mmf_debug(MMF_DEBUG_ERROR,"[%05d][%s] NULL template\n", __LINE__, __func__);
+		return MM_ERROR_CAMCORDER_INVALID_ARGUMENT;
+	}
+
+	tmpl->info = NULL;
+
+	if (tmpl->mismatch) {
+		return MM_ERROR_CAMCORDER_INVALID_CONDITION;
+	}
+
+	for (i = 0 ; i < tmpl->entry_num ; i++) {
+		if (!tmpl->entry[i].patched) {
+			mmf_debug(MMF_DEBUG_LOG,"[%05d][%s] tag %x of ifd %d is not set\n", __LINE__, __func__, tmpl->entry[i].tag, tmpl->entry[i].ifd);
+			return MM_ERROR_CAMCORDER_INVALID_CONDITION;
+		}
+	}
 
 	return MM_ERROR_NONE;
 }
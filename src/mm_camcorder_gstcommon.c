@@ -122,6 +122,7 @@ gboolean	videocodec_fileformat_compatibility_table[MM_VIDEO_CODEC_NUM][MM_FILE_F
 #define USE_AUDIO_CLOCK_TUNE
 #define _MMCAMCORDER_WAIT_EOS_TIME	5.0		//sec
 #define _DPRAM_RAW_PCM_LOCATION		"/dev/rawPCM0"
+#define _MMCAMCORDER_VSTREAM_POOL_COUNT	2
 
 /*-----------------------------------------------------------------------
 |    LOCAL FUNCTION PROTOTYPES:						|
@@ -142,6 +143,9 @@ gboolean	videocodec_fileformat_compatibility_table[MM_VIDEO_CODEC_NUM][MM_FILE_F
 static gboolean __mmcamcorder_video_dataprobe_preview(GstPad *pad, GstBuffer *buffer, gpointer u_data);
 static gboolean __mmcamcorder_video_dataprobe_vsink(GstPad *pad, GstBuffer *buffer, gpointer u_data);
 static gboolean __mmcamcorder_video_dataprobe_vsink_drop_by_time(GstPad *pad, GstBuffer *buffer, gpointer u_data);
+static gboolean __mmcamcorder_make_planar_stream(GstBuffer *buffer, int use_zero_copy_format, MMCamcorderVideoStreamPlanarDataType *stream);
+static void __mmcamcorder_release_planar_stream(MMCamcorderVideoStreamPlanarDataType *stream);
+static gboolean __mmcamcorder_update_video_format(_MMCamcorderVideoFormat *vformat, GstBuffer *buffer);
 
 static int __mmcamcorder_get_amrnb_bitrate_mode(int bitrate);
 
@@ -1368,6 +1372,11 @@ int _mmcamcorder_create_preview_pipeline(MMHandleType handle)
 	GstPad *sinkpad = NULL;
 	GstBus *bus = NULL;
 
+	int camera_width = 0;
+	int camera_height = 0;
+	int camera_format = MM_PIXEL_FORMAT_INVALID;
+	unsigned int pool_size = 0;
+
 	mmf_camcorder_t *hcamcorder= MMF_CAMCORDER(handle);
 	_MMCamcorderSubContext *sc = NULL;
 
@@ -1379,6 +1388,38 @@ int _mmcamcorder_create_preview_pipeline(MMHandleType handle)
 
 	_mmcam_dbg_log("");
 
+	/* Prepare buffer pool for converting zero copy buffer of video stream callback */
+	mm_camcorder_get_attributes(handle, NULL,
+	                            MMCAM_CAMERA_WIDTH, &camera_width,
+	                            MMCAM_CAMERA_HEIGHT, &camera_height,
+	                            MMCAM_CAMERA_FORMAT, &camera_format,
+	                            NULL);
+	if (hcamcorder->use_zero_copy_format &&
+	    (camera_format == MM_PIXEL_FORMAT_NV12 || camera_format == MM_PIXEL_FORMAT_I420)) {
+		pool_size = (camera_width * camera_height * 3) >> 1;
+	}
+
+	/* Prepare dispatch thread of video stream callback */
+	err = _mmcamcorder_create_vstream_dispatch(handle);
+	if (err != MM_ERROR_NONE) {
+		return err;
+	}
+
+	/* Prepare rate limit of video stream callback */
+	mm_camcorder_get_attributes(handle, NULL,
+	                            MMCAM_VIDEO_STREAM_CALLBACK_FPS, &(sc->vstream_cb_fps),
+	                            MMCAM_VIDEO_STREAM_CALLBACK_INTERVAL, &(sc->vstream_cb_interval),
+	                            NULL);
+	sc->vstream_frame_count = 0;
+	sc->vstream_next_time = GST_CLOCK_TIME_NONE;
+
+	if (sc->vstream_dispatch.lock) {
+		/* converted buffers are kept in dispatch queue until callback is returned */
+		_mmcamcorder_buffer_pool_init(&sc->vstream_pool, pool_size, sc->vstream_dispatch.length + 1);
+	} else {
+		_mmcamcorder_buffer_pool_init(&sc->vstream_pool, pool_size, _MMCAMCORDER_VSTREAM_POOL_COUNT);
+	}
+
 	/** Create gstreamer element **/
 	/* Main pipeline */
 	_MMCAMCORDER_PIPELINE_MAKE(sc, _MMCAMCORDER_MAIN_PIPE, "camcorder_pipeline", err);
@@ -1418,7 +1459,7 @@ int _mmcamcorder_create_preview_pipeline(MMHandleType handle)
 	if (hcamcorder->type == MM_CAMCORDER_MODE_IMAGE) {
 		sinkpad = gst_element_get_static_pad(sc->element[_MMCAMCORDER_VIDEOSINK_SINK].gst, "sink");
 		MMCAMCORDER_ADD_BUFFER_PROBE(sinkpad, _MMCAMCORDER_HANDLER_PREVIEW,
-		                             __mmcamcorder_video_dataprobe_vsink, hcamcorder);
+		                             __mmcamcorder_video_dataprobe_vsink_drop_by_time, hcamcorder);
 	} else if (hcamcorder->type == MM_CAMCORDER_MODE_VIDEO) {
 		sinkpad = gst_element_get_static_pad(sc->element[_MMCAMCORDER_VIDEOSINK_QUE].gst, "sink");
 		MMCAMCORDER_ADD_BUFFER_PROBE(sinkpad, _MMCAMCORDER_HANDLER_PREVIEW,
@@ -1473,6 +1514,9 @@ void _mmcamcorder_negosig_handler(GstElement *videosrc, MMHandleType handle)
 		sc->cam_stability_count = _MMCAMCORDER_CAMSTABLE_COUNT;
 	}
 
+	/* format of video stream may be changed. parse it again with next buffer */
+	sc->vstream_format.need_update = TRUE;
+
 	if (hcamcorder->type == MM_CAMCORDER_MODE_IMAGE) {
 		_MMCamcorderImageInfo *info = NULL;
 		info = sc->info;
@@ -1718,49 +1762,65 @@ static gboolean __mmcamcorder_video_dataprobe_preview(GstPad *pad, GstBuffer *bu
 
 	current_state = hcamcorder->state;
 
+	kpi = &(sc->kpi);
+
 	if (sc->drop_vframe > 0) {
 		if (sc->pass_first_vframe > 0) {
 			sc->pass_first_vframe--;
 			_mmcam_dbg_log("Pass video frame by pass_first_vframe");
 		} else {
 			sc->drop_vframe--;
+			kpi->drop_by_vframe++;
 			_mmcam_dbg_log("Drop video frame by drop_vframe");
 			return FALSE;
 		}
 	} else if (sc->cam_stability_count > 0) {
 		sc->cam_stability_count--;
+		kpi->drop_by_stability++;
 		_mmcam_dbg_log("Drop video frame by cam_stability_count");
 		return FALSE;
 	}
 
 	if (current_state >= MM_CAMCORDER_STATE_PREPARE) {
-		int diff_sec;
 		int frame_count = 0;
-		struct timeval current_video_time;
+		gint64 current_video_time = g_get_monotonic_time();
 
-		kpi = &(sc->kpi);
-		if (kpi->init_video_time.tv_sec == kpi->last_video_time.tv_sec &&
-		    kpi->init_video_time.tv_usec == kpi->last_video_time.tv_usec &&
-		    kpi->init_video_time.tv_usec  == 0) {
+		if (kpi->init_video_time == 0) {
 			_mmcam_dbg_log("START to measure FPS");
-			gettimeofday(&(kpi->init_video_time), NULL);
+			kpi->init_video_time = current_video_time;
+			kpi->last_video_time = current_video_time;
 		}
 
 		frame_count = ++(kpi->video_framecount);
 
-		gettimeofday(&current_video_time, NULL);
-		diff_sec = current_video_time.tv_sec - kpi->last_video_time.tv_sec;
-		if (diff_sec != 0) {
-			kpi->current_fps = (frame_count - kpi->last_framecount) / diff_sec;
-			if ((current_video_time.tv_sec - kpi->init_video_time.tv_sec) != 0) {
-				int framecount = kpi->video_framecount;
-				int elased_sec = current_video_time.tv_sec - kpi->init_video_time.tv_sec;
-				kpi->average_fps = framecount / elased_sec;
+		/* wake up capture stop which is waiting for preview frame */
+		_mmcamcorder_frame_notifier_signal(&(sc->frame_notifier));
+
+		/* frame interval histogram */
+		if (kpi->last_frame_time != 0) {
+			gint64 interval = current_video_time - kpi->last_frame_time;
+			int bucket = (int)(interval / _MMCAMCORDER_KPI_INTERVAL_BUCKET_USEC);
+
+			if (bucket >= _MMCAMCORDER_KPI_INTERVAL_BUCKET_NUM) {
+				bucket = _MMCAMCORDER_KPI_INTERVAL_BUCKET_NUM - 1;
+			}
+			kpi->interval_histogram[bucket]++;
+			kpi->interval_count++;
+			if (interval > kpi->interval_max) {
+				kpi->interval_max = (unsigned int)interval;
 			}
+		}
+		kpi->last_frame_time = current_video_time;
+
+		if (current_video_time - kpi->last_video_time >= G_USEC_PER_SEC) {
+			gint64 diff_time = current_video_time - kpi->last_video_time;
+			gint64 elapsed_time = current_video_time - kpi->init_video_time;
+
+			kpi->current_fps = (int)(((gint64)(frame_count - kpi->last_framecount) * G_USEC_PER_SEC) / diff_time);
+			kpi->average_fps = (int)(((gint64)frame_count * G_USEC_PER_SEC) / elapsed_time);
 
 			kpi->last_framecount = frame_count;
-			kpi->last_video_time.tv_sec = current_video_time.tv_sec;
-			kpi->last_video_time.tv_usec = current_video_time.tv_usec;
+			kpi->last_video_time = current_video_time;
 			/*
 			_mmcam_dbg_log("current fps(%d), average(%d)", kpi->current_fps, kpi->average_fps);
 			*/
@@ -1771,22 +1831,170 @@ static gboolean __mmcamcorder_video_dataprobe_preview(GstPad *pad, GstBuffer *bu
 }
 
 
+static gboolean __mmcamcorder_make_planar_stream(GstBuffer *buffer, int use_zero_copy_format, MMCamcorderVideoStreamPlanarDataType *stream)
+{
+	unsigned int i = 0;
+	int width = stream->width;
+	int height = stream->height;
+	unsigned int need_size = 0;
+	unsigned char *data = (unsigned char *)GST_BUFFER_DATA(buffer);
+
+	/* layout of contiguous buffer */
+	switch (stream->format) {
+	case MM_PIXEL_FORMAT_NV12:
+		stream->num_planes = 2;
+		stream->stride[0] = width;
+		stream->elevation[0] = height;
+		stream->stride[1] = width;
+		stream->elevation[1] = height >> 1;
+		break;
+	case MM_PIXEL_FORMAT_I420:
+	case MM_PIXEL_FORMAT_YV12:
+		stream->num_planes = 3;
+		stream->stride[0] = width;
+		stream->elevation[0] = height;
+		stream->stride[1] = stream->stride[2] = width >> 1;
+		stream->elevation[1] = stream->elevation[2] = height >> 1;
+		break;
+	case MM_PIXEL_FORMAT_422P:
+		stream->num_planes = 3;
+		stream->stride[0] = width;
+		stream->elevation[0] = height;
+		stream->stride[1] = stream->stride[2] = width >> 1;
+		stream->elevation[1] = stream->elevation[2] = height;
+		break;
+	case MM_PIXEL_FORMAT_YUYV:
+	case MM_PIXEL_FORMAT_UYVY:
+	case MM_PIXEL_FORMAT_RGB565:
+		stream->num_planes = 1;
+		stream->stride[0] = width << 1;
+		stream->elevation[0] = height;
+		break;
+	case MM_PIXEL_FORMAT_RGB888:
+		stream->num_planes = 1;
+		stream->stride[0] = width * 3;
+		stream->elevation[0] = height;
+		break;
+	case MM_PIXEL_FORMAT_ARGB:
+	case MM_PIXEL_FORMAT_RGBA:
+		stream->num_planes = 1;
+		stream->stride[0] = width << 2;
+		stream->elevation[0] = height;
+		break;
+	default:
+		stream->num_planes = 1;
+		stream->stride[0] = GST_BUFFER_SIZE(buffer) / height;
+		stream->elevation[0] = height;
+		break;
+	}
+
+	if ((stream->format == MM_PIXEL_FORMAT_NV12 || stream->format == MM_PIXEL_FORMAT_I420) &&
+	    use_zero_copy_format && GST_BUFFER_MALLOCDATA(buffer)) {
+		/* planes of zero copy buffer are located separately */
+		SCMN_IMGB *scmn_imgb = (SCMN_IMGB *)GST_BUFFER_MALLOCDATA(buffer);
+
+		for (i = 0 ; i < stream->num_planes ; i++) {
+			stream->data[i] = scmn_imgb->a[i];
+			if (scmn_imgb->s[i] > 0) {
+				stream->stride[i] = scmn_imgb->s[i];
+			}
+			if (scmn_imgb->e[i] > 0) {
+				stream->elevation[i] = scmn_imgb->e[i];
+			}
+			if (stream->data[i] == NULL) {
+				_mmcam_dbg_warn("NULL plane[%u] of zero copy buffer", i);
+				return FALSE;
+			}
+		}
+	} else {
+		for (i = 0 ; i < stream->num_planes ; i++) {
+			stream->data[i] = data + need_size;
+			need_size += stream->stride[i] * stream->elevation[i];
+		}
+
+		if (need_size > GST_BUFFER_SIZE(buffer)) {
+			_mmcam_dbg_warn("buffer size[%d] is smaller than expected[%d]", GST_BUFFER_SIZE(buffer), need_size);
+			return FALSE;
+		}
+	}
+
+	for (i = stream->num_planes ; i < MM_CAMCORDER_STREAM_PLANE_MAX ; i++) {
+		stream->data[i] = NULL;
+		stream->stride[i] = 0;
+		stream->elevation[i] = 0;
+	}
+
+	return TRUE;
+}
+
+
+static void __mmcamcorder_release_planar_stream(MMCamcorderVideoStreamPlanarDataType *stream)
+{
+	if (stream && stream->priv) {
+		gst_buffer_unref((GstBuffer *)stream->priv);
+		stream->priv = NULL;
+	}
+}
+
+
+static gboolean __mmcamcorder_update_video_format(_MMCamcorderVideoFormat *vformat, GstBuffer *buffer)
+{
+	GstCaps *caps = GST_BUFFER_CAPS(buffer);
+	GstStructure *structure = NULL;
+
+	/* caps of buffer is same with cached one, nothing to do */
+	if (vformat->caps == caps && vformat->need_update == FALSE) {
+		return TRUE;
+	}
+
+	vformat->need_update = FALSE;
+
+	if (vformat->caps) {
+		gst_caps_unref(vformat->caps);
+		vformat->caps = NULL;
+	}
+
+	vformat->width = 0;
+	vformat->height = 0;
+	vformat->fourcc = 0;
+	vformat->format = MM_PIXEL_FORMAT_INVALID;
+
+	if (caps == NULL) {
+		_mmcam_dbg_warn( "Caps is NULL." );
+		return FALSE;
+	}
+
+	structure = gst_caps_get_structure(caps, 0);
+	gst_structure_get_int(structure, "width", &(vformat->width));
+	gst_structure_get_int(structure, "height", &(vformat->height));
+	gst_structure_get_fourcc(structure, "format", &(vformat->fourcc));
+	vformat->format = _mmcamcorder_get_pixtype(vformat->fourcc);
+	vformat->caps = gst_caps_ref(caps);
+
+	_mmcam_dbg_log("video stream format - %dx%d, format[%d]",
+	               vformat->width, vformat->height, vformat->format);
+
+	return TRUE;
+}
+
+
 static gboolean __mmcamcorder_video_dataprobe_vsink(GstPad *pad, GstBuffer *buffer, gpointer u_data)
 {
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(u_data);
+	_MMCamcorderSubContext *sc = NULL;
 
 	mmf_return_val_if_fail(hcamcorder, FALSE);
 
+	sc = MMF_CAMCORDER_SUBCONTEXT(u_data);
+	mmf_return_val_if_fail(sc, FALSE);
+
 	if (buffer == NULL || GST_BUFFER_DATA(buffer) == NULL) {
 		_mmcam_dbg_err("Null buffer!!");
 		return FALSE;
 	}
 
-	if (hcamcorder->vstream_cb && buffer) {
-		GstCaps *caps = NULL;
-		GstStructure *structure = NULL;
+	if (hcamcorder->vstream_cb || hcamcorder->vstream_planar_cb) {
 		int state = MM_CAMCORDER_STATE_NULL;
-		unsigned int fourcc = 0;
 		MMCamcorderVideoStreamDataType stream;
 		void *standard_data = NULL;
 
@@ -1796,19 +2004,14 @@ static gboolean __mmcamcorder_video_dataprobe_vsink(GstPad *pad, GstBuffer *buff
 			return TRUE;
 		}
 
-		caps = gst_buffer_get_caps(buffer);
-		if (caps == NULL) {
-			_mmcam_dbg_warn( "Caps is NULL." );
+		/* parse caps only when it is changed */
+		if (!__mmcamcorder_update_video_format(&sc->vstream_format, buffer)) {
 			return TRUE;
 		}
 
-		structure = gst_caps_get_structure( caps, 0 );
-		gst_structure_get_int(structure, "width", &(stream.width));
-		gst_structure_get_int(structure, "height", &(stream.height));
-		gst_structure_get_fourcc(structure, "format", &fourcc);
-		stream.format = _mmcamcorder_get_pixtype(fourcc);
-		gst_caps_unref( caps );
-		caps = NULL;
+		stream.width = sc->vstream_format.width;
+		stream.height = sc->vstream_format.height;
+		stream.format = sc->vstream_format.format;
 
 		/*
 		_mmcam_dbg_log( "Call video steramCb, data[%p], Width[%d],Height[%d], Format[%d]",
@@ -1823,11 +2026,46 @@ static gboolean __mmcamcorder_video_dataprobe_vsink(GstPad *pad, GstBuffer *buff
 		stream.length = GST_BUFFER_SIZE(buffer);
 		stream.timestamp = (unsigned int)(GST_BUFFER_TIMESTAMP(buffer)/1000000); /* nano sec -> mili sec */
 
+		/* planar stream callback : deliver planes of buffer without copy */
+		if (hcamcorder->vstream_planar_cb) {
+			MMCamcorderVideoStreamPlanarDataType planar_stream;
+
+			planar_stream.format = stream.format;
+			planar_stream.width = stream.width;
+			planar_stream.height = stream.height;
+			planar_stream.timestamp = stream.timestamp;
+			planar_stream.release = __mmcamcorder_release_planar_stream;
+			planar_stream.priv = NULL;
+
+			if (__mmcamcorder_make_planar_stream(buffer, hcamcorder->use_zero_copy_format, &planar_stream)) {
+				mm_camcorder_video_stream_planar_callback planar_cb = NULL;
+				void *planar_cb_param = NULL;
+
+				/* application callback is not called with lock */
+				_MMCAMCORDER_LOCK_VSTREAM_CALLBACK(hcamcorder);
+				planar_cb = hcamcorder->vstream_planar_cb;
+				planar_cb_param = hcamcorder->vstream_planar_cb_param;
+				_MMCAMCORDER_UNLOCK_VSTREAM_CALLBACK(hcamcorder);
+
+				if (planar_cb) {
+					/* this reference is released by application through release function */
+					planar_stream.priv = (void *)gst_buffer_ref(buffer);
+					planar_cb(&planar_stream, planar_cb_param);
+				}
+			} else {
+				_mmcam_dbg_warn("failed to make planar stream. skip planar stream callback...");
+			}
+		}
+
+		if (hcamcorder->vstream_cb == NULL) {
+			return TRUE;
+		}
+
 		/* make normal buffer for user handling when use zero copy format && NV12 */
 		if ((stream.format == MM_PIXEL_FORMAT_NV12 || stream.format == MM_PIXEL_FORMAT_I420) &&
 		    hcamcorder->use_zero_copy_format &&
 		    GST_BUFFER_MALLOCDATA(buffer)) {
-			standard_data = (void *)malloc(stream.length);
+			standard_data = _mmcamcorder_buffer_pool_get(&sc->vstream_pool, stream.length);
 			if (standard_data) {
 				int size_y = stream.width * stream.height;
 				SCMN_IMGB *scmn_imgb = (SCMN_IMGB *)GST_BUFFER_MALLOCDATA(buffer);
@@ -1850,6 +2088,12 @@ static gboolean __mmcamcorder_video_dataprobe_vsink(GstPad *pad, GstBuffer *buff
 			stream.data = (void *)GST_BUFFER_DATA(buffer);
 		}
 
+		if (sc->vstream_dispatch.lock) {
+			/* hand over frame to dispatch thread. converted data is released by it */
+			_mmcamcorder_push_vstream_frame((MMHandleType)hcamcorder, &stream, buffer, standard_data);
+			return TRUE;
+		}
+
 		_MMCAMCORDER_LOCK_VSTREAM_CALLBACK(hcamcorder);
 		if (hcamcorder->vstream_cb) {
 			hcamcorder->vstream_cb(&stream, hcamcorder->vstream_cb_param);
@@ -1857,7 +2101,7 @@ static gboolean __mmcamcorder_video_dataprobe_vsink(GstPad *pad, GstBuffer *buff
 		_MMCAMCORDER_UNLOCK_VSTREAM_CALLBACK(hcamcorder);
 
 		if (standard_data) {
-			free(standard_data);
+			_mmcamcorder_buffer_pool_put(&sc->vstream_pool, standard_data, stream.length);
 			standard_data = NULL;
 		}
 	}
@@ -1880,9 +2124,36 @@ static gboolean __mmcamcorder_video_dataprobe_vsink_drop_by_time(GstPad *pad, Gs
 	_mmcam_dbg_log("VIDEO SRC time stamp : [%" GST_TIME_FORMAT "]", GST_TIME_ARGS(GST_BUFFER_TIMESTAMP(buffer)));
 */
 
+	/* skip frames which are not delivered to video stream callback. they are still displayed. */
+	if (sc->vstream_cb_interval > 1) {
+		if ((sc->vstream_frame_count++ % sc->vstream_cb_interval) != 0) {
+			return TRUE;
+		}
+	}
+
+	if (sc->vstream_cb_fps > 0 && buffer && GST_BUFFER_TIMESTAMP_IS_VALID(buffer)) {
+		GstClockTime timestamp = GST_BUFFER_TIMESTAMP(buffer);
+		GstClockTime duration = GST_SECOND / sc->vstream_cb_fps;
+		GstClockTime next_time = sc->vstream_next_time;
+
+		if (GST_CLOCK_TIME_IS_VALID(next_time) &&
+		    timestamp < next_time && next_time - timestamp <= duration) {
+			return TRUE;
+		}
+
+		/* keep pace with target frame rate, but restart it if timestamp jumps */
+		if (GST_CLOCK_TIME_IS_VALID(next_time) &&
+		    timestamp >= next_time && timestamp - next_time < duration) {
+			sc->vstream_next_time = next_time + duration;
+		} else {
+			sc->vstream_next_time = timestamp + duration;
+		}
+	}
+
 	/* Call video stream callback */
 	if (__mmcamcorder_video_dataprobe_vsink(pad, buffer, u_data) == FALSE) {
 		_mmcam_dbg_warn( "__mmcamcorder_video_dataprobe_vsink failed." );
+		sc->kpi.drop_by_probe++;
 		return FALSE;
 	}
 
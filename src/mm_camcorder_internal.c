@@ -75,6 +75,11 @@ ASM_cb_result_t _mmcamcorder_asm_callback(int handle, ASM_event_sources_t event_
                                           unsigned int sound_status, void *cb_data);
 
 static gboolean __mmcamcorder_set_attr_to_camsensor_cb(gpointer data);
+static void     *__mmcamcorder_vstream_dispatch_thread(void *arg);
+static void     __mmcamcorder_release_vstream_frame(_MMCamcorderSubContext *sc, _MMCamcorderVStreamFrame *frame);
+static gboolean __mmcamcorder_is_command_pair(_MMCamcorderCommandType pending, _MMCamcorderCommandType type, int state);
+static void     __mmcamcorder_complete_command(__MMCamcorderCmdInfo *info, int result);
+static void     __mmcamcorder_unref_command(__MMCamcorderCmdInfo *info);
 
 /*=======================================================================================
 |  FUNCTION DEFINITIONS									|
@@ -132,6 +137,8 @@ int _mmcamcorder_create(MMHandleType *handle, MMCamPreset *info)
 	(hcamcorder->mtsafe).vstream_cb_lock = g_mutex_new();
 	(hcamcorder->mtsafe).astream_cb_lock = g_mutex_new();
 
+	_mmcamcorder_msg_queue_init(&(hcamcorder->msg_queue), (MMHandleType)hcamcorder);
+
 	pthread_mutex_init(&(hcamcorder->sound_lock), NULL);
 	pthread_cond_init(&(hcamcorder->sound_cond), NULL);
 
@@ -315,6 +322,33 @@ int _mmcamcorder_create(MMHandleType *handle, MMCamPreset *info)
 	                                &(hcamcorder->use_zero_copy_format));
 	_mmcam_dbg_log("UseZeroCopyFormat : %d", hcamcorder->use_zero_copy_format);
 
+	/* Create pool of face detect info. Maximum face count comes from DetectNumber in INI */
+	{
+		int fd_max_faces = 0;
+		int fd_drop_stale = 0;
+		type_int_range *detect_number = NULL;
+
+		_mmcamcorder_conf_get_value_int_range(hcamcorder->conf_ctrl,
+		                                      CONFIGURE_CATEGORY_CTRL_DETECT,
+		                                      "DetectNumber",
+		                                      &detect_number);
+		if (detect_number) {
+			fd_max_faces = detect_number->max;
+		}
+
+		_mmcamcorder_conf_get_value_int(hcamcorder->conf_main,
+		                                CONFIGURE_CATEGORY_MAIN_VIDEO_INPUT,
+		                                "FaceDetectDropStale",
+		                                &fd_drop_stale);
+
+		if (!_mmcamcorder_fd_pool_init(&(hcamcorder->fd_pool), fd_max_faces, fd_drop_stale)) {
+			_mmcam_dbg_warn("face detect pool init failed. face detect info will not be sent");
+		}
+	}
+
+	/* Snapshot of attributes for streaming thread */
+	_mmcamcorder_init_hot_attributes((MMHandleType)hcamcorder);
+
 	/* Make some attributes as read-only type */
 	__ta__( "    _mmcamcorder_lock_readonly_attributes",
 	_mmcamcorder_lock_readonly_attributes((MMHandleType)hcamcorder);
@@ -392,6 +426,9 @@ _ERR_DEFAULT_VALUE_INIT:
 	g_mutex_free ((hcamcorder->mtsafe).state_lock);
 	g_mutex_free ((hcamcorder->mtsafe).gst_state_lock);	
 
+	_mmcamcorder_msg_queue_deinit(&(hcamcorder->msg_queue));
+	_mmcamcorder_fd_pool_deinit(&(hcamcorder->fd_pool));
+
 	if (hcamcorder->conf_ctrl) {
 		_mmcamcorder_conf_release_info( &hcamcorder->conf_ctrl );
 	}
@@ -482,8 +519,8 @@ int _mmcamcorder_destroy(MMHandleType handle)
 
 	}
 
-	/* Remove command loop when async state change mode */
-	if (!hcamcorder->sync_state_change) {
+	/* Remove command loop when async state change mode or async command was requested */
+	if (hcamcorder->cmd.cmd_queue) {
 		_mmcamcorder_destroy_command_loop(handle);
 	}
 
@@ -497,6 +534,8 @@ int _mmcamcorder_destroy(MMHandleType handle)
 
 	/* Remove messages which are not called yet */
 	_mmcamcroder_remove_message_all(handle);
+	_mmcamcorder_msg_queue_deinit(&(hcamcorder->msg_queue));
+	_mmcamcorder_fd_pool_deinit(&(hcamcorder->fd_pool));
 
 	/* Unregister ASM */
 	if (MM_ERROR_NONE != _mm_session_util_read_type(-1, &sessionType)) {
@@ -1619,6 +1658,32 @@ int _mmcamcorder_set_video_stream_callback(MMHandleType handle, mm_camcorder_vid
 }
 
 
+int _mmcamcorder_set_video_stream_planar_callback(MMHandleType handle, mm_camcorder_video_stream_planar_callback callback, void *user_data)
+{
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+
+	_mmcam_dbg_log("");
+
+	mmf_return_val_if_fail(hcamcorder, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+
+	if (callback == NULL) {
+		_mmcam_dbg_warn("Planar Video Stream Callback is disabled, because application sets it to NULL");
+	}
+
+	if (!_MMCAMCORDER_TRYLOCK_VSTREAM_CALLBACK(hcamcorder)) {
+		_mmcam_dbg_warn("Application's video stream callback is running now");
+		return MM_ERROR_CAMCORDER_INVALID_CONDITION;
+	}
+
+	hcamcorder->vstream_planar_cb = callback;
+	hcamcorder->vstream_planar_cb_param = user_data;
+
+	_MMCAMCORDER_UNLOCK_VSTREAM_CALLBACK(hcamcorder);
+
+	return MM_ERROR_NONE;
+}
+
+
 int _mmcamcorder_set_audio_stream_callback(MMHandleType handle, mm_camcorder_audio_stream_callback callback, void *user_data)
 {
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
@@ -2285,6 +2350,25 @@ _MMCamcorderSubContext *_mmcamcorder_alloc_subcontext(int type)
 	sc->pass_first_vframe = 0;
 	sc->is_modified_rate = FALSE;
 
+	if (!_mmcamcorder_frame_notifier_init(&sc->frame_notifier)) {
+		_mmcam_dbg_err("Failed to init frame notifier");
+		free(sc->element);
+		free(sc->info);
+		free(sc);
+		return NULL;
+	}
+
+	/* lock of pre-record buffer is kept while sub context is alive,
+	   because statistics could be requested while pre-recording is stopped */
+	if (!_mmcamcorder_pre_record_buffer_create(&sc->pre_record)) {
+		_mmcam_dbg_err("Failed to create pre-record buffer");
+		_mmcamcorder_frame_notifier_deinit(&sc->frame_notifier);
+		free(sc->element);
+		free(sc->info);
+		free(sc);
+		return NULL;
+	}
+
 	return sc;
 }
 
@@ -2294,6 +2378,32 @@ void _mmcamcorder_dealloc_subcontext(_MMCamcorderSubContext *sc)
 	_mmcam_dbg_log("");
 
 	if (sc) {
+		/* dispatch thread should be stopped before buffer pool is released */
+		_mmcamcorder_destroy_vstream_dispatch(sc);
+		_mmcamcorder_buffer_pool_deinit(&sc->vstream_pool);
+		_mmcamcorder_storage_monitor_stop(&sc->storage_monitor);
+		_mmcamcorder_audio_meter_deinit(&sc->audio_meter);
+		_mmcamcorder_silence_buffer_deinit(&sc->silence);
+		_mmcamcorder_frame_notifier_deinit(&sc->frame_notifier);
+		_mmcamcorder_pre_record_buffer_destroy(&sc->pre_record);
+		_mmcamcorder_encode_pool_stop(&sc->encode_pool);
+
+		if (sc->exif_template) {
+			mm_exif_template_destroy(sc->exif_template);
+			sc->exif_template = NULL;
+		}
+
+		if (sc->capture_exif.data) {
+			free(sc->capture_exif.data);
+			sc->capture_exif.data = NULL;
+			sc->capture_exif.size = 0;
+		}
+
+		if (sc->vstream_format.caps) {
+			gst_caps_unref(sc->vstream_format.caps);
+			sc->vstream_format.caps = NULL;
+		}
+
 		if (sc->element) {
 			free(sc->element);
 			sc->element = NULL;
@@ -2501,9 +2611,9 @@ gboolean _mmcamcorder_pipeline_cb_message(GstBus *bus, GstMessage *message, gpoi
 				return TRUE;
 			}
 
-			cam_fd_info = (MMCamFaceDetectInfo *)malloc(sizeof(MMCamFaceDetectInfo));
+			cam_fd_info = _mmcamcorder_fd_pool_get(&(hcamcorder->fd_pool));
 			if (cam_fd_info == NULL) {
-				_mmcam_dbg_warn("cam_fd_info alloc failed");
+				_mmcam_dbg_warn("no free slot for face detect info. drop it");
 
 				free(fd_info);
 				fd_info = NULL;
@@ -2513,48 +2623,38 @@ gboolean _mmcamcorder_pipeline_cb_message(GstBus *bus, GstMessage *message, gpoi
 
 			/* set total face count */
 			cam_fd_info->num_of_faces = fd_info->num_of_faces;
+			if (cam_fd_info->num_of_faces > hcamcorder->fd_pool.max_faces) {
+				_mmcam_dbg_warn("too many faces %d, max %d",
+				                cam_fd_info->num_of_faces, hcamcorder->fd_pool.max_faces);
+				cam_fd_info->num_of_faces = hcamcorder->fd_pool.max_faces;
+			}
 
-			if (cam_fd_info->num_of_faces > 0) {
-				cam_fd_info->face_info = (MMCamFaceInfo *)malloc(sizeof(MMCamFaceInfo) * cam_fd_info->num_of_faces);
-				if (cam_fd_info->face_info) {
-					/* set information of each face */
-					for (i = 0 ; i < fd_info->num_of_faces ; i++) {
-						cam_fd_info->face_info[i].id = fd_info->face_info[i].id;
-						cam_fd_info->face_info[i].score = fd_info->face_info[i].score;
-						cam_fd_info->face_info[i].rect.x = fd_info->face_info[i].rect.x;
-						cam_fd_info->face_info[i].rect.y = fd_info->face_info[i].rect.y;
-						cam_fd_info->face_info[i].rect.width = fd_info->face_info[i].rect.width;
-						cam_fd_info->face_info[i].rect.height = fd_info->face_info[i].rect.height;
-						/*
-						_mmcam_dbg_log("id %d, score %d, [%d,%d,%dx%d]",
-						               fd_info->face_info[i].id,
-						               fd_info->face_info[i].score,
-						               fd_info->face_info[i].rect.x,
-						               fd_info->face_info[i].rect.y,
-						               fd_info->face_info[i].rect.width,
-						               fd_info->face_info[i].rect.height);
-						*/
-					}
-				} else {
-					_mmcam_dbg_warn("MMCamFaceInfo alloc failed");
-
-					/* free allocated memory that is not sent */
-					free(cam_fd_info);
-					cam_fd_info = NULL;
-				}
-			} else {
-				cam_fd_info->face_info = NULL;
+			/* set information of each face */
+			for (i = 0 ; i < cam_fd_info->num_of_faces ; i++) {
+				cam_fd_info->face_info[i].id = fd_info->face_info[i].id;
+				cam_fd_info->face_info[i].score = fd_info->face_info[i].score;
+				cam_fd_info->face_info[i].rect.x = fd_info->face_info[i].rect.x;
+				cam_fd_info->face_info[i].rect.y = fd_info->face_info[i].rect.y;
+				cam_fd_info->face_info[i].rect.width = fd_info->face_info[i].rect.width;
+				cam_fd_info->face_info[i].rect.height = fd_info->face_info[i].rect.height;
+				/*
+				_mmcam_dbg_log("id %d, score %d, [%d,%d,%dx%d]",
+				               fd_info->face_info[i].id,
+				               fd_info->face_info[i].score,
+				               fd_info->face_info[i].rect.x,
+				               fd_info->face_info[i].rect.y,
+				               fd_info->face_info[i].rect.width,
+				               fd_info->face_info[i].rect.height);
+				*/
 			}
 
-			if (cam_fd_info) {
-				/* send message  - cam_fd_info should be freed by application */
-				msg.id = MM_MESSAGE_CAMCORDER_FACE_DETECT_INFO;
-				msg.param.data = cam_fd_info;
-				msg.param.size = sizeof(MMCamFaceDetectInfo);
-				msg.param.code = 0;
+			/* send message - cam_fd_info is returned to pool after message callback */
+			msg.id = MM_MESSAGE_CAMCORDER_FACE_DETECT_INFO;
+			msg.param.data = cam_fd_info;
+			msg.param.size = sizeof(MMCamFaceDetectInfo);
+			msg.param.code = 0;
 
-				_mmcamcroder_send_message((MMHandleType)hcamcorder, &msg);
-			}
+			_mmcamcroder_send_message((MMHandleType)hcamcorder, &msg);
 
 			/* free fd_info allocated by plugin */
 			free(fd_info);
@@ -3031,6 +3131,115 @@ int _mmcamcorder_video_average_framerate(MMHandleType handle)
 }
 
 
+int _mmcamcorder_get_video_frame_statistics(MMHandleType handle, MMCamcorderVideoFrameStatistics *stats)
+{
+	int i = 0;
+	unsigned int count = 0;
+	unsigned int sum = 0;
+	unsigned int p50_count = 0;
+	unsigned int p95_count = 0;
+	unsigned int p99_count = 0;
+	unsigned int histogram[_MMCAMCORDER_KPI_INTERVAL_BUCKET_NUM];
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderSubContext *sc = NULL;
+	_MMCamcorderKPIMeasure *kpi = NULL;
+
+	mmf_return_val_if_fail(hcamcorder, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+	mmf_return_val_if_fail(stats, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
+	if (sc == NULL) {
+		_mmcam_dbg_warn("Not realized yet");
+		return MM_ERROR_CAMCORDER_INVALID_STATE;
+	}
+
+	kpi = &(sc->kpi);
+
+	memset(stats, 0x00, sizeof(MMCamcorderVideoFrameStatistics));
+
+	/* histogram is updated in streaming thread, so use a copy of it */
+	memcpy(histogram, kpi->interval_histogram, sizeof(histogram));
+	for (i = 0 ; i < _MMCAMCORDER_KPI_INTERVAL_BUCKET_NUM ; i++) {
+		count += histogram[i];
+	}
+
+	stats->frame_count = count;
+	stats->interval_max = kpi->interval_max;
+	stats->drop_by_vframe = kpi->drop_by_vframe;
+	stats->drop_by_stability = kpi->drop_by_stability;
+	stats->drop_by_probe = kpi->drop_by_probe;
+
+	if (count == 0) {
+		return MM_ERROR_NONE;
+	}
+
+	/* rank of each percentile (round up) */
+	p50_count = (count * 50 + 99) / 100;
+	p95_count = (count * 95 + 99) / 100;
+	p99_count = (count * 99 + 99) / 100;
+
+	/* upper bound of bucket is reported, and the last bucket includes all longer intervals */
+	for (i = 0 ; i < _MMCAMCORDER_KPI_INTERVAL_BUCKET_NUM ; i++) {
+		unsigned int upper = (i == _MMCAMCORDER_KPI_INTERVAL_BUCKET_NUM - 1) ?
+		                     kpi->interval_max : (i + 1) * _MMCAMCORDER_KPI_INTERVAL_BUCKET_USEC;
+
+		sum += histogram[i];
+		if (stats->interval_p50 == 0 && sum >= p50_count) {
+			stats->interval_p50 = upper;
+		}
+		if (stats->interval_p95 == 0 && sum >= p95_count) {
+			stats->interval_p95 = upper;
+		}
+		if (stats->interval_p99 == 0 && sum >= p99_count) {
+			stats->interval_p99 = upper;
+			break;
+		}
+	}
+
+	return MM_ERROR_NONE;
+}
+
+
+int _mmcamcorder_get_audio_level(MMHandleType handle, MMCamcorderAudioLevel *level)
+{
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderSubContext *sc = NULL;
+
+	mmf_return_val_if_fail(hcamcorder, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+	mmf_return_val_if_fail(level, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
+	if (sc == NULL || sc->audio_meter.lock == NULL) {
+		_mmcam_dbg_warn("Audio meter is not started");
+		return MM_ERROR_CAMCORDER_INVALID_STATE;
+	}
+
+	_mmcamcorder_audio_meter_get_level(&(sc->audio_meter), level);
+
+	return MM_ERROR_NONE;
+}
+
+
+int _mmcamcorder_get_pre_record_statistics(MMHandleType handle, MMCamcorderPreRecordStatistics *stats)
+{
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderSubContext *sc = NULL;
+
+	mmf_return_val_if_fail(hcamcorder, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+	mmf_return_val_if_fail(stats, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
+
+	/* lock of pre-record buffer is valid while sub context is alive */
+	if (sc == NULL || !_mmcamcorder_pre_record_buffer_get_statistics(&(sc->pre_record), stats)) {
+		_mmcam_dbg_warn("Pre-recording is not started");
+		return MM_ERROR_CAMCORDER_INVALID_STATE;
+	}
+
+	return MM_ERROR_NONE;
+}
+
+
 void _mmcamcorder_video_current_framerate_init(MMHandleType handle)
 {
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
@@ -3047,9 +3256,32 @@ void _mmcamcorder_video_current_framerate_init(MMHandleType handle)
 }
 
 /* Async state change */
+__MMCamcorderCmdInfo *_mmcamcorder_new_command_info(MMHandleType handle, _MMCamcorderCommandType type)
+{
+	__MMCamcorderCmdInfo *cmdinfo = NULL;
+
+	cmdinfo = (__MMCamcorderCmdInfo*)g_malloc0(sizeof(__MMCamcorderCmdInfo));
+
+	cmdinfo->handle = handle;
+	cmdinfo->type = type;
+	cmdinfo->lock = g_mutex_new();
+	cmdinfo->cond = g_cond_new();
+	cmdinfo->ref_count = 1;
+
+	return cmdinfo;
+}
+
 void _mmcamcorder_delete_command_info(__MMCamcorderCmdInfo *cmdinfo)
 {
 	if (cmdinfo) {
+		if (cmdinfo->cond) {
+			g_cond_free(cmdinfo->cond);
+			cmdinfo->cond = NULL;
+		}
+		if (cmdinfo->lock) {
+			g_mutex_free(cmdinfo->lock);
+			cmdinfo->lock = NULL;
+		}
 		g_free(cmdinfo);
 	}
 }
@@ -3186,6 +3418,275 @@ static void __mmcamcorder_force_resume(mmf_camcorder_t *hcamcorder)
 	return;
 }
 
+int _mmcamcorder_create_vstream_dispatch(MMHandleType handle)
+{
+	int mode = MM_CAMCORDER_VIDEO_STREAM_DISPATCH_SYNC;
+	int length = _MMCAMCORDER_VSTREAM_QUEUE_DEFAULT;
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderSubContext *sc = NULL;
+	_MMCamcorderVStreamDispatch *dispatch = NULL;
+
+	mmf_return_val_if_fail(hcamcorder, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
+	mmf_return_val_if_fail(sc, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+
+	dispatch = &(sc->vstream_dispatch);
+
+	mm_camcorder_get_attributes(handle, NULL,
+	                            MMCAM_VIDEO_STREAM_DISPATCH_MODE, &mode,
+	                            MMCAM_VIDEO_STREAM_QUEUE_LENGTH, &length,
+	                            NULL);
+
+	_mmcam_dbg_log("dispatch mode[%d], queue length[%d]", mode, length);
+
+	if (mode == MM_CAMCORDER_VIDEO_STREAM_DISPATCH_SYNC) {
+		/* video stream callback is called in streaming thread */
+		return MM_ERROR_NONE;
+	}
+
+	if (length < 1 || length > _MMCAMCORDER_VSTREAM_QUEUE_MAX) {
+		length = _MMCAMCORDER_VSTREAM_QUEUE_DEFAULT;
+	}
+
+	memset(dispatch, 0x00, sizeof(_MMCamcorderVStreamDispatch));
+	dispatch->mode = mode;
+	dispatch->length = length;
+	dispatch->lock = g_mutex_new();
+	dispatch->cond = g_cond_new();
+	dispatch->running = TRUE;
+
+	if (pthread_create(&dispatch->thread, NULL, __mmcamcorder_vstream_dispatch_thread, hcamcorder)) {
+		_mmcam_dbg_err("failed to create video stream dispatch thread");
+		dispatch->running = FALSE;
+		g_cond_free(dispatch->cond);
+		dispatch->cond = NULL;
+		g_mutex_free(dispatch->lock);
+		dispatch->lock = NULL;
+		return MM_ERROR_CAMCORDER_INTERNAL;
+	}
+
+	return MM_ERROR_NONE;
+}
+
+
+void _mmcamcorder_destroy_vstream_dispatch(_MMCamcorderSubContext *sc)
+{
+	_MMCamcorderVStreamDispatch *dispatch = NULL;
+
+	mmf_return_if_fail(sc);
+
+	dispatch = &(sc->vstream_dispatch);
+	if (dispatch->lock == NULL) {
+		return;
+	}
+
+	_mmcam_dbg_log("dropped frame count[%u]", dispatch->dropped_count);
+
+	g_mutex_lock(dispatch->lock);
+	dispatch->running = FALSE;
+	g_cond_broadcast(dispatch->cond);
+	g_mutex_unlock(dispatch->lock);
+
+	_mmcam_dbg_log("wait for pthread join");
+
+	pthread_join(dispatch->thread, NULL);
+
+	_mmcam_dbg_log("pthread join!!");
+
+	/* release remained frames */
+	while (dispatch->depth > 0) {
+		__mmcamcorder_release_vstream_frame(sc, &(dispatch->frame[dispatch->head]));
+		dispatch->head = (dispatch->head + 1) % dispatch->length;
+		dispatch->depth--;
+	}
+
+	g_cond_free(dispatch->cond);
+	dispatch->cond = NULL;
+	g_mutex_free(dispatch->lock);
+	dispatch->lock = NULL;
+
+	return;
+}
+
+
+gboolean _mmcamcorder_push_vstream_frame(MMHandleType handle, MMCamcorderVideoStreamDataType *stream,
+                                         GstBuffer *buffer, void *converted_data)
+{
+	int tail = 0;
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderSubContext *sc = NULL;
+	_MMCamcorderVStreamDispatch *dispatch = NULL;
+	_MMCamcorderVStreamFrame *frame = NULL;
+	_MMCamcorderVStreamFrame dropped;
+
+	mmf_return_val_if_fail(hcamcorder, FALSE);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
+	mmf_return_val_if_fail(sc, FALSE);
+
+	dispatch = &(sc->vstream_dispatch);
+	mmf_return_val_if_fail(dispatch->lock, FALSE);
+
+	dropped.buffer = NULL;
+	dropped.converted_data = NULL;
+
+	g_mutex_lock(dispatch->lock);
+
+	if (dispatch->depth >= dispatch->length) {
+		switch (dispatch->mode) {
+		case MM_CAMCORDER_VIDEO_STREAM_DISPATCH_DROP_OLDEST:
+			dropped = dispatch->frame[dispatch->head];
+			dispatch->head = (dispatch->head + 1) % dispatch->length;
+			dispatch->depth--;
+			dispatch->dropped_count++;
+			break;
+		case MM_CAMCORDER_VIDEO_STREAM_DISPATCH_BLOCK:
+			while (dispatch->running && dispatch->depth >= dispatch->length) {
+				g_cond_wait(dispatch->cond, dispatch->lock);
+			}
+			if (dispatch->running) {
+				break;
+			}
+			/* fall through : dispatch thread is stopped */
+		case MM_CAMCORDER_VIDEO_STREAM_DISPATCH_DROP_NEWEST:
+		default:
+			dispatch->dropped_count++;
+			g_mutex_unlock(dispatch->lock);
+
+			if (converted_data) {
+				_mmcamcorder_buffer_pool_put(&sc->vstream_pool, converted_data, stream->length);
+			}
+			return FALSE;
+		}
+	}
+
+	tail = (dispatch->head + dispatch->depth) % dispatch->length;
+	frame = &(dispatch->frame[tail]);
+	frame->stream = *stream;
+	frame->converted_data = converted_data;
+	if (converted_data) {
+		frame->buffer = NULL;
+	} else {
+		/* stream data points to buffer, so keep it until callback is returned */
+		frame->buffer = gst_buffer_ref(buffer);
+	}
+	dispatch->depth++;
+
+	g_cond_broadcast(dispatch->cond);
+	g_mutex_unlock(dispatch->lock);
+
+	/* release dropped frame out of lock */
+	__mmcamcorder_release_vstream_frame(sc, &dropped);
+
+	return TRUE;
+}
+
+
+int _mmcamcorder_get_video_stream_dispatch_stats(MMHandleType handle, unsigned int *queue_depth, unsigned int *dropped_count)
+{
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderSubContext *sc = NULL;
+	_MMCamcorderVStreamDispatch *dispatch = NULL;
+
+	mmf_return_val_if_fail(hcamcorder, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+	mmf_return_val_if_fail(queue_depth && dropped_count, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
+	if (sc == NULL) {
+		_mmcam_dbg_warn("Not realized yet");
+		return MM_ERROR_CAMCORDER_INVALID_STATE;
+	}
+
+	dispatch = &(sc->vstream_dispatch);
+
+	if (dispatch->lock) {
+		g_mutex_lock(dispatch->lock);
+		*queue_depth = dispatch->depth;
+		*dropped_count = dispatch->dropped_count;
+		g_mutex_unlock(dispatch->lock);
+	} else {
+		*queue_depth = 0;
+		*dropped_count = 0;
+	}
+
+	return MM_ERROR_NONE;
+}
+
+
+static void __mmcamcorder_release_vstream_frame(_MMCamcorderSubContext *sc, _MMCamcorderVStreamFrame *frame)
+{
+	if (frame->converted_data) {
+		_mmcamcorder_buffer_pool_put(&sc->vstream_pool, frame->converted_data, frame->stream.length);
+		frame->converted_data = NULL;
+	}
+
+	if (frame->buffer) {
+		gst_buffer_unref(frame->buffer);
+		frame->buffer = NULL;
+	}
+
+	return;
+}
+
+
+static void *__mmcamcorder_vstream_dispatch_thread(void *arg)
+{
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(arg);
+	_MMCamcorderSubContext *sc = NULL;
+	_MMCamcorderVStreamDispatch *dispatch = NULL;
+	_MMCamcorderVStreamFrame frame;
+
+	mmf_return_val_if_fail(hcamcorder, NULL);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(hcamcorder);
+	mmf_return_val_if_fail(sc, NULL);
+
+	dispatch = &(sc->vstream_dispatch);
+
+	_mmcam_dbg_log("start video stream dispatch thread");
+
+	g_mutex_lock(dispatch->lock);
+
+	while (dispatch->running) {
+		if (dispatch->depth == 0) {
+			g_cond_wait(dispatch->cond, dispatch->lock);
+			continue;
+		}
+
+		/* pop the oldest frame */
+		frame = dispatch->frame[dispatch->head];
+		dispatch->frame[dispatch->head].buffer = NULL;
+		dispatch->frame[dispatch->head].converted_data = NULL;
+		dispatch->head = (dispatch->head + 1) % dispatch->length;
+		dispatch->depth--;
+
+		/* wake up streaming thread which waits for free slot */
+		g_cond_broadcast(dispatch->cond);
+		g_mutex_unlock(dispatch->lock);
+
+		/* frames queued before preview stop are not delivered */
+		if (_mmcamcorder_get_state((MMHandleType)hcamcorder) >= MM_CAMCORDER_STATE_PREPARE) {
+			_MMCAMCORDER_LOCK_VSTREAM_CALLBACK(hcamcorder);
+			if (hcamcorder->vstream_cb) {
+				hcamcorder->vstream_cb(&(frame.stream), hcamcorder->vstream_cb_param);
+			}
+			_MMCAMCORDER_UNLOCK_VSTREAM_CALLBACK(hcamcorder);
+		}
+
+		__mmcamcorder_release_vstream_frame(sc, &frame);
+
+		g_mutex_lock(dispatch->lock);
+	}
+
+	g_mutex_unlock(dispatch->lock);
+
+	_mmcam_dbg_log("exit video stream dispatch thread");
+
+	return NULL;
+}
+
+
 int _mmcamcorder_create_command_loop(MMHandleType handle)
 {
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
@@ -3199,10 +3700,21 @@ int _mmcamcorder_create_command_loop(MMHandleType handle)
 	cmd->cmd_queue = g_queue_new();
 	mmf_return_val_if_fail(cmd->cmd_queue, MM_ERROR_CAMCORDER_INVALID_CONDITION);
 
-	sem_init(&cmd->sema, 0, 0);
+	cmd->lock = g_mutex_new();
+	cmd->cond = g_cond_new();
+	cmd->coalesced_count = 0;
+	cmd->executing = FALSE;
 
 	if (pthread_create(&cmd->pCommandThread, NULL, _mmcamcorder_command_loop_thread, hcamcorder)) {
 		perror("Make Command Thread Fail");
+
+		g_cond_free(cmd->cond);
+		cmd->cond = NULL;
+		g_mutex_free(cmd->lock);
+		cmd->lock = NULL;
+		g_queue_free(cmd->cmd_queue);
+		cmd->cmd_queue = NULL;
+
 		return MM_ERROR_COMMON_UNKNOWN;
 	}
 
@@ -3221,26 +3733,33 @@ int _mmcamcorder_destroy_command_loop(MMHandleType handle)
 	cmd = (_MMCamcorderCommand *)&(hcamcorder->cmd);
 	mmf_return_val_if_fail(cmd->cmd_queue, MM_ERROR_CAMCORDER_INVALID_CONDITION);
 
-	_mmcamcorder_append_simple_command(handle, _MMCAMCORDER_CMD_QUIT);
+	/* complete commands which are not executed yet, they are not executed after destroy.
+	   completion handle doesn't refer camcorder handle, so it could be waited after destroy. */
+	g_mutex_lock(cmd->lock);
+	while (!g_queue_is_empty(cmd->cmd_queue)) {
+		__MMCamcorderCmdInfo *info = NULL;
+		info = g_queue_pop_head(cmd->cmd_queue);
+		_mmcam_dbg_warn("command %d is not executed", info->type);
+		__mmcamcorder_complete_command(info, MM_ERROR_CAMCORDER_INVALID_CONDITION);
+	}
+	g_mutex_unlock(cmd->lock);
 
-	sem_post(&cmd->sema); /* why is this needed? */
+	_mmcamcorder_append_simple_command(handle, _MMCAMCORDER_CMD_QUIT);
 
 	_mmcam_dbg_log("wait for pthread join");
 
 	pthread_join(cmd->pCommandThread, NULL);
 
-	_mmcam_dbg_log("pthread join!!");
-	
-	sem_destroy(&cmd->sema);
+	_mmcam_dbg_log("pthread join!! coalesced command pair %u", cmd->coalesced_count);
 
-	while (!g_queue_is_empty(cmd->cmd_queue)) {
-		__MMCamcorderCmdInfo *info = NULL;
-		info = g_queue_pop_head(cmd->cmd_queue);
-		_mmcamcorder_delete_command_info(info);
-	}
 	g_queue_free(cmd->cmd_queue);
+	cmd->cmd_queue = NULL;
+	g_cond_free(cmd->cond);
+	cmd->cond = NULL;
+	g_mutex_free(cmd->lock);
+	cmd->lock = NULL;
 
-	_mmcam_dbg_log("Command loop clear.");	
+	_mmcam_dbg_log("Command loop clear.");
 
 	return MM_ERROR_NONE;
 }
@@ -3248,27 +3767,49 @@ int _mmcamcorder_destroy_command_loop(MMHandleType handle)
 
 int _mmcamcorder_append_command(MMHandleType handle, __MMCamcorderCmdInfo *info)
 {
-	int value = 0;
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
 	_MMCamcorderCommand *cmd;
+	__MMCamcorderCmdInfo *tail = NULL;
 
 	mmf_return_val_if_fail(hcamcorder, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+	mmf_return_val_if_fail(info, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
 
 	_mmcam_dbg_log("");
 
 	cmd = (_MMCamcorderCommand *)&(hcamcorder->cmd);
-	mmf_return_val_if_fail(cmd->cmd_queue, MM_ERROR_CAMCORDER_INVALID_CONDITION);
+	if (cmd->cmd_queue == NULL) {
+		_mmcam_dbg_err("command loop is not created");
+		/* reference of queue is dropped, because it's not queued */
+		__mmcamcorder_unref_command(info);
+		return MM_ERROR_CAMCORDER_INVALID_CONDITION;
+	}
 
-	g_queue_push_tail (cmd->cmd_queue, (gpointer)info);
+	g_mutex_lock(cmd->lock);
 
-	sem_getvalue(&cmd->sema, &value);
+	/* cancel pending command which is reverted by this command.
+	   it's allowed only when the pending command is the next one to be executed,
+	   and the state after both commands is the same with current state. */
+	tail = (__MMCamcorderCmdInfo *)g_queue_peek_tail(cmd->cmd_queue);
+	if (tail && !cmd->executing && g_queue_get_length(cmd->cmd_queue) == 1 &&
+	    __mmcamcorder_is_command_pair(tail->type, info->type, _mmcamcorder_get_state(handle))) {
+		_mmcam_dbg_log("Command %d is cancelled by %d", tail->type, info->type);
 
-	if (value == 0) {
-		sem_post(&cmd->sema);
-	} else {
-		/* Don't need to post. */
+		/* neither is executed, so they are not completed with success */
+		g_queue_pop_tail(cmd->cmd_queue);
+		__mmcamcorder_complete_command(tail, MM_ERROR_CAMCORDER_CMD_IS_RUNNING);
+		__mmcamcorder_complete_command(info, MM_ERROR_CAMCORDER_CMD_IS_RUNNING);
+		cmd->coalesced_count++;
+
+		g_mutex_unlock(cmd->lock);
+
+		return MM_ERROR_NONE;
 	}
 
+	g_queue_push_tail(cmd->cmd_queue, (gpointer)info);
+	g_cond_signal(cmd->cond);
+
+	g_mutex_unlock(cmd->lock);
+
 	return MM_ERROR_NONE;
 }
 
@@ -3282,14 +3823,104 @@ int _mmcamcorder_append_simple_command(MMHandleType handle, _MMCamcorderCommandT
 
 	_mmcam_dbg_log("Command Type=%d", type);
 
-	info = (__MMCamcorderCmdInfo*)malloc(sizeof(__MMCamcorderCmdInfo));
+	info = _mmcamcorder_new_command_info(handle, type);
 
-	info->handle = handle;
-	info->type = type;
+	return _mmcamcorder_append_command(handle, info);
+}
 
-	_mmcamcorder_append_command(handle, info);	
 
-	return MM_ERROR_NONE;
+int _mmcamcorder_append_async_command(MMHandleType handle, _MMCamcorderCommandType type, MMCamcorderCompletionHandle *completion)
+{
+	int ret = MM_ERROR_NONE;
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+	__MMCamcorderCmdInfo *info = NULL;
+
+	mmf_return_val_if_fail(hcamcorder, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+
+	_mmcam_dbg_log("Command Type=%d, completion %p", type, completion);
+
+	/* command loop is created only in async state change mode by default */
+	_MMCAMCORDER_LOCK(handle);
+	if (hcamcorder->cmd.cmd_queue == NULL) {
+		ret = _mmcamcorder_create_command_loop(handle);
+	}
+	_MMCAMCORDER_UNLOCK(handle);
+
+	if (ret != MM_ERROR_NONE) {
+		_mmcam_dbg_err("failed to create command loop");
+		return ret;
+	}
+
+	info = _mmcamcorder_new_command_info(handle, type);
+
+	if (completion) {
+		/* one more reference for completion handle */
+		info->ref_count++;
+		*completion = NULL;
+	}
+
+	ret = _mmcamcorder_append_command(handle, info);
+	if (completion) {
+		if (ret == MM_ERROR_NONE) {
+			*completion = (MMCamcorderCompletionHandle)info;
+		} else {
+			/* reference of queue is already dropped */
+			__mmcamcorder_unref_command(info);
+		}
+	}
+
+	return ret;
+}
+
+
+int _mmcamcorder_wait_command(MMCamcorderCompletionHandle completion, int timeout_ms, int *result)
+{
+	int ret = MM_ERROR_NONE;
+	GTimeVal end_time;
+	__MMCamcorderCmdInfo *info = (__MMCamcorderCmdInfo *)completion;
+
+	mmf_return_val_if_fail(info, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+	mmf_return_val_if_fail(info->lock, MM_ERROR_CAMCORDER_INVALID_CONDITION);
+
+	if (timeout_ms >= 0) {
+		g_get_current_time(&end_time);
+		g_time_val_add(&end_time, (glong)timeout_ms * 1000);
+	}
+
+	g_mutex_lock(info->lock);
+
+	while (!info->done) {
+		if (timeout_ms < 0) {
+			g_cond_wait(info->cond, info->lock);
+		} else if (!g_cond_timed_wait(info->cond, info->lock, &end_time)) {
+			break;
+		}
+	}
+
+	if (info->done) {
+		if (result) {
+			*result = info->result;
+		}
+	} else {
+		_mmcam_dbg_warn("command %d is not completed in %d ms", info->type, timeout_ms);
+		ret = MM_ERROR_CAMCORDER_RESPONSE_TIMEOUT;
+	}
+
+	g_mutex_unlock(info->lock);
+
+	return ret;
+}
+
+
+void _mmcamcorder_release_command(MMCamcorderCompletionHandle completion)
+{
+	__MMCamcorderCmdInfo *info = (__MMCamcorderCmdInfo *)completion;
+
+	mmf_return_if_fail(info);
+
+	__mmcamcorder_unref_command(info);
+
+	return;
 }
 
 
@@ -3307,81 +3938,131 @@ void *_mmcamcorder_command_loop_thread(void *arg)
 
 	_mmcam_dbg_log("");
 
-	while (!bExit_loop) {
-		sem_wait(&cmd->sema);
+	g_mutex_lock(cmd->lock);
 
-		/* send command */
-		while (!g_queue_is_empty (cmd->cmd_queue)) {
-			int bRet = MM_ERROR_NONE;
+	while (!bExit_loop) {
+		int bRet = MM_ERROR_NONE;
 
-			cmdinfo = g_queue_pop_head(cmd->cmd_queue);
-			if (cmdinfo->handle == (MMHandleType)NULL) {
-				_mmcam_dbg_log("Handle in cmdinfo is Null.");
-				bRet = MM_ERROR_CAMCORDER_NOT_INITIALIZED;
-			} else {
-				switch (cmdinfo->type) {
-				case _MMCAMCORDER_CMD_CREATE:
-				case _MMCAMCORDER_CMD_DESTROY:
-				case _MMCAMCORDER_CMD_CAPTURESTART:
-				case _MMCAMCORDER_CMD_CAPTURESTOP:
-				case _MMCAMCORDER_CMD_RECORD:
-				case _MMCAMCORDER_CMD_PAUSE:
-				case _MMCAMCORDER_CMD_COMMIT:
-					__ta__("_mmcamcorder_commit",
-					bRet = _mmcamcorder_commit(cmdinfo->handle);
-					);
-					break;
-				case _MMCAMCORDER_CMD_CANCEL:
-					//Not used yet.
-					break;
-				case _MMCAMCORDER_CMD_REALIZE:
-					__ta__("_mmcamcorder_realize",
-					bRet = _mmcamcorder_realize(cmdinfo->handle);
-					);
-					break;
-				case _MMCAMCORDER_CMD_UNREALIZE:
-					__ta__("_mmcamcorder_unrealize",
-					bRet = _mmcamcorder_unrealize(cmdinfo->handle);
-					);
-					break;
-				case _MMCAMCORDER_CMD_START:
-					__ta__("_mmcamcorder_start",
-					bRet = _mmcamcorder_start(cmdinfo->handle);
-					);
-					break;
-				case _MMCAMCORDER_CMD_STOP:
-					__ta__("_mmcamcorder_stop",
-					bRet = _mmcamcorder_stop(cmdinfo->handle);
-					);
-					break;
-				case _MMCAMCORDER_CMD_QUIT:
-					_mmcam_dbg_log("Exit command loop!!");
-					bExit_loop = TRUE;
-					break;
-				default:
-					_mmcam_dbg_log("Wrong command type!!!");
-					break;
-				}
-			}
+		/* sleep until command is queued */
+		while (g_queue_is_empty(cmd->cmd_queue)) {
+			g_cond_wait(cmd->cond, cmd->lock);
+		}
 
-			if (bRet != MM_ERROR_NONE) {
-				_mmcam_dbg_log("Error on command process!(%x)", bRet);
-				/* Do something? */
-			}
+		cmdinfo = g_queue_pop_head(cmd->cmd_queue);
+		cmd->executing = TRUE;
 
-			_mmcamcorder_delete_command_info(cmdinfo);
+		g_mutex_unlock(cmd->lock);
 
-			if (bExit_loop) {
+		if (cmdinfo->handle == (MMHandleType)NULL) {
+			_mmcam_dbg_log("Handle in cmdinfo is Null.");
+			bRet = MM_ERROR_CAMCORDER_NOT_INITIALIZED;
+		} else {
+			switch (cmdinfo->type) {
+			case _MMCAMCORDER_CMD_CREATE:
+			case _MMCAMCORDER_CMD_DESTROY:
+			case _MMCAMCORDER_CMD_CAPTURESTART:
+			case _MMCAMCORDER_CMD_CAPTURESTOP:
+			case _MMCAMCORDER_CMD_RECORD:
+			case _MMCAMCORDER_CMD_PAUSE:
+			case _MMCAMCORDER_CMD_COMMIT:
+				__ta__("_mmcamcorder_commit",
+				bRet = _mmcamcorder_commit(cmdinfo->handle);
+				);
+				break;
+			case _MMCAMCORDER_CMD_CANCEL:
+				//Not used yet.
+				break;
+			case _MMCAMCORDER_CMD_REALIZE:
+				__ta__("_mmcamcorder_realize",
+				bRet = _mmcamcorder_realize(cmdinfo->handle);
+				);
+				break;
+			case _MMCAMCORDER_CMD_UNREALIZE:
+				__ta__("_mmcamcorder_unrealize",
+				bRet = _mmcamcorder_unrealize(cmdinfo->handle);
+				);
+				break;
+			case _MMCAMCORDER_CMD_START:
+				__ta__("_mmcamcorder_start",
+				bRet = _mmcamcorder_start(cmdinfo->handle);
+				);
+				break;
+			case _MMCAMCORDER_CMD_STOP:
+				__ta__("_mmcamcorder_stop",
+				bRet = _mmcamcorder_stop(cmdinfo->handle);
+				);
+				break;
+			case _MMCAMCORDER_CMD_QUIT:
+				_mmcam_dbg_log("Exit command loop!!");
+				bExit_loop = TRUE;
+				break;
+			default:
+				_mmcam_dbg_log("Wrong command type!!!");
 				break;
 			}
-			usleep(1);
 		}
+
+		if (bRet != MM_ERROR_NONE) {
+			_mmcam_dbg_log("Error on command process!(%x)", bRet);
+		}
+
+		g_mutex_lock(cmd->lock);
+		cmd->executing = FALSE;
+		__mmcamcorder_complete_command(cmdinfo, bRet);
+		cmdinfo = NULL;
 	}
 
+	g_mutex_unlock(cmd->lock);
+
 	return NULL;
 }
 
 
+static gboolean __mmcamcorder_is_command_pair(_MMCamcorderCommandType pending, _MMCamcorderCommandType type, int state)
+{
+	/* pending command which is not started yet has no effect if it is reverted right after,
+	   but only if it's valid in current state. otherwise both should fail as they are. */
+	if ((pending == _MMCAMCORDER_CMD_START && type == _MMCAMCORDER_CMD_STOP && state == MM_CAMCORDER_STATE_READY) ||
+	    (pending == _MMCAMCORDER_CMD_REALIZE && type == _MMCAMCORDER_CMD_UNREALIZE && state == MM_CAMCORDER_STATE_NULL)) {
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+
+/* reference of command queue is dropped */
+static void __mmcamcorder_complete_command(__MMCamcorderCmdInfo *info, int result)
+{
+	g_mutex_lock(info->lock);
+	info->done = TRUE;
+	info->result = result;
+	g_cond_broadcast(info->cond);
+	g_mutex_unlock(info->lock);
+
+	__mmcamcorder_unref_command(info);
+
+	return;
+}
+
+
+static void __mmcamcorder_unref_command(__MMCamcorderCmdInfo *info)
+{
+	gboolean last = FALSE;
+
+	g_mutex_lock(info->lock);
+	info->ref_count--;
+	last = (info->ref_count <= 0);
+	g_mutex_unlock(info->lock);
+
+	if (last) {
+		_mmcamcorder_delete_command_info(info);
+	}
+
+	return;
+}
+
+
 static gboolean __mmcamcorder_handle_gst_error(MMHandleType handle, GstMessage *message, GError *error)
 {
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
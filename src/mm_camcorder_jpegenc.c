@@ -0,0 +1,903 @@
+/*
+ * libmm-camcorder
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jeongmo Yang <jm80.yang@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*=======================================================================================
+|  INCLUDE FILES									|
+=======================================================================================*/
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "mm_camcorder_internal.h"
+#include "mm_camcorder_jpegenc.h"
+
+/*---------------------------------------------------------------------------------------
+|    LOCAL VARIABLE DEFINITIONS for internal						|
+---------------------------------------------------------------------------------------*/
+#define _JPEGENC_COMPONENT_NUM          3
+#define _JPEGENC_HEADER_SIZE_MAX        1024
+
+/* table index */
+enum {
+	_JPEGENC_TABLE_LUMA = 0,
+	_JPEGENC_TABLE_CHROMA,
+	_JPEGENC_TABLE_NUM
+};
+
+/* zigzag position to natural position */
+static const unsigned char __jpegenc_natural_order[64] = {
+	 0,  1,  8, 16,  9,  2,  3, 10,
+	17, 24, 32, 25, 18, 11,  4,  5,
+	12, 19, 26, 33, 40, 48, 41, 34,
+	27, 20, 13,  6,  7, 14, 21, 28,
+	35, 42, 49, 56, 57, 50, 43, 36,
+	29, 22, 15, 23, 30, 37, 44, 51,
+	58, 59, 52, 45, 38, 31, 39, 46,
+	53, 60, 61, 54, 47, 55, 62, 63
+};
+
+/* quantization tables of ITU-T T.81 Annex K, natural order */
+static const unsigned char __jpegenc_std_quant[_JPEGENC_TABLE_NUM][64] = {
+	{
+		16,  11,  10,  16,  24,  40,  51,  61,
+		12,  12,  14,  19,  26,  58,  60,  55,
+		14,  13,  16,  24,  40,  57,  69,  56,
+		14,  17,  22,  29,  51,  87,  80,  62,
+		18,  22,  37,  56,  68, 109, 103,  77,
+		24,  35,  55,  64,  81, 104, 113,  92,
+		49,  64,  78,  87, 103, 121, 120, 101,
+		72,  92,  95,  98, 112, 100, 103,  99
+	},
+	{
+		17,  18,  24,  47,  99,  99,  99,  99,
+		18,  21,  26,  66,  99,  99,  99,  99,
+		24,  26,  56,  99,  99,  99,  99,  99,
+		47,  66,  99,  99,  99,  99,  99,  99,
+		99,  99,  99,  99,  99,  99,  99,  99,
+		99,  99,  99,  99,  99,  99,  99,  99,
+		99,  99,  99,  99,  99,  99,  99,  99,
+		99,  99,  99,  99,  99,  99,  99,  99
+	}
+};
+
+/* huffman tables of ITU-T T.81 Annex K */
+static const unsigned char __jpegenc_dc_bits[_JPEGENC_TABLE_NUM][16] = {
+	{ 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 },
+	{ 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 }
+};
+
+static const unsigned char __jpegenc_dc_vals[12] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11
+};
+
+static const unsigned char __jpegenc_ac_bits[_JPEGENC_TABLE_NUM][16] = {
+	{ 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d },
+	{ 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 }
+};
+
+static const unsigned char __jpegenc_ac_vals[_JPEGENC_TABLE_NUM][162] = {
+	{
+		0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12,
+		0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+		0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08,
+		0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+		0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16,
+		0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+		0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+		0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+		0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
+		0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+		0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79,
+		0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+		0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98,
+		0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+		0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6,
+		0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+		0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4,
+		0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+		0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea,
+		0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+		0xf9, 0xfa
+	},
+	{
+		0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21,
+		0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+		0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91,
+		0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+		0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34,
+		0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+		0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38,
+		0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+		0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58,
+		0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+		0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78,
+		0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+		0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96,
+		0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+		0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4,
+		0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+		0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2,
+		0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+		0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9,
+		0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+		0xf9, 0xfa
+	}
+};
+
+/* scale factors of AAN DCT */
+static const float __jpegenc_aan_scale[8] = {
+	1.0f, 1.387039845f, 1.306562965f, 1.175875602f,
+	1.0f, 0.785694958f, 0.541196100f, 0.275899379f
+};
+
+/* huffman code table */
+typedef struct {
+	unsigned short code[256];
+	unsigned char size[256];
+} _JpegencHuffTable;
+
+/* layout of source frame */
+typedef struct {
+	const unsigned char *y;         /* first luma sample */
+	int y_step;                     /* distance between luma samples in a row */
+	int y_stride;                   /* distance between rows of luma */
+	const unsigned char *u;         /* first Cb sample */
+	const unsigned char *v;         /* first Cr sample */
+	int c_step;                     /* distance between chroma samples in a row */
+	int c_stride;                   /* distance between rows of chroma */
+	int c_vsub;                     /* whether chroma should be subsampled vertically */
+	int width;
+	int height;
+	int c_width;
+	int c_height;
+} _JpegencSource;
+
+/* information which is shared by all slices, read only while encoding */
+typedef struct {
+	_JpegencSource src;
+	unsigned char quant[_JPEGENC_TABLE_NUM][64];    /* natural order */
+	float divisor[_JPEGENC_TABLE_NUM][64];          /* reciprocal of scaled quantizer, natural order */
+	_JpegencHuffTable dc[_JPEGENC_TABLE_NUM];
+	_JpegencHuffTable ac[_JPEGENC_TABLE_NUM];
+	int mcu_cols;
+	int mcu_rows;
+} _JpegencContext;
+
+/* encoded data of a slice */
+typedef struct {
+	const _JpegencContext *ctx;
+	pthread_t thread;
+	int thread_created;
+	int row_start;                  /* first MCU row */
+	int row_end;                    /* MCU row after the last */
+	unsigned char *data;
+	unsigned int size;
+	unsigned int alloc;
+	unsigned int bit_buffer;
+	int bit_count;
+	int error;
+} _JpegencSlice;
+
+/*---------------------------------------------------------------------------------------
+|    LOCAL FUNCTION PROTOTYPES:								|
+---------------------------------------------------------------------------------------*/
+static gboolean __jpegenc_init_source(_JpegencSource *src, const unsigned char *data, int width, int height,
+                                      int format, unsigned int length);
+static void __jpegenc_init_tables(_JpegencContext *ctx, unsigned int quality);
+static void __jpegenc_build_huff_table(_JpegencHuffTable *table, const unsigned char *bits, const unsigned char *vals);
+static unsigned int __jpegenc_write_header(const _JpegencContext *ctx, unsigned char *header);
+static void *__jpegenc_slice_thread(void *arg);
+static void __jpegenc_encode_slice(_JpegencSlice *slice);
+static void __jpegenc_load_block(const _JpegencSource *src, int plane, int x, int y, float *block);
+static void __jpegenc_fdct_1d(float *p, int step);
+static void __jpegenc_fdct(float *data);
+static void __jpegenc_encode_block(_JpegencSlice *slice, float *block, int table, int *last_dc);
+static inline void __jpegenc_put_byte(_JpegencSlice *slice, unsigned char byte);
+static inline void __jpegenc_put_bits(_JpegencSlice *slice, unsigned int bits, int count);
+static void __jpegenc_flush_bits(_JpegencSlice *slice);
+
+/*=======================================================================================
+|  FUNCTION DEFINITIONS									|
+=======================================================================================*/
+/*---------------------------------------------------------------------------------------
+|    GLOBAL FUNCTION DEFINITIONS:							|
+---------------------------------------------------------------------------------------*/
+gboolean _mmcamcorder_jpegenc_is_supported(int src_format)
+{
+	switch (src_format) {
+	case MM_PIXEL_FORMAT_NV12:
+	case MM_PIXEL_FORMAT_I420:
+	case MM_PIXEL_FORMAT_YUYV:
+	case MM_PIXEL_FORMAT_UYVY:
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+
+gboolean _mmcamcorder_jpegenc_encode(void *src_data, unsigned int src_width, unsigned int src_height,
+                                     int src_format, unsigned int src_length, unsigned int jpeg_quality,
+                                     int slice_num, void **result_data, unsigned int *result_length)
+{
+	int i = 0;
+	int error = FALSE;
+	unsigned int header_size = 0;
+	unsigned int total_size = 0;
+	unsigned char *result = NULL;
+	unsigned char *pos = NULL;
+	_JpegencContext *ctx = NULL;
+	_JpegencSlice slice[_MMCAMCORDER_JPEGENC_SLICE_MAX];
+	unsigned char header[_JPEGENC_HEADER_SIZE_MAX];
+
+	mmf_return_val_if_fail(src_data && result_data && result_length, FALSE);
+
+	if (src_width == 0 || src_height == 0 || src_width > 0xffff || src_height > 0xffff) {
+		_mmcam_dbg_err("invalid size %dx%d", src_width, src_height);
+		return FALSE;
+	}
+
+	ctx = (_JpegencContext *)malloc(sizeof(_JpegencContext));
+	if (ctx == NULL) {
+		_mmcam_dbg_err("failed to alloc context");
+		return FALSE;
+	}
+
+	if (!__jpegenc_init_source(&ctx->src, (const unsigned char *)src_data, src_width, src_height, src_format, src_length)) {
+		free(ctx);
+		return FALSE;
+	}
+
+	__jpegenc_init_tables(ctx, jpeg_quality);
+
+	ctx->mcu_cols = (src_width + 15) >> 4;
+	ctx->mcu_rows = (src_height + 15) >> 4;
+
+	if (slice_num < 1) {
+		slice_num = 1;
+	} else if (slice_num > _MMCAMCORDER_JPEGENC_SLICE_MAX) {
+		slice_num = _MMCAMCORDER_JPEGENC_SLICE_MAX;
+	}
+	if (slice_num > ctx->mcu_rows) {
+		slice_num = ctx->mcu_rows;
+	}
+
+	_mmcam_dbg_log("%dx%d, format %d, quality %d, slice %d", src_width, src_height, src_format, jpeg_quality, slice_num);
+
+	/* slice 0 is encoded by calling thread */
+	memset(slice, 0x00, sizeof(slice));
+	for (i = 0 ; i < slice_num ; i++) {
+		slice[i].ctx = ctx;
+		slice[i].row_start = ctx->mcu_rows * i / slice_num;
+		slice[i].row_end = ctx->mcu_rows * (i + 1) / slice_num;
+
+		if (i > 0) {
+			if (pthread_create(&(slice[i].thread), NULL, __jpegenc_slice_thread, &slice[i]) == 0) {
+				slice[i].thread_created = TRUE;
+			} else {
+				_mmcam_dbg_warn("failed to create thread for slice %d, encode it later", i);
+			}
+		}
+	}
+
+	__jpegenc_encode_slice(&slice[0]);
+
+	for (i = 1 ; i < slice_num ; i++) {
+		if (slice[i].thread_created) {
+			pthread_join(slice[i].thread, NULL);
+		} else {
+			__jpegenc_encode_slice(&slice[i]);
+		}
+	}
+
+	header_size = __jpegenc_write_header(ctx, header);
+	total_size = header_size + 2;
+
+	for (i = 0 ; i < slice_num ; i++) {
+		error |= slice[i].error;
+		total_size += slice[i].size;
+	}
+
+	if (!error) {
+		result = (unsigned char *)malloc(total_size);
+	}
+
+	if (result) {
+		pos = result;
+
+		memcpy(pos, header, header_size);
+		pos += header_size;
+
+		for (i = 0 ; i < slice_num ; i++) {
+			memcpy(pos, slice[i].data, slice[i].size);
+			pos += slice[i].size;
+		}
+
+		/* EOI */
+		*pos++ = 0xff;
+		*pos++ = 0xd9;
+
+		*result_data = result;
+		*result_length = total_size;
+
+		_mmcam_dbg_log("JPEG encode length(%d)", total_size);
+	} else {
+		_mmcam_dbg_err("failed to encode, error %d", error);
+	}
+
+	for (i = 0 ; i < slice_num ; i++) {
+		if (slice[i].data) {
+			free(slice[i].data);
+			slice[i].data = NULL;
+		}
+	}
+
+	free(ctx);
+	ctx = NULL;
+
+	return result ? TRUE : FALSE;
+}
+
+
+/*---------------------------------------------------------------------------------------
+|    LOCAL FUNCTION DEFINITIONS:							|
+---------------------------------------------------------------------------------------*/
+static gboolean __jpegenc_init_source(_JpegencSource *src, const unsigned char *data, int width, int height,
+                                      int format, unsigned int length)
+{
+	unsigned int need_length = 0;
+
+	src->width = width;
+	src->height = height;
+	src->c_width = (width + 1) >> 1;
+	src->c_height = (height + 1) >> 1;
+
+	switch (format) {
+	case MM_PIXEL_FORMAT_NV12:
+		src->y = data;
+		src->y_step = 1;
+		src->y_stride = width;
+		src->u = data + width * height;
+		src->v = src->u + 1;
+		src->c_step = 2;
+		src->c_stride = src->c_width << 1;
+		src->c_vsub = FALSE;
+		need_length = width * height + src->c_stride * src->c_height;
+		break;
+	case MM_PIXEL_FORMAT_I420:
+		src->y = data;
+		src->y_step = 1;
+		src->y_stride = width;
+		src->u = data + width * height;
+		src->v = src->u + src->c_width * src->c_height;
+		src->c_step = 1;
+		src->c_stride = src->c_width;
+		src->c_vsub = FALSE;
+		need_length = width * height + ((src->c_width * src->c_height) << 1);
+		break;
+	case MM_PIXEL_FORMAT_YUYV:
+		src->y = data;
+		src->y_step = 2;
+		src->y_stride = src->c_width << 2;
+		src->u = data + 1;
+		src->v = data + 3;
+		src->c_step = 4;
+		src->c_stride = src->y_stride;
+		src->c_vsub = TRUE;
+		need_length = src->y_stride * height;
+		break;
+	case MM_PIXEL_FORMAT_UYVY:
+		src->y = data + 1;
+		src->y_step = 2;
+		src->y_stride = src->c_width << 2;
+		src->u = data;
+		src->v = data + 2;
+		src->c_step = 4;
+		src->c_stride = src->y_stride;
+		src->c_vsub = TRUE;
+		need_length = src->y_stride * height;
+		break;
+	default:
+		_mmcam_dbg_err("not supported format %d", format);
+		return FALSE;
+	}
+
+	if (length < need_length) {
+		_mmcam_dbg_err("too short source %d, it should be %d at least", length, need_length);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+
+static void __jpegenc_init_tables(_JpegencContext *ctx, unsigned int quality)
+{
+	int i = 0;
+	int t = 0;
+	int scale = 0;
+	int value = 0;
+
+	/* same scaling with IJG */
+	if (quality < 1) {
+		quality = 1;
+	} else if (quality > 100) {
+		quality = 100;
+	}
+
+	if (quality < 50) {
+		scale = 5000 / quality;
+	} else {
+		scale = 200 - (quality << 1);
+	}
+
+	for (t = 0 ; t < _JPEGENC_TABLE_NUM ; t++) {
+		for (i = 0 ; i < 64 ; i++) {
+			value = (__jpegenc_std_quant[t][i] * scale + 50) / 100;
+			if (value < 1) {
+				value = 1;
+			} else if (value > 255) {
+				value = 255;
+			}
+
+			ctx->quant[t][i] = (unsigned char)value;
+			ctx->divisor[t][i] = 1.0f / (value * __jpegenc_aan_scale[i >> 3] * __jpegenc_aan_scale[i & 7] * 8.0f);
+		}
+
+		__jpegenc_build_huff_table(&ctx->dc[t], __jpegenc_dc_bits[t], __jpegenc_dc_vals);
+		__jpegenc_build_huff_table(&ctx->ac[t], __jpegenc_ac_bits[t], __jpegenc_ac_vals[t]);
+	}
+
+	return;
+}
+
+
+static void __jpegenc_build_huff_table(_JpegencHuffTable *table, const unsigned char *bits, const unsigned char *vals)
+{
+	int i = 0;
+	int j = 0;
+	int k = 0;
+	unsigned int code = 0;
+
+	memset(table, 0x00, sizeof(_JpegencHuffTable));
+
+	for (i = 0 ; i < 16 ; i++) {
+		for (j = 0 ; j < bits[i] ; j++) {
+			table->code[vals[k]] = (unsigned short)code;
+			table->size[vals[k]] = (unsigned char)(i + 1);
+			code++;
+			k++;
+		}
+		code <<= 1;
+	}
+
+	return;
+}
+
+
+static unsigned int __jpegenc_write_header(const _JpegencContext *ctx, unsigned char *header)
+{
+	int i = 0;
+	int t = 0;
+	int count = 0;
+	unsigned char *pos = header;
+	unsigned int length = 0;
+
+	/* SOI */
+	*pos++ = 0xff;
+	*pos++ = 0xd8;
+
+	/* DQT, zigzag order */
+	*pos++ = 0xff;
+	*pos++ = 0xdb;
+	*pos++ = 0x00;
+	*pos++ = 2 + _JPEGENC_TABLE_NUM * 65;
+	for (t = 0 ; t < _JPEGENC_TABLE_NUM ; t++) {
+		*pos++ = t;
+		for (i = 0 ; i < 64 ; i++) {
+			*pos++ = ctx->quant[t][__jpegenc_natural_order[i]];
+		}
+	}
+
+	/* SOF0 - Y 2x2, Cb 1x1, Cr 1x1 */
+	*pos++ = 0xff;
+	*pos++ = 0xc0;
+	*pos++ = 0x00;
+	*pos++ = 8 + _JPEGENC_COMPONENT_NUM * 3;
+	*pos++ = 8;
+	*pos++ = (ctx->src.height >> 8) & 0xff;
+	*pos++ = ctx->src.height & 0xff;
+	*pos++ = (ctx->src.width >> 8) & 0xff;
+	*pos++ = ctx->src.width & 0xff;
+	*pos++ = _JPEGENC_COMPONENT_NUM;
+	for (i = 0 ; i < _JPEGENC_COMPONENT_NUM ; i++) {
+		*pos++ = i + 1;
+		*pos++ = (i == 0) ? 0x22 : 0x11;
+		*pos++ = (i == 0) ? _JPEGENC_TABLE_LUMA : _JPEGENC_TABLE_CHROMA;
+	}
+
+	/* DHT */
+	length = 2;
+	for (t = 0 ; t < _JPEGENC_TABLE_NUM ; t++) {
+		length += 17 + sizeof(__jpegenc_dc_vals);
+		length += 17 + sizeof(__jpegenc_ac_vals[t]);
+	}
+	*pos++ = 0xff;
+	*pos++ = 0xc4;
+	*pos++ = (length >> 8) & 0xff;
+	*pos++ = length & 0xff;
+	for (t = 0 ; t < _JPEGENC_TABLE_NUM ; t++) {
+		*pos++ = 0x00 | t;
+		for (i = 0, count = 0 ; i < 16 ; i++) {
+			*pos++ = __jpegenc_dc_bits[t][i];
+			count += __jpegenc_dc_bits[t][i];
+		}
+		memcpy(pos, __jpegenc_dc_vals, count);
+		pos += count;
+
+		*pos++ = 0x10 | t;
+		for (i = 0, count = 0 ; i < 16 ; i++) {
+			*pos++ = __jpegenc_ac_bits[t][i];
+			count += __jpegenc_ac_bits[t][i];
+		}
+		memcpy(pos, __jpegenc_ac_vals[t], count);
+		pos += count;
+	}
+
+	/* DRI - restart by MCU row */
+	*pos++ = 0xff;
+	*pos++ = 0xdd;
+	*pos++ = 0x00;
+	*pos++ = 0x04;
+	*pos++ = (ctx->mcu_cols >> 8) & 0xff;
+	*pos++ = ctx->mcu_cols & 0xff;
+
+	/* SOS */
+	*pos++ = 0xff;
+	*pos++ = 0xda;
+	*pos++ = 0x00;
+	*pos++ = 6 + _JPEGENC_COMPONENT_NUM * 2;
+	*pos++ = _JPEGENC_COMPONENT_NUM;
+	for (i = 0 ; i < _JPEGENC_COMPONENT_NUM ; i++) {
+		*pos++ = i + 1;
+		*pos++ = (i == 0) ? 0x00 : 0x11;
+	}
+	*pos++ = 0;
+	*pos++ = 63;
+	*pos++ = 0;
+
+	return (unsigned int)(pos - header);
+}
+
+
+static void *__jpegenc_slice_thread(void *arg)
+{
+	__jpegenc_encode_slice((_JpegencSlice *)arg);
+
+	return NULL;
+}
+
+
+static void __jpegenc_encode_slice(_JpegencSlice *slice)
+{
+	int row = 0;
+	int col = 0;
+	int last_dc[_JPEGENC_COMPONENT_NUM];
+	float block[64];
+	const _JpegencContext *ctx = slice->ctx;
+
+	/* rough estimation, it grows if needed */
+	slice->alloc = ((ctx->src.width * 16 * (slice->row_end - slice->row_start)) >> 2) + 1024;
+	slice->data = (unsigned char *)malloc(slice->alloc);
+	if (slice->data == NULL) {
+		slice->error = TRUE;
+		return;
+	}
+
+	for (row = slice->row_start ; row < slice->row_end && !slice->error ; row++) {
+		/* restart marker between MCU rows, the number depends on row only */
+		if (row > 0) {
+			__jpegenc_put_byte(slice, 0xff);
+			__jpegenc_put_byte(slice, 0xd0 + ((row - 1) & 7));
+		}
+
+		last_dc[0] = last_dc[1] = last_dc[2] = 0;
+
+		for (col = 0 ; col < ctx->mcu_cols ; col++) {
+			/* Y */
+			__jpegenc_load_block(&ctx->src, 0, col << 4, row << 4, block);
+			__jpegenc_encode_block(slice, block, _JPEGENC_TABLE_LUMA, &last_dc[0]);
+			__jpegenc_load_block(&ctx->src, 0, (col << 4) + 8, row << 4, block);
+			__jpegenc_encode_block(slice, block, _JPEGENC_TABLE_LUMA, &last_dc[0]);
+			__jpegenc_load_block(&ctx->src, 0, col << 4, (row << 4) + 8, block);
+			__jpegenc_encode_block(slice, block, _JPEGENC_TABLE_LUMA, &last_dc[0]);
+			__jpegenc_load_block(&ctx->src, 0, (col << 4) + 8, (row << 4) + 8, block);
+			__jpegenc_encode_block(slice, block, _JPEGENC_TABLE_LUMA, &last_dc[0]);
+
+			/* Cb, Cr */
+			__jpegenc_load_block(&ctx->src, 1, col << 3, row << 3, block);
+			__jpegenc_encode_block(slice, block, _JPEGENC_TABLE_CHROMA, &last_dc[1]);
+			__jpegenc_load_block(&ctx->src, 2, col << 3, row << 3, block);
+			__jpegenc_encode_block(slice, block, _JPEGENC_TABLE_CHROMA, &last_dc[2]);
+		}
+
+		__jpegenc_flush_bits(slice);
+	}
+
+	return;
+}
+
+
+static void __jpegenc_load_block(const _JpegencSource *src, int plane, int x, int y, float *block)
+{
+	int i = 0;
+	int j = 0;
+	int sx = 0;
+	int sy = 0;
+	int sy2 = 0;
+	int col[8];
+	const unsigned char *base = NULL;
+	const unsigned char *line = NULL;
+	const unsigned char *line2 = NULL;
+
+	/* samples out of frame are replaced with the edge */
+	if (plane == 0) {
+		for (i = 0 ; i < 8 ; i++) {
+			sx = (x + i < src->width) ? x + i : src->width - 1;
+			col[i] = sx * src->y_step;
+		}
+
+		for (j = 0 ; j < 8 ; j++) {
+			sy = (y + j < src->height) ? y + j : src->height - 1;
+			line = src->y + sy * src->y_stride;
+			for (i = 0 ; i < 8 ; i++) {
+				*block++ = (float)line[col[i]] - 128.0f;
+			}
+		}
+
+		return;
+	}
+
+	base = (plane == 1) ? src->u : src->v;
+
+	for (i = 0 ; i < 8 ; i++) {
+		sx = (x + i < src->c_width) ? x + i : src->c_width - 1;
+		col[i] = sx * src->c_step;
+	}
+
+	for (j = 0 ; j < 8 ; j++) {
+		sy = (y + j < src->c_height) ? y + j : src->c_height - 1;
+		if (src->c_vsub) {
+			/* 4:2:2 packed source, average two lines */
+			sy2 = (sy << 1) + 1 < src->height ? (sy << 1) + 1 : (sy << 1);
+			line = base + (sy << 1) * src->c_stride;
+			line2 = base + sy2 * src->c_stride;
+			for (i = 0 ; i < 8 ; i++) {
+				*block++ = (float)((line[col[i]] + line2[col[i]] + 1) >> 1) - 128.0f;
+			}
+		} else {
+			line = base + sy * src->c_stride;
+			for (i = 0 ; i < 8 ; i++) {
+				*block++ = (float)line[col[i]] - 128.0f;
+			}
+		}
+	}
+
+	return;
+}
+
+
+static void __jpegenc_fdct_1d(float *p, int step)
+{
+	float tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
+	float tmp10, tmp11, tmp12, tmp13;
+	float z1, z2, z3, z4, z5, z11, z13;
+
+	tmp0 = p[0] + p[7 * step];
+	tmp7 = p[0] - p[7 * step];
+	tmp1 = p[1 * step] + p[6 * step];
+	tmp6 = p[1 * step] - p[6 * step];
+	tmp2 = p[2 * step] + p[5 * step];
+	tmp5 = p[2 * step] - p[5 * step];
+	tmp3 = p[3 * step] + p[4 * step];
+	tmp4 = p[3 * step] - p[4 * step];
+
+	/* even part */
+	tmp10 = tmp0 + tmp3;
+	tmp13 = tmp0 - tmp3;
+	tmp11 = tmp1 + tmp2;
+	tmp12 = tmp1 - tmp2;
+
+	p[0] = tmp10 + tmp11;
+	p[4 * step] = tmp10 - tmp11;
+
+	z1 = (tmp12 + tmp13) * 0.707106781f;
+	p[2 * step] = tmp13 + z1;
+	p[6 * step] = tmp13 - z1;
+
+	/* odd part */
+	tmp10 = tmp4 + tmp5;
+	tmp11 = tmp5 + tmp6;
+	tmp12 = tmp6 + tmp7;
+
+	z5 = (tmp10 - tmp12) * 0.382683433f;
+	z2 = 0.541196100f * tmp10 + z5;
+	z4 = 1.306562965f * tmp12 + z5;
+	z3 = tmp11 * 0.707106781f;
+
+	z11 = tmp7 + z3;
+	z13 = tmp7 - z3;
+
+	p[5 * step] = z13 + z2;
+	p[3 * step] = z13 - z2;
+	p[1 * step] = z11 + z4;
+	p[7 * step] = z11 - z4;
+
+	return;
+}
+
+
+static void __jpegenc_fdct(float *data)
+{
+	int i = 0;
+
+	/* AAN algorithm, output is scaled by __jpegenc_aan_scale */
+	for (i = 0 ; i < 8 ; i++) {
+		__jpegenc_fdct_1d(data + (i << 3), 1);
+	}
+
+	for (i = 0 ; i < 8 ; i++) {
+		__jpegenc_fdct_1d(data + i, 8);
+	}
+
+	return;
+}
+
+
+static void __jpegenc_encode_block(_JpegencSlice *slice, float *block, int table, int *last_dc)
+{
+	int i = 0;
+	int run = 0;
+	int value = 0;
+	int temp = 0;
+	int nbits = 0;
+	float scaled = 0;
+	int coef[64];
+	const _JpegencContext *ctx = slice->ctx;
+	const _JpegencHuffTable *dc = &ctx->dc[table];
+	const _JpegencHuffTable *ac = &ctx->ac[table];
+
+	__jpegenc_fdct(block);
+
+	/* quantize in zigzag order */
+	for (i = 0 ; i < 64 ; i++) {
+		scaled = block[__jpegenc_natural_order[i]] * ctx->divisor[table][__jpegenc_natural_order[i]];
+		coef[i] = (int)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+	}
+
+	/* DC difference */
+	value = temp = coef[0] - *last_dc;
+	*last_dc = coef[0];
+
+	if (temp < 0) {
+		temp = -temp;
+		value--;
+	}
+	for (nbits = 0 ; temp ; nbits++) {
+		temp >>= 1;
+	}
+
+	__jpegenc_put_bits(slice, dc->code[nbits], dc->size[nbits]);
+	if (nbits) {
+		__jpegenc_put_bits(slice, value & ((1 << nbits) - 1), nbits);
+	}
+
+	/* AC */
+	for (i = 1 ; i < 64 ; i++) {
+		value = temp = coef[i];
+		if (temp == 0) {
+			run++;
+			continue;
+		}
+
+		/* ZRL */
+		while (run > 15) {
+			__jpegenc_put_bits(slice, ac->code[0xf0], ac->size[0xf0]);
+			run -= 16;
+		}
+
+		if (temp < 0) {
+			temp = -temp;
+			value--;
+		}
+		for (nbits = 1 ; (temp >>= 1) ; nbits++) {
+			;
+		}
+
+		__jpegenc_put_bits(slice, ac->code[(run << 4) + nbits], ac->size[(run << 4) + nbits]);
+		__jpegenc_put_bits(slice, value & ((1 << nbits) - 1), nbits);
+
+		run = 0;
+	}
+
+	/* EOB */
+	if (run > 0) {
+		__jpegenc_put_bits(slice, ac->code[0x00], ac->size[0x00]);
+	}
+
+	return;
+}
+
+
+static inline void __jpegenc_put_byte(_JpegencSlice *slice, unsigned char byte)
+{
+	unsigned char *data = NULL;
+
+	if (slice->size >= slice->alloc) {
+		data = (unsigned char *)realloc(slice->data, slice->alloc << 1);
+		if (data == NULL) {
+			slice->error = TRUE;
+			return;
+		}
+
+		slice->data = data;
+		slice->alloc <<= 1;
+	}
+
+	slice->data[slice->size++] = byte;
+
+	return;
+}
+
+
+static inline void __jpegenc_put_bits(_JpegencSlice *slice, unsigned int bits, int count)
+{
+	unsigned char byte = 0;
+
+	slice->bit_buffer = (slice->bit_buffer << count) | bits;
+	slice->bit_count += count;
+
+	while (slice->bit_count >= 8) {
+		slice->bit_count -= 8;
+		byte = (unsigned char)(slice->bit_buffer >> slice->bit_count);
+		__jpegenc_put_byte(slice, byte);
+
+		/* byte stuffing */
+		if (byte == 0xff) {
+			__jpegenc_put_byte(slice, 0x00);
+		}
+	}
+
+	return;
+}
+
+
+static void __jpegenc_flush_bits(_JpegencSlice *slice)
+{
+	/* pad with 1 bits to byte boundary */
+	if (slice->bit_count > 0) {
+		__jpegenc_put_bits(slice, (1 << (8 - slice->bit_count)) - 1, 8 - slice->bit_count);
+	}
+
+	slice->bit_buffer = 0;
+	slice->bit_count = 0;
+
+	return;
+}
@@ -42,17 +42,43 @@
 /*---------------------------------------------------------------------------------------
 |    LOCAL VARIABLE DEFINITIONS for internal						|
 ---------------------------------------------------------------------------------------*/
+/* data to check arrival of new preview frame */
+typedef struct {
+	_MMCamcorderSubContext *sc;
+	unsigned int framecount;
+} _MMCamcorderPreviewFrameCheck;
+
+/* captured frame which is encoded by encode pool */
+typedef struct {
+	mmf_camcorder_t *hcamcorder;
+	GstBuffer *buffer1;
+	GstBuffer *buffer2;
+	GstBuffer *buffer3;
+	int pixtype;
+	int quality;
+	MMCamcorderCaptureDataType dest;
+	void *encoded_data;
+} _MMCamcorderCaptureJob;
 
 
 /*---------------------------------------------------------------------------------------
 |    LOCAL FUNCTION PROTOTYPES:								|
 ---------------------------------------------------------------------------------------*/
 /** STATIC INTERNAL FUNCTION **/
+static gboolean __mmcamcorder_check_new_preview_frame(gpointer data);
 /* Functions for JPEG capture without Encode bin */
 int _mmcamcorder_image_cmd_capture(MMHandleType handle);
 int _mmcamcorder_image_cmd_preview_start(MMHandleType handle);
 int _mmcamcorder_image_cmd_preview_stop(MMHandleType handle);
 static void __mmcamcorder_image_capture_cb(GstElement *element, GstBuffer *buffer1, GstBuffer *buffer2, GstBuffer *buffer3, gpointer u_data);
+static void __mmcamcorder_image_capture_deliver(mmf_camcorder_t *hcamcorder, GstBuffer *buffer1, GstBuffer *buffer2, GstBuffer *buffer3,
+                                                int pixtype, MMCamcorderCaptureDataType *dest, void *encoded_data);
+static void __mmcamcorder_image_capture_finish(mmf_camcorder_t *hcamcorder, int count,
+                                               GstBuffer *buffer1, GstBuffer *buffer2, GstBuffer *buffer3, void *encoded_data);
+static gboolean __mmcamcorder_capture_encode_job(gpointer data);
+static void __mmcamcorder_capture_deliver_job(gpointer data, gboolean result, gpointer user_data);
+static int __mmcamcorder_write_exif_basic_info(MMHandleType handle, int image_width, int image_height,
+                                               mm_exif_template_t *tmpl, ExifData *ed);
 
 /* Functions for JPEG capture with Encode bin */
 int _mmcamcorder_image_cmd_capture_with_encbin(MMHandleType handle);
@@ -187,6 +213,7 @@ int _mmcamcorder_remove_stillshot_pipeline(MMHandleType handle)
 	/* Check pipeline */
 	if (sc->element[_MMCAMCORDER_MAIN_PIPE].gst) {
 		_mmcamcorder_remove_all_handlers(handle, _MMCAMCORDER_HANDLER_STILLSHOT);
+		_mmcamcorder_encode_pool_stop(&sc->encode_pool);
 
 		if (sc->bencbin_capture) {
 			GstPad *srcpad = NULL, *sinkpad = NULL;
@@ -391,6 +418,32 @@ int _mmcamcorder_image_cmd_capture(MMHandleType handle)
 
 		_mmcam_dbg_log("capture format (%d)", cap_format);
 
+		/* multi shot frames are encoded by several threads */
+		if (sc->internal_encode && info->type == _MMCamcorder_MULTI_SHOT) {
+			int encode_thread = 0;
+			int encode_max_in_flight = 0;
+
+			_mmcamcorder_conf_get_value_int(hcamcorder->conf_main,
+			                                CONFIGURE_CATEGORY_MAIN_CAPTURE,
+			                                "EncodeThread",
+			                                &encode_thread);
+			_mmcamcorder_conf_get_value_int(hcamcorder->conf_main,
+			                                CONFIGURE_CATEGORY_MAIN_CAPTURE,
+			                                "EncodeMaxInFlight",
+			                                &encode_max_in_flight);
+
+			/* 0 means number of online cores */
+			if (encode_thread <= 0) {
+				encode_thread = (int)sysconf(_SC_NPROCESSORS_ONLN);
+			}
+
+			if (encode_thread > 1 &&
+			    !_mmcamcorder_encode_pool_start(&sc->encode_pool, encode_thread, encode_max_in_flight,
+			                                    __mmcamcorder_capture_encode_job, __mmcamcorder_capture_deliver_job, NULL)) {
+				_mmcam_dbg_warn("failed to start encode pool, encode in capture callback");
+			}
+		}
+
 		/* Note: width/height of capture is set in commit function of attribute or in create function of pipeline */
 		MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_VIDEOSRC_SRC].gst, "capture-fourcc", cap_fourcc);
 		MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_VIDEOSRC_SRC].gst, "capture-interval", info->interval);
@@ -532,6 +585,9 @@ int _mmcamcorder_image_cmd_preview_start(MMHandleType handle)
 	sc->display_interval = 0;
 	sc->previous_slot_time = 0;
 
+	/* wait for delivery of frames which are encoded by encode pool */
+	_mmcamcorder_encode_pool_drain(&sc->encode_pool);
+
 	/* Image info */
 	info->capture_cur_count = 0;
 	info->capture_send_count = 0;
@@ -645,7 +701,8 @@ int _mmcamcorder_image_cmd_preview_start(MMHandleType handle)
 
 	if (state == GST_STATE_PLAYING) {
 		if (!strcmp(videosrc_name, "avsysvideosrc") || !strcmp(videosrc_name, "camerasrc")) {
-			int try_count = 0;
+			gboolean frame_done = TRUE;
+			_MMCamcorderPreviewFrameCheck frame_check;
 
 			if (info->preview_format != MM_PIXEL_FORMAT_ITLV_JPEG_UYVY) {
 				mmf_attrs_t *attr = (mmf_attrs_t *)MMF_CAMCORDER_ATTRS(handle);
@@ -660,11 +717,12 @@ int _mmcamcorder_image_cmd_preview_start(MMHandleType handle)
 					);
 				}
 
+				frame_check.sc = sc;
+				frame_check.framecount = current_framecount;
+
 				__ta__("    Wait preview frame after capture",
-				while (current_framecount >= sc->kpi.video_framecount &&
-				       try_count++ < _MMCAMCORDER_CAPTURE_STOP_CHECK_COUNT) {
-					usleep(_MMCAMCORDER_CAPTURE_STOP_CHECK_INTERVAL);
-				}
+				frame_done = _mmcamcorder_frame_notifier_wait(&(sc->frame_notifier), __mmcamcorder_check_new_preview_frame,
+				                                              &frame_check, _MMCAMCORDER_CAPTURE_STOP_TIMEOUT);
 				);
 			}
 
@@ -672,8 +730,8 @@ int _mmcamcorder_image_cmd_preview_start(MMHandleType handle)
 				MMCAMCORDER_G_OBJECT_SET( sc->element[_MMCAMCORDER_VIDEOSINK_QUE].gst, "empty-buffers", FALSE);
 			}
 
-			_mmcam_dbg_log("Wait Frame Done. count before[%d],after[%d], try_count[%d]",
-			               current_framecount, sc->kpi.video_framecount, try_count);
+			_mmcam_dbg_log("Wait Frame Done. count before[%d],after[%d], done[%d]",
+			               current_framecount, sc->kpi.video_framecount, frame_done);
 		} else {
 			ret = _mmcamcorder_gst_set_state(handle, pipeline, GST_STATE_READY);
 			MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_VIDEOSINK_QUE].gst, "empty-buffers", FALSE);
@@ -734,6 +792,9 @@ int _mmcamcorder_image_cmd_preview_stop(MMHandleType handle)
 
 	pipeline = sc->element[_MMCAMCORDER_MAIN_PIPE].gst;
 
+	/* captured frames should be returned to camerasrc before stop */
+	_mmcamcorder_encode_pool_drain(&sc->encode_pool);
+
 	MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_VIDEOSINK_QUE].gst, "empty-buffers", TRUE);
 	ret = _mmcamcorder_gst_set_state(handle, pipeline, GST_STATE_READY);
 	MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_VIDEOSINK_QUE].gst, "empty-buffers", FALSE);
@@ -1084,14 +1145,19 @@ int _mmcamcorder_image_cmd_preview_start_with_encbin(MMHandleType handle)
 
 	if (state == GST_STATE_PLAYING) {
 		if (!strcmp(videosrc_name, "avsysvideosrc") || !strcmp(videosrc_name, "camerasrc")) {
+			gboolean frame_done = FALSE;
+			_MMCamcorderPreviewFrameCheck frame_check;
+
+			frame_check.sc = sc;
+			frame_check.framecount = current_framecount;
+
 			__ta__( "    Wait preview frame after capture",
-			while (current_framecount == sc->kpi.video_framecount) {
-				usleep(_MMCAMCORDER_CAPTURE_STOP_CHECK_INTERVAL);
-			}
+			frame_done = _mmcamcorder_frame_notifier_wait(&(sc->frame_notifier), __mmcamcorder_check_new_preview_frame,
+			                                              &frame_check, _MMCAMCORDER_CAPTURE_STOP_TIMEOUT);
 			);
 
-			_mmcam_dbg_log("Wait Frame Done. count before[%d],after[%d]",
-			               current_framecount, sc->kpi.video_framecount);
+			_mmcam_dbg_log("Wait Frame Done. count before[%d],after[%d], done[%d]",
+			               current_framecount, sc->kpi.video_framecount, frame_done);
 		} else {
 #if 1
 			MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_VIDEOSINK_QUE].gst, "empty-buffers", TRUE);
@@ -1248,14 +1314,23 @@ void __mmcamcorder_init_stillshot_info (MMHandleType handle)
 
 int __mmcamcorder_capture_save_exifinfo(MMHandleType handle, MMCamcorderCaptureDataType *original, MMCamcorderCaptureDataType *thumbnail)
 {
+	int i = 0;
 	int ret = MM_ERROR_NONE;
+	int segmented = FALSE;
 	unsigned char *data = NULL;
 	unsigned int datalen = 0;
 
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderSubContext *sc = NULL;
+	mm_exif_info_t *exif_info = NULL;
 
 	mmf_return_val_if_fail(hcamcorder, FALSE);
 
+	sc = MMF_CAMCORDER_SUBCONTEXT(hcamcorder);
+	mmf_return_val_if_fail(sc, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+
+	exif_info = hcamcorder->exif_info;
+
 	_mmcam_dbg_log("");
 
 	if (!original || original->data == NULL || original->length == 0) {
@@ -1267,19 +1342,31 @@ int __mmcamcorder_capture_save_exifinfo(MMHandleType handle, MMCamcorderCaptureD
 		datalen = original->length;
 	}
 
+	/* EXIF with thumbnail of previous image */
+	if (sc->capture_exif.data) {
+		free(sc->capture_exif.data);
+		sc->capture_exif.data = NULL;
+		sc->capture_exif.size = 0;
+	}
+
 	if (thumbnail) {
 		if (thumbnail->data && thumbnail->length > 0) {
 			_mmcam_dbg_log("thumbnail is added!thumbnail->data=%p thumbnail->width=%d ,thumbnail->height=%d",
 			               thumbnail->data, thumbnail->width, thumbnail->height);
 
-			/* add thumbnail exif info */
-			__ta__("                    mm_exif_add_thumbnail_info",
-			ret = mm_exif_add_thumbnail_info(hcamcorder->exif_info,
-			                                 thumbnail->data,
-			                                 thumbnail->width,
-			                                 thumbnail->height,
-			                                 thumbnail->length);
+			/* add thumbnail exif info. EXIF info of handle is not changed,
+			   because it could be shared with application as EXIF raw data. */
+			__ta__("                    mm_exif_make_thumbnail_info",
+			ret = mm_exif_make_thumbnail_info(&sc->capture_exif,
+			                                  hcamcorder->exif_info,
+			                                  thumbnail->data,
+			                                  thumbnail->width,
+			                                  thumbnail->height,
+			                                  thumbnail->length);
 			);
+			if (ret == MM_ERROR_NONE && sc->capture_exif.data) {
+				exif_info = &sc->capture_exif;
+			}
 		} else {
 			_mmcam_dbg_err("Skip adding thumbnail (data=%p, length=%d)",
 			               thumbnail->data, thumbnail->length);
@@ -1287,12 +1374,34 @@ int __mmcamcorder_capture_save_exifinfo(MMHandleType handle, MMCamcorderCaptureD
 	}
 
 	if (ret == MM_ERROR_NONE) {
-		/* write jpeg with exif */
-		__ta__("                    mm_exif_write_exif_jpeg_to_memory",
-		ret = mm_exif_write_exif_jpeg_to_memory(&original->data, &original->length ,hcamcorder->exif_info,  data, datalen);
-		);
-		if (ret != MM_ERROR_NONE) {
-			_mmcam_dbg_err("mm_exif_write_exif_jpeg_to_memory error! [0x%x]",ret);
+		mm_camcorder_get_attributes(handle, NULL, MMCAM_CAPTURE_SEGMENTED, &segmented, NULL);
+		if (segmented) {
+			/* deliver header, exif and jpeg as they are without copying */
+			ret = mm_exif_make_exif_jpeg_segment(&sc->capture_jpeg, exif_info, data, datalen);
+			if (ret == MM_ERROR_NONE) {
+				for (i = 0 ; i < sc->capture_jpeg.segment_num ; i++) {
+					sc->capture_segment[i].data = sc->capture_jpeg.segment[i].iov_base;
+					sc->capture_segment[i].length = sc->capture_jpeg.segment[i].iov_len;
+				}
+
+				original->data = NULL;
+				original->length = sc->capture_jpeg.length;
+				original->segment = sc->capture_segment;
+				original->segment_num = sc->capture_jpeg.segment_num;
+
+				_mmcam_dbg_log("JPEG with EXIF is delivered by %d segments, length %d",
+				               original->segment_num, original->length);
+			} else {
+				_mmcam_dbg_err("mm_exif_make_exif_jpeg_segment error! [0x%x]",ret);
+			}
+		} else {
+			/* write jpeg with exif */
+			__ta__("                    mm_exif_write_exif_jpeg_to_memory",
+			ret = mm_exif_write_exif_jpeg_to_memory(&original->data, &original->length ,exif_info,  data, datalen);
+			);
+			if (ret != MM_ERROR_NONE) {
+				_mmcam_dbg_err("mm_exif_write_exif_jpeg_to_memory error! [0x%x]",ret);
+			}
 		}
 	}
 
@@ -1366,6 +1475,39 @@ int __mmcamcorder_set_jpeg_data(MMHandleType handle, MMCamcorderCaptureDataType
 }
 
 
+void __mmcamcorder_set_capture_segment(MMHandleType handle, MMCamcorderCaptureDataType *dest)
+{
+	int segmented = FALSE;
+
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderSubContext *sc = NULL;
+
+	mmf_return_if_fail(hcamcorder && dest);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(hcamcorder);
+	mmf_return_if_fail(sc);
+
+	/* already delivered by segments */
+	if (dest->segment || dest->data == NULL) {
+		return;
+	}
+
+	mm_camcorder_get_attributes(handle, NULL, MMCAM_CAPTURE_SEGMENTED, &segmented, NULL);
+	if (!segmented) {
+		return;
+	}
+
+	/* contiguous image is delivered as one segment */
+	sc->capture_segment[0].data = dest->data;
+	sc->capture_segment[0].length = dest->length;
+
+	dest->segment = sc->capture_segment;
+	dest->segment_num = 1;
+
+	return;
+}
+
+
 void __mmcamcorder_release_jpeg_data(MMHandleType handle, MMCamcorderCaptureDataType *dest)
 {
 	int tag_enable = 0;
@@ -1387,6 +1529,17 @@ void __mmcamcorder_release_jpeg_data(MMHandleType handle, MMCamcorderCaptureData
 	MMCAMCORDER_G_OBJECT_GET(sc->element[_MMCAMCORDER_VIDEOSRC_SRC].gst, "provide-exif", &provide_exif);
 	);
 
+	/* segments point EXIF info and encoded data, and they are released with them */
+	dest->segment = NULL;
+	dest->segment_num = 0;
+
+	/* EXIF with thumbnail is not needed after delivery */
+	if (sc->capture_exif.data) {
+		free(sc->capture_exif.data);
+		sc->capture_exif.data = NULL;
+		sc->capture_exif.size = 0;
+	}
+
 	/* if dest->data is allocated in MSL, release it */
 	if (tag_enable && !provide_exif) {
 		if (dest->data) {
@@ -1409,25 +1562,13 @@ static void __mmcamcorder_image_capture_cb(GstElement *element, GstBuffer *buffe
 {
 	int ret = MM_ERROR_NONE;
 	int pixtype = MM_PIXEL_FORMAT_INVALID;
-	int pixtype_sub = MM_PIXEL_FORMAT_INVALID;
-	int codectype = MM_IMAGE_CODEC_JPEG;
-	int attr_index = 0;
-	int count = 0;
 	int stop_cont_shot = 0;
-	int tag_enable = FALSE;
-	int provide_exif = FALSE;
-	unsigned char *exif_raw_data = NULL;
 
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(u_data);
 	_MMCamcorderImageInfo *info = NULL;
 	_MMCamcorderSubContext *sc = NULL;
+	_MMCamcorderCaptureJob *job = NULL;
 	MMCamcorderCaptureDataType dest = {0,};
-	MMCamcorderCaptureDataType thumb = {0,};
-	MMCamcorderCaptureDataType scrnail = {0,};
-
-	mmf_attrs_t *attrs = NULL;
-	mmf_attribute_t *item_screennail = NULL;
-	mmf_attribute_t *item_exif_raw_data = NULL;
 
 	void *encoded_data = NULL;
 
@@ -1449,7 +1590,7 @@ static void __mmcamcorder_image_capture_cb(GstElement *element, GstBuffer *buffe
 
 	/* check capture state */
 	if (info->type == _MMCamcorder_MULTI_SHOT && info->capture_send_count > 0) {
-		mm_camcorder_get_attributes((MMHandleType)hcamcorder, NULL, "capture-break-cont-shot", &stop_cont_shot, NULL);
+		stop_cont_shot = g_atomic_int_get(&(hcamcorder->hot_attrs.capture_break_cont_shot));
 		if (stop_cont_shot == TRUE) {
 			_mmcam_dbg_warn("capture stop command already come. skip this...");
 			MMTA_ACUM_ITEM_END( "            MSL capture callback", FALSE );
@@ -1520,14 +1661,57 @@ static void __mmcamcorder_image_capture_cb(GstElement *element, GstBuffer *buffe
 	/* Encode JPEG */
 	if (sc->internal_encode) {
 		int capture_quality = 0;
+		int encode_slice = 0;
 		mm_camcorder_get_attributes((MMHandleType)hcamcorder, NULL,
 		                            MMCAM_IMAGE_ENCODER_QUALITY, &capture_quality,
 		                            NULL);
 		_mmcam_dbg_log("capture_quality %d", capture_quality);
 
-		__ta__("                _mmcamcorder_encode_jpeg",
-		ret = _mmcamcorder_encode_jpeg(GST_BUFFER_DATA(buffer1), dest.width, dest.height,
-		                               pixtype, dest.length, capture_quality, &(dest.data), &(dest.length));
+		/* encode in parallel and deliver in order by encode pool if multi shot */
+		if (info->type == _MMCamcorder_MULTI_SHOT && sc->encode_pool.lock) {
+			job = (_MMCamcorderCaptureJob *)malloc(sizeof(_MMCamcorderCaptureJob));
+			if (job) {
+				job->hcamcorder = hcamcorder;
+				job->buffer1 = buffer1;
+				job->buffer2 = buffer2;
+				job->buffer3 = buffer3;
+				job->pixtype = pixtype;
+				job->quality = capture_quality;
+				job->dest = dest;
+				job->encoded_data = NULL;
+
+				/* this is blocked while too many frames are in flight */
+				__ta__("                _mmcamcorder_encode_pool_push",
+				ret = _mmcamcorder_encode_pool_push(&sc->encode_pool, job);
+				);
+				if (ret) {
+					MMTA_ACUM_ITEM_END("            MSL capture callback", FALSE);
+					_mmcam_dbg_log("END - frame is pushed to encode pool");
+					return;
+				}
+
+				_mmcam_dbg_warn("failed to push to encode pool, encode here");
+				free(job);
+				job = NULL;
+			}
+
+			/* frames in pool share EXIF and capture segments with this one,
+			   so they should be delivered before this frame is encoded here */
+			__ta__("                _mmcamcorder_encode_pool_drain",
+			_mmcamcorder_encode_pool_drain(&sc->encode_pool);
+			);
+		}
+
+		/* single frame is split into slices which are encoded in parallel, if EncodeSlice is set */
+		_mmcamcorder_conf_get_value_int(hcamcorder->conf_main,
+		                                CONFIGURE_CATEGORY_MAIN_CAPTURE,
+		                                "EncodeSlice",
+		                                &encode_slice);
+
+		__ta__("                _mmcamcorder_encode_jpeg_with_slice",
+		ret = _mmcamcorder_encode_jpeg_with_slice(GST_BUFFER_DATA(buffer1), dest.width, dest.height,
+		                                          pixtype, dest.length, capture_quality, encode_slice,
+		                                          &(dest.data), &(dest.length));
 		);
 		if (!ret) {
 			_mmcam_dbg_err("_mmcamcorder_encode_jpeg failed");
@@ -1541,6 +1725,49 @@ static void __mmcamcorder_image_capture_cb(GstElement *element, GstBuffer *buffe
 		dest.format = MM_PIXEL_FORMAT_ENCODED;
 	}
 
+	__mmcamcorder_image_capture_deliver(hcamcorder, buffer1, buffer2, buffer3, pixtype, &dest, encoded_data);
+
+	MMTA_ACUM_ITEM_END( "            MSL capture callback", FALSE );
+
+	_mmcam_dbg_err("END");
+
+	return;
+
+error:
+	__mmcamcorder_image_capture_finish(hcamcorder, 0, buffer1, buffer2, buffer3, encoded_data);
+
+	MMTA_ACUM_ITEM_END( "            MSL capture callback", FALSE );
+
+	_mmcam_dbg_err("END");
+
+	return;
+}
+
+
+static void __mmcamcorder_image_capture_deliver(mmf_camcorder_t *hcamcorder, GstBuffer *buffer1, GstBuffer *buffer2, GstBuffer *buffer3,
+                                                int pixtype, MMCamcorderCaptureDataType *dest, void *encoded_data)
+{
+	int ret = MM_ERROR_NONE;
+	int pixtype_sub = MM_PIXEL_FORMAT_INVALID;
+	int codectype = MM_IMAGE_CODEC_JPEG;
+	int attr_index = 0;
+	int count = 0;
+	int tag_enable = FALSE;
+	int provide_exif = FALSE;
+	int exif_raw_data_set = FALSE;
+
+	_MMCamcorderImageInfo *info = NULL;
+	_MMCamcorderSubContext *sc = NULL;
+	MMCamcorderCaptureDataType thumb = {0,};
+	MMCamcorderCaptureDataType scrnail = {0,};
+
+	mmf_attrs_t *attrs = NULL;
+	mmf_attribute_t *item_screennail = NULL;
+	mmf_attribute_t *item_exif_raw_data = NULL;
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(hcamcorder);
+	info = sc->info;
+
 	/* Thumbnail image buffer */
 	if (buffer2 && GST_BUFFER_DATA(buffer2) && (GST_BUFFER_SIZE(buffer2) !=0)) {
 		_mmcam_dbg_log("Thumnail (buffer2=%p)",buffer2);
@@ -1573,38 +1800,26 @@ static void __mmcamcorder_image_capture_cb(GstElement *element, GstBuffer *buffe
 	/* commit screennail data */
 	mmf_attribute_commit(item_screennail);
 
-	/* create EXIF info */
-	__ta__("                    mm_exif_create_exif_info",
-	ret = mm_exif_create_exif_info(&(hcamcorder->exif_info));
+	/* add basic exif info. EXIF info is created at first, and reused for next image */
+	_mmcam_dbg_log("add basic exif info");
+	__ta__("                    __mmcamcorder_set_exif_basic_info",
+	ret = __mmcamcorder_set_exif_basic_info((MMHandleType)hcamcorder, dest->width, dest->height);
 	);
 	if (ret != MM_ERROR_NONE) {
-		_mmcam_dbg_err("Failed to create exif_info [%x], but keep going...", ret);
-	} else {
-		/* add basic exif info */
-		_mmcam_dbg_log("add basic exif info");
-		__ta__("                    __mmcamcorder_set_exif_basic_info",
-		ret = __mmcamcorder_set_exif_basic_info((MMHandleType)hcamcorder, dest.width, dest.height);
-		);
-		if (ret != MM_ERROR_NONE) {
-			_mmcam_dbg_warn("Failed set_exif_basic_info [%x], but keep going...", ret);
-			ret = MM_ERROR_NONE;
-		}
+		_mmcam_dbg_warn("Failed set_exif_basic_info [%x], but keep going...", ret);
+		ret = MM_ERROR_NONE;
 	}
 
 	/* get attribute item for EXIF data */
 	mm_attrs_get_index((MMHandleType)attrs, MMCAM_CAPTURED_EXIF_RAW_DATA, &attr_index);
 	item_exif_raw_data = &attrs->items[attr_index];
 
-	/* set EXIF data to attribute */
+	/* set EXIF data to attribute without copy. it's valid only in capture callback,
+	   and EXIF info of handle is not changed until the callback returns. */
 	if (hcamcorder->exif_info && hcamcorder->exif_info->data) {
-		exif_raw_data = (unsigned char *)malloc(hcamcorder->exif_info->size);
-		if (exif_raw_data) {
-			memcpy(exif_raw_data, hcamcorder->exif_info->data, hcamcorder->exif_info->size);
-			mmf_attribute_set_data(item_exif_raw_data, exif_raw_data, hcamcorder->exif_info->size);
-			_mmcam_dbg_log("set EXIF raw data %p, size %d", exif_raw_data, hcamcorder->exif_info->size);
-		} else {
-			_mmcam_dbg_warn("failed to alloc for EXIF, size %d", hcamcorder->exif_info->size);
-		}
+		mmf_attribute_set_data(item_exif_raw_data, hcamcorder->exif_info->data, hcamcorder->exif_info->size);
+		exif_raw_data_set = TRUE;
+		_mmcam_dbg_log("set EXIF raw data %p, size %d", hcamcorder->exif_info->data, hcamcorder->exif_info->size);
 	} else {
 		_mmcam_dbg_warn("failed to create EXIF. set EXIF as NULL");
 		mmf_attribute_set_data(item_exif_raw_data, NULL, 0);
@@ -1618,7 +1833,7 @@ static void __mmcamcorder_image_capture_cb(GstElement *element, GstBuffer *buffe
 	MMCAMCORDER_G_OBJECT_GET(sc->element[_MMCAMCORDER_VIDEOSRC_SRC].gst, "provide-exif", &provide_exif);
 
 	/* Set extra data for JPEG if tag enabled and doesn't provide EXIF */
-	if (dest.format == MM_PIXEL_FORMAT_ENCODED &&
+	if (dest->format == MM_PIXEL_FORMAT_ENCODED &&
 	    tag_enable && !provide_exif) {
 		mm_camcorder_get_attributes((MMHandleType)hcamcorder, NULL,
 		                            MMCAM_IMAGE_ENCODER, &codectype,
@@ -1630,7 +1845,7 @@ static void __mmcamcorder_image_capture_cb(GstElement *element, GstBuffer *buffe
 		case MM_IMAGE_CODEC_SRW:
 		case MM_IMAGE_CODEC_JPEG_SRW:
 			__ta__( "                __mmcamcorder_set_jpeg_data",
-			ret = __mmcamcorder_set_jpeg_data((MMHandleType)hcamcorder, &dest, &thumb);
+			ret = __mmcamcorder_set_jpeg_data((MMHandleType)hcamcorder, dest, &thumb);
 			);
 			if (ret != MM_ERROR_NONE) {
 				_mmcam_dbg_err("Error on setting extra data to jpeg");
@@ -1647,6 +1862,9 @@ static void __mmcamcorder_image_capture_cb(GstElement *element, GstBuffer *buffe
 		}
 	}
 
+	/* set segment if captured image is delivered by segments */
+	__mmcamcorder_set_capture_segment((MMHandleType)hcamcorder, dest);
+
 	/* Handle Capture Callback */
 	_MMCAMCORDER_LOCK_VCAPTURE_CALLBACK(hcamcorder);
 
@@ -1654,9 +1872,9 @@ static void __mmcamcorder_image_capture_cb(GstElement *element, GstBuffer *buffe
 		_mmcam_dbg_log("APPLICATION CALLBACK START");
 		MMTA_ACUM_ITEM_BEGIN("                Application capture callback", 0);
 		if (thumb.data) {
-			ret = hcamcorder->vcapture_cb(&dest, &thumb, hcamcorder->vcapture_cb_param);
+			ret = hcamcorder->vcapture_cb(dest, &thumb, hcamcorder->vcapture_cb_param);
 		} else {
-			ret = hcamcorder->vcapture_cb(&dest, NULL, hcamcorder->vcapture_cb_param);
+			ret = hcamcorder->vcapture_cb(dest, NULL, hcamcorder->vcapture_cb_param);
 		}
 		MMTA_ACUM_ITEM_END("                Application capture callback", 0);
 		_mmcam_dbg_log("APPLICATION CALLBACK END");
@@ -1684,27 +1902,41 @@ static void __mmcamcorder_image_capture_cb(GstElement *element, GstBuffer *buffe
 err_release_exif:
 	_MMCAMCORDER_UNLOCK_VCAPTURE_CALLBACK(hcamcorder);
 
+	/* Release jpeg data */
+	if (pixtype == MM_PIXEL_FORMAT_ENCODED) {
+		__ta__("                __mmcamcorder_release_jpeg_data",
+		__mmcamcorder_release_jpeg_data((MMHandleType)hcamcorder, dest);
+		);
+	}
+
+error:
 	/* init screennail and EXIF raw data */
 	__ta__("                init attributes:scrnl and EXIF",
-	mmf_attribute_set_data(item_screennail, NULL, 0);
-	mmf_attribute_commit(item_screennail);
-	if (exif_raw_data) {
-		free(exif_raw_data);
-		exif_raw_data = NULL;
-
+	if (item_screennail) {
+		mmf_attribute_set_data(item_screennail, NULL, 0);
+		mmf_attribute_commit(item_screennail);
+	}
+	if (exif_raw_data_set) {
 		mmf_attribute_set_data(item_exif_raw_data, NULL, 0);
 		mmf_attribute_commit(item_exif_raw_data);
 	}
 	);
 
-	/* Release jpeg data */
-	if (pixtype == MM_PIXEL_FORMAT_ENCODED) {
-		__ta__("                __mmcamcorder_release_jpeg_data",
-		__mmcamcorder_release_jpeg_data((MMHandleType)hcamcorder, &dest);
-		);
-	}
+	__mmcamcorder_image_capture_finish(hcamcorder, count, buffer1, buffer2, buffer3, encoded_data);
+
+	return;
+}
+
+
+static void __mmcamcorder_image_capture_finish(mmf_camcorder_t *hcamcorder, int count,
+                                               GstBuffer *buffer1, GstBuffer *buffer2, GstBuffer *buffer3, void *encoded_data)
+{
+	_MMCamcorderImageInfo *info = NULL;
+	_MMCamcorderSubContext *sc = NULL;
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(hcamcorder);
+	info = sc->info;
 
-error:
 	/* Check end condition and set proper value */
 	if (info->hdr_capture_mode != MM_CAMCORDER_HDR_ON_AND_ORIGINAL ||
 	    (info->hdr_capture_mode == MM_CAMCORDER_HDR_ON_AND_ORIGINAL && count == 2)) {
@@ -1713,10 +1945,6 @@ error:
 
 	/* release internal allocated data */
 	if (encoded_data) {
-		if (dest.data == encoded_data) {
-			dest.data = NULL;
-		}
-
 		free(encoded_data);
 		encoded_data = NULL;
 	}
@@ -1732,15 +1960,51 @@ error:
 		gst_buffer_unref(buffer3);
 	}
 
-	/* destroy exif info */
-	__ta__("                mm_exif_destory_exif_info",
-	mm_exif_destory_exif_info(hcamcorder->exif_info);
+	return;
+}
+
+
+static gboolean __mmcamcorder_capture_encode_job(gpointer data)
+{
+	gboolean ret = FALSE;
+	_MMCamcorderCaptureJob *job = (_MMCamcorderCaptureJob *)data;
+
+	mmf_return_val_if_fail(job && job->buffer1, FALSE);
+
+	/* frames are already encoded in parallel, so a frame is not split */
+	__ta__("                _mmcamcorder_encode_jpeg",
+	ret = _mmcamcorder_encode_jpeg(GST_BUFFER_DATA(job->buffer1), job->dest.width, job->dest.height,
+	                               job->pixtype, job->dest.length, job->quality,
+	                               &(job->dest.data), &(job->dest.length));
 	);
-	hcamcorder->exif_info = NULL;
+	if (ret) {
+		job->encoded_data = job->dest.data;
+		job->dest.format = MM_PIXEL_FORMAT_ENCODED;
+	}
 
-	MMTA_ACUM_ITEM_END( "            MSL capture callback", FALSE );
+	return ret;
+}
 
-	_mmcam_dbg_err("END");
+
+static void __mmcamcorder_capture_deliver_job(gpointer data, gboolean result, gpointer user_data)
+{
+	_MMCamcorderCaptureJob *job = (_MMCamcorderCaptureJob *)data;
+
+	mmf_return_if_fail(job);
+
+	if (result) {
+		__mmcamcorder_image_capture_deliver(job->hcamcorder, job->buffer1, job->buffer2, job->buffer3,
+		                                    job->pixtype, &(job->dest), job->encoded_data);
+	} else {
+		_mmcam_dbg_err("_mmcamcorder_encode_jpeg failed");
+
+		MMCAM_SEND_MESSAGE(job->hcamcorder, MM_MESSAGE_CAMCORDER_ERROR, MM_ERROR_CAMCORDER_INTERNAL);
+
+		__mmcamcorder_image_capture_finish(job->hcamcorder, 0, job->buffer1, job->buffer2, job->buffer3, job->encoded_data);
+	}
+
+	free(job);
+	job = NULL;
 
 	return;
 }
@@ -1770,6 +2034,16 @@ static gboolean __mmcamcorder_encodesink_handoff_callback(GstElement *fakesink,
 }
 
 
+static gboolean __mmcamcorder_check_new_preview_frame(gpointer data)
+{
+	_MMCamcorderPreviewFrameCheck *check = (_MMCamcorderPreviewFrameCheck *)data;
+
+	mmf_return_val_if_fail(check && check->sc, FALSE);
+
+	return (check->sc->kpi.video_framecount != check->framecount);
+}
+
+
 /* Take a picture with capture mode */
 int _mmcamcorder_set_resize_property(MMHandleType handle, int capture_width, int capture_height)
 {
@@ -1796,6 +2070,101 @@ int _mmcamcorder_set_resize_property(MMHandleType handle, int capture_width, int
 
 
 int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int image_height)
+{
+	int ret = MM_ERROR_NONE;
+	ExifData *ed = NULL;
+	mm_exif_template_t *tmpl = NULL;
+
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderSubContext *sc = NULL;
+
+	mmf_return_val_if_fail(hcamcorder, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
+	mmf_return_val_if_fail(sc, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+
+	/* template is built with the first image, and then only values are patched for next images */
+	if (sc->exif_template) {
+		if (hcamcorder->exif_info == NULL) {
+			ret = mm_exif_create_exif_info(&(hcamcorder->exif_info));
+		}
+
+		if (ret == MM_ERROR_NONE) {
+			ret = mm_exif_template_begin_patch(sc->exif_template, hcamcorder->exif_info);
+		}
+
+		if (ret == MM_ERROR_NONE) {
+			ret = __mmcamcorder_write_exif_basic_info(handle, image_width, image_height, sc->exif_template, NULL);
+			if (ret == MM_ERROR_NONE) {
+				ret = mm_exif_template_end_patch(sc->exif_template);
+				if (ret == MM_ERROR_NONE) {
+					return MM_ERROR_NONE;
+				}
+			}
+		}
+
+		_mmcam_dbg_log("EXIF template can not be used [%x], build it again", ret);
+
+		mm_exif_template_destroy(sc->exif_template);
+		sc->exif_template = NULL;
+	}
+
+	/* build from default EXIF data */
+	if (hcamcorder->exif_info) {
+		mm_exif_destory_exif_info(hcamcorder->exif_info);
+		hcamcorder->exif_info = NULL;
+	}
+
+	ret = mm_exif_create_exif_info(&(hcamcorder->exif_info));
+	if (ret != MM_ERROR_NONE) {
+		_mmcam_dbg_err("failed to create exif info [%x]", ret);
+		return ret;
+	}
+
+	ret = mm_exif_template_create(&tmpl);
+	if (ret != MM_ERROR_NONE) {
+		_mmcam_dbg_err("failed to create exif template [%x]", ret);
+		return ret;
+	}
+
+	/* get ExifData from exif info */
+	__ta__("                        mm_exif_get_exif_from_info",
+	ed = mm_exif_get_exif_from_info(hcamcorder->exif_info);
+	);
+	if (ed == NULL || ed->ifd == NULL) {
+		_mmcam_dbg_err("get exif data error!!(%p, %p)", ed, (ed ? ed->ifd : NULL));
+		mm_exif_template_destroy(tmpl);
+		if (ed) {
+			exif_data_unref(ed);
+		}
+		return MM_ERROR_INVALID_HANDLE;
+	}
+
+	ret = __mmcamcorder_write_exif_basic_info(handle, image_width, image_height, tmpl, ed);
+	if (ret == MM_ERROR_NONE) {
+		ret = mm_exif_set_exif_to_info(hcamcorder->exif_info, ed);
+		if (ret != MM_ERROR_NONE) {
+			_mmcam_dbg_err("mm_exif_set_exif_to_info err!! [%x]", ret);
+		}
+	}
+
+	exif_data_unref(ed);
+	ed = NULL;
+
+	if (ret == MM_ERROR_NONE &&
+	    mm_exif_template_save(tmpl, hcamcorder->exif_info) == MM_ERROR_NONE) {
+		sc->exif_template = tmpl;
+	} else {
+		_mmcam_dbg_warn("failed to save EXIF template");
+		mm_exif_template_destroy(tmpl);
+	}
+
+	return ret;
+}
+
+
+static int __mmcamcorder_write_exif_basic_info(MMHandleType handle, int image_width, int image_height,
+                                               mm_exif_template_t *tmpl, ExifData *ed)
 {
 	int ret = MM_ERROR_NONE;
 	int value;
@@ -1810,9 +2179,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 #ifdef WRITE_EXIF_MAKER_INFO /* FIXME */
 	char *maker = NULL;
 #endif
-	char *user_comment = NULL;
+	const char *user_comment = NULL;
 	char *err_name = NULL;
-	ExifData *ed = NULL;
+	ExifByteOrder byte_order;
 	ExifLong config;
 	ExifLong ExifVersion;
 	static ExifShort eshort[20];
@@ -1843,13 +2212,11 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 		);
 	}
 
-	/* get ExifData from exif info */
-	__ta__("                        mm_exif_get_exif_from_info",
-	ed = mm_exif_get_exif_from_info(hcamcorder->exif_info);
-	);
-	if (ed == NULL || ed->ifd == NULL) {
-		_mmcam_dbg_err("get exif data error!!(%p, %p)", ed, (ed ? ed->ifd : NULL));
-		return MM_ERROR_INVALID_HANDLE;
+	/* ExifData is given when template is built. Otherwise, values are patched into template */
+	if (ed) {
+		byte_order = exif_data_get_byte_order(ed);
+	} else {
+		byte_order = tmpl->order;
 	}
 
 	/* Receive attribute info */
@@ -1858,8 +2225,8 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 	/*0. EXIF_TAG_EXIF_VERSION */
 	ExifVersion = MM_EXIF_VERSION;
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_EXIF_VERSION,
-	                            EXIF_FORMAT_UNDEFINED, 4, (unsigned char *)&ExifVersion);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_EXIF_VERSION,
+	                                 EXIF_FORMAT_UNDEFINED, 4, (unsigned char *)&ExifVersion);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_EXIF_VERSION);
 	}
@@ -1867,15 +2234,15 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	/*1. EXIF_TAG_IMAGE_WIDTH */ /*EXIF_TAG_PIXEL_X_DIMENSION*/
 	value = image_width;
 
-	exif_set_long((unsigned char *)&elong[cntl], exif_data_get_byte_order(ed), value);
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_0, EXIF_TAG_IMAGE_WIDTH,
-	                            EXIF_FORMAT_LONG, 1, (unsigned char *)&elong[cntl]);
+	exif_set_long((unsigned char *)&elong[cntl], byte_order, value);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_0, EXIF_TAG_IMAGE_WIDTH,
+	                                 EXIF_FORMAT_LONG, 1, (unsigned char *)&elong[cntl]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_IMAGE_WIDTH);
 	}
 
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_PIXEL_X_DIMENSION,
-	                            EXIF_FORMAT_LONG, 1, (unsigned char *)&elong[cntl++]);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_PIXEL_X_DIMENSION,
+	                                 EXIF_FORMAT_LONG, 1, (unsigned char *)&elong[cntl++]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_PIXEL_X_DIMENSION);
 	}
@@ -1884,15 +2251,15 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	/*2. EXIF_TAG_IMAGE_LENGTH*/ /*EXIF_TAG_PIXEL_Y_DIMENSION*/
 	value = image_height;
 
-	exif_set_long((unsigned char *)&elong[cntl], exif_data_get_byte_order (ed), value);
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_0, EXIF_TAG_IMAGE_LENGTH,
-	                            EXIF_FORMAT_LONG, 1, (unsigned char *)&elong[cntl]);
+	exif_set_long((unsigned char *)&elong[cntl], byte_order, value);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_0, EXIF_TAG_IMAGE_LENGTH,
+	                                 EXIF_FORMAT_LONG, 1, (unsigned char *)&elong[cntl]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_IMAGE_LENGTH);
 	}
 
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_PIXEL_Y_DIMENSION,
-	                            EXIF_FORMAT_LONG, 1, (unsigned char *)&elong[cntl++]);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_PIXEL_Y_DIMENSION,
+	                                 EXIF_FORMAT_LONG, 1, (unsigned char *)&elong[cntl++]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_PIXEL_Y_DIMENSION);
 	}
@@ -1904,17 +2271,10 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 	/*13. EXIF_TAG_DATE_TIME_DIGITIZED*/
 	{
-		unsigned char *b;
+		unsigned char b[20];
 		time_t t;
 		struct tm tm;
 
-		b = malloc(20 * sizeof(unsigned char));
-		if (b == NULL) {
-			_mmcam_dbg_err("failed to alloc b");
-			ret = MM_ERROR_CAMCORDER_LOW_MEMORY;
-			EXIF_SET_ERR(ret, EXIF_TAG_DATE_TIME);
-		}
-
 		memset(b, '\0', 20);
 
 		t = time(NULL);
@@ -1925,31 +2285,20 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 		         tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
 		         tm.tm_hour, tm.tm_min, tm.tm_sec);
 
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_0, EXIF_TAG_DATE_TIME, EXIF_FORMAT_ASCII, 20, b);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_0, EXIF_TAG_DATE_TIME, EXIF_FORMAT_ASCII, 20, b);
 		if (ret != MM_ERROR_NONE) {
-			if (ret == MM_ERROR_CAMCORDER_LOW_MEMORY) {
-				free(b);
-			}
 			EXIF_SET_ERR(ret, EXIF_TAG_DATE_TIME);
 		}
 
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_DATE_TIME_ORIGINAL, EXIF_FORMAT_ASCII, 20, b);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_DATE_TIME_ORIGINAL, EXIF_FORMAT_ASCII, 20, b);
 		if (ret != MM_ERROR_NONE) {
-			if (ret == MM_ERROR_CAMCORDER_LOW_MEMORY) {
-				free(b);
-			}
 			EXIF_SET_ERR(ret, EXIF_TAG_DATE_TIME_ORIGINAL);
 		}
 
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_DATE_TIME_DIGITIZED, EXIF_FORMAT_ASCII, 20, b);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_DATE_TIME_DIGITIZED, EXIF_FORMAT_ASCII, 20, b);
 		if (ret != MM_ERROR_NONE) {
-			if (ret == MM_ERROR_CAMCORDER_LOW_MEMORY) {
-				free(b);
-			}
 			EXIF_SET_ERR(ret, EXIF_TAG_DATE_TIME_DIGITIZED);
 		}
-
-		free(b);
 	}
 
 #ifdef WRITE_EXIF_MAKER_INFO /* FIXME */
@@ -1957,8 +2306,8 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	maker = strdup(MM_MAKER_NAME);
 	if (maker) {
 		_mmcam_dbg_log("maker [%s]", maker);
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_0, EXIF_TAG_MAKE,
-		                            EXIF_FORMAT_ASCII, strlen(maker), (unsigned char *)maker);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_0, EXIF_TAG_MAKE,
+		                                 EXIF_FORMAT_ASCII, strlen(maker), (unsigned char *)maker);
 		free(maker);
 		if (ret != MM_ERROR_NONE) {
 			EXIF_SET_ERR(ret, EXIF_TAG_MAKE);
@@ -1976,7 +2325,7 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	_mmcam_dbg_log("model_name [%s]", str_value);
 	if (str_value) {
 		char *model = strdup(str_value);
-		mm_exif_set_add_entry(ed,EXIF_IFD_0,EXIF_TAG_MODEL,EXIF_FORMAT_ASCII,strlen(model)+1, (unsigned char*)model);
+		mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_0,EXIF_TAG_MODEL,EXIF_FORMAT_ASCII,strlen(model)+1, (unsigned char*)model);
 		free(model);
 		str_value = NULL;
 		if (ret != MM_ERROR_NONE) {
@@ -1990,10 +2339,8 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	mm_camcorder_get_attributes(handle, NULL, MMCAM_TAG_IMAGE_DESCRIPTION, &str_value, &str_val_len, NULL);
 	_mmcam_dbg_log("desctiption [%s]", str_value);
 	if (str_value && str_val_len > 0) {
-		char *description = strdup(str_value);
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_0, EXIF_TAG_IMAGE_DESCRIPTION,
-		                            EXIF_FORMAT_ASCII, strlen(description), (unsigned char *)description);
-		free(description);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_0, EXIF_TAG_IMAGE_DESCRIPTION,
+		                                 EXIF_FORMAT_ASCII, strlen(str_value), (unsigned char *)str_value);
 		str_value = NULL;
 		str_val_len = 0;
 		if (ret != MM_ERROR_NONE) {
@@ -2011,8 +2358,8 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 		len = snprintf(software, sizeof(software), "%x.%x ", avsys_exif_info.software_used>>8,(avsys_exif_info.software_used & 0xff));
 		_mmcam_dbg_log("software [%s], len [%d]", software, len);
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_0, EXIF_TAG_SOFTWARE,
-		                            EXIF_FORMAT_ASCII, len, software);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_0, EXIF_TAG_SOFTWARE,
+		                                 EXIF_FORMAT_ASCII, len, software);
 		if (ret != MM_ERROR_NONE) {
 			EXIF_SET_ERR(ret, EXIF_TAG_SOFTWARE);
 		}
@@ -2027,9 +2374,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 		value = MM_EXIF_ORIENTATION;
 	}
 
-	exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order(ed), value);
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_0, EXIF_TAG_ORIENTATION,
-	                            EXIF_FORMAT_SHORT, 1, (unsigned char*)&eshort[cnts++]);
+	exif_set_short((unsigned char *)&eshort[cnts], byte_order, value);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_0, EXIF_TAG_ORIENTATION,
+	                                 EXIF_FORMAT_SHORT, 1, (unsigned char*)&eshort[cnts++]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_ORIENTATION);
 	}
@@ -2038,25 +2385,19 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 	/*3. User Comment*/
 	/*FIXME : get user comment from real user */
-	user_comment = strdup(MM_USER_COMMENT);
-	if (user_comment) {
-		_mmcam_dbg_log("user_comment=%s",user_comment);
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_USER_COMMENT,
-		                            EXIF_FORMAT_ASCII, strlen(user_comment), (unsigned char *)user_comment);
-		free(user_comment);
-		if (ret != MM_ERROR_NONE) {
-			EXIF_SET_ERR(ret, EXIF_TAG_USER_COMMENT);
-		}
-	} else {
-		ret = MM_ERROR_CAMCORDER_LOW_MEMORY;
+	user_comment = MM_USER_COMMENT;
+	_mmcam_dbg_log("user_comment=%s",user_comment);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_USER_COMMENT,
+	                                 EXIF_FORMAT_ASCII, strlen(user_comment), (unsigned char *)user_comment);
+	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_USER_COMMENT);
 	}
 
 	/*9. EXIF_TAG_COLOR_SPACE */
 	if (control != NULL) {
-		exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order(ed), avsys_exif_info.colorspace);
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_COLOR_SPACE,
-		                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+		exif_set_short((unsigned char *)&eshort[cnts], byte_order, avsys_exif_info.colorspace);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_COLOR_SPACE,
+		                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 		if (ret != MM_ERROR_NONE) {
 			EXIF_SET_ERR(ret, EXIF_TAG_COLOR_SPACE);
 		}
@@ -2066,8 +2407,8 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	if (control != NULL) {
 		config = avsys_exif_info.component_configuration;
 		_mmcam_dbg_log("EXIF_TAG_COMPONENTS_CONFIGURATION [%4x] ",config);
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_COMPONENTS_CONFIGURATION,
-		                            EXIF_FORMAT_UNDEFINED, 4, (unsigned char *)&config);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_COMPONENTS_CONFIGURATION,
+		                                 EXIF_FORMAT_UNDEFINED, 4, (unsigned char *)&config);
 		if (ret != MM_ERROR_NONE) {
 			EXIF_SET_ERR(ret, EXIF_TAG_COMPONENTS_CONFIGURATION);
 		}
@@ -2081,26 +2422,20 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 	/*14. EXIF_TAG_EXPOSURE_TIME*/
 	if (avsys_exif_info.exposure_time_numerator && avsys_exif_info.exposure_time_denominator) {
-		unsigned char *b = NULL;
+		unsigned char b[sizeof(ExifRational)];
 		ExifRational rData;
 
 		_mmcam_dbg_log("EXIF_TAG_EXPOSURE_TIME numerator [%d], denominator [%d]",
 		               avsys_exif_info.exposure_time_numerator, avsys_exif_info.exposure_time_denominator)
 
-		b = malloc(sizeof(ExifRational));
-		if (b) {
-			rData.numerator = avsys_exif_info.exposure_time_numerator;
-			rData.denominator = avsys_exif_info.exposure_time_denominator;
+		rData.numerator = avsys_exif_info.exposure_time_numerator;
+		rData.denominator = avsys_exif_info.exposure_time_denominator;
 
-			exif_set_rational(b, exif_data_get_byte_order(ed), rData);
-			ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_EXPOSURE_TIME,
-			                            EXIF_FORMAT_RATIONAL, 1, b);
-			free(b);
-			if (ret != MM_ERROR_NONE) {
-				EXIF_SET_ERR(ret, EXIF_TAG_EXPOSURE_TIME);
-			}
-		} else {
-			_mmcam_dbg_warn("malloc failed.");
+		exif_set_rational(b, byte_order, rData);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_EXPOSURE_TIME,
+		                                 EXIF_FORMAT_RATIONAL, 1, b);
+		if (ret != MM_ERROR_NONE) {
+			EXIF_SET_ERR(ret, EXIF_TAG_EXPOSURE_TIME);
 		}
 	} else {
 		_mmcam_dbg_log("Skip set EXIF_TAG_EXPOSURE_TIME numerator [%d], denominator [%d]",
@@ -2109,25 +2444,19 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 	/*15. EXIF_TAG_FNUMBER */
 	if (avsys_exif_info.aperture_f_num_numerator && avsys_exif_info.aperture_f_num_denominator) {
-		unsigned char *b = NULL;
+		unsigned char b[sizeof(ExifRational)];
 		ExifRational rData;
 
 		_mmcam_dbg_log("EXIF_TAG_FNUMBER numerator [%d], denominator [%d]",
 		               avsys_exif_info.aperture_f_num_numerator, avsys_exif_info.aperture_f_num_denominator);
 
-		b = malloc(sizeof(ExifRational));
-		if (b) {
-			rData.numerator = avsys_exif_info.aperture_f_num_numerator;
-			rData.denominator = avsys_exif_info.aperture_f_num_denominator;
-			exif_set_rational(b, exif_data_get_byte_order(ed), rData);
-			ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_FNUMBER,
-			                            EXIF_FORMAT_RATIONAL, 1, b);
-			free(b);
-			if(ret != MM_ERROR_NONE) {
-				EXIF_SET_ERR(ret, EXIF_TAG_FNUMBER);
-			}
-		} else {
-			_mmcam_dbg_warn( "malloc failed." );
+		rData.numerator = avsys_exif_info.aperture_f_num_numerator;
+		rData.denominator = avsys_exif_info.aperture_f_num_denominator;
+		exif_set_rational(b, byte_order, rData);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_FNUMBER,
+		                                 EXIF_FORMAT_RATIONAL, 1, b);
+		if(ret != MM_ERROR_NONE) {
+			EXIF_SET_ERR(ret, EXIF_TAG_FNUMBER);
 		}
 	} else {
 		_mmcam_dbg_log("Skip set EXIF_TAG_FNUMBER numerator [%d], denominator [%d]",
@@ -2137,9 +2466,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	/*16. EXIF_TAG_EXPOSURE_PROGRAM*/
 	/*FIXME*/
 	value = MM_EXPOSURE_PROGRAM;
-	exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order(ed), value);
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_EXPOSURE_PROGRAM,
-	                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+	exif_set_short((unsigned char *)&eshort[cnts], byte_order, value);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_EXPOSURE_PROGRAM,
+	                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_EXPOSURE_PROGRAM);
 	}
@@ -2147,9 +2476,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	/*17. EXIF_TAG_ISO_SPEED_RATINGS*/
 	if (avsys_exif_info.iso) {
 		_mmcam_dbg_log("EXIF_TAG_ISO_SPEED_RATINGS [%d]", avsys_exif_info.iso);
-		exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order(ed), avsys_exif_info.iso);
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_ISO_SPEED_RATINGS,
-		                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+		exif_set_short((unsigned char *)&eshort[cnts], byte_order, avsys_exif_info.iso);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_ISO_SPEED_RATINGS,
+		                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 		if (ret != MM_ERROR_NONE) {
 			EXIF_SET_ERR(ret, EXIF_TAG_ISO_SPEED_RATINGS);
 		}
@@ -2157,25 +2486,19 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 	/*18. EXIF_TAG_SHUTTER_SPEED_VALUE*/
 	if (avsys_exif_info.shutter_speed_numerator && avsys_exif_info.shutter_speed_denominator) {
-		unsigned char *b = NULL;
+		unsigned char b[sizeof(ExifSRational)];
 		ExifSRational rsData;
 
 		_mmcam_dbg_log("EXIF_TAG_SHUTTER_SPEED_VALUE numerator [%d], denominator [%d]",
 		               avsys_exif_info.shutter_speed_numerator, avsys_exif_info.shutter_speed_denominator);
 
-		b = malloc(sizeof(ExifSRational));
-		if (b) {
-			rsData.numerator = avsys_exif_info.shutter_speed_numerator;
-			rsData.denominator = avsys_exif_info.shutter_speed_denominator;
-			exif_set_srational(b, exif_data_get_byte_order(ed), rsData);
-			ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_SHUTTER_SPEED_VALUE,
-			                            EXIF_FORMAT_SRATIONAL, 1, b);
-			free(b);
-			if (ret != MM_ERROR_NONE) {
-				EXIF_SET_ERR(ret, EXIF_TAG_SHUTTER_SPEED_VALUE);
-			}
-		} else {
-			_mmcam_dbg_warn("malloc failed.");
+		rsData.numerator = avsys_exif_info.shutter_speed_numerator;
+		rsData.denominator = avsys_exif_info.shutter_speed_denominator;
+		exif_set_srational(b, byte_order, rsData);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_SHUTTER_SPEED_VALUE,
+		                                 EXIF_FORMAT_SRATIONAL, 1, b);
+		if (ret != MM_ERROR_NONE) {
+			EXIF_SET_ERR(ret, EXIF_TAG_SHUTTER_SPEED_VALUE);
 		}
 	} else {
 		_mmcam_dbg_log("Skip set EXIF_TAG_SHUTTER_SPEED_VALUE numerator [%d], denominator [%d]",
@@ -2184,24 +2507,18 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 	/*19. EXIF_TAG_APERTURE_VALUE*/
 	if (avsys_exif_info.aperture_in_APEX) {
-		unsigned char *b = NULL;
+		unsigned char b[sizeof(ExifRational)];
 		ExifRational rData;
 
 		_mmcam_dbg_log("EXIF_TAG_APERTURE_VALUE [%d]", avsys_exif_info.aperture_in_APEX);
 
-		b = malloc(sizeof(ExifRational));
-		if (b) {
-			rData.numerator = avsys_exif_info.aperture_in_APEX;
-			rData.denominator = 1;
-			exif_set_rational(b, exif_data_get_byte_order(ed), rData);
-			ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_APERTURE_VALUE,
-			                            EXIF_FORMAT_RATIONAL, 1, b);
-			free(b);
-			if(ret != MM_ERROR_NONE) {
-				EXIF_SET_ERR(ret, EXIF_TAG_APERTURE_VALUE);
-			}
-		} else {
-			_mmcam_dbg_warn("malloc failed.");
+		rData.numerator = avsys_exif_info.aperture_in_APEX;
+		rData.denominator = 1;
+		exif_set_rational(b, byte_order, rData);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_APERTURE_VALUE,
+		                                 EXIF_FORMAT_RATIONAL, 1, b);
+		if(ret != MM_ERROR_NONE) {
+			EXIF_SET_ERR(ret, EXIF_TAG_APERTURE_VALUE);
 		}
 	} else {
 		_mmcam_dbg_log("Skip set EXIF_TAG_APERTURE_VALUE [%d]", avsys_exif_info.aperture_in_APEX);
@@ -2209,25 +2526,19 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 	/*20. EXIF_TAG_BRIGHTNESS_VALUE*/
 	if (avsys_exif_info.brigtness_numerator && avsys_exif_info.brightness_denominator) {
-		unsigned char *b = NULL;
+		unsigned char b[sizeof(ExifSRational)];
 		ExifSRational rsData;
 
 		_mmcam_dbg_log("EXIF_TAG_BRIGHTNESS_VALUE numerator [%d], denominator [%d]",
 		               avsys_exif_info.brigtness_numerator, avsys_exif_info.brightness_denominator);
 
-		b = malloc(sizeof(ExifSRational));
-		if (b) {
-			rsData.numerator = avsys_exif_info.brigtness_numerator;
-			rsData.denominator = avsys_exif_info.brightness_denominator;
-			exif_set_srational(b, exif_data_get_byte_order(ed), rsData);
-			ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_BRIGHTNESS_VALUE,
-			                            EXIF_FORMAT_SRATIONAL, 1, b);
-			free(b);
-			if (ret != MM_ERROR_NONE) {
-				EXIF_SET_ERR(ret, EXIF_TAG_BRIGHTNESS_VALUE);
-			}
-		} else {
-			_mmcam_dbg_warn( "malloc failed." );
+		rsData.numerator = avsys_exif_info.brigtness_numerator;
+		rsData.denominator = avsys_exif_info.brightness_denominator;
+		exif_set_srational(b, byte_order, rsData);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_BRIGHTNESS_VALUE,
+		                                 EXIF_FORMAT_SRATIONAL, 1, b);
+		if (ret != MM_ERROR_NONE) {
+			EXIF_SET_ERR(ret, EXIF_TAG_BRIGHTNESS_VALUE);
 		}
 	} else {
 		_mmcam_dbg_log("Skip set EXIF_TAG_BRIGHTNESS_VALUE numerator [%d], denominatorr [%d]",
@@ -2238,24 +2549,18 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	value = 0;
 	ret = mm_camcorder_get_attributes(handle, NULL, MMCAM_FILTER_BRIGHTNESS, &value, NULL);
 	if (ret == MM_ERROR_NONE) {
-		unsigned char *b = NULL;
+		unsigned char b[sizeof(ExifSRational)];
 		ExifSRational rsData;
 
 		_mmcam_dbg_log("EXIF_TAG_BRIGHTNESS_VALUE %d",value);
 
-		b = malloc(sizeof(ExifSRational));
-		if (b) {
-			rsData.numerator = value - 5;
-			rsData.denominator = 10;
-			exif_set_srational(b, exif_data_get_byte_order(ed), rsData);
-			ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_EXPOSURE_BIAS_VALUE,
-			                            EXIF_FORMAT_SRATIONAL, 1, b);
-			free(b);
-			if (ret != MM_ERROR_NONE) {
-				EXIF_SET_ERR(ret, EXIF_TAG_EXPOSURE_BIAS_VALUE);
-			}
-		} else {
-			_mmcam_dbg_warn("malloc failed.");
+		rsData.numerator = value - 5;
+		rsData.denominator = 10;
+		exif_set_srational(b, byte_order, rsData);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_EXPOSURE_BIAS_VALUE,
+		                                 EXIF_FORMAT_SRATIONAL, 1, b);
+		if (ret != MM_ERROR_NONE) {
+			EXIF_SET_ERR(ret, EXIF_TAG_EXPOSURE_BIAS_VALUE);
 		}
 	} else {
 		_mmcam_dbg_log("failed to get MMCAM_FILTER_BRIGHTNESS [%x]", ret);
@@ -2264,24 +2569,18 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	/*22  EXIF_TAG_MAX_APERTURE_VALUE*/
 /*
 	if (avsys_exif_info.max_lens_aperture_in_APEX) {
-		unsigned char *b = NULL;
+		unsigned char b[sizeof(ExifRational)];
 		ExifRational rData;
 
 		_mmcam_dbg_log("EXIF_TAG_MAX_APERTURE_VALUE [%d]", avsys_exif_info.max_lens_aperture_in_APEX);
 
-		b = malloc(sizeof(ExifRational));
-		if (b) {
-			rData.numerator = avsys_exif_info.max_lens_aperture_in_APEX;
-			rData.denominator = 1;
-			exif_set_rational(b, exif_data_get_byte_order(ed), rData);
-			ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_MAX_APERTURE_VALUE,
-			                            EXIF_FORMAT_RATIONAL, 1, b);
-			free(b);
-			if (ret != MM_ERROR_NONE) {
-				EXIF_SET_ERR(ret, EXIF_TAG_MAX_APERTURE_VALUE);
-			}
-		} else {
-			_mmcam_dbg_warn("failed to alloc for MAX aperture value");
+		rData.numerator = avsys_exif_info.max_lens_aperture_in_APEX;
+		rData.denominator = 1;
+		exif_set_rational(b, byte_order, rData);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_MAX_APERTURE_VALUE,
+		                                 EXIF_FORMAT_RATIONAL, 1, b);
+		if (ret != MM_ERROR_NONE) {
+			EXIF_SET_ERR(ret, EXIF_TAG_MAX_APERTURE_VALUE);
 		}
 	}
 */
@@ -2291,10 +2590,10 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 	/*24. EXIF_TAG_METERING_MODE */
 	if (control != NULL) {
-		exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order(ed),avsys_exif_info.metering_mode);
+		exif_set_short((unsigned char *)&eshort[cnts], byte_order,avsys_exif_info.metering_mode);
 		_mmcam_dbg_log("EXIF_TAG_METERING_MODE [%d]", avsys_exif_info.metering_mode);
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_METERING_MODE,
-		                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_METERING_MODE,
+		                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 		if (ret != MM_ERROR_NONE) {
 			EXIF_SET_ERR(ret, EXIF_TAG_METERING_MODE);
 		}
@@ -2304,10 +2603,10 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 	/*26. EXIF_TAG_FLASH*/
 	if (control != NULL) {
-		exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order (ed),avsys_exif_info.flash);
+		exif_set_short((unsigned char *)&eshort[cnts], byte_order,avsys_exif_info.flash);
 		_mmcam_dbg_log("EXIF_TAG_FLASH [%d]", avsys_exif_info.flash);
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_FLASH,
-		                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_FLASH,
+		                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 		if (ret != MM_ERROR_NONE) {
 			EXIF_SET_ERR(ret, EXIF_TAG_FLASH);
 		}
@@ -2315,25 +2614,19 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 	/*27. EXIF_TAG_FOCAL_LENGTH*/
 	if (avsys_exif_info.focal_len_numerator && avsys_exif_info.focal_len_denominator) {
-		unsigned char *b = NULL;
+		unsigned char b[sizeof(ExifRational)];
 		ExifRational rData;
 
 		_mmcam_dbg_log("EXIF_TAG_FOCAL_LENGTH numerator [%d], denominator [%d]",
 		               avsys_exif_info.focal_len_numerator, avsys_exif_info.focal_len_denominator);
 
-		b = malloc(sizeof(ExifRational));
-		if (b) {
-			rData.numerator = avsys_exif_info.focal_len_numerator;
-			rData.denominator = avsys_exif_info.focal_len_denominator;
-			exif_set_rational(b, exif_data_get_byte_order(ed), rData);
-			ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_FOCAL_LENGTH,
-			                            EXIF_FORMAT_RATIONAL, 1, b);
-			free(b);
-			if (ret != MM_ERROR_NONE) {
-				EXIF_SET_ERR(ret, EXIF_TAG_FOCAL_LENGTH);
-			}
-		} else {
-			_mmcam_dbg_warn("malloc failed.");
+		rData.numerator = avsys_exif_info.focal_len_numerator;
+		rData.denominator = avsys_exif_info.focal_len_denominator;
+		exif_set_rational(b, byte_order, rData);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_FOCAL_LENGTH,
+		                                 EXIF_FORMAT_RATIONAL, 1, b);
+		if (ret != MM_ERROR_NONE) {
+			EXIF_SET_ERR(ret, EXIF_TAG_FOCAL_LENGTH);
 		}
 	} else {
 		_mmcam_dbg_log("Skip set EXIF_TAG_FOCAL_LENGTH numerator [%d], denominator [%d]",
@@ -2343,9 +2636,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	/*28. EXIF_TAG_SENSING_METHOD*/
 	/*FIXME*/
 	value = MM_SENSING_MODE;
-	exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order (ed),value);
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_SENSING_METHOD,
-	                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+	exif_set_short((unsigned char *)&eshort[cnts], byte_order,value);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_SENSING_METHOD,
+	                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_SENSING_METHOD);
 	}
@@ -2353,9 +2646,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	/*29. EXIF_TAG_FILE_SOURCE*/
 /*
 	value = MM_FILE_SOURCE;
-	exif_set_long(&elong[cntl], exif_data_get_byte_order(ed),value);
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_FILE_SOURCE,
-	                            EXIF_FORMAT_UNDEFINED, 4, (unsigned char *)&elong[cntl++]);
+	exif_set_long(&elong[cntl], byte_order,value);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_FILE_SOURCE,
+	                                 EXIF_FORMAT_UNDEFINED, 4, (unsigned char *)&elong[cntl++]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_FILE_SOURCE);
 	}
@@ -2364,9 +2657,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	/*30. EXIF_TAG_SCENE_TYPE*/
 /*
 	value = MM_SCENE_TYPE;
-	exif_set_long(&elong[cntl], exif_data_get_byte_order(ed),value);
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_SCENE_TYPE,
-	                            EXIF_FORMAT_UNDEFINED, 4, (unsigned char *)&elong[cntl++]);
+	exif_set_long(&elong[cntl], byte_order,value);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_SCENE_TYPE,
+	                                 EXIF_FORMAT_UNDEFINED, 4, (unsigned char *)&elong[cntl++]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_SCENE_TYPE);
 	}
@@ -2375,9 +2668,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	/*31. EXIF_TAG_EXPOSURE_MODE*/
 	/*FIXME*/
 	value = MM_EXPOSURE_MODE;
-	exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order(ed),value);
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_EXPOSURE_MODE,
-	                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+	exif_set_short((unsigned char *)&eshort[cnts], byte_order,value);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_EXPOSURE_MODE,
+	                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_EXPOSURE_MODE);
 	}
@@ -2395,9 +2688,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 			set_value = 1;
 		}
 
-		exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order(ed), set_value);
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_WHITE_BALANCE,
-		                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+		exif_set_short((unsigned char *)&eshort[cnts], byte_order, set_value);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_WHITE_BALANCE,
+		                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 		if (ret != MM_ERROR_NONE) {
 			EXIF_SET_ERR(ret, EXIF_TAG_WHITE_BALANCE);
 		}
@@ -2411,9 +2704,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	if (ret == MM_ERROR_NONE) {
 		_mmcam_dbg_log("DIGITAL ZOOM [%d]", value);
 
-		exif_set_long(&elong[cntl], exif_data_get_byte_order(ed), value);
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_DIGITAL_ZOOM_RATIO,
-		                            EXIF_FORMAT_LONG, 1, (unsigned char *)&elong[cntl++]);
+		exif_set_long(&elong[cntl], byte_order, value);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_DIGITAL_ZOOM_RATIO,
+		                                 EXIF_FORMAT_LONG, 1, (unsigned char *)&elong[cntl++]);
 		if (ret != MM_ERROR_NONE) {
 			EXIF_SET_ERR(ret, EXIF_TAG_DIGITAL_ZOOM_RATIO);
 		}
@@ -2426,9 +2719,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	/*FIXME*/
 /*
 	value = MM_FOCAL_LENGTH_35MMFILM;
-	exif_set_short(&eshort[cnts], exif_data_get_byte_order(ed),value);
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_FOCAL_LENGTH_IN_35MM_FILM,
-	                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+	exif_set_short(&eshort[cnts], byte_order,value);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_FOCAL_LENGTH_IN_35MM_FILM,
+	                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_FOCAL_LENGTH_IN_35MM_FILM);
 	}
@@ -2454,9 +2747,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 				scene_capture_type = 4; /* Others */
 			}
 
-			exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order(ed), scene_capture_type);
-			ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_SCENE_CAPTURE_TYPE,
-			                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+			exif_set_short((unsigned char *)&eshort[cnts], byte_order, scene_capture_type);
+			ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_SCENE_CAPTURE_TYPE,
+			                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 			if (ret != MM_ERROR_NONE) {
 				EXIF_SET_ERR(ret, EXIF_TAG_SCENE_CAPTURE_TYPE);
 			}
@@ -2469,9 +2762,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	/*FIXME*/
 /*
 	value = MM_GAIN_CONTROL;
-	exif_set_long(&elong[cntl], exif_data_get_byte_order(ed), value);
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_GAIN_CONTROL,
-	                            EXIF_FORMAT_LONG, 1, (unsigned char *)&elong[cntl++]);
+	exif_set_long(&elong[cntl], byte_order, value);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_GAIN_CONTROL,
+	                                 EXIF_FORMAT_LONG, 1, (unsigned char *)&elong[cntl++]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_GAIN_CONTROL);
 	}
@@ -2500,9 +2793,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 				level = MM_VALUE_HARD;
 			}
 
-			exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order(ed), level);
-			ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_CONTRAST,
-			                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+			exif_set_short((unsigned char *)&eshort[cnts], byte_order, level);
+			ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_CONTRAST,
+			                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 			if (ret != MM_ERROR_NONE) {
 				EXIF_SET_ERR(ret, EXIF_TAG_CONTRAST);
 			}
@@ -2533,9 +2826,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 				level=MM_VALUE_HARD;
 			}
 
-			exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order(ed), level);
-			ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_SATURATION,
-			                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+			exif_set_short((unsigned char *)&eshort[cnts], byte_order, level);
+			ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_SATURATION,
+			                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 			if (ret != MM_ERROR_NONE) {
 				EXIF_SET_ERR(ret, EXIF_TAG_SATURATION);
 			}
@@ -2566,9 +2859,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 				level = MM_VALUE_HARD;
 			}
 
-			exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order(ed), level);
-			ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_SHARPNESS,
-			                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+			exif_set_short((unsigned char *)&eshort[cnts], byte_order, level);
+			ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_SHARPNESS,
+			                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 			if (ret != MM_ERROR_NONE) {
 				EXIF_SET_ERR(ret, EXIF_TAG_SHARPNESS);
 			}
@@ -2581,9 +2874,9 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	/*FIXME*/
 	value = MM_SUBJECT_DISTANCE_RANGE;
 	_mmcam_dbg_log("DISTANCE_RANGE [%d]", value);
-	exif_set_short((unsigned char *)&eshort[cnts], exif_data_get_byte_order(ed), value);
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_SUBJECT_DISTANCE_RANGE,
-	                            EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
+	exif_set_short((unsigned char *)&eshort[cnts], byte_order, value);
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_SUBJECT_DISTANCE_RANGE,
+	                                 EXIF_FORMAT_SHORT, 1, (unsigned char *)&eshort[cnts++]);
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_SUBJECT_DISTANCE_RANGE);
 	}
@@ -2595,8 +2888,8 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 		_mmcam_dbg_log("Tag for GPS is ENABLED.");
 
-		ret = mm_exif_set_add_entry(ed, EXIF_IFD_GPS, EXIF_TAG_GPS_VERSION_ID,
-		                            EXIF_FORMAT_BYTE, 4, (unsigned char *)&GpsVersion);
+		ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_GPS, EXIF_TAG_GPS_VERSION_ID,
+		                                 EXIF_FORMAT_BYTE, 4, (unsigned char *)&GpsVersion);
 		if (ret != MM_ERROR_NONE) {
 			EXIF_SET_ERR(ret, EXIF_TAG_GPS_VERSION_ID);
 		}
@@ -2614,22 +2907,22 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 		_mmcam_dbg_log("f_latitude [%f]", f_latitude);
 		if (f_latitude != INVALID_GPS_VALUE) {
-			unsigned char *b = NULL;
+			unsigned char b[3 * sizeof(ExifRational)];
 			unsigned int deg;
 			unsigned int min;
 			unsigned int sec;
 			ExifRational rData;
 
 			if (f_latitude < 0) {
-				ret = mm_exif_set_add_entry(ed, EXIF_IFD_GPS, EXIF_TAG_GPS_LATITUDE_REF,
-				                            EXIF_FORMAT_ASCII, 2, (unsigned char *)"S");
+				ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_GPS, EXIF_TAG_GPS_LATITUDE_REF,
+				                                 EXIF_FORMAT_ASCII, 2, (unsigned char *)"S");
 				if (ret != MM_ERROR_NONE) {
 					EXIF_SET_ERR(ret, EXIF_TAG_GPS_LATITUDE_REF);
 				}
 				f_latitude = -f_latitude;
 			} else if (f_latitude > 0) {
-				ret = mm_exif_set_add_entry(ed, EXIF_IFD_GPS, EXIF_TAG_GPS_LATITUDE_REF,
-				                            EXIF_FORMAT_ASCII, 2, (unsigned char *)"N");
+				ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_GPS, EXIF_TAG_GPS_LATITUDE_REF,
+				                                 EXIF_FORMAT_ASCII, 2, (unsigned char *)"N");
 				if (ret != MM_ERROR_NONE) {
 					EXIF_SET_ERR(ret, EXIF_TAG_GPS_LATITUDE_REF);
 				}
@@ -2640,46 +2933,40 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 			sec = (unsigned int)(((f_latitude-deg)*3600)-min*60);
 
 			_mmcam_dbg_log("f_latitude deg[%d], min[%d], sec[%d]", deg, min, sec);
-			b = malloc(3 * sizeof(ExifRational));
-			if (b) {
-				rData.numerator = deg;
-				rData.denominator = 1;
-				exif_set_rational(b, exif_data_get_byte_order(ed), rData);
-				rData.numerator = min;
-				exif_set_rational(b+8, exif_data_get_byte_order(ed), rData);
-				rData.numerator = sec;
-				exif_set_rational(b+16, exif_data_get_byte_order(ed), rData);
-
-				ret = mm_exif_set_add_entry(ed, EXIF_IFD_GPS, EXIF_TAG_GPS_LATITUDE,
-				                            EXIF_FORMAT_RATIONAL, 3, (unsigned char *)b);
-				free(b);
-				if (ret != MM_ERROR_NONE) {
-					EXIF_SET_ERR(ret, EXIF_TAG_GPS_LATITUDE);
-				}
-			} else {
-				_mmcam_dbg_warn("malloc failed");
+			rData.numerator = deg;
+			rData.denominator = 1;
+			exif_set_rational(b, byte_order, rData);
+			rData.numerator = min;
+			exif_set_rational(b+8, byte_order, rData);
+			rData.numerator = sec;
+			exif_set_rational(b+16, byte_order, rData);
+
+			ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_GPS, EXIF_TAG_GPS_LATITUDE,
+			                                 EXIF_FORMAT_RATIONAL, 3, (unsigned char *)b);
+			if (ret != MM_ERROR_NONE) {
+				EXIF_SET_ERR(ret, EXIF_TAG_GPS_LATITUDE);
 			}
 		}
 
 		/*42. Longitude*/
 		_mmcam_dbg_log("f_longitude [%f]", f_longitude);
 		if (f_longitude != INVALID_GPS_VALUE) {
-			unsigned char *b = NULL;
+			unsigned char b[3 * sizeof(ExifRational)];
 			unsigned int deg;
 			unsigned int min;
 			unsigned int sec;
 			ExifRational rData;
 
 			if (f_longitude < 0) {
-				ret = mm_exif_set_add_entry(ed, EXIF_IFD_GPS, EXIF_TAG_GPS_LONGITUDE_REF,
-				                            EXIF_FORMAT_ASCII, 2, (unsigned char *)"W");
+				ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_GPS, EXIF_TAG_GPS_LONGITUDE_REF,
+				                                 EXIF_FORMAT_ASCII, 2, (unsigned char *)"W");
 				if (ret != MM_ERROR_NONE) {
 					EXIF_SET_ERR(ret, EXIF_TAG_GPS_LONGITUDE_REF);
 				}
 				f_longitude = -f_longitude;
 			} else if (f_longitude > 0) {
-				ret = mm_exif_set_add_entry(ed, EXIF_IFD_GPS, EXIF_TAG_GPS_LONGITUDE_REF,
-				                            EXIF_FORMAT_ASCII, 2, (unsigned char *)"E");
+				ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_GPS, EXIF_TAG_GPS_LONGITUDE_REF,
+				                                 EXIF_FORMAT_ASCII, 2, (unsigned char *)"E");
 				if (ret != MM_ERROR_NONE) {
 					EXIF_SET_ERR(ret, EXIF_TAG_GPS_LONGITUDE_REF);
 				}
@@ -2690,23 +2977,17 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 			sec = (unsigned int)(((f_longitude-deg)*3600)-min*60);
 
 			_mmcam_dbg_log("f_longitude deg[%d], min[%d], sec[%d]", deg, min, sec);
-			b = malloc(3 * sizeof(ExifRational));
-			if (b) {
-				rData.numerator = deg;
-				rData.denominator = 1;
-				exif_set_rational(b, exif_data_get_byte_order(ed), rData);
-				rData.numerator = min;
-				exif_set_rational(b+8, exif_data_get_byte_order(ed), rData);
-				rData.numerator = sec;
-				exif_set_rational(b+16, exif_data_get_byte_order(ed), rData);
-				ret = mm_exif_set_add_entry(ed, EXIF_IFD_GPS, EXIF_TAG_GPS_LONGITUDE,
-				                            EXIF_FORMAT_RATIONAL, 3, (unsigned char *)b);
-				free(b);
-				if (ret != MM_ERROR_NONE) {
-					EXIF_SET_ERR(ret, EXIF_TAG_GPS_LONGITUDE);
-				}
-			} else {
-				_mmcam_dbg_warn("malloc failed");
+			rData.numerator = deg;
+			rData.denominator = 1;
+			exif_set_rational(b, byte_order, rData);
+			rData.numerator = min;
+			exif_set_rational(b+8, byte_order, rData);
+			rData.numerator = sec;
+			exif_set_rational(b+16, byte_order, rData);
+			ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_GPS, EXIF_TAG_GPS_LONGITUDE,
+			                                 EXIF_FORMAT_RATIONAL, 3, (unsigned char *)b);
+			if (ret != MM_ERROR_NONE) {
+				EXIF_SET_ERR(ret, EXIF_TAG_GPS_LONGITUDE);
 			}
 		}
 
@@ -2714,37 +2995,29 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 		_mmcam_dbg_log("f_altitude [%f]", f_altitude);
 		if (f_altitude != INVALID_GPS_VALUE) {
 			ExifByte alt_ref = 0;
-			unsigned char *b = NULL;
+			unsigned char b[sizeof(ExifRational)];
 			ExifRational rData;
-			b = malloc(sizeof(ExifRational));
-			if (b) {
-				if (f_altitude < 0) {
-					alt_ref = 1;
-					f_altitude = -f_altitude;
-				}
+			if (f_altitude < 0) {
+				alt_ref = 1;
+				f_altitude = -f_altitude;
+			}
 
-				ret = mm_exif_set_add_entry(ed, EXIF_IFD_GPS, EXIF_TAG_GPS_ALTITUDE_REF,
-				                            EXIF_FORMAT_BYTE, 1, (unsigned char *)&alt_ref);
-				if (ret != MM_ERROR_NONE) {
-					_mmcam_dbg_err("error [%x], tag [%x]", ret, EXIF_TAG_GPS_ALTITUDE_REF);
-					if (ret == MM_ERROR_CAMCORDER_LOW_MEMORY) {
-						free(b);
-						b = NULL;
-						goto exit;
-					}
+			ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_GPS, EXIF_TAG_GPS_ALTITUDE_REF,
+			                                 EXIF_FORMAT_BYTE, 1, (unsigned char *)&alt_ref);
+			if (ret != MM_ERROR_NONE) {
+				_mmcam_dbg_err("error [%x], tag [%x]", ret, EXIF_TAG_GPS_ALTITUDE_REF);
+				if (ret == MM_ERROR_CAMCORDER_LOW_MEMORY) {
+					goto exit;
 				}
+			}
 
-				rData.numerator = (unsigned int)(f_altitude + 0.5)*100;
-				rData.denominator = 100;
-				exif_set_rational(b, exif_data_get_byte_order(ed), rData);
-				ret = mm_exif_set_add_entry(ed, EXIF_IFD_GPS, EXIF_TAG_GPS_ALTITUDE,
-				                            EXIF_FORMAT_RATIONAL, 1, (unsigned char *)b);
-				free(b);
-				if (ret != MM_ERROR_NONE) {
-					EXIF_SET_ERR(ret, EXIF_TAG_GPS_ALTITUDE);
-				}
-			} else {
-				_mmcam_dbg_warn("malloc failed");
+			rData.numerator = (unsigned int)(f_altitude + 0.5)*100;
+			rData.denominator = 100;
+			exif_set_rational(b, byte_order, rData);
+			ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_GPS, EXIF_TAG_GPS_ALTITUDE,
+			                                 EXIF_FORMAT_RATIONAL, 1, (unsigned char *)b);
+			if (ret != MM_ERROR_NONE) {
+				EXIF_SET_ERR(ret, EXIF_TAG_GPS_ALTITUDE);
 			}
 		}
 
@@ -2754,7 +3027,7 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 			mm_camcorder_get_attributes(handle, NULL, "tag-gps-time-stamp", &gps_timestamp, NULL);
 			_mmcam_dbg_log("Gps timestamp [%f]", gps_timestamp);
 			if (gps_timestamp > 0.0) {
-				unsigned char *b = NULL;
+				unsigned char b[3 * sizeof(ExifRational)];
 				unsigned int hour;
 				unsigned int min;
 				unsigned int microsec;
@@ -2765,28 +3038,22 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 				microsec = (unsigned int)(((double)((double)gps_timestamp -(double)(3600 * hour)) -(double)(60 * min)) * 1000000);
 
 				_mmcam_dbg_log("Gps timestamp hour[%d], min[%d], microsec[%d]", hour, min, microsec);
-				b = malloc(3 * sizeof(ExifRational));
-				if (b) {
-					rData.numerator = hour;
-					rData.denominator = 1;
-					exif_set_rational(b, exif_data_get_byte_order(ed), rData);
-
-					rData.numerator = min;
-					rData.denominator = 1;
-					exif_set_rational(b + 8, exif_data_get_byte_order(ed), rData);
-
-					rData.numerator = microsec;
-					rData.denominator = 1000000;
-					exif_set_rational(b + 16, exif_data_get_byte_order(ed), rData);
-
-					ret = mm_exif_set_add_entry(ed, EXIF_IFD_GPS, EXIF_TAG_GPS_TIME_STAMP,
-					                            EXIF_FORMAT_RATIONAL, 3, b);
-					free(b);
-					if (ret != MM_ERROR_NONE) {
-						EXIF_SET_ERR(ret, EXIF_TAG_GPS_TIME_STAMP);
-					}
-				} else {
-					_mmcam_dbg_warn( "malloc failed." );
+				rData.numerator = hour;
+				rData.denominator = 1;
+				exif_set_rational(b, byte_order, rData);
+
+				rData.numerator = min;
+				rData.denominator = 1;
+				exif_set_rational(b + 8, byte_order, rData);
+
+				rData.numerator = microsec;
+				rData.denominator = 1000000;
+				exif_set_rational(b + 16, byte_order, rData);
+
+				ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_GPS, EXIF_TAG_GPS_TIME_STAMP,
+				                                 EXIF_FORMAT_RATIONAL, 3, b);
+				if (ret != MM_ERROR_NONE) {
+					EXIF_SET_ERR(ret, EXIF_TAG_GPS_TIME_STAMP);
 				}
 			}
 		}
@@ -2802,8 +3069,8 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 				_mmcam_dbg_log("Date stamp [%s]", date_stamp);
 
 				/* cause it should include NULL char */
-				ret = mm_exif_set_add_entry(ed, EXIF_IFD_GPS, EXIF_TAG_GPS_DATE_STAMP,
-				                            EXIF_FORMAT_ASCII, date_stamp_len + 1, date_stamp);
+				ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_GPS, EXIF_TAG_GPS_DATE_STAMP,
+				                                 EXIF_FORMAT_ASCII, date_stamp_len + 1, date_stamp);
 				if (ret != MM_ERROR_NONE) {
 					EXIF_SET_ERR(ret, EXIF_TAG_GPS_DATE_STAMP);
 				}
@@ -2820,8 +3087,8 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 			if (processing_method) {
 				_mmcam_dbg_log("Processing method [%s]", processing_method);
 
-				ret = mm_exif_set_add_entry(ed, EXIF_IFD_GPS, EXIF_TAG_GPS_PROCESSING_METHOD,
-				                            EXIF_FORMAT_UNDEFINED, processing_method_len, processing_method);
+				ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_GPS, EXIF_TAG_GPS_PROCESSING_METHOD,
+				                                 EXIF_FORMAT_UNDEFINED, processing_method_len, processing_method);
 				if (ret != MM_ERROR_NONE) {
 					EXIF_SET_ERR(ret, EXIF_TAG_GPS_PROCESSING_METHOD);
 				}
@@ -2833,12 +3100,18 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 
 
 	/*47. EXIF_TAG_MAKER_NOTE*/
-	ret = mm_exif_set_add_entry(ed, EXIF_IFD_EXIF, EXIF_TAG_MAKER_NOTE,
-	                            EXIF_FORMAT_UNDEFINED, 8, (unsigned char *)"SAMSUNG");
+	ret = mm_exif_template_set_entry(tmpl, ed, EXIF_IFD_EXIF, EXIF_TAG_MAKER_NOTE,
+	                                 EXIF_FORMAT_UNDEFINED, 8, (unsigned char *)"SAMSUNG");
 	if (ret != MM_ERROR_NONE) {
 		EXIF_SET_ERR(ret, EXIF_TAG_MAKER_NOTE);
 	}
 
+	/* maker note is kept as it is in template */
+	if (ed == NULL) {
+		ret = MM_ERROR_NONE;
+		goto exit;
+	}
+
 	/* create and link samsung maker note */
 	ret = mm_exif_mnote_create(ed);
 	if (ret != MM_ERROR_NONE){
@@ -2879,19 +3152,10 @@ int __mmcamcorder_set_exif_basic_info(MMHandleType handle, int image_width, int
 	*/
 	}
 
-	_mmcam_dbg_log("");
-
-	ret = mm_exif_set_exif_to_info(hcamcorder->exif_info, ed);
-	if (ret != MM_ERROR_NONE) {
-		_mmcam_dbg_err("mm_exif_set_exif_to_info err!! [%x]", ret);
-	}
+	ret = MM_ERROR_NONE;
 
 exit:
 	_mmcam_dbg_log("finished!! [%x]", ret);
 
-	if (ed) {
-		exif_data_unref (ed);
-	}
-
 	return ret;
 }
@@ -26,11 +26,25 @@
 ========================================================================================== */
 #include <stdio.h>
 #include <stdarg.h>
+#include <errno.h>
 #include <camsrcjpegenc.h>
 #include <sys/vfs.h> /* struct statfs */
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <math.h>
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define _MMCAMCORDER_AUDIO_METER_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define _MMCAMCORDER_AUDIO_METER_SSE2
+#endif
 
 #include "mm_camcorder_internal.h"
 #include "mm_camcorder_util.h"
+#include "mm_camcorder_jpegenc.h"
 
 /*---------------------------------------------------------------------------
 |    GLOBAL VARIABLE DEFINITIONS for internal								|
@@ -40,23 +54,6 @@
 |    LOCAL VARIABLE DEFINITIONS for internal								|
 ---------------------------------------------------------------------------*/
 #define TIME_STRING_MAX_LEN   64
-#define FPUTC_CHECK(x_char, x_file)\
-{\
-	if (fputc(x_char, x_file) == EOF) \
-	{\
-		_mmcam_dbg_err("[Critical] fputc() returns fail.\n");	\
-		return FALSE;\
-	}\
-}
-#define FPUTS_CHECK(x_str, x_file)\
-{\
-	if (fputs(x_str, x_file) == EOF) \
-	{\
-		_mmcam_dbg_err("[Critical] fputs() returns fail.\n");\
-		SAFE_FREE(str);	\
-		return FALSE;\
-	}\
-}
 
 /*---------------------------------------------------------------------------
 |    LOCAL FUNCTION PROTOTYPES:												|
@@ -66,10 +63,31 @@
 //static gint 		skip_mdat(FILE *f);
 static guint16           get_language_code(const char *str);
 static gchar*            str_to_utf8(const gchar *str);
-static inline gboolean   write_tag(FILE *f, const gchar *tag);
-static inline gboolean   write_to_32(FILE *f, guint val);
-static inline gboolean   write_to_16(FILE *f, guint val);
-static inline gboolean   write_to_24(FILE *f, guint val);
+static inline void       put_tag(GByteArray *array, const gchar *tag);
+static inline void       put_32(GByteArray *array, guint val);
+static inline void       put_16(GByteArray *array, guint val);
+static inline void       put_24(GByteArray *array, guint val);
+static inline void       put_8(GByteArray *array, guint val);
+static inline void       put_string(GByteArray *array, const gchar *str);
+static inline void       put_size(GByteArray *array, guint pos);
+static int               __mmcamcorder_box_index_add(_MMCamcorderBoxIndex *index, const guchar *header, guint64 offset,
+                                                     guint64 limit, int parent);
+static gboolean          __mmcamcorder_box_index_map(_MMCamcorderBoxIndex *index, int box);
+static gboolean          __mmcamcorder_box_index_write_size(_MMCamcorderBoxIndex *index, int box, guint64 size);
+static void              __mmcamcorder_buffer_pool_flush(_MMCamcorderBufferPool *pool);
+static gboolean          __mmcamcorder_msg_is_coalescable(mmf_camcorder_t *hcamcorder, int id);
+static _MMCamcorderMsgStats *__mmcamcorder_msg_get_stats(_MMCamcorderMsgQueue *queue, int id);
+static void              __mmcamcorder_msg_release_data(_MMCamcorderMsgItem *item);
+static void             *__mmcamcorder_storage_monitor_thread(void *arg);
+static void              __mmcamcorder_storage_monitor_publish(_MMCamcorderStorageMonitor *monitor, _MMCamcorderStorageInfo *info);
+static void              __mmcamcorder_audio_meter_s16(const short *pcm, unsigned int frames, int channel, guint64 *square_sum, int *peak);
+static void              __mmcamcorder_audio_meter_u8(const unsigned char *pcm, unsigned int frames, int channel, guint64 *square_sum, int *peak);
+static void              __mmcamcorder_audio_meter_complete(_MMCamcorderAudioMeter *meter);
+static void              __mmcamcorder_audio_meter_reset(_MMCamcorderAudioMeter *meter, int format, int channel);
+static void              __mmcamcorder_pre_record_buffer_drop(_MMCamcorderPreRecordBuffer *pre_record, _MMCamcorderPreRecordStream stream);
+static void              __mmcamcorder_pre_record_buffer_trim(_MMCamcorderPreRecordBuffer *pre_record);
+static void             *__mmcamcorder_encode_pool_thread(void *arg);
+static gint              __mmcamcorder_encode_pool_compare(gconstpointer a, gconstpointer b, gpointer user_data);
 
 /*===========================================================================================
 |																							|
@@ -85,159 +103,304 @@ gint32 _mmcamcorder_double_to_fix(gdouble d_number)
 	return (gint32) (d_number * 65536.0);
 }
 
-// find top level tag only, do not use this function for finding sub level tags
-gint _mmcamcorder_find_tag(FILE *f, guint32 tag_fourcc)
+gboolean _mmcamcorder_box_index_open(_MMCamcorderBoxIndex *index, const char *filename)
 {
-	guchar buf[8];
+	int box = 0;
+	int moov = -1;
+	guint64 offset = 0;
+	guchar header[16];
+	struct stat st;
 
-	rewind(f);
+	mmf_return_val_if_fail(index && filename, FALSE);
 
-	while(fread(&buf, sizeof(guchar), 8, f)>0)
-	{
-		gulong buf_size = 0;
-		guint32 buf_fourcc = MMCAM_FOURCC(buf[4], buf[5],buf[6],buf[7]);
+	memset(index, 0x00, sizeof(_MMCamcorderBoxIndex));
+	index->fd = -1;
 
-		if(tag_fourcc == buf_fourcc)
-		{
-			_mmcam_dbg_log("find tag : %c%c%c%c", MMCAM_FOURCC_ARGS(tag_fourcc));
-			return 1;
+	index->fd = open(filename, O_RDWR);
+	if (index->fd < 0) {
+		_mmcam_dbg_err("open [%s] failed [%s]", filename, strerror(errno));
+		return FALSE;
+	}
+
+	if (fstat(index->fd, &st) < 0) {
+		_mmcam_dbg_err("fstat failed [%s]", strerror(errno));
+		goto _INDEX_OPEN_FAILED;
+	}
+
+	index->file_size = (guint64)st.st_size;
+
+	/* top level boxes - read only headers, 'mdat' is never touched */
+	while (offset + 8 <= index->file_size) {
+		memset(header, 0x00, sizeof(header));
+		if (pread(index->fd, header, sizeof(header), (off_t)offset) < 8) {
+			_mmcam_dbg_err("pread failed at %" G_GUINT64_FORMAT, offset);
+			goto _INDEX_OPEN_FAILED;
 		}
-		else
-		{
-			_mmcam_dbg_log("skip [%c%c%c%c]  tag", MMCAM_FOURCC_ARGS(buf_fourcc));		
-			buf_size = _mmcamcorder_get_container_size(buf);
-			if(fseek(f, buf_size-8, SEEK_CUR) != 0)
-			{
-				_mmcam_dbg_err("fseek() fail");
-				return 0;
-			}		
+
+		box = __mmcamcorder_box_index_add(index, header, offset, index->file_size, -1);
+		if (box < 0) {
+			goto _INDEX_OPEN_FAILED;
+		}
+
+		if (index->box[box].fourcc == MMCAM_FOURCC('m','o','o','v')) {
+			moov = box;
+		}
+
+		if (index->box[box].size == 0) {
+			break;
+		}
+
+		offset += index->box[box].size;
+	}
+
+	/* children of 'moov' from mapped memory */
+	if (moov >= 0) {
+		guint64 end = 0;
+		guchar *data = NULL;
+
+		if (!__mmcamcorder_box_index_map(index, moov)) {
+			goto _INDEX_OPEN_FAILED;
+		}
+
+		offset = index->box[moov].offset + index->box[moov].header_size;
+		end = index->box[moov].size ? index->box[moov].offset + index->box[moov].size : index->file_size;
+
+		while (offset + 8 <= end) {
+			data = index->map + (offset - index->map_offset);
+			memset(header, 0x00, sizeof(header));
+			memcpy(header, data, MIN(sizeof(header), end - offset));
+
+			box = __mmcamcorder_box_index_add(index, header, offset, end, moov);
+			if (box < 0) {
+				goto _INDEX_OPEN_FAILED;
+			}
+
+			if (index->box[box].size == 0) {
+				break;
+			}
+
+			offset += index->box[box].size;
 		}
 	}
-	_mmcam_dbg_log("cannot find tag : %c%c%c%c", MMCAM_FOURCC_ARGS(tag_fourcc));
-	return 0;
+
+	_mmcam_dbg_log("[%s] size %" G_GUINT64_FORMAT ", %d boxes indexed", filename, index->file_size, index->box_num);
+
+	return TRUE;
+
+_INDEX_OPEN_FAILED:
+	_mmcamcorder_box_index_close(index);
+	return FALSE;
 }
 
-gboolean _mmcamcorder_update_size(FILE *f, gint64 prev_pos, gint64 curr_pos)
+
+void _mmcamcorder_box_index_close(_MMCamcorderBoxIndex *index)
 {
-	_mmcam_dbg_log("size : %"G_GINT64_FORMAT"", curr_pos-prev_pos);
-	if(fseek(f, prev_pos, SEEK_SET) != 0)
-	{
-		_mmcam_dbg_err("fseek() fail");
-		return FALSE;
+	mmf_return_if_fail(index);
+
+	if (index->map) {
+		munmap(index->map, index->map_size);
+		index->map = NULL;
+		index->map_size = 0;
 	}
 
-	if (!write_to_32(f, curr_pos -prev_pos))
-		return FALSE;
-	
-	if(fseek(f, curr_pos, SEEK_SET) != 0)
-	{
-		_mmcam_dbg_err("fseek() fail");
-		return FALSE;
+	if (index->fd >= 0) {
+		close(index->fd);
+		index->fd = -1;
 	}
-	
+
+	index->box_num = 0;
+
+	return;
+}
+
+
+int _mmcamcorder_box_index_find(_MMCamcorderBoxIndex *index, int parent, guint32 fourcc)
+{
+	int i = 0;
+
+	mmf_return_val_if_fail(index, -1);
+
+	for (i = 0 ; i < index->box_num ; i++) {
+		if (index->box[i].parent == parent && index->box[i].fourcc == fourcc) {
+			_mmcam_dbg_log("find box : %c%c%c%c", MMCAM_FOURCC_ARGS(fourcc));
+			return i;
+		}
+	}
+
+	_mmcam_dbg_log("cannot find box : %c%c%c%c", MMCAM_FOURCC_ARGS(fourcc));
+
+	return -1;
+}
+
+
+gboolean _mmcamcorder_box_index_append(_MMCamcorderBoxIndex *index, int box, const guchar *data, guint32 size)
+{
+	int i = 0;
+	ssize_t written = 0;
+	guint64 offset = 0;
+
+	mmf_return_val_if_fail(index && index->fd >= 0 && data && size >= 8, FALSE);
+	mmf_return_val_if_fail(box >= -1 && box < index->box_num, FALSE);
+
+	/* box and all of its parents should end at end of file to be extended in place */
+	for (i = box ; i >= 0 ; i = index->box[i].parent) {
+		if (index->box[i].size != 0 &&
+		    index->box[i].offset + index->box[i].size != index->file_size) {
+			_mmcam_dbg_err("[%c%c%c%c] is not at end of file, can not append",
+			               MMCAM_FOURCC_ARGS(index->box[i].fourcc));
+			return FALSE;
+		}
+
+		if (index->box[i].header_size == 8 &&
+		    index->box[i].size + size > G_MAXUINT32) {
+			_mmcam_dbg_err("[%c%c%c%c] exceeds 32bit size", MMCAM_FOURCC_ARGS(index->box[i].fourcc));
+			return FALSE;
+		}
+	}
+
+	offset = index->file_size;
+
+	while (written < (ssize_t)size) {
+		ssize_t ret = pwrite(index->fd, data + written, size - written, (off_t)(offset + written));
+		if (ret <= 0) {
+			_mmcam_dbg_err("pwrite failed [%s]", strerror(errno));
+			if (ftruncate(index->fd, (off_t)offset) < 0) {
+				_mmcam_dbg_err("ftruncate failed [%s]", strerror(errno));
+			}
+			return FALSE;
+		}
+		written += ret;
+	}
+
+	index->file_size += size;
+
+	/* patch sizes of box and parents */
+	for (i = box ; i >= 0 ; i = index->box[i].parent) {
+		if (index->box[i].size == 0) {
+			continue;
+		}
+
+		if (!__mmcamcorder_box_index_write_size(index, i, index->box[i].size + size)) {
+			return FALSE;
+		}
+	}
+
+	/* index appended box, so that boxes can be appended into it */
+	if (index->box_num < _MMCAMCORDER_BOX_INDEX_MAX) {
+		__mmcamcorder_box_index_add(index, data, offset, index->file_size, box);
+	}
+
 	return TRUE;
 }
 
-gboolean _mmcamcorder_write_loci(FILE *f, _MMCamcorderLocationInfo info)
+
+GByteArray *_mmcamcorder_make_loci(_MMCamcorderLocationInfo info)
 {
-	gint64 current_pos, pos;
 	gchar *str = NULL;
+	GByteArray *array = NULL;
 
 	_mmcam_dbg_log("");
 
-	if((pos = ftell(f))<0)
-	{
-		_mmcam_dbg_err("ftell() returns negative value");	
-		return FALSE;
+	array = g_byte_array_sized_new(128);
+	if (array == NULL) {
+		return NULL;
 	}
-	
-	if(!write_to_32(f, 0)) //size
-		return FALSE;
-	
-	if(!write_tag(f, "loci")) 	// type
-		return FALSE;
-	
-	FPUTC_CHECK(0, f);		// version
 
-	if(!write_to_24(f, 0))	// flags
-		return FALSE;
-	
-	if(!write_to_16(f, get_language_code("eng"))) // language
-		return FALSE;
-	
+	put_32(array, 0);                               // size
+	put_tag(array, "loci");                         // type
+	put_8(array, 0);                                // version
+	put_24(array, 0);                               // flags
+	put_16(array, get_language_code("eng"));        // language
+
 	str = str_to_utf8("location_name");
-	
-	FPUTS_CHECK(str, f); // name
+	put_string(array, str);                         // name
 	SAFE_FREE(str);
-	
-	FPUTC_CHECK('\0', f);
-	FPUTC_CHECK(0, f);		//role
-	
-	if(!write_to_32(f, info.longitude))	// Longitude
-		return FALSE;
-	
-	if(!write_to_32(f, info.latitude)) // Latitude
-		return FALSE;
-	
-	if(! write_to_32(f, info.altitude))	// Altitude
-		return FALSE;
-	
+
+	put_8(array, 0);                                // role
+	put_32(array, info.longitude);                  // Longitude
+	put_32(array, info.latitude);                   // Latitude
+	put_32(array, info.altitude);                   // Altitude
+
 	str = str_to_utf8("Astronomical_body");
-	FPUTS_CHECK(str, f);//Astronomical_body
+	put_string(array, str);                         // Astronomical_body
 	SAFE_FREE(str);
-	
-	FPUTC_CHECK('\0', f);
-	
+
 	str = str_to_utf8("Additional_notes");
-	FPUTS_CHECK(str, f); // Additional_notes
+	put_string(array, str);                         // Additional_notes
 	SAFE_FREE(str);
-	
-	FPUTC_CHECK('\0', f);
-	
-	if((current_pos = ftell(f))<0)
-	{
-		_mmcam_dbg_err("ftell() returns negative value");	
-		return FALSE;
-	}
-	
-	if(! _mmcamcorder_update_size(f, pos, current_pos))
-		return FALSE;
 
-	return TRUE;
+	put_size(array, 0);
+
+	return array;
 }
 
-gboolean _mmcamcorder_write_udta(FILE *f, _MMCamcorderLocationInfo info)
+
+GByteArray *_mmcamcorder_make_udta(_MMCamcorderLocationInfo info)
 {
-	gint64 current_pos, pos;
+	GByteArray *array = NULL;
+	GByteArray *loci = NULL;
 
 	_mmcam_dbg_log("");
- 
-	if((pos = ftell(f))<0)
-	{
-		_mmcam_dbg_err("ftell() returns negative value");	
-		return FALSE;
+
+	loci = _mmcamcorder_make_loci(info);
+	if (loci == NULL) {
+		return NULL;
 	}
- 	
-	if(!write_to_32(f, 0)) 	//size 
-		return FALSE;
-  	
-	if(!write_tag(f, "udta")) 	// type	
-		return FALSE;
- 	
-	if(! _mmcamcorder_write_loci(f, info))
-		return FALSE;
- 	
-	if((current_pos = ftell(f))<0)
-	{
-		_mmcam_dbg_err("ftell() returns negative value");
+
+	array = g_byte_array_sized_new(loci->len + 8);
+	if (array == NULL) {
+		g_byte_array_free(loci, TRUE);
+		return NULL;
+	}
+
+	put_32(array, 0);                               // size
+	put_tag(array, "udta");                         // type
+	g_byte_array_append(array, loci->data, loci->len);
+	put_size(array, 0);
+
+	g_byte_array_free(loci, TRUE);
+
+	return array;
+}
+
+
+gboolean _mmcamcorder_write_loci(_MMCamcorderBoxIndex *index, int udta, _MMCamcorderLocationInfo info)
+{
+	gboolean ret = FALSE;
+	GByteArray *loci = NULL;
+
+	mmf_return_val_if_fail(index, FALSE);
+
+	loci = _mmcamcorder_make_loci(info);
+	if (loci == NULL) {
 		return FALSE;
 	}
- 
-	if(! _mmcamcorder_update_size(f, pos, current_pos))
+
+	ret = _mmcamcorder_box_index_append(index, udta, loci->data, loci->len);
+
+	g_byte_array_free(loci, TRUE);
+
+	return ret;
+}
+
+
+gboolean _mmcamcorder_write_udta(_MMCamcorderBoxIndex *index, int moov, _MMCamcorderLocationInfo info)
+{
+	gboolean ret = FALSE;
+	GByteArray *udta = NULL;
+
+	mmf_return_val_if_fail(index, FALSE);
+
+	udta = _mmcamcorder_make_udta(info);
+	if (udta == NULL) {
 		return FALSE;
- 
+	}
 
-	return TRUE;
+	ret = _mmcamcorder_box_index_append(index, moov, udta->data, udta->len);
+
+	g_byte_array_free(udta, TRUE);
+
+	return ret;
 }
 
 
@@ -260,20 +423,996 @@ int _mmcamcorder_get_freespace(const gchar *path, guint64 *free_space)
 {
 	struct statfs fs;
 
-	g_assert(path);
+	g_assert(path);
+
+	if (!g_file_test(path, G_FILE_TEST_EXISTS | G_FILE_TEST_IS_DIR)) {
+		_mmcam_dbg_log("File(%s) doesn't exist.", path);
+		return -2;
+	}
+
+	if (-1 == statfs(path, &fs)) {
+		_mmcam_dbg_log("Getting free space is failed.(%s)", path);
+		return -1;
+	}
+
+	*free_space = (guint64)fs.f_bsize * fs.f_bavail;
+	return 1;
+}
+
+
+gboolean _mmcamcorder_storage_monitor_start(_MMCamcorderStorageMonitor *monitor)
+{
+	mmf_return_val_if_fail(monitor, FALSE);
+
+	if (monitor->lock) {
+		_mmcam_dbg_log("already started");
+		return TRUE;
+	}
+
+	memset(monitor, 0x00, sizeof(_MMCamcorderStorageMonitor));
+
+	monitor->lock = g_mutex_new();
+	monitor->cond = g_cond_new();
+	monitor->running = TRUE;
+
+	if (pthread_create(&(monitor->thread), NULL, __mmcamcorder_storage_monitor_thread, monitor)) {
+		_mmcam_dbg_err("failed to create storage monitor thread");
+
+		g_cond_free(monitor->cond);
+		monitor->cond = NULL;
+		g_mutex_free(monitor->lock);
+		monitor->lock = NULL;
+		monitor->running = FALSE;
+
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+
+void _mmcamcorder_storage_monitor_stop(_MMCamcorderStorageMonitor *monitor)
+{
+	mmf_return_if_fail(monitor);
+
+	if (monitor->lock == NULL) {
+		return;
+	}
+
+	g_mutex_lock(monitor->lock);
+	monitor->running = FALSE;
+	g_cond_signal(monitor->cond);
+	g_mutex_unlock(monitor->lock);
+
+	pthread_join(monitor->thread, NULL);
+
+	if (monitor->path) {
+		g_free(monitor->path);
+		monitor->path = NULL;
+	}
+
+	g_cond_free(monitor->cond);
+	monitor->cond = NULL;
+	g_mutex_free(monitor->lock);
+	monitor->lock = NULL;
+
+	return;
+}
+
+
+void _mmcamcorder_storage_monitor_set_path(_MMCamcorderStorageMonitor *monitor, const char *path)
+{
+	_MMCamcorderStorageInfo info;
+
+	mmf_return_if_fail(monitor);
+
+	if (monitor->lock == NULL) {
+		/* not started */
+		return;
+	}
+
+	_mmcam_dbg_log("path %s", path ? path : "NULL");
+
+	memset(&info, 0x00, sizeof(_MMCamcorderStorageInfo));
+
+	g_mutex_lock(monitor->lock);
+
+	if (monitor->path) {
+		g_free(monitor->path);
+		monitor->path = NULL;
+	}
+	if (path) {
+		/* recording file is not created until pipeline starts, so check its directory */
+		monitor->path = g_path_get_dirname(path);
+	}
+	monitor->generation++;
+
+	/* forget information of previous path and check new path right now */
+	__mmcamcorder_storage_monitor_publish(monitor, &info);
+	g_cond_signal(monitor->cond);
+
+	g_mutex_unlock(monitor->lock);
+
+	return;
+}
+
+
+void _mmcamcorder_storage_monitor_get_info(_MMCamcorderStorageMonitor *monitor, _MMCamcorderStorageInfo *info)
+{
+	gint count = 0;
+	gint64 elapsed = 0;
+	guint64 consumed = 0;
+
+	mmf_return_if_fail(monitor && info);
+
+	/* lock-free read of the latest published information.
+	   the slot could be overwritten if it's published twice while copying, then read again. */
+	do {
+		count = g_atomic_int_get(&(monitor->publish_count));
+		memcpy(info, &(monitor->info[g_atomic_int_get(&(monitor->index))]), sizeof(_MMCamcorderStorageInfo));
+	} while (count != g_atomic_int_get(&(monitor->publish_count)));
+
+	/* predict free space at this moment from write rate */
+	if (info->status > 0 && info->write_rate > 0) {
+		elapsed = g_get_monotonic_time() - info->check_time;
+		if (elapsed > 0) {
+			consumed = (info->write_rate * (guint64)elapsed) / G_USEC_PER_SEC;
+			info->free_space = (info->free_space > consumed) ? (info->free_space - consumed) : 0;
+		}
+	}
+
+	return;
+}
+
+
+unsigned int _mmcamcorder_storage_monitor_get_remained_time(_MMCamcorderStorageMonitor *monitor, guint64 reserved_size)
+{
+	guint64 remained_time = 0;
+	_MMCamcorderStorageInfo info;
+
+	mmf_return_val_if_fail(monitor, 0);
+
+	_mmcamcorder_storage_monitor_get_info(monitor, &info);
+
+	/* unknown */
+	if (info.status <= 0 || info.write_rate == 0) {
+		return 0;
+	}
+
+	if (info.free_space <= reserved_size) {
+		return 0;
+	}
+
+	remained_time = ((info.free_space - reserved_size) * 1000) / info.write_rate;
+	if (remained_time > G_MAXUINT) {
+		remained_time = G_MAXUINT;
+	}
+
+	return (unsigned int)remained_time;
+}
+
+
+gboolean _mmcamcorder_audio_meter_init(_MMCamcorderAudioMeter *meter, int samplerate, int interval)
+{
+	mmf_return_val_if_fail(meter, FALSE);
+
+	if (samplerate <= 0) {
+		_mmcam_dbg_err("invalid samplerate %d", samplerate);
+		return FALSE;
+	}
+
+	if (interval < _MMCAMCORDER_AUDIO_METER_INTERVAL_MIN) {
+		_mmcam_dbg_warn("interval %d is too short, use %d", interval, _MMCAMCORDER_AUDIO_METER_INTERVAL_MIN);
+		interval = _MMCAMCORDER_AUDIO_METER_INTERVAL_MIN;
+	}
+
+	if (meter->lock == NULL) {
+		memset(meter, 0x00, sizeof(_MMCamcorderAudioMeter));
+		meter->lock = g_mutex_new();
+	}
+
+	g_mutex_lock(meter->lock);
+
+	meter->window_frames = (unsigned int)(((guint64)samplerate * interval) / 1000);
+	if (meter->window_frames == 0) {
+		meter->window_frames = 1;
+	}
+
+	__mmcamcorder_audio_meter_reset(meter, MM_CAMCORDER_AUDIO_FORMAT_PCM_S16_LE, 1);
+	memcpy(&(meter->level), &(meter->last), sizeof(MMCamcorderAudioLevel));
+
+	g_mutex_unlock(meter->lock);
+
+	_mmcam_dbg_log("samplerate %d, interval %d ms, window %u frames", samplerate, interval, meter->window_frames);
+
+	return TRUE;
+}
+
+
+void _mmcamcorder_audio_meter_deinit(_MMCamcorderAudioMeter *meter)
+{
+	mmf_return_if_fail(meter);
+
+	if (meter->lock) {
+		g_mutex_free(meter->lock);
+		meter->lock = NULL;
+	}
+
+	return;
+}
+
+
+gboolean _mmcamcorder_audio_meter_process(_MMCamcorderAudioMeter *meter, const unsigned char *data, unsigned int size,
+                                          int format, int channel, MMCamcorderAudioLevel *level)
+{
+	int sample_size = 0;
+	unsigned int frames = 0;
+	unsigned int chunk = 0;
+	gboolean completed = FALSE;
+
+	mmf_return_val_if_fail(meter && level, FALSE);
+
+	if (meter->lock == NULL) {
+		return FALSE;
+	}
+
+	if (channel < 1 || channel > MM_CAMCORDER_AUDIO_LEVEL_CHANNEL_MAX) {
+		_mmcam_dbg_warn("not supported channel %d", channel);
+		return FALSE;
+	}
+
+	/* start new window if format is changed */
+	if (format != meter->format || channel != meter->channel) {
+		__mmcamcorder_audio_meter_reset(meter, format, channel);
+	}
+
+	if (format == MM_CAMCORDER_AUDIO_FORMAT_PCM_S16_LE) {
+		sample_size = 2;
+	} else {
+		sample_size = 1;
+	}
+
+	frames = size / (sample_size * channel);
+
+	while (frames > 0) {
+		chunk = meter->window_frames - meter->frame_count;
+		if (chunk > frames) {
+			chunk = frames;
+		}
+
+		/* NULL data means silence, nothing to accumulate */
+		if (data) {
+			if (sample_size == 2) {
+				__mmcamcorder_audio_meter_s16((const short *)data, chunk, channel, meter->square_sum, meter->peak);
+			} else {
+				__mmcamcorder_audio_meter_u8(data, chunk, channel, meter->square_sum, meter->peak);
+			}
+
+			data += chunk * sample_size * channel;
+		}
+
+		frames -= chunk;
+		meter->frame_count += chunk;
+
+		if (meter->frame_count >= meter->window_frames) {
+			__mmcamcorder_audio_meter_complete(meter);
+			completed = TRUE;
+		}
+	}
+
+	memcpy(level, &(meter->last), sizeof(MMCamcorderAudioLevel));
+
+	return completed;
+}
+
+
+void _mmcamcorder_audio_meter_get_level(_MMCamcorderAudioMeter *meter, MMCamcorderAudioLevel *level)
+{
+	mmf_return_if_fail(meter && level);
+
+	if (meter->lock == NULL) {
+		return;
+	}
+
+	g_mutex_lock(meter->lock);
+	memcpy(level, &(meter->level), sizeof(MMCamcorderAudioLevel));
+	g_mutex_unlock(meter->lock);
+
+	return;
+}
+
+
+gboolean _mmcamcorder_silence_buffer_apply(_MMCamcorderSilenceBuffer *silence, GstBuffer *buffer)
+{
+	guint8 *data = NULL;
+	unsigned int size = 0;
+
+	mmf_return_val_if_fail(silence && buffer, FALSE);
+
+	size = GST_BUFFER_SIZE(buffer);
+
+	/* Subclass of GstBuffer could release its memory with GST_BUFFER_DATA,
+	   so data pointer can be replaced only for plain GstBuffer.
+	   Metadata of buffer which is shared with others(ex. tee) should not be changed either. */
+	if (G_TYPE_FROM_INSTANCE(buffer) != GST_TYPE_BUFFER ||
+	    !gst_buffer_is_metadata_writable(buffer)) {
+		memset(GST_BUFFER_DATA(buffer), 0, size);
+		return FALSE;
+	}
+
+	if (size > silence->size) {
+		/* buffers in pipeline could still refer previous one, so keep it until pipeline is destroyed */
+		data = (guint8 *)g_malloc0(size);
+		if (silence->data) {
+			silence->retired = g_list_prepend(silence->retired, silence->data);
+		}
+		silence->data = data;
+		silence->size = size;
+
+		_mmcam_dbg_log("silence data %p, size %u", data, size);
+	}
+
+	/* Memory of buffer is released with GST_BUFFER_MALLOCDATA, so source data is not touched.
+	   Read only flag makes downstream elements copy the buffer before writing. */
+	GST_BUFFER_DATA(buffer) = silence->data;
+	GST_BUFFER_FLAG_SET(buffer, GST_BUFFER_FLAG_READONLY);
+
+	return TRUE;
+}
+
+
+void _mmcamcorder_silence_buffer_deinit(_MMCamcorderSilenceBuffer *silence)
+{
+	mmf_return_if_fail(silence);
+
+	if (silence->retired) {
+		g_list_foreach(silence->retired, (GFunc)g_free, NULL);
+		g_list_free(silence->retired);
+		silence->retired = NULL;
+	}
+
+	if (silence->data) {
+		g_free(silence->data);
+		silence->data = NULL;
+	}
+
+	silence->size = 0;
+
+	return;
+}
+
+
+gboolean _mmcamcorder_frame_notifier_init(_MMCamcorderFrameNotifier *notifier)
+{
+	mmf_return_val_if_fail(notifier, FALSE);
+
+	notifier->lock = g_mutex_new();
+	notifier->cond = g_cond_new();
+	notifier->waiting = 0;
+
+	if (notifier->lock == NULL || notifier->cond == NULL) {
+		_mmcamcorder_frame_notifier_deinit(notifier);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+
+void _mmcamcorder_frame_notifier_deinit(_MMCamcorderFrameNotifier *notifier)
+{
+	mmf_return_if_fail(notifier);
+
+	if (notifier->cond) {
+		g_cond_free(notifier->cond);
+		notifier->cond = NULL;
+	}
+
+	if (notifier->lock) {
+		g_mutex_free(notifier->lock);
+		notifier->lock = NULL;
+	}
+
+	return;
+}
+
+
+void _mmcamcorder_frame_notifier_signal(_MMCamcorderFrameNotifier *notifier)
+{
+	mmf_return_if_fail(notifier);
+
+	/* streaming thread takes lock only when someone is waiting */
+	if (g_atomic_int_get(&(notifier->waiting)) > 0 && notifier->lock) {
+		g_mutex_lock(notifier->lock);
+		g_cond_broadcast(notifier->cond);
+		g_mutex_unlock(notifier->lock);
+	}
+
+	return;
+}
+
+
+gboolean _mmcamcorder_frame_notifier_wait(_MMCamcorderFrameNotifier *notifier, _MMCamcorderFrameCheckFunc check,
+                                          gpointer data, int timeout)
+{
+	gboolean ret = FALSE;
+	GTimeVal end_time;
+
+	mmf_return_val_if_fail(notifier && notifier->lock && check, FALSE);
+
+	if (check(data)) {
+		return TRUE;
+	}
+
+	g_get_current_time(&end_time);
+	g_time_val_add(&end_time, timeout * 1000);
+
+	g_mutex_lock(notifier->lock);
+
+	/* waiting count should be visible before condition is checked again,
+	   then frame which satisfies condition after this always signals */
+	g_atomic_int_inc(&(notifier->waiting));
+
+	while (!(ret = check(data))) {
+		if (!g_cond_timed_wait(notifier->cond, notifier->lock, &end_time)) {
+			ret = check(data);
+			break;
+		}
+	}
+
+	g_atomic_int_add(&(notifier->waiting), -1);
+
+	g_mutex_unlock(notifier->lock);
+
+	return ret;
+}
+
+
+gboolean _mmcamcorder_pre_record_buffer_create(_MMCamcorderPreRecordBuffer *pre_record)
+{
+	int i = 0;
+
+	mmf_return_val_if_fail(pre_record, FALSE);
+
+	memset(pre_record, 0x00, sizeof(_MMCamcorderPreRecordBuffer));
+
+	pre_record->lock = g_mutex_new();
+	if (pre_record->lock == NULL) {
+		_mmcam_dbg_err("failed to create lock");
+		return FALSE;
+	}
+
+	for (i = 0 ; i < _MMCAMCORDER_PRE_RECORD_STREAM_NUM ; i++) {
+		g_queue_init(&(pre_record->queue[i]));
+	}
+
+	return TRUE;
+}
+
+
+void _mmcamcorder_pre_record_buffer_destroy(_MMCamcorderPreRecordBuffer *pre_record)
+{
+	mmf_return_if_fail(pre_record);
+
+	if (pre_record->lock == NULL) {
+		return;
+	}
+
+	_mmcamcorder_pre_record_buffer_deinit(pre_record);
+
+	g_mutex_free(pre_record->lock);
+	pre_record->lock = NULL;
+
+	return;
+}
+
+
+gboolean _mmcamcorder_pre_record_buffer_init(_MMCamcorderPreRecordBuffer *pre_record, int duration, unsigned int max_size)
+{
+	int i = 0;
+
+	mmf_return_val_if_fail(pre_record && pre_record->lock, FALSE);
+	mmf_return_val_if_fail(duration > 0 && max_size > 0, FALSE);
+
+	/* frames of previous session are not used any more */
+	_mmcamcorder_pre_record_buffer_deinit(pre_record);
+
+	g_mutex_lock(pre_record->lock);
+
+	for (i = 0 ; i < _MMCAMCORDER_PRE_RECORD_STREAM_NUM ; i++) {
+		pre_record->drop[i] = 0;
+	}
+
+	pre_record->size = 0;
+	pre_record->peak_size = 0;
+	pre_record->max_size = (guint64)max_size;
+	pre_record->duration = (GstClockTime)duration * GST_MSECOND;
+	pre_record->active = TRUE;
+
+	g_mutex_unlock(pre_record->lock);
+
+	_mmcam_dbg_log("pre-record buffer : duration %d ms, max size %u", duration, max_size);
+
+	return TRUE;
+}
+
+
+void _mmcamcorder_pre_record_buffer_deinit(_MMCamcorderPreRecordBuffer *pre_record)
+{
+	int i = 0;
+	GstBuffer *buffer = NULL;
+
+	mmf_return_if_fail(pre_record);
+
+	if (pre_record->lock == NULL) {
+		return;
+	}
+
+	g_mutex_lock(pre_record->lock);
+
+	for (i = 0 ; i < _MMCAMCORDER_PRE_RECORD_STREAM_NUM ; i++) {
+		while ((buffer = (GstBuffer *)g_queue_pop_head(&(pre_record->queue[i])))) {
+			gst_buffer_unref(buffer);
+		}
+	}
+
+	pre_record->size = 0;
+	pre_record->active = FALSE;
+
+	g_mutex_unlock(pre_record->lock);
+
+	return;
+}
+
+
+void _mmcamcorder_pre_record_buffer_push(_MMCamcorderPreRecordBuffer *pre_record, _MMCamcorderPreRecordStream stream, GstBuffer *buffer)
+{
+	mmf_return_if_fail(pre_record && pre_record->lock);
+	mmf_return_if_fail(buffer && stream < _MMCAMCORDER_PRE_RECORD_STREAM_NUM);
+
+	g_mutex_lock(pre_record->lock);
+
+	if (!pre_record->active) {
+		g_mutex_unlock(pre_record->lock);
+		return;
+	}
+
+	/* video should be started with key frame */
+	if (stream == _MMCAMCORDER_PRE_RECORD_VIDEO &&
+	    g_queue_is_empty(&(pre_record->queue[stream])) &&
+	    GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+		pre_record->drop[stream]++;
+		g_mutex_unlock(pre_record->lock);
+		return;
+	}
+
+	g_queue_push_tail(&(pre_record->queue[stream]), gst_buffer_ref(buffer));
+	pre_record->size += GST_BUFFER_SIZE(buffer);
+
+	__mmcamcorder_pre_record_buffer_trim(pre_record);
+
+	if (pre_record->size > pre_record->peak_size) {
+		pre_record->peak_size = pre_record->size;
+	}
+
+	g_mutex_unlock(pre_record->lock);
+
+	return;
+}
+
+
+GstBuffer *_mmcamcorder_pre_record_buffer_pop(_MMCamcorderPreRecordBuffer *pre_record, _MMCamcorderPreRecordStream stream)
+{
+	GstBuffer *buffer = NULL;
+
+	mmf_return_val_if_fail(pre_record && pre_record->lock, NULL);
+	mmf_return_val_if_fail(stream < _MMCAMCORDER_PRE_RECORD_STREAM_NUM, NULL);
+
+	g_mutex_lock(pre_record->lock);
+
+	buffer = (GstBuffer *)g_queue_pop_head(&(pre_record->queue[stream]));
+	if (buffer) {
+		pre_record->size -= GST_BUFFER_SIZE(buffer);
+	}
+
+	g_mutex_unlock(pre_record->lock);
+
+	return buffer;
+}
+
+
+GstClockTime _mmcamcorder_pre_record_buffer_get_start_time(_MMCamcorderPreRecordBuffer *pre_record)
+{
+	GstBuffer *buffer = NULL;
+	GstClockTime start_time = GST_CLOCK_TIME_NONE;
+
+	mmf_return_val_if_fail(pre_record && pre_record->lock, GST_CLOCK_TIME_NONE);
+
+	g_mutex_lock(pre_record->lock);
+
+	/* recording starts from the first key frame, audio before it is already trimmed */
+	buffer = (GstBuffer *)g_queue_peek_head(&(pre_record->queue[_MMCAMCORDER_PRE_RECORD_VIDEO]));
+	if (buffer == NULL) {
+		buffer = (GstBuffer *)g_queue_peek_head(&(pre_record->queue[_MMCAMCORDER_PRE_RECORD_AUDIO]));
+	}
+
+	if (buffer) {
+		start_time = GST_BUFFER_TIMESTAMP(buffer);
+	}
+
+	g_mutex_unlock(pre_record->lock);
+
+	return start_time;
+}
+
+
+gboolean _mmcamcorder_pre_record_buffer_get_statistics(_MMCamcorderPreRecordBuffer *pre_record, MMCamcorderPreRecordStatistics *stats)
+{
+	GstBuffer *head = NULL;
+	GstBuffer *tail = NULL;
+	GQueue *video = NULL;
+
+	mmf_return_val_if_fail(pre_record && stats, FALSE);
+
+	memset(stats, 0x00, sizeof(MMCamcorderPreRecordStatistics));
+
+	if (pre_record->lock == NULL) {
+		return FALSE;
+	}
+
+	g_mutex_lock(pre_record->lock);
+
+	if (!pre_record->active) {
+		g_mutex_unlock(pre_record->lock);
+		return FALSE;
+	}
+
+	video = &(pre_record->queue[_MMCAMCORDER_PRE_RECORD_VIDEO]);
+	head = (GstBuffer *)g_queue_peek_head(video);
+	tail = (GstBuffer *)g_queue_peek_tail(video);
+	if (head && tail &&
+	    GST_BUFFER_TIMESTAMP_IS_VALID(head) && GST_BUFFER_TIMESTAMP_IS_VALID(tail)) {
+		stats->buffered_time = (unsigned int)GST_TIME_AS_MSECONDS(GST_BUFFER_TIMESTAMP(tail) - GST_BUFFER_TIMESTAMP(head));
+	}
+
+	stats->video_count = g_queue_get_length(video);
+	stats->audio_count = g_queue_get_length(&(pre_record->queue[_MMCAMCORDER_PRE_RECORD_AUDIO]));
+	stats->buffered_size = (unsigned int)(pre_record->size >> 10);
+	stats->peak_size = (unsigned int)(pre_record->peak_size >> 10);
+	stats->max_size = (unsigned int)(pre_record->max_size >> 10);
+	stats->drop_video = pre_record->drop[_MMCAMCORDER_PRE_RECORD_VIDEO];
+	stats->drop_audio = pre_record->drop[_MMCAMCORDER_PRE_RECORD_AUDIO];
+
+	g_mutex_unlock(pre_record->lock);
+
+	return TRUE;
+}
+
+
+/* should be called with lock of pre-record buffer, drop the oldest frame of the stream */
+static void __mmcamcorder_pre_record_buffer_drop(_MMCamcorderPreRecordBuffer *pre_record, _MMCamcorderPreRecordStream stream)
+{
+	GstBuffer *buffer = (GstBuffer *)g_queue_pop_head(&(pre_record->queue[stream]));
+
+	if (buffer) {
+		pre_record->size -= GST_BUFFER_SIZE(buffer);
+		pre_record->drop[stream]++;
+		gst_buffer_unref(buffer);
+	}
+
+	return;
+}
+
+
+/* should be called with lock of pre-record buffer */
+static void __mmcamcorder_pre_record_buffer_trim(_MMCamcorderPreRecordBuffer *pre_record)
+{
+	GList *key = NULL;
+	GstBuffer *head = NULL;
+	GstBuffer *tail = NULL;
+	GstBuffer *buffer = NULL;
+	GQueue *video = &(pre_record->queue[_MMCAMCORDER_PRE_RECORD_VIDEO]);
+	GQueue *audio = &(pre_record->queue[_MMCAMCORDER_PRE_RECORD_AUDIO]);
+
+	/* drop the oldest GOP while the rest still covers duration, or memory is over the limit */
+	while (!g_queue_is_empty(video)) {
+		for (key = video->head->next ; key ; key = key->next) {
+			if (!GST_BUFFER_FLAG_IS_SET(GST_BUFFER(key->data), GST_BUFFER_FLAG_DELTA_UNIT)) {
+				break;
+			}
+		}
+
+		if (pre_record->size <= pre_record->max_size) {
+			tail = (GstBuffer *)g_queue_peek_tail(video);
+			if (key == NULL ||
+			    !GST_BUFFER_TIMESTAMP_IS_VALID(GST_BUFFER(key->data)) ||
+			    !GST_BUFFER_TIMESTAMP_IS_VALID(tail) ||
+			    GST_BUFFER_TIMESTAMP(GST_BUFFER(key->data)) + pre_record->duration > GST_BUFFER_TIMESTAMP(tail)) {
+				break;
+			}
+		}
+
+		/* key frame is not popped, so its list node is still valid */
+		while (video->head && video->head != key) {
+			__mmcamcorder_pre_record_buffer_drop(pre_record, _MMCAMCORDER_PRE_RECORD_VIDEO);
+		}
+	}
+
+	head = (GstBuffer *)g_queue_peek_head(video);
+	if (head && GST_BUFFER_TIMESTAMP_IS_VALID(head)) {
+		/* audio before the first key frame is not recorded */
+		while ((buffer = (GstBuffer *)g_queue_peek_head(audio)) &&
+		       GST_BUFFER_TIMESTAMP_IS_VALID(buffer) &&
+		       GST_BUFFER_TIMESTAMP(buffer) < GST_BUFFER_TIMESTAMP(head)) {
+			__mmcamcorder_pre_record_buffer_drop(pre_record, _MMCAMCORDER_PRE_RECORD_AUDIO);
+		}
+	} else if (head == NULL) {
+		/* no video yet, keep audio with duration and memory limit */
+		while ((head = (GstBuffer *)g_queue_peek_head(audio))) {
+			tail = (GstBuffer *)g_queue_peek_tail(audio);
+			if (pre_record->size <= pre_record->max_size &&
+			    (!GST_BUFFER_TIMESTAMP_IS_VALID(head) || !GST_BUFFER_TIMESTAMP_IS_VALID(tail) ||
+			     GST_BUFFER_TIMESTAMP(head) + pre_record->duration > GST_BUFFER_TIMESTAMP(tail))) {
+				break;
+			}
+
+			__mmcamcorder_pre_record_buffer_drop(pre_record, _MMCAMCORDER_PRE_RECORD_AUDIO);
+		}
+	}
+
+	return;
+}
+
+
+void _mmcamcorder_segment_tracker_reset(_MMCamcorderSegmentTracker *tracker)
+{
+	mmf_return_if_fail(tracker);
+
+	memset(tracker, 0x00, sizeof(_MMCamcorderSegmentTracker));
+
+	return;
+}
+
+
+static void __mmcamcorder_segment_tracker_get_info(_MMCamcorderSegmentTracker *tracker, guint64 end_offset,
+                                                   MMCamcorderRecordingSegmentInfo *segment)
+{
+	segment->index = tracker->index;
+	segment->start_time = (unsigned int)tracker->start_time;
+	segment->end_time = (unsigned int)tracker->end_time;
+	segment->offset = tracker->start_offset;
+	segment->size = (end_offset > tracker->start_offset) ? (end_offset - tracker->start_offset) : 0;
+
+	return;
+}
+
+
+gboolean _mmcamcorder_segment_tracker_write(_MMCamcorderSegmentTracker *tracker, const guint8 *data, unsigned int size,
+                                            guint64 input_time, MMCamcorderRecordingSegmentInfo *segment)
+{
+	gboolean closed = FALSE;
+
+	mmf_return_val_if_fail(tracker && segment, FALSE);
+
+	/* every fragment starts with moof, and it's written after all samples of the fragment are collected.
+	   so the previous segment is finished at this position, and this fragment ends at current input time. */
+	if (data && size >= 8 && !memcmp(data + 4, "moof", 4)) {
+		if (tracker->moof_count > 0) {
+			__mmcamcorder_segment_tracker_get_info(tracker, tracker->position, segment);
+			closed = TRUE;
+
+			tracker->index++;
+			tracker->start_time = tracker->end_time;
+			tracker->start_offset = tracker->position;
+		}
+
+		tracker->end_time = input_time;
+		tracker->moof_count++;
+	}
+
+	tracker->position += size;
+	if (tracker->position > tracker->size) {
+		tracker->size = tracker->position;
+	}
+
+	return closed;
+}
+
+
+void _mmcamcorder_segment_tracker_seek(_MMCamcorderSegmentTracker *tracker, guint64 position)
+{
+	mmf_return_if_fail(tracker);
+
+	/* muxer seeks to rewrite header, it doesn't change size of segments */
+	tracker->position = position;
+
+	return;
+}
+
+
+void _mmcamcorder_segment_tracker_finish(_MMCamcorderSegmentTracker *tracker, guint64 input_time, MMCamcorderRecordingSegmentInfo *segment)
+{
+	mmf_return_if_fail(tracker && segment);
+
+	/* the last segment is written until the end of file */
+	tracker->end_time = input_time;
+	__mmcamcorder_segment_tracker_get_info(tracker, tracker->size, segment);
+
+	return;
+}
+
+
+gboolean _mmcamcorder_encode_pool_start(_MMCamcorderEncodePool *pool, int thread_num, int max_in_flight,
+                                        _MMCamcorderEncodeFunc encode, _MMCamcorderEncodeDeliverFunc deliver, gpointer user_data)
+{
+	int i = 0;
+
+	mmf_return_val_if_fail(pool && encode && deliver, FALSE);
+
+	if (pool->lock) {
+		_mmcam_dbg_log("already started");
+		return TRUE;
+	}
+
+	if (thread_num < 1) {
+		thread_num = 1;
+	} else if (thread_num > _MMCAMCORDER_ENCODE_POOL_THREAD_MAX) {
+		thread_num = _MMCAMCORDER_ENCODE_POOL_THREAD_MAX;
+	}
+
+	/* keep at least one job waiting for each worker */
+	if (max_in_flight < thread_num) {
+		max_in_flight = thread_num + 1;
+	}
+
+	memset(pool, 0x00, sizeof(_MMCamcorderEncodePool));
+
+	pool->lock = g_mutex_new();
+	pool->cond = g_cond_new();
+	pool->max_in_flight = max_in_flight;
+	pool->encode = encode;
+	pool->deliver = deliver;
+	pool->user_data = user_data;
+	pool->running = TRUE;
+
+	g_queue_init(&pool->pending);
+	g_queue_init(&pool->done);
+
+	for (i = 0 ; i < thread_num ; i++) {
+		if (pthread_create(&(pool->thread[i]), NULL, __mmcamcorder_encode_pool_thread, pool)) {
+			_mmcam_dbg_err("failed to create encode thread %d", i);
+			break;
+		}
+		pool->thread_num++;
+	}
+
+	if (pool->thread_num == 0) {
+		g_cond_free(pool->cond);
+		pool->cond = NULL;
+		g_mutex_free(pool->lock);
+		pool->lock = NULL;
+		pool->running = FALSE;
+
+		return FALSE;
+	}
+
+	_mmcam_dbg_log("encode pool started - thread %d, max in flight %d", pool->thread_num, pool->max_in_flight);
+
+	return TRUE;
+}
+
+
+void _mmcamcorder_encode_pool_stop(_MMCamcorderEncodePool *pool)
+{
+	int i = 0;
+	_MMCamcorderEncodeJob *entry = NULL;
+
+	mmf_return_if_fail(pool);
+
+	if (pool->lock == NULL) {
+		return;
+	}
+
+	/* every pushed job is delivered before workers exit */
+	_mmcamcorder_encode_pool_drain(pool);
+
+	g_mutex_lock(pool->lock);
+	pool->running = FALSE;
+	g_cond_broadcast(pool->cond);
+	g_mutex_unlock(pool->lock);
+
+	for (i = 0 ; i < pool->thread_num ; i++) {
+		pthread_join(pool->thread[i], NULL);
+	}
+
+	pool->thread_num = 0;
+
+	/* release jobs which were pushed while stopping */
+	while ((entry = (_MMCamcorderEncodeJob *)g_queue_pop_head(&pool->done)) ||
+	       (entry = (_MMCamcorderEncodeJob *)g_queue_pop_head(&pool->pending))) {
+		_mmcam_dbg_warn("release job %u without encoding", entry->seq);
+		pool->deliver(entry->job, FALSE, pool->user_data);
+		free(entry);
+		entry = NULL;
+	}
+
+	g_cond_free(pool->cond);
+	pool->cond = NULL;
+	g_mutex_free(pool->lock);
+	pool->lock = NULL;
+
+	return;
+}
+
+
+gboolean _mmcamcorder_encode_pool_push(_MMCamcorderEncodePool *pool, gpointer job)
+{
+	_MMCamcorderEncodeJob *entry = NULL;
+
+	mmf_return_val_if_fail(pool && job, FALSE);
+
+	if (pool->lock == NULL) {
+		return FALSE;
+	}
+
+	entry = (_MMCamcorderEncodeJob *)malloc(sizeof(_MMCamcorderEncodeJob));
+	if (entry == NULL) {
+		_mmcam_dbg_err("failed to alloc encode job");
+		return FALSE;
+	}
+
+	entry->job = job;
+	entry->result = FALSE;
+
+	g_mutex_lock(pool->lock);
+
+	/* block caller until a job is delivered, it holds back the source of jobs */
+	while (pool->running && pool->in_flight >= pool->max_in_flight) {
+		g_cond_wait(pool->cond, pool->lock);
+	}
+
+	if (!pool->running) {
+		g_mutex_unlock(pool->lock);
+		free(entry);
+		return FALSE;
+	}
+
+	entry->seq = pool->push_seq++;
+	pool->in_flight++;
+	g_queue_push_tail(&pool->pending, entry);
+	g_cond_broadcast(pool->cond);
+
+	g_mutex_unlock(pool->lock);
+
+	return TRUE;
+}
+
+
+void _mmcamcorder_encode_pool_drain(_MMCamcorderEncodePool *pool)
+{
+	int i = 0;
+
+	mmf_return_if_fail(pool);
 
-	if (!g_file_test(path, G_FILE_TEST_EXISTS | G_FILE_TEST_IS_DIR)) {
-		_mmcam_dbg_log("File(%s) doesn't exist.", path);
-		return -2;
+	if (pool->lock == NULL) {
+		return;
 	}
 
-	if (-1 == statfs(path, &fs)) {
-		_mmcam_dbg_log("Getting free space is failed.(%s)", path);
-		return -1;
+	/* deliver function could call this, but it can not wait for itself */
+	for (i = 0 ; i < pool->thread_num ; i++) {
+		if (pthread_equal(pool->thread[i], pthread_self())) {
+			_mmcam_dbg_warn("called in encode thread, skip draining");
+			return;
+		}
 	}
 
-	*free_space = (guint64)fs.f_bsize * fs.f_bavail;
-	return 1;
+	g_mutex_lock(pool->lock);
+	while (pool->in_flight > 0) {
+		g_cond_wait(pool->cond, pool->lock);
+	}
+	g_mutex_unlock(pool->lock);
+
+	return;
 }
 
 
@@ -570,61 +1709,95 @@ void _mmcamcorder_element_release_noti(gpointer data, GObject *where_the_object_
 gboolean
 _mmcamcroder_msg_callback(void *data)
 {
-	_MMCamcorderMsgItem *item = (_MMCamcorderMsgItem*)data;
+	int i = 0;
+	int index = 0;
+	gboolean remained = FALSE;
+	_MMCamcorderMsgItem item;
+	_MMCamcorderMsgItem *overflow_item = NULL;
+	_MMCamcorderMsgQueue *queue = (_MMCamcorderMsgQueue *)data;
 	mmf_camcorder_t *hcamcorder = NULL;
-	mmf_return_val_if_fail( item, FALSE );
 
-	hcamcorder = MMF_CAMCORDER(item->handle);
-	mmf_return_val_if_fail( hcamcorder, FALSE );
+	mmf_return_val_if_fail(queue, FALSE);
 
-	/*_mmcam_dbg_log("msg id:%x, msg_cb:%p, msg_data:%p, item:%p", item->id, hcamcorder->msg_cb, hcamcorder->msg_data, item);*/
+	hcamcorder = MMF_CAMCORDER(queue->handle);
+	mmf_return_val_if_fail(hcamcorder, FALSE);
 
-	_MMCAMCORDER_LOCK_MESSAGE_CALLBACK(hcamcorder);
+	/* dispatch limited number of messages at once not to block main loop */
+	for (i = 0 ; i < _MMCAMCORDER_MSG_DISPATCH_MAX ; i++) {
+		g_mutex_lock(queue->lock);
 
-	/* check delay of CAPTURED message */
-	if (item->id == MM_MESSAGE_CAMCORDER_CAPTURED) {
-		MMTA_ACUM_ITEM_END("                CAPTURED MESSAGE DELAY", FALSE);
-	}
+		if (queue->count <= 0) {
+			queue->idle_id = 0;
+			g_mutex_unlock(queue->lock);
 
-	if ((hcamcorder) && (hcamcorder->msg_cb)) {
-		hcamcorder->msg_cb(item->id, (MMMessageParamType*)(&(item->param)), hcamcorder->msg_cb_param);
-	}
+			/* For not being called again */
+			return FALSE;
+		}
 
-	_MMCAMCORDER_UNLOCK_MESSAGE_CALLBACK(hcamcorder);
+		memcpy(&item, &(queue->item[queue->head]), sizeof(_MMCamcorderMsgItem));
+		queue->head = (queue->head + 1) % _MMCAMCORDER_MSG_QUEUE_MAX;
+		queue->count--;
 
-	_MMCAMCORDER_LOCK((MMHandleType)hcamcorder);
+		/* move the oldest overflowed message to the tail of ring */
+		if (queue->overflow) {
+			overflow_item = (_MMCamcorderMsgItem *)queue->overflow->data;
+			queue->overflow = g_list_delete_link(queue->overflow, queue->overflow);
 
-	if (hcamcorder->msg_data) {
-		hcamcorder->msg_data = g_list_remove(hcamcorder->msg_data, item);
-	}
+			index = (queue->head + queue->count) % _MMCAMCORDER_MSG_QUEUE_MAX;
+			memcpy(&(queue->item[index]), overflow_item, sizeof(_MMCamcorderMsgItem));
+			queue->count++;
 
-	/* release allocated memory */
-	if (item->id == MM_MESSAGE_CAMCORDER_FACE_DETECT_INFO) {
-		MMCamFaceDetectInfo *cam_fd_info = (MMCamFaceDetectInfo *)item->param.data;
-		if (cam_fd_info) {
-			SAFE_FREE(cam_fd_info->face_info);
-			free(cam_fd_info);
-			cam_fd_info = NULL;
+			free(overflow_item);
+			overflow_item = NULL;
 		}
 
-		item->param.data = NULL;
-		item->param.size = 0;
+		g_mutex_unlock(queue->lock);
+
+		/*_mmcam_dbg_log("msg id:%x, msg_cb:%p", item.id, hcamcorder->msg_cb);*/
+
+		_MMCAMCORDER_LOCK_MESSAGE_CALLBACK(hcamcorder);
+
+		/* check delay of CAPTURED message */
+		if (item.id == MM_MESSAGE_CAMCORDER_CAPTURED) {
+			MMTA_ACUM_ITEM_END("                CAPTURED MESSAGE DELAY", FALSE);
+		}
+
+		if (hcamcorder->msg_cb) {
+			hcamcorder->msg_cb(item.id, (MMMessageParamType*)(&(item.param)), hcamcorder->msg_cb_param);
+		}
+
+		_MMCAMCORDER_UNLOCK_MESSAGE_CALLBACK(hcamcorder);
+
+		/* release allocated memory */
+		__mmcamcorder_msg_release_data(&item);
 	}
 
-	free(item);
-	item = NULL;
+	g_mutex_lock(queue->lock);
+
+	if (queue->count > 0) {
+		remained = TRUE;
+	} else {
+		queue->idle_id = 0;
+		remained = FALSE;
+	}
 
-	_MMCAMCORDER_UNLOCK((MMHandleType)hcamcorder);
+	g_mutex_unlock(queue->lock);
 
-	/* For not being called again */
-	return FALSE;
+	return remained;
 }
 
 
 gboolean
 _mmcamcroder_send_message(MMHandleType handle, _MMCamcorderMsgItem *data)
 {
+	int i = 0;
+	int j = 0;
+	int index = 0;
+	int next = 0;
+	gboolean coalescable = FALSE;
 	mmf_camcorder_t* hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderMsgQueue *queue = NULL;
+	_MMCamcorderMsgStats *stats = NULL;
 	_MMCamcorderMsgItem *item = NULL;
 
 	mmf_return_val_if_fail(hcamcorder, FALSE);
@@ -637,6 +1810,7 @@ _mmcamcroder_send_message(MMHandleType handle, _MMCamcorderMsgItem *data)
 			data->param.union_type = MM_MSG_UNION_STATE;
 			break;
 		case MM_MESSAGE_CAMCORDER_RECORDING_STATUS:
+		case MM_MESSAGE_CAMCORDER_RECORDING_SEGMENT:
 			data->param.union_type = MM_MSG_UNION_RECORDING_STATUS;
 			break;
 		case MM_MESSAGE_CAMCORDER_FIRMWARE_UPDATE:
@@ -657,17 +1831,73 @@ _mmcamcroder_send_message(MMHandleType handle, _MMCamcorderMsgItem *data)
 			break;
 	}
 
-	item = g_malloc(sizeof(_MMCamcorderMsgItem));
-	memcpy(item, data, sizeof(_MMCamcorderMsgItem));
-	item->handle = handle;
+	data->handle = handle;
 
-	_MMCAMCORDER_LOCK(handle);
-	hcamcorder->msg_data = g_list_append(hcamcorder->msg_data, item);
-//	_mmcam_dbg_log("item[%p]", item);
+	queue = &(hcamcorder->msg_queue);
+	mmf_return_val_if_fail(queue->lock, FALSE);
 
-	g_idle_add(_mmcamcroder_msg_callback, item);
+	coalescable = __mmcamcorder_msg_is_coalescable(hcamcorder, data->id);
 
-	_MMCAMCORDER_UNLOCK(handle);
+	g_mutex_lock(queue->lock);
+
+	stats = __mmcamcorder_msg_get_stats(queue, data->id);
+	if (stats) {
+		stats->enqueue_count++;
+	}
+
+	/* latest value wins : remove pending message which has same id, and new one is queued at the tail.
+	   it's not replaced in place, because it should not be delivered before messages sent after old one. */
+	if (coalescable && queue->overflow == NULL) {
+		for (i = 0 ; i < queue->count ; i++) {
+			index = (queue->head + i) % _MMCAMCORDER_MSG_QUEUE_MAX;
+			if (queue->item[index].id == data->id) {
+				__mmcamcorder_msg_release_data(&(queue->item[index]));
+
+				for (j = i + 1 ; j < queue->count ; j++) {
+					next = (queue->head + j) % _MMCAMCORDER_MSG_QUEUE_MAX;
+					memcpy(&(queue->item[index]), &(queue->item[next]), sizeof(_MMCamcorderMsgItem));
+					index = next;
+				}
+				queue->count--;
+
+				if (stats) {
+					stats->drop_count++;
+				}
+				break;
+			}
+		}
+	}
+
+	if (queue->count < _MMCAMCORDER_MSG_QUEUE_MAX && queue->overflow == NULL) {
+		index = (queue->head + queue->count) % _MMCAMCORDER_MSG_QUEUE_MAX;
+		memcpy(&(queue->item[index]), data, sizeof(_MMCamcorderMsgItem));
+		queue->count++;
+	} else if (coalescable) {
+		_mmcam_dbg_warn("message queue is full. drop msg id[%x]", data->id);
+		__mmcamcorder_msg_release_data(data);
+		if (stats) {
+			stats->drop_count++;
+		}
+	} else {
+		/* message which should not be lost is kept in overflow list */
+		item = (_MMCamcorderMsgItem *)malloc(sizeof(_MMCamcorderMsgItem));
+		if (item) {
+			memcpy(item, data, sizeof(_MMCamcorderMsgItem));
+			queue->overflow = g_list_append(queue->overflow, item);
+			_mmcam_dbg_warn("message queue is full. msg id[%x] is kept in overflow list", data->id);
+		} else {
+			_mmcam_dbg_err("failed to alloc overflow item. drop msg id[%x]", data->id);
+			if (stats) {
+				stats->drop_count++;
+			}
+		}
+	}
+
+	if (queue->idle_id == 0) {
+		queue->idle_id = g_idle_add(_mmcamcroder_msg_callback, queue);
+	}
+
+	g_mutex_unlock(queue->lock);
 
 	return TRUE;
 }
@@ -677,53 +1907,393 @@ void
 _mmcamcroder_remove_message_all(MMHandleType handle)
 {
 	mmf_camcorder_t* hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderMsgQueue *queue = NULL;
 	_MMCamcorderMsgItem *item = NULL;
 	gboolean ret = TRUE;
 	GList *list = NULL;
 
 	mmf_return_if_fail(hcamcorder);
 
+	queue = &(hcamcorder->msg_queue);
+
+	if (queue->lock) {
+		g_mutex_lock(queue->lock);
+
+		if (queue->idle_id > 0) {
+			ret = g_source_remove(queue->idle_id);
+			_mmcam_dbg_log("Remove message dispatcher[%d]. ret[%d]", queue->idle_id, ret);
+			queue->idle_id = 0;
+		}
+
+		if (queue->count <= 0) {
+			_mmcam_dbg_log("No message data is remained.");
+		}
+
+		while (queue->count > 0) {
+			__mmcamcorder_msg_release_data(&(queue->item[queue->head]));
+			queue->head = (queue->head + 1) % _MMCAMCORDER_MSG_QUEUE_MAX;
+			queue->count--;
+		}
+		queue->head = 0;
+
+		for (list = queue->overflow ; list ; list = g_list_next(list)) {
+			item = (_MMCamcorderMsgItem *)list->data;
+			if (item) {
+				__mmcamcorder_msg_release_data(item);
+				free(item);
+			}
+		}
+		g_list_free(queue->overflow);
+		queue->overflow = NULL;
+
+		g_mutex_unlock(queue->lock);
+	}
+
 	_MMCAMCORDER_LOCK(handle);
 
-	if(!hcamcorder->msg_data)
-	{
-		_mmcam_dbg_log("No message data is remained.");
+	/* remove idle function for playing capture sound */
+	do {
+		ret = g_idle_remove_by_data(hcamcorder);
+		_mmcam_dbg_log("remove idle function for playing capture sound. ret[%d]", ret);
+	} while (ret);
+
+	_MMCAMCORDER_UNLOCK(handle);
+
+	return;
+}
+
+
+gboolean
+_mmcamcorder_msg_queue_init(_MMCamcorderMsgQueue *queue, MMHandleType handle)
+{
+	mmf_return_val_if_fail(queue, FALSE);
+
+	memset(queue, 0x00, sizeof(_MMCamcorderMsgQueue));
+
+	queue->lock = g_mutex_new();
+	if (queue->lock == NULL) {
+		_mmcam_dbg_err("failed to create lock of message queue");
+		return FALSE;
 	}
-	else
-	{
-		list = hcamcorder->msg_data;
 
-		while(list)
-		{
-			item = list->data;
-			list =  g_list_next(list);
+	queue->handle = handle;
 
-			if(!item)
-			{
-				_mmcam_dbg_err("Fail to remove message. The item is NULL");
+	return TRUE;
+}
+
+
+void
+_mmcamcorder_msg_queue_deinit(_MMCamcorderMsgQueue *queue)
+{
+	int i = 0;
+
+	mmf_return_if_fail(queue);
+
+	if (queue->lock == NULL) {
+		return;
+	}
+
+	for (i = 0 ; i < queue->stats_num ; i++) {
+		_mmcam_dbg_log("msg id[%x] - enqueued %u, dropped %u",
+		               queue->stats[i].id, queue->stats[i].enqueue_count, queue->stats[i].drop_count);
+	}
+
+	g_mutex_free(queue->lock);
+	queue->lock = NULL;
+
+	return;
+}
+
+
+int
+_mmcamcorder_get_message_stats(MMHandleType handle, int message_id, unsigned int *enqueue_count, unsigned int *drop_count)
+{
+	int i = 0;
+	mmf_camcorder_t* hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderMsgQueue *queue = NULL;
+
+	mmf_return_val_if_fail(hcamcorder, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+	mmf_return_val_if_fail(enqueue_count && drop_count, MM_ERROR_CAMCORDER_INVALID_ARGUMENT);
+
+	queue = &(hcamcorder->msg_queue);
+	mmf_return_val_if_fail(queue->lock, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+
+	*enqueue_count = 0;
+	*drop_count = 0;
+
+	g_mutex_lock(queue->lock);
+
+	for (i = 0 ; i < queue->stats_num ; i++) {
+		if (queue->stats[i].id == message_id) {
+			*enqueue_count = queue->stats[i].enqueue_count;
+			*drop_count = queue->stats[i].drop_count;
+			break;
+		}
+	}
+
+	g_mutex_unlock(queue->lock);
+
+	return MM_ERROR_NONE;
+}
+
+
+gboolean
+_mmcamcorder_fd_pool_init(_MMCamcorderFaceDetectPool *pool, int max_faces, int drop_stale)
+{
+	int i = 0;
+
+	mmf_return_val_if_fail(pool, FALSE);
+
+	memset(pool, 0x00, sizeof(_MMCamcorderFaceDetectPool));
+
+	if (max_faces <= 0) {
+		max_faces = _MMCAMCORDER_FD_MAX_FACES_DEFAULT;
+	}
+
+	pool->face_info = (MMCamFaceInfo *)malloc(sizeof(MMCamFaceInfo) * max_faces * _MMCAMCORDER_FD_POOL_SLOT_NUM);
+	if (pool->face_info == NULL) {
+		_mmcam_dbg_err("failed to alloc face info for pool");
+		return FALSE;
+	}
+
+	pool->lock = g_mutex_new();
+	if (pool->lock == NULL) {
+		_mmcam_dbg_err("failed to create lock of face detect pool");
+		SAFE_FREE(pool->face_info);
+		return FALSE;
+	}
+
+	for (i = 0 ; i < _MMCAMCORDER_FD_POOL_SLOT_NUM ; i++) {
+		pool->slot[i].in_use = FALSE;
+		pool->slot[i].info.num_of_faces = 0;
+		pool->slot[i].info.face_info = pool->face_info + (i * max_faces);
+	}
+
+	pool->max_faces = max_faces;
+	pool->drop_stale = drop_stale;
+
+	_mmcam_dbg_log("max faces %d, drop stale %d", max_faces, drop_stale);
+
+	return TRUE;
+}
+
+
+void
+_mmcamcorder_fd_pool_deinit(_MMCamcorderFaceDetectPool *pool)
+{
+	mmf_return_if_fail(pool);
+
+	if (pool->lock == NULL) {
+		return;
+	}
+
+	_mmcam_dbg_log("face detect info dropped %u", pool->drop_count);
+
+	g_mutex_free(pool->lock);
+	pool->lock = NULL;
+
+	SAFE_FREE(pool->face_info);
+
+	return;
+}
+
+
+MMCamFaceDetectInfo *
+_mmcamcorder_fd_pool_get(_MMCamcorderFaceDetectPool *pool)
+{
+	int i = 0;
+	MMCamFaceDetectInfo *info = NULL;
+
+	mmf_return_val_if_fail(pool && pool->lock, NULL);
+
+	g_mutex_lock(pool->lock);
+
+	for (i = 0 ; i < _MMCAMCORDER_FD_POOL_SLOT_NUM ; i++) {
+		if (!pool->slot[i].in_use) {
+			pool->slot[i].in_use = TRUE;
+			pool->slot[i].info.num_of_faces = 0;
+			info = &(pool->slot[i].info);
+			break;
+		}
+	}
+
+	if (info == NULL) {
+		pool->drop_count++;
+	}
+
+	g_mutex_unlock(pool->lock);
+
+	return info;
+}
+
+
+void
+_mmcamcorder_fd_pool_put(_MMCamcorderFaceDetectPool *pool, MMCamFaceDetectInfo *info)
+{
+	int i = 0;
+
+	mmf_return_if_fail(pool && pool->lock && info);
+
+	g_mutex_lock(pool->lock);
+
+	for (i = 0 ; i < _MMCAMCORDER_FD_POOL_SLOT_NUM ; i++) {
+		if (&(pool->slot[i].info) == info) {
+			pool->slot[i].in_use = FALSE;
+			/* restore face info array in case that application changed it */
+			pool->slot[i].info.face_info = pool->face_info + (i * pool->max_faces);
+			break;
+		}
+	}
+
+	g_mutex_unlock(pool->lock);
+
+	if (i == _MMCAMCORDER_FD_POOL_SLOT_NUM) {
+		_mmcam_dbg_err("%p is not a slot of face detect pool", info);
+	}
+
+	return;
+}
+
+
+gboolean
+_mmcamcorder_buffer_pool_init(_MMCamcorderBufferPool *pool, unsigned int buffer_size, int count)
+{
+	mmf_return_val_if_fail(pool, FALSE);
+
+	if (pool->lock == NULL) {
+		pool->lock = g_mutex_new();
+		pool->hit_count = 0;
+		pool->miss_count = 0;
+	}
+
+	if (count > _MMCAMCORDER_BUFFER_POOL_MAX) {
+		count = _MMCAMCORDER_BUFFER_POOL_MAX;
+	}
+
+	g_mutex_lock(pool->lock);
+
+	__mmcamcorder_buffer_pool_flush(pool);
+
+	pool->buffer_size = buffer_size;
+
+	if (buffer_size > 0) {
+		while (pool->count < count) {
+			pool->buffer[pool->count] = malloc(buffer_size);
+			if (pool->buffer[pool->count] == NULL) {
+				_mmcam_dbg_warn("failed to alloc buffer[%d] of pool", pool->count);
+				break;
 			}
-			else
-			{
-				ret = g_idle_remove_by_data (item);
-				_mmcam_dbg_log("Remove item[%p]. ret[%d]", item, ret);
+			pool->count++;
+		}
+	}
+
+	g_mutex_unlock(pool->lock);
+
+	_mmcam_dbg_log("buffer pool[%p] - size[%u], count[%d]", pool, buffer_size, pool->count);
+
+	return TRUE;
+}
+
+
+void
+_mmcamcorder_buffer_pool_deinit(_MMCamcorderBufferPool *pool)
+{
+	mmf_return_if_fail(pool);
+
+	if (pool->lock == NULL) {
+		return;
+	}
+
+	_mmcam_dbg_log("buffer pool[%p] - hit[%" G_GUINT64_FORMAT "], miss[%" G_GUINT64_FORMAT "]",
+	               pool, pool->hit_count, pool->miss_count);
+
+	g_mutex_lock(pool->lock);
+	__mmcamcorder_buffer_pool_flush(pool);
+	pool->buffer_size = 0;
+	g_mutex_unlock(pool->lock);
+
+	g_mutex_free(pool->lock);
+	pool->lock = NULL;
+
+	return;
+}
+
+
+void *
+_mmcamcorder_buffer_pool_get(_MMCamcorderBufferPool *pool, unsigned int size)
+{
+	void *buffer = NULL;
+
+	mmf_return_val_if_fail(pool && pool->lock, NULL);
+
+	g_mutex_lock(pool->lock);
+
+	if (size != pool->buffer_size) {
+		/* resolution is changed. rebuild pool with new size */
+		_mmcam_dbg_log("rebuild buffer pool[%p] - size[%u] -> [%u]", pool, pool->buffer_size, size);
+		__mmcamcorder_buffer_pool_flush(pool);
+		pool->buffer_size = size;
+	}
+
+	if (pool->count > 0) {
+		pool->count--;
+		buffer = pool->buffer[pool->count];
+		pool->buffer[pool->count] = NULL;
+		pool->hit_count++;
+	} else {
+		pool->miss_count++;
+	}
+
+	g_mutex_unlock(pool->lock);
+
+	if (buffer == NULL) {
+		buffer = malloc(size);
+	}
+
+	return buffer;
+}
+
+
+void
+_mmcamcorder_buffer_pool_put(_MMCamcorderBufferPool *pool, void *buffer, unsigned int size)
+{
+	mmf_return_if_fail(pool && pool->lock);
+
+	if (buffer == NULL) {
+		return;
+	}
+
+	g_mutex_lock(pool->lock);
 
-				hcamcorder->msg_data = g_list_remove(hcamcorder->msg_data, item);
+	if (size == pool->buffer_size && pool->count < _MMCAMCORDER_BUFFER_POOL_MAX) {
+		pool->buffer[pool->count] = buffer;
+		pool->count++;
+		buffer = NULL;
+	}
 
-				SAFE_FREE(item);
-			}
-		}
+	g_mutex_unlock(pool->lock);
 
-		g_list_free(hcamcorder->msg_data);
-		hcamcorder->msg_data = NULL;
+	/* size is not matched or pool is full */
+	if (buffer) {
+		free(buffer);
+		buffer = NULL;
 	}
 
-	/* remove idle function for playing capture sound */
-	do {
-		ret = g_idle_remove_by_data(hcamcorder);
-		_mmcam_dbg_log("remove idle function for playing capture sound. ret[%d]", ret);
-	} while (ret);
+	return;
+}
 
-	_MMCAMCORDER_UNLOCK(handle);
+
+void
+_mmcamcorder_buffer_pool_get_stats(_MMCamcorderBufferPool *pool, guint64 *hit_count, guint64 *miss_count)
+{
+	mmf_return_if_fail(pool);
+
+	if (hit_count) {
+		*hit_count = pool->hit_count;
+	}
+	if (miss_count) {
+		*miss_count = pool->miss_count;
+	}
 
 	return;
 }
@@ -1028,6 +2598,7 @@ gboolean _mmcamcorder_encode_jpeg(void *src_data, unsigned int src_width, unsign
 	gboolean do_encode = FALSE;
 	jpegenc_parameter enc_param;
 	static jpegenc_info enc_info = {-1,};
+	G_LOCK_DEFINE_STATIC(enc_info);
 
 	_mmcam_dbg_log("START");
 
@@ -1035,12 +2606,15 @@ gboolean _mmcamcorder_encode_jpeg(void *src_data, unsigned int src_width, unsign
 
 	CLEAR(enc_param);
 
+	/* it could be called by several encode threads at the same time */
+	G_LOCK(enc_info);
 	if (enc_info.sw_support == -1) {
 		CLEAR(enc_info);
 		__ta__("camsrcjpegenc_get_info",
 		camsrcjpegenc_get_info(&enc_info);
 		);
 	}
+	G_UNLOCK(enc_info);
 
 	src_fourcc = _mmcamcorder_get_fourcc(src_format, 0, FALSE);
 	camsrcjpegenc_get_src_fmt(src_fourcc, &(enc_param.src_fmt));
@@ -1054,33 +2628,38 @@ gboolean _mmcamcorder_encode_jpeg(void *src_data, unsigned int src_width, unsign
 				break;
 			}
 		}
+	}
 
-		if (do_encode) {
-			enc_param.src_data = src_data;
-			enc_param.width = src_width;
-			enc_param.height = src_height;
-			enc_param.src_len = src_length;
-			enc_param.jpeg_mode = JPEG_MODE_BASELINE;
-			enc_param.jpeg_quality = jpeg_quality;
+	if (do_encode) {
+		enc_param.src_data = src_data;
+		enc_param.width = src_width;
+		enc_param.height = src_height;
+		enc_param.src_len = src_length;
+		enc_param.jpeg_mode = JPEG_MODE_BASELINE;
+		enc_param.jpeg_quality = jpeg_quality;
 
-			__ta__("                    camsrcjpegenc_encode",
-			ret = camsrcjpegenc_encode(&enc_info, JPEG_ENCODER_SOFTWARE, &enc_param );
-			);
-			if (ret == CAMSRC_JPEGENC_ERROR_NONE) {
-				*result_data = enc_param.result_data;
-				*result_length = enc_param.result_len;
+		__ta__("                    camsrcjpegenc_encode",
+		ret = camsrcjpegenc_encode(&enc_info, JPEG_ENCODER_SOFTWARE, &enc_param );
+		);
+		if (ret == CAMSRC_JPEGENC_ERROR_NONE) {
+			*result_data = enc_param.result_data;
+			*result_length = enc_param.result_len;
 
-				_mmcam_dbg_log("JPEG encode length(%d)", *result_length);
+			_mmcam_dbg_log("JPEG encode length(%d)", *result_length);
 
-				return TRUE;
-			} else {
-				_mmcam_dbg_err("camsrcjpegenc_encode failed(%x)", ret);
-				return FALSE;
-			}
+			return TRUE;
 		} else {
-			_mmcam_dbg_err("S/W JPEG codec does NOT support format [%d]", src_format);
+			_mmcam_dbg_err("camsrcjpegenc_encode failed(%x)", ret);
 			return FALSE;
 		}
+	} else if (_mmcamcorder_jpegenc_is_supported(src_format)) {
+		_mmcam_dbg_log("S/W JPEG codec does NOT support format [%d], use built-in encoder", src_format);
+
+		__ta__("                    _mmcamcorder_jpegenc_encode",
+		ret = _mmcamcorder_jpegenc_encode(src_data, src_width, src_height, src_format, src_length,
+		                                  jpeg_quality, 1, result_data, result_length);
+		);
+		return ret;
 	} else {
 		_mmcam_dbg_err("Not Supported FOURCC(format:%d) or There is NO S/W encoder(%d)",
 				src_format, enc_info.sw_support);
@@ -1089,6 +2668,28 @@ gboolean _mmcamcorder_encode_jpeg(void *src_data, unsigned int src_width, unsign
 }
 
 
+gboolean _mmcamcorder_encode_jpeg_with_slice(void *src_data, unsigned int src_width, unsigned int src_height,
+                                             int src_format, unsigned int src_length, unsigned int jpeg_quality,
+                                             int slice_num, void **result_data, unsigned int *result_length)
+{
+	int ret = 0;
+
+	mmf_return_val_if_fail(src_data && result_data && result_length, FALSE);
+
+	/* built-in encoder is used only if slices are requested by configure, otherwise platform encoder */
+	if (slice_num > 1 && _mmcamcorder_jpegenc_is_supported(src_format)) {
+		__ta__("                    _mmcamcorder_jpegenc_encode",
+		ret = _mmcamcorder_jpegenc_encode(src_data, src_width, src_height, src_format, src_length,
+		                                  jpeg_quality, slice_num, result_data, result_length);
+		);
+		return ret;
+	}
+
+	return _mmcamcorder_encode_jpeg(src_data, src_width, src_height, src_format, src_length,
+	                                jpeg_quality, result_data, result_length);
+}
+
+
 static guint16 get_language_code(const char *str)
 {
     return (guint16) (((str[0]-0x60) & 0x1F) << 10) + (((str[1]-0x60) & 0x1F) << 5) + ((str[2]-0x60) & 0x1F);
@@ -1099,33 +2700,585 @@ static gchar * str_to_utf8(const gchar *str)
 	return g_convert (str, -1, "UTF-8", "ASCII", NULL, NULL, NULL);
 }
 
-static inline gboolean write_tag(FILE *f, const gchar *tag)
+static inline void put_tag(GByteArray *array, const gchar *tag)
+{
+	g_byte_array_append(array, (const guint8 *)tag, strlen(tag));
+}
+
+static inline void put_32(GByteArray *array, guint val)
+{
+	guint8 buf[4] = {val >> 24, val >> 16, val >> 8, val};
+	g_byte_array_append(array, buf, 4);
+}
+
+static inline void put_16(GByteArray *array, guint val)
+{
+	guint8 buf[2] = {val >> 8, val};
+	g_byte_array_append(array, buf, 2);
+}
+
+static inline void put_24(GByteArray *array, guint val)
+{
+	guint8 buf[3] = {val >> 16, val >> 8, val};
+	g_byte_array_append(array, buf, 3);
+}
+
+static inline void put_8(GByteArray *array, guint val)
+{
+	guint8 buf = val;
+	g_byte_array_append(array, &buf, 1);
+}
+
+/* string with null terminator */
+static inline void put_string(GByteArray *array, const gchar *str)
+{
+	if (str) {
+		g_byte_array_append(array, (const guint8 *)str, strlen(str));
+	}
+	put_8(array, 0);
+}
+
+/* update size field of box which starts at pos to end of array */
+static inline void put_size(GByteArray *array, guint pos)
+{
+	guint size = array->len - pos;
+
+	array->data[pos] = size >> 24;
+	array->data[pos + 1] = size >> 16;
+	array->data[pos + 2] = size >> 8;
+	array->data[pos + 3] = size;
+}
+
+
+/* parse box header and add it to index, returns index of box or -1 */
+static int __mmcamcorder_box_index_add(_MMCamcorderBoxIndex *index, const guchar *header, guint64 offset,
+                                       guint64 limit, int parent)
+{
+	_MMCamcorderBoxInfo *box = NULL;
+
+	if (index->box_num >= _MMCAMCORDER_BOX_INDEX_MAX) {
+		_mmcam_dbg_err("too many boxes");
+		return -1;
+	}
+
+	box = &(index->box[index->box_num]);
+	box->fourcc = MMCAM_FOURCC(header[4], header[5], header[6], header[7]);
+	box->offset = offset;
+	box->size = _mmcamcorder_get_container_size(header);
+	box->header_size = 8;
+	box->parent = parent;
+
+	if (box->size == 1) {
+		/* 64bit largesize */
+		box->size = ((guint64)_mmcamcorder_get_container_size(header + 8) << 32) |
+		            (guint64)_mmcamcorder_get_container_size(header + 12);
+		box->header_size = 16;
+	}
+
+	if ((box->size != 0 && box->size < (guint64)box->header_size) ||
+	    offset + box->size > limit) {
+		_mmcam_dbg_err("invalid box [%c%c%c%c] offset %" G_GUINT64_FORMAT ", size %" G_GUINT64_FORMAT,
+		               MMCAM_FOURCC_ARGS(box->fourcc), offset, box->size);
+		return -1;
+	}
+
+	_mmcam_dbg_log("[%c%c%c%c] offset %" G_GUINT64_FORMAT ", size %" G_GUINT64_FORMAT ", parent %d",
+	               MMCAM_FOURCC_ARGS(box->fourcc), offset, box->size, parent);
+
+	return index->box_num++;
+}
+
+
+/* map whole area of box */
+static gboolean __mmcamcorder_box_index_map(_MMCamcorderBoxIndex *index, int box)
 {
-	while(*tag)
-		FPUTC_CHECK(*tag++, f);
+	long page_size = sysconf(_SC_PAGESIZE);
+	guint64 end = 0;
+
+	end = index->box[box].size ? index->box[box].offset + index->box[box].size : index->file_size;
+
+	if (page_size <= 0) {
+		page_size = 4096;
+	}
+
+	index->map_offset = index->box[box].offset - (index->box[box].offset % (guint64)page_size);
+	index->map_size = (size_t)(end - index->map_offset);
+
+	index->map = (guchar *)mmap(NULL, index->map_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+	                            index->fd, (off_t)index->map_offset);
+	if (index->map == MAP_FAILED) {
+		_mmcam_dbg_err("mmap failed [%s]", strerror(errno));
+		index->map = NULL;
+		index->map_size = 0;
+		return FALSE;
+	}
 
-	return TRUE;	
+	return TRUE;
 }
 
-static inline gboolean write_to_32(FILE *f, guint val)
+
+/* write size field of box, in mapped memory if possible */
+static gboolean __mmcamcorder_box_index_write_size(_MMCamcorderBoxIndex *index, int box, guint64 size)
 {
-	FPUTC_CHECK(val >> 24, f);
-	FPUTC_CHECK(val >> 16, f);
-	FPUTC_CHECK(val >> 8, f);
-	FPUTC_CHECK(val, f);
+	int i = 0;
+	int len = 4;
+	guint64 offset = index->box[box].offset;
+	guchar buf[8];
+
+	if (index->box[box].header_size == 16) {
+		/* largesize field after type */
+		offset += 8;
+		len = 8;
+	}
+
+	for (i = 0 ; i < len ; i++) {
+		buf[i] = (guchar)(size >> (8 * (len - 1 - i)));
+	}
+
+	if (index->map && offset >= index->map_offset && offset + len <= index->map_offset + index->map_size) {
+		memcpy(index->map + (offset - index->map_offset), buf, len);
+	} else if (pwrite(index->fd, buf, len, (off_t)offset) != len) {
+		_mmcam_dbg_err("pwrite failed [%s]", strerror(errno));
+		return FALSE;
+	}
+
+	index->box[box].size = size;
+
 	return TRUE;
 }
 
-static inline gboolean write_to_16(FILE *f, guint val)
+
+static void __mmcamcorder_buffer_pool_flush(_MMCamcorderBufferPool *pool)
+{
+	while (pool->count > 0) {
+		pool->count--;
+		if (pool->buffer[pool->count]) {
+			free(pool->buffer[pool->count]);
+			pool->buffer[pool->count] = NULL;
+		}
+	}
+}
+
+
+static gboolean __mmcamcorder_msg_is_coalescable(mmf_camcorder_t *hcamcorder, int id)
+{
+	/* only the latest value is meaningful for these messages */
+	switch (id) {
+	case MM_MESSAGE_CAMCORDER_CURRENT_VOLUME:
+	case MM_MESSAGE_CAMCORDER_RECORDING_STATUS:
+		return TRUE;
+	case MM_MESSAGE_CAMCORDER_FACE_DETECT_INFO:
+		return hcamcorder->fd_pool.drop_stale;
+	default:
+		return FALSE;
+	}
+}
+
+
+static _MMCamcorderMsgStats *__mmcamcorder_msg_get_stats(_MMCamcorderMsgQueue *queue, int id)
+{
+	int i = 0;
+
+	for (i = 0 ; i < queue->stats_num ; i++) {
+		if (queue->stats[i].id == id) {
+			return &(queue->stats[i]);
+		}
+	}
+
+	if (queue->stats_num >= _MMCAMCORDER_MSG_STATS_MAX) {
+		return NULL;
+	}
+
+	queue->stats[queue->stats_num].id = id;
+	queue->stats[queue->stats_num].enqueue_count = 0;
+	queue->stats[queue->stats_num].drop_count = 0;
+
+	return &(queue->stats[queue->stats_num++]);
+}
+
+
+static void __mmcamcorder_msg_release_data(_MMCamcorderMsgItem *item)
+{
+	if (item->id == MM_MESSAGE_CAMCORDER_FACE_DETECT_INFO) {
+		mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(item->handle);
+		MMCamFaceDetectInfo *cam_fd_info = (MMCamFaceDetectInfo *)item->param.data;
+
+		/* return slot to pool */
+		if (hcamcorder && cam_fd_info) {
+			_mmcamcorder_fd_pool_put(&(hcamcorder->fd_pool), cam_fd_info);
+		}
+
+		item->param.data = NULL;
+		item->param.size = 0;
+	} else if (item->id == MM_MESSAGE_CAMCORDER_RECORDING_SEGMENT) {
+		if (item->param.data) {
+			free(item->param.data);
+		}
+
+		item->param.data = NULL;
+		item->param.size = 0;
+	}
+
+	return;
+}
+
+
+static void *__mmcamcorder_storage_monitor_thread(void *arg)
+{
+	int ret = 0;
+	char *path = NULL;
+	unsigned int generation = 0;
+	guint64 free_space = 0;
+	gint64 check_time = 0;
+	GTimeVal end_time;
+	_MMCamcorderStorageInfo info;
+	_MMCamcorderStorageInfo *prev = NULL;
+	_MMCamcorderStorageMonitor *monitor = (_MMCamcorderStorageMonitor *)arg;
+
+	mmf_return_val_if_fail(monitor, NULL);
+
+	_mmcam_dbg_log("start");
+
+	g_mutex_lock(monitor->lock);
+
+	while (monitor->running) {
+		if (monitor->path == NULL) {
+			g_cond_wait(monitor->cond, monitor->lock);
+			continue;
+		}
+
+		path = g_strdup(monitor->path);
+		generation = monitor->generation;
+
+		/* statfs could be blocked on slow storage, so do it without lock */
+		g_mutex_unlock(monitor->lock);
+
+		free_space = 0;
+		ret = _mmcamcorder_get_freespace(path, &free_space);
+		check_time = g_get_monotonic_time();
+
+		g_free(path);
+		path = NULL;
+
+		g_mutex_lock(monitor->lock);
+
+		/* publish only if path was not changed while checking */
+		if (generation == monitor->generation) {
+			prev = &(monitor->info[monitor->index]);
+
+			memset(&info, 0x00, sizeof(_MMCamcorderStorageInfo));
+			info.status = ret;
+			info.sequence = prev->sequence + 1;
+			info.free_space = free_space;
+			info.check_time = check_time;
+			info.write_rate = prev->write_rate;
+
+			/* moving average of consumed space per second */
+			if (ret > 0 && prev->status > 0 &&
+			    prev->free_space > free_space && check_time > prev->check_time) {
+				guint64 rate = ((prev->free_space - free_space) * G_USEC_PER_SEC) / (guint64)(check_time - prev->check_time);
+				if (info.write_rate == 0) {
+					info.write_rate = rate;
+				} else {
+					info.write_rate = (info.write_rate * 3 + rate) >> 2;
+				}
+			}
+
+			__mmcamcorder_storage_monitor_publish(monitor, &info);
+		}
+
+		g_get_current_time(&end_time);
+		g_time_val_add(&end_time, _MMCAMCORDER_STORAGE_CHECK_INTERVAL * 1000);
+		g_cond_timed_wait(monitor->cond, monitor->lock, &end_time);
+	}
+
+	g_mutex_unlock(monitor->lock);
+
+	_mmcam_dbg_log("done");
+
+	return NULL;
+}
+
+
+/* should be called with monitor->lock */
+static void __mmcamcorder_storage_monitor_publish(_MMCamcorderStorageMonitor *monitor, _MMCamcorderStorageInfo *info)
+{
+	gint next = monitor->index ? 0 : 1;
+
+	/* write to the buffer which readers are not using, then switch index */
+	g_atomic_int_inc(&(monitor->publish_count));
+	memcpy(&(monitor->info[next]), info, sizeof(_MMCamcorderStorageInfo));
+	g_atomic_int_set(&(monitor->index), next);
+
+	return;
+}
+
+
+/* accumulate sum of squares and peak of interleaved S16 samples for each channel (1 or 2 channels) */
+static void __mmcamcorder_audio_meter_s16(const short *pcm, unsigned int frames, int channel, guint64 *square_sum, int *peak)
+{
+	unsigned int i = 0;
+	unsigned int count = frames * channel;
+	int value = 0;
+
+#if defined(_MMCAMCORDER_AUDIO_METER_NEON)
+	int k = 0;
+	int c = 0;
+	short vmax[8];
+	short vmin[8];
+	int64x2_t acc[2] = {vdupq_n_s64(0), vdupq_n_s64(0)};
+	int16x8_t max_val[2] = {vdupq_n_s16(-32768), vdupq_n_s16(-32768)};
+	int16x8_t min_val[2] = {vdupq_n_s16(32767), vdupq_n_s16(32767)};
+
+	if (channel == 2) {
+		/* de-interleave left and right channel */
+		for ( ; i + 16 <= count ; i += 16) {
+			int16x8x2_t x = vld2q_s16(pcm + i);
+			for (c = 0 ; c < 2 ; c++) {
+				acc[c] = vpadalq_s32(acc[c], vmull_s16(vget_low_s16(x.val[c]), vget_low_s16(x.val[c])));
+				acc[c] = vpadalq_s32(acc[c], vmull_s16(vget_high_s16(x.val[c]), vget_high_s16(x.val[c])));
+				max_val[c] = vmaxq_s16(max_val[c], x.val[c]);
+				min_val[c] = vminq_s16(min_val[c], x.val[c]);
+			}
+		}
+	} else {
+		for ( ; i + 8 <= count ; i += 8) {
+			int16x8_t x = vld1q_s16(pcm + i);
+			acc[0] = vpadalq_s32(acc[0], vmull_s16(vget_low_s16(x), vget_low_s16(x)));
+			acc[0] = vpadalq_s32(acc[0], vmull_s16(vget_high_s16(x), vget_high_s16(x)));
+			max_val[0] = vmaxq_s16(max_val[0], x);
+			min_val[0] = vminq_s16(min_val[0], x);
+		}
+	}
+
+	for (c = 0 ; c < channel ; c++) {
+		square_sum[c] += (guint64)(vgetq_lane_s64(acc[c], 0) + vgetq_lane_s64(acc[c], 1));
+
+		vst1q_s16(vmax, max_val[c]);
+		vst1q_s16(vmin, min_val[c]);
+		for (k = 0 ; k < 8 ; k++) {
+			if (vmax[k] > peak[c]) {
+				peak[c] = vmax[k];
+			}
+			if (-vmin[k] > peak[c]) {
+				peak[c] = -vmin[k];
+			}
+		}
+	}
+#elif defined(_MMCAMCORDER_AUDIO_METER_SSE2)
+	int k = 0;
+	guint64 sum[2];
+	short vmax[8];
+	short vmin[8];
+	__m128i zero = _mm_setzero_si128();
+	__m128i even_mask = _mm_set1_epi32(0x0000ffff);
+	__m128i acc_even = _mm_setzero_si128();
+	__m128i acc_odd = _mm_setzero_si128();
+	__m128i max_val = _mm_set1_epi16(-32768);
+	__m128i min_val = _mm_set1_epi16(32767);
+
+	for ( ; i + 8 <= count ; i += 8) {
+		__m128i x = _mm_loadu_si128((const __m128i *)(pcm + i));
+		__m128i sq_even;
+		__m128i sq_odd;
+
+		max_val = _mm_max_epi16(max_val, x);
+		min_val = _mm_min_epi16(min_val, x);
+
+		if (channel == 2) {
+			/* even samples are left channel, odd samples are right channel */
+			sq_even = _mm_madd_epi16(x, _mm_and_si128(x, even_mask));
+			sq_odd = _mm_madd_epi16(x, _mm_andnot_si128(even_mask, x));
+			acc_odd = _mm_add_epi64(acc_odd, _mm_unpacklo_epi32(sq_odd, zero));
+			acc_odd = _mm_add_epi64(acc_odd, _mm_unpackhi_epi32(sq_odd, zero));
+		} else {
+			sq_even = _mm_madd_epi16(x, x);
+		}
+
+		/* sum of two squares could be 2^31, so extend it as unsigned */
+		acc_even = _mm_add_epi64(acc_even, _mm_unpacklo_epi32(sq_even, zero));
+		acc_even = _mm_add_epi64(acc_even, _mm_unpackhi_epi32(sq_even, zero));
+	}
+
+	_mm_storeu_si128((__m128i *)sum, acc_even);
+	square_sum[0] += sum[0] + sum[1];
+	if (channel == 2) {
+		_mm_storeu_si128((__m128i *)sum, acc_odd);
+		square_sum[1] += sum[0] + sum[1];
+	}
+
+	_mm_storeu_si128((__m128i *)vmax, max_val);
+	_mm_storeu_si128((__m128i *)vmin, min_val);
+	for (k = 0 ; k < 8 ; k++) {
+		if (vmax[k] > peak[k % channel]) {
+			peak[k % channel] = vmax[k];
+		}
+		if (-vmin[k] > peak[k % channel]) {
+			peak[k % channel] = -vmin[k];
+		}
+	}
+#endif
+
+	/* remained samples. i is multiple of channel here */
+	for ( ; i < count ; i++) {
+		value = pcm[i];
+		square_sum[i % channel] += (guint64)(value * value);
+		if (value < 0) {
+			value = -value;
+		}
+		if (value > peak[i % channel]) {
+			peak[i % channel] = value;
+		}
+	}
+
+	return;
+}
+
+
+/* accumulate sum of squares and peak of interleaved U8 samples for each channel */
+static void __mmcamcorder_audio_meter_u8(const unsigned char *pcm, unsigned int frames, int channel, guint64 *square_sum, int *peak)
+{
+	unsigned int i = 0;
+	unsigned int count = frames * channel;
+	int value = 0;
+
+	for (i = 0 ; i < count ; i++) {
+		value = (int)pcm[i] - 128;
+		square_sum[i % channel] += (guint64)(value * value);
+		if (value < 0) {
+			value = -value;
+		}
+		if (value > peak[i % channel]) {
+			peak[i % channel] = value;
+		}
+	}
+
+	return;
+}
+
+
+/* calculate level of current window and start next window */
+static void __mmcamcorder_audio_meter_complete(_MMCamcorderAudioMeter *meter)
+{
+	#define MAX_AMPLITUDE_MEAN_16BIT 23170.115738161934
+	#define MAX_AMPLITUDE_MEAN_08BIT    89.803909382810
+
+	int i = 0;
+	double rms = 0.0;
+	double rms_ref = 0.0;
+	double peak_ref = 0.0;
+	double db = 0.0;
+
+	if (meter->format == MM_CAMCORDER_AUDIO_FORMAT_PCM_S16_LE) {
+		rms_ref = MAX_AMPLITUDE_MEAN_16BIT;
+		peak_ref = 32768.0;
+	} else {
+		rms_ref = MAX_AMPLITUDE_MEAN_08BIT;
+		peak_ref = 128.0;
+	}
+
+	meter->last.channel = meter->channel;
+
+	for (i = 0 ; i < meter->channel ; i++) {
+		rms = sqrt((double)meter->square_sum[i] / meter->frame_count);
+
+		db = (rms > 0.0) ? 20 * log10(rms / rms_ref) : _MMCAMCORDER_AUDIO_METER_DB_MIN;
+		meter->last.rms_dB[i] = (float)MAX(db, _MMCAMCORDER_AUDIO_METER_DB_MIN);
+
+		db = (meter->peak[i] > 0) ? 20 * log10(meter->peak[i] / peak_ref) : _MMCAMCORDER_AUDIO_METER_DB_MIN;
+		meter->last.peak_dB[i] = (float)MAX(db, _MMCAMCORDER_AUDIO_METER_DB_MIN);
+
+		meter->square_sum[i] = 0;
+		meter->peak[i] = 0;
+	}
+
+	meter->frame_count = 0;
+
+	g_mutex_lock(meter->lock);
+	memcpy(&(meter->level), &(meter->last), sizeof(MMCamcorderAudioLevel));
+	g_mutex_unlock(meter->lock);
+
+	return;
+}
+
+
+/* drop accumulated samples and reset level */
+static void __mmcamcorder_audio_meter_reset(_MMCamcorderAudioMeter *meter, int format, int channel)
+{
+	int i = 0;
+
+	meter->format = format;
+	meter->channel = channel;
+	meter->frame_count = 0;
+
+	meter->last.channel = channel;
+	for (i = 0 ; i < MM_CAMCORDER_AUDIO_LEVEL_CHANNEL_MAX ; i++) {
+		meter->square_sum[i] = 0;
+		meter->peak[i] = 0;
+		meter->last.rms_dB[i] = _MMCAMCORDER_AUDIO_METER_DB_MIN;
+		meter->last.peak_dB[i] = _MMCAMCORDER_AUDIO_METER_DB_MIN;
+	}
+
+	return;
+}
+
+
+static void *__mmcamcorder_encode_pool_thread(void *arg)
 {
-	FPUTC_CHECK(val >> 8, f);
-	FPUTC_CHECK(val, f);
-	return TRUE;	
+	_MMCamcorderEncodePool *pool = (_MMCamcorderEncodePool *)arg;
+	_MMCamcorderEncodeJob *entry = NULL;
+
+	mmf_return_val_if_fail(pool, NULL);
+
+	g_mutex_lock(pool->lock);
+
+	while (pool->running) {
+		entry = (_MMCamcorderEncodeJob *)g_queue_pop_head(&pool->pending);
+		if (entry == NULL) {
+			g_cond_wait(pool->cond, pool->lock);
+			continue;
+		}
+
+		g_mutex_unlock(pool->lock);
+		entry->result = pool->encode(entry->job);
+		g_mutex_lock(pool->lock);
+
+		g_queue_insert_sorted(&pool->done, entry, __mmcamcorder_encode_pool_compare, NULL);
+
+		/* only one worker delivers at a time, and it delivers every job which is ready in order */
+		while (!pool->delivering) {
+			entry = (_MMCamcorderEncodeJob *)g_queue_peek_head(&pool->done);
+			if (entry == NULL || entry->seq != pool->deliver_seq) {
+				break;
+			}
+
+			g_queue_pop_head(&pool->done);
+			pool->delivering = TRUE;
+
+			g_mutex_unlock(pool->lock);
+			pool->deliver(entry->job, entry->result, pool->user_data);
+			free(entry);
+			entry = NULL;
+			g_mutex_lock(pool->lock);
+
+			pool->delivering = FALSE;
+			pool->deliver_seq++;
+			pool->in_flight--;
+			g_cond_broadcast(pool->cond);
+		}
+	}
+
+	g_mutex_unlock(pool->lock);
+
+	return NULL;
 }
 
-static inline gboolean write_to_24(FILE *f, guint val)
+
+static gint __mmcamcorder_encode_pool_compare(gconstpointer a, gconstpointer b, gpointer user_data)
 {
-	write_to_16(f, val >> 8);
-	FPUTC_CHECK(val, f);
-	return TRUE;	
+	const _MMCamcorderEncodeJob *job_a = (const _MMCamcorderEncodeJob *)a;
+	const _MMCamcorderEncodeJob *job_b = (const _MMCamcorderEncodeJob *)b;
+
+	/* sequence could wrap around */
+	return (gint)(job_a->seq - job_b->seq);
 }
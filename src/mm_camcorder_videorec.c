@@ -35,9 +35,8 @@
 |    LOCAL VARIABLE DEFINITIONS for internal						|
 ---------------------------------------------------------------------------------------*/
 #define _MMCAMCORDER_MINIMUM_FRAME              10
-#define _MMCAMCORDER_RETRIAL_COUNT              10
-#define _MMCAMCORDER_FRAME_WAIT_TIME            200000 /* ms */
-#define _MMCAMCORDER_FREE_SPACE_CHECK_INTERVAL  5
+#define _MMCAMCORDER_FRAME_WAIT_TIMEOUT         2000 /* msec */
+#define _MMCAMCORDER_PRE_RECORD_LOCATION        "/dev/null"
 
 /*---------------------------------------------------------------------------------------
 |    LOCAL FUNCTION PROTOTYPES:								|
@@ -48,9 +47,23 @@ static gboolean __mmcamcorder_video_dataprobe_record(GstPad *pad, GstBuffer *buf
 static gboolean __mmcamcorder_audioque_dataprobe(GstPad *pad, GstBuffer *buffer, gpointer u_data);
 static gboolean __mmcamcorder_video_dataprobe_audio_disable(GstPad *pad, GstBuffer *buffer, gpointer u_data);
 static gboolean __mmcamcorder_audio_dataprobe_audio_mute(GstPad *pad, GstBuffer *buffer, gpointer u_data);
+static gboolean __mmcamcorder_set_locationinfo_to_mux(MMHandleType handle, int fileformat);
 static gboolean __mmcamcorder_add_locationinfo(MMHandleType handle, int fileformat);
 static gboolean __mmcamcorder_add_locationinfo_mp4(MMHandleType handle);
 static gboolean __mmcamcorder_eventprobe_monitor(GstPad *pad, GstEvent *event, gpointer u_data);
+static gboolean __mmcamcorder_check_enough_frames(gpointer data);
+static gboolean __mmcamcorder_set_fragment_to_mux(_MMCamcorderSubContext *sc, _MMCamcorderVideoInfo *info);
+static void __mmcamcorder_send_segment_message(mmf_camcorder_t *hcamcorder, MMCamcorderRecordingSegmentInfo *info);
+static gboolean __mmcamcorder_dataprobe_mux_output(GstPad *pad, GstBuffer *buffer, gpointer u_data);
+static gboolean __mmcamcorder_eventprobe_mux_output(GstPad *pad, GstEvent *event, gpointer u_data);
+static guint64 __mmcamcorder_get_trailer_size(_MMCamcorderSubContext *sc, _MMCamcorderVideoInfo *info);
+static int __mmcamcorder_start_pre_record(MMHandleType handle);
+static void __mmcamcorder_stop_pre_record(MMHandleType handle);
+static int __mmcamcorder_set_pre_record_location(_MMCamcorderSubContext *sc, const char *filename);
+static void __mmcamcorder_release_pre_record(_MMCamcorderSubContext *sc, _MMCamcorderVideoInfo *info);
+static gboolean __mmcamcorder_video_dataprobe_pre_record(GstPad *pad, GstBuffer *buffer, gpointer u_data);
+static gboolean __mmcamcorder_audio_dataprobe_pre_record(GstPad *pad, GstBuffer *buffer, gpointer u_data);
+static gboolean __mmcamcorder_pre_record_dataprobe(GstPad *pad, GstBuffer *buffer, mmf_camcorder_t *hcamcorder, _MMCamcorderPreRecordStream stream);
 
 /*=======================================================================================
 |  FUNCTION DEFINITIONS									|
@@ -69,6 +82,7 @@ int _mmcamcorder_add_recorder_pipeline(MMHandleType handle)
 
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
 	_MMCamcorderSubContext *sc = NULL;
+	_MMCamcorderVideoInfo *info = NULL;
 
 	type_element *RecordsinkElement = NULL;
 
@@ -76,7 +90,10 @@ int _mmcamcorder_add_recorder_pipeline(MMHandleType handle)
 
 	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
 	mmf_return_val_if_fail(sc, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+	mmf_return_val_if_fail(sc->info, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
 	mmf_return_val_if_fail(sc->element, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+
+	info = sc->info;
 	
 	_mmcam_dbg_log("");
 
@@ -148,6 +165,24 @@ int _mmcamcorder_add_recorder_pipeline(MMHandleType handle)
 
 	/* set data probe function */
 
+	/* pre-record probes should be called before others on same pad,
+	   because they hold frames until recording is started */
+	if (g_atomic_int_get(&(info->pre_recording))) {
+		srcpad = gst_element_get_static_pad(sc->element[_MMCAMCORDER_ENCSINK_VENC].gst, "src");
+		MMCAMCORDER_ADD_BUFFER_PROBE(srcpad, _MMCAMCORDER_HANDLER_VIDEOREC,
+		                             __mmcamcorder_video_dataprobe_pre_record, hcamcorder);
+		gst_object_unref(srcpad);
+		srcpad = NULL;
+
+		if (sc->audio_disable == FALSE) {
+			srcpad = gst_element_get_static_pad(sc->element[_MMCAMCORDER_ENCSINK_AENC].gst, "src");
+			MMCAMCORDER_ADD_BUFFER_PROBE(srcpad, _MMCAMCORDER_HANDLER_VIDEOREC,
+			                             __mmcamcorder_audio_dataprobe_pre_record, hcamcorder);
+			gst_object_unref(srcpad);
+			srcpad = NULL;
+		}
+	}
+
 	/* register message cb */
 
 	/* set data probe function for audio */
@@ -203,6 +238,17 @@ int _mmcamcorder_add_recorder_pipeline(MMHandleType handle)
 		                             __mmcamcorder_audio_dataprobe_check, hcamcorder);
 		gst_object_unref(srcpad);
 		srcpad = NULL;
+
+		/* segments of segmented recording are reported when muxer writes them */
+		if (sc->element[_MMCAMCORDER_ENCSINK_MUX].gst) {
+			srcpad = gst_element_get_static_pad(sc->element[_MMCAMCORDER_ENCSINK_MUX].gst, "src");
+			MMCAMCORDER_ADD_BUFFER_PROBE(srcpad, _MMCAMCORDER_HANDLER_VIDEOREC,
+			                             __mmcamcorder_dataprobe_mux_output, hcamcorder);
+			MMCAMCORDER_ADD_EVENT_PROBE(srcpad, _MMCAMCORDER_HANDLER_VIDEOREC,
+			                            __mmcamcorder_eventprobe_mux_output, hcamcorder);
+			gst_object_unref(srcpad);
+			srcpad = NULL;
+		}
 	}
 
 	MMCAMCORDER_SIGNAL_CONNECT(sc->element[_MMCAMCORDER_VIDEOSRC_SRC].gst,
@@ -437,29 +483,36 @@ int _mmcamcorder_video_command(MMHandleType handle, int command)
 	{
 		if (_mmcamcorder_get_state((MMHandleType)hcamcorder) != MM_CAMCORDER_STATE_PAUSED) {
 			guint imax_time = 0;
+			guint isegment_time = 0;
+			gboolean pre_recording = g_atomic_int_get(&(info->pre_recording));
 
 			/* Play record start sound */
 			_mmcamcorder_sound_solo_play(handle, _MMCAMCORDER_FILEPATH_REC_START_SND, TRUE);
 
 			/* Recording */
-			_mmcam_dbg_log("Record Start");
-			ret = _mmcamcorder_gst_set_state(handle, pipeline, GST_STATE_PAUSED);
-			if (ret != MM_ERROR_NONE) {
-				goto _ERR_CAMCORDER_VIDEO_COMMAND;
-			}
+			_mmcam_dbg_log("Record Start (pre-recording %d)", pre_recording);
 
-			_mmcamcorder_conf_get_value_int(hcamcorder->conf_main,
-			                                CONFIGURE_CATEGORY_MAIN_RECORD,
-			                                "DropVideoFrame",
-			                                &(sc->drop_vframe));
+			/* recorder pipeline is already running in pre-recording */
+			if (!pre_recording) {
+				ret = _mmcamcorder_gst_set_state(handle, pipeline, GST_STATE_PAUSED);
+				if (ret != MM_ERROR_NONE) {
+					goto _ERR_CAMCORDER_VIDEO_COMMAND;
+				}
+
+				/* frames after restarting pipeline could be unstable */
+				_mmcamcorder_conf_get_value_int(hcamcorder->conf_main,
+				                                CONFIGURE_CATEGORY_MAIN_RECORD,
+				                                "DropVideoFrame",
+				                                &(sc->drop_vframe));
 
-			_mmcamcorder_conf_get_value_int(hcamcorder->conf_main,
-			                                CONFIGURE_CATEGORY_MAIN_RECORD,
-			                                "PassFirstVideoFrame",
-			                                &(sc->pass_first_vframe));
+				_mmcamcorder_conf_get_value_int(hcamcorder->conf_main,
+				                                CONFIGURE_CATEGORY_MAIN_RECORD,
+				                                "PassFirstVideoFrame",
+				                                &(sc->pass_first_vframe));
 
-			_mmcam_dbg_log("Drop video frame count[%d], Pass fisrt video frame count[%d]",
-			               sc->drop_vframe, sc->pass_first_vframe);
+				_mmcam_dbg_log("Drop video frame count[%d], Pass fisrt video frame count[%d]",
+				               sc->drop_vframe, sc->pass_first_vframe);
+			}
 
 			ret = mm_camcorder_get_attributes(handle, &err_name,
 			                                  MMCAM_CAMERA_FPS, &fps,
@@ -467,6 +520,7 @@ int _mmcamcorder_video_command(MMHandleType handle, int command)
 			                                  MMCAM_FILE_FORMAT, &fileformat,
 			                                  MMCAM_TARGET_FILENAME, &temp_filename, &size,
 			                                  MMCAM_TARGET_TIME_LIMIT, &imax_time,
+			                                  MMCAM_TARGET_SEGMENT_TIME_LIMIT, &isegment_time,
 			                                  MMCAM_FILE_FORMAT, &(info->fileformat),
 			                                  NULL);
 			if (ret != MM_ERROR_NONE) {
@@ -482,6 +536,13 @@ int _mmcamcorder_video_command(MMHandleType handle, int command)
 				info->max_time = ((guint64)imax_time) * 1000; /* to millisecond */
 			}
 
+			/* set segment duration */
+			if (isegment_time <= 0) {
+				info->segment_duration = 0; /* not segmented */
+			} else {
+				info->segment_duration = ((guint64)isegment_time) * 1000; /* to millisecond */
+			}
+
 			if (sc->is_modified_rate) {
 				info->record_timestamp_ratio = (_MMCAMCORDER_DEFAULT_RECORDING_MOTION_RATE/motion_rate);
 				_mmcam_dbg_log("high speed recording fps:%d, slow_rate:%f, timestamp_ratio:%f",
@@ -492,11 +553,22 @@ int _mmcamcorder_video_command(MMHandleType handle, int command)
 			}
 
 			MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_VIDEOSRC_SRC].gst, "hold-af-after-capturing", TRUE);
-			MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_VIDEOSRC_SRC].gst, "req-negotiation", TRUE);
 
-			ret =_mmcamcorder_add_recorder_pipeline((MMHandleType)hcamcorder);
-			if (ret != MM_ERROR_NONE) {
-				goto _ERR_CAMCORDER_VIDEO_COMMAND;
+			if (!pre_recording) {
+				MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_VIDEOSRC_SRC].gst, "req-negotiation", TRUE);
+
+				ret =_mmcamcorder_add_recorder_pipeline((MMHandleType)hcamcorder);
+				if (ret != MM_ERROR_NONE) {
+					goto _ERR_CAMCORDER_VIDEO_COMMAND;
+				}
+
+				info->pre_record_base = 0;
+			}
+
+			/* muxer closes fragment every segment, then trailer is not needed to be estimated */
+			if (info->segment_duration > 0 &&
+			    !__mmcamcorder_set_fragment_to_mux(sc, info)) {
+				info->segment_duration = 0;
 			}
 
 			info->filename = strdup(temp_filename);
@@ -507,63 +579,91 @@ int _mmcamcorder_video_command(MMHandleType handle, int command)
 
 			_mmcam_dbg_log("Record start : set file name using attribute - %s ",info->filename);
 
-			MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_ENCSINK_SINK].gst, "location", info->filename);
+			if (pre_recording) {
+				ret = __mmcamcorder_set_pre_record_location(sc, info->filename);
+				if (ret != MM_ERROR_NONE) {
+					g_free(info->filename);
+					info->filename = NULL;
+					goto _ERR_CAMCORDER_VIDEO_COMMAND;
+				}
+			} else {
+				MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_ENCSINK_SINK].gst, "location", info->filename);
+			}
+
+			/* free space is checked by storage monitor thread while recording */
+			_mmcamcorder_storage_monitor_start(&(sc->storage_monitor));
+			_mmcamcorder_storage_monitor_set_path(&(sc->storage_monitor), info->filename);
+			sc->storage_sequence = 0;
+
 			MMCAMCORDER_G_OBJECT_SET( sc->element[_MMCAMCORDER_ENCSINK_ENCBIN].gst, "block", 0);
 
 			/* Adjust display FPS */
 			sc->display_interval = 0;
 			sc->previous_slot_time = 0;
 
-			/* gst_element_set_base_time(GST_ELEMENT(pipeline), (GstClockTime)0);
-			   if you want to use audio clock, enable this block
-			   for change recorder_pipeline state to paused. */
-			__ta__("        _MMCamcorder_CMD_RECORD:GST_STATE_PAUSED2",
-			ret = _mmcamcorder_gst_set_state(handle, pipeline, GST_STATE_PAUSED);
-			);
-			if (ret != MM_ERROR_NONE) {
-				/* Remove recorder pipeline and recording file which size maybe zero */
-				__ta__("        record fail:remove_recorder_pipeline",
-				_mmcamcorder_remove_recorder_pipeline((MMHandleType)hcamcorder);
+			if (!pre_recording) {
+				/* gst_element_set_base_time(GST_ELEMENT(pipeline), (GstClockTime)0);
+				   if you want to use audio clock, enable this block
+				   for change recorder_pipeline state to paused. */
+				__ta__("        _MMCamcorder_CMD_RECORD:GST_STATE_PAUSED2",
+				ret = _mmcamcorder_gst_set_state(handle, pipeline, GST_STATE_PAUSED);
 				);
-				if (info->filename) {
-					_mmcam_dbg_log("file delete(%s)", info->filename);
-					unlink(info->filename);
-					g_free(info->filename);
-					info->filename = NULL;
+				if (ret != MM_ERROR_NONE) {
+					/* Remove recorder pipeline and recording file which size maybe zero */
+					__ta__("        record fail:remove_recorder_pipeline",
+					_mmcamcorder_remove_recorder_pipeline((MMHandleType)hcamcorder);
+					);
+					if (info->filename) {
+						_mmcam_dbg_log("file delete(%s)", info->filename);
+						unlink(info->filename);
+						g_free(info->filename);
+						info->filename = NULL;
+						_mmcamcorder_storage_monitor_set_path(&(sc->storage_monitor), NULL);
+					}
+					goto _ERR_CAMCORDER_VIDEO_COMMAND;
 				}
-				goto _ERR_CAMCORDER_VIDEO_COMMAND;
+
+				/**< To fix video recording hanging
+					1. use gst_element_set_start_time() instead of gst_pipeline_set_new_stream_time()
+					2. Set (GstClockTime)1 instead of (GstClockTime)0. Because of strict check in gstreamer 0.25,
+					 basetime wouldn't change if you set (GstClockTime)0.
+					3. Move set start time position below PAUSED of pipeline.
+				*/
+				gst_element_set_start_time(GST_ELEMENT(pipeline), (GstClockTime)1);
 			}
 
-			/**< To fix video recording hanging
-				1. use gst_element_set_start_time() instead of gst_pipeline_set_new_stream_time()
-				2. Set (GstClockTime)1 instead of (GstClockTime)0. Because of strict check in gstreamer 0.25,
-				 basetime wouldn't change if you set (GstClockTime)0.
-				3. Move set start time position below PAUSED of pipeline.
-			*/
-			gst_element_set_start_time(GST_ELEMENT(pipeline), (GstClockTime)1);
 			info->video_frame_count = 0;
 			info->audio_frame_count = 0;
 			info->filesize = 0;
+			info->location_by_mux = FALSE;
+			info->segment_input_time = 0;
+			_mmcamcorder_segment_tracker_reset(&sc->segment);
 			sc->ferror_send = FALSE;
 			sc->ferror_count = 0;
 			sc->error_occurs = FALSE;
 			sc->bget_eos = FALSE;
 
-			__ta__("        _MMCamcorder_CMD_RECORD:GST_STATE_PLAYING2",
-			ret = _mmcamcorder_gst_set_state(handle, pipeline, GST_STATE_PLAYING);
-			);
-			if (ret != MM_ERROR_NONE) {
-				/* Remove recorder pipeline and recording file which size maybe zero */
-				__ta__("        record fail:remove_recorder_pipeline",
-				_mmcamcorder_remove_recorder_pipeline((MMHandleType)hcamcorder);
+			if (pre_recording) {
+				/* frames in pre-record buffer are muxed first, then live frames follow */
+				__mmcamcorder_release_pre_record(sc, info);
+			} else {
+				__ta__("        _MMCamcorder_CMD_RECORD:GST_STATE_PLAYING2",
+				ret = _mmcamcorder_gst_set_state(handle, pipeline, GST_STATE_PLAYING);
 				);
-				if (info->filename) {
-					_mmcam_dbg_log("file delete(%s)", info->filename);
-					unlink(info->filename);
-					g_free(info->filename);
-					info->filename = NULL;
+				if (ret != MM_ERROR_NONE) {
+					/* Remove recorder pipeline and recording file which size maybe zero */
+					__ta__("        record fail:remove_recorder_pipeline",
+					_mmcamcorder_remove_recorder_pipeline((MMHandleType)hcamcorder);
+					);
+					if (info->filename) {
+						_mmcam_dbg_log("file delete(%s)", info->filename);
+						unlink(info->filename);
+						g_free(info->filename);
+						info->filename = NULL;
+						_mmcamcorder_storage_monitor_set_path(&(sc->storage_monitor), NULL);
+					}
+					goto _ERR_CAMCORDER_VIDEO_COMMAND;
 				}
-				goto _ERR_CAMCORDER_VIDEO_COMMAND;
 			}
 		} else {
 			/* Resume case */
@@ -582,44 +682,19 @@ int _mmcamcorder_video_command(MMHandleType handle, int command)
 		break;
 	case _MMCamcorder_CMD_PAUSE:
 	{
-		int count = 0;
-
 		if (info->b_commiting) {
 			_mmcam_dbg_warn("now on commiting previous file!!(command : %d)", command);
 			return MM_ERROR_CAMCORDER_CMD_IS_RUNNING;
 		}
 
-		for (count = 0 ; count <= _MMCAMCORDER_RETRIAL_COUNT ; count++) {
-			if (sc->audio_disable) {
-				/* check only video frame */
-				if (info->video_frame_count >= _MMCAMCORDER_MINIMUM_FRAME) {
-					break;
-				} else if (count == _MMCAMCORDER_RETRIAL_COUNT) {
-					_mmcam_dbg_err("Pause fail, frame count %" G_GUINT64_FORMAT "",
-					               info->video_frame_count);
-					return MM_ERROR_CAMCORDER_INVALID_CONDITION;
-				} else {
-					_mmcam_dbg_warn("Waiting for enough video frame, retrial[%d], frame %" G_GUINT64_FORMAT "",
-					                count, info->video_frame_count);
-				}
-
-				usleep(_MMCAMCORDER_FRAME_WAIT_TIME);
-			} else {
-				/* check both of video and audio frame */
-				if (info->video_frame_count >= _MMCAMCORDER_MINIMUM_FRAME && info->audio_frame_count) {
-					break;
-				} else if (count == _MMCAMCORDER_RETRIAL_COUNT) {
-					_mmcam_dbg_err("Pause fail, frame count VIDEO[%" G_GUINT64_FORMAT "], AUDIO [%" G_GUINT64_FORMAT "]",
-					               info->video_frame_count, info->audio_frame_count);
-					return MM_ERROR_CAMCORDER_INVALID_CONDITION;
-				} else {
-					_mmcam_dbg_warn("Waiting for enough frames, retrial [%d], VIDEO[%" G_GUINT64_FORMAT "], AUDIO [%" G_GUINT64_FORMAT "]",
-					                count, info->video_frame_count, info->audio_frame_count);
-				}
-
-				usleep(_MMCAMCORDER_FRAME_WAIT_TIME);
-			}
+		/* wait until data probes signal that enough frames are recorded */
+		if (!_mmcamcorder_frame_notifier_wait(&(sc->frame_notifier), __mmcamcorder_check_enough_frames,
+		                                      sc, _MMCAMCORDER_FRAME_WAIT_TIMEOUT)) {
+			_mmcam_dbg_err("Pause fail, frame count VIDEO[%" G_GUINT64_FORMAT "], AUDIO [%" G_GUINT64_FORMAT "]",
+			               info->video_frame_count, info->audio_frame_count);
+			return MM_ERROR_CAMCORDER_INVALID_CONDITION;
 		}
+
 		/* tee block */
 		MMCAMCORDER_G_OBJECT_SET( sc->element[_MMCAMCORDER_ENCSINK_ENCBIN].gst, "runtime-pause", TRUE);
 
@@ -653,6 +728,7 @@ int _mmcamcorder_video_command(MMHandleType handle, int command)
 			unlink(info->filename);
 			g_free(info->filename);
 			info->filename = NULL;
+			_mmcamcorder_storage_monitor_set_path(&(sc->storage_monitor), NULL);
 		}
 
 		sc->isMaxsizePausing = FALSE;
@@ -663,6 +739,14 @@ int _mmcamcorder_video_command(MMHandleType handle, int command)
 		info->video_frame_count = 0;
 		info->audio_frame_count = 0;
 		info->filesize =0;
+		info->location_by_mux = FALSE;
+		info->pre_record_base = 0;
+
+		/* keep frames for next recording */
+		ret = __mmcamcorder_start_pre_record(handle);
+		if (ret != MM_ERROR_NONE) {
+			goto _ERR_CAMCORDER_VIDEO_COMMAND;
+		}
 
 		__ta__("        _MMCamcorder_CMD_CANCEL:GST_STATE_PLAYING",
 		ret =_mmcamcorder_gst_set_state(handle, pipeline, GST_STATE_PLAYING);
@@ -675,8 +759,6 @@ int _mmcamcorder_video_command(MMHandleType handle, int command)
 	}
 	case _MMCamcorder_CMD_COMMIT:
 	{
-		int count = 0;
-
 		if (info->b_commiting) {
 			_mmcam_dbg_err("now on commiting previous file!!(command : %d)", command);
 			return MM_ERROR_CAMCORDER_CMD_IS_RUNNING;
@@ -685,43 +767,20 @@ int _mmcamcorder_video_command(MMHandleType handle, int command)
 			info->b_commiting = TRUE;
 		}
 
-		for (count = 0 ; count <= _MMCAMCORDER_RETRIAL_COUNT ; count++) {
-			if (sc->audio_disable) {
-				/* check only video frame */
-				if (info->video_frame_count >= _MMCAMCORDER_MINIMUM_FRAME) {
-					break;
-				} else if (count == _MMCAMCORDER_RETRIAL_COUNT) {
-					_mmcam_dbg_err("Commit fail, frame count is %" G_GUINT64_FORMAT "",
-					               info->video_frame_count);
-					info->b_commiting = FALSE;
-					return MM_ERROR_CAMCORDER_INVALID_CONDITION;
-				} else {
-					_mmcam_dbg_warn("Waiting for enough video frame, retrial [%d], frame %" G_GUINT64_FORMAT "",
-					                count, info->video_frame_count);
-				}
-
-				usleep(_MMCAMCORDER_FRAME_WAIT_TIME);
-			} else {
-				/* check both of video and audio frame */
-				if (info->video_frame_count >= _MMCAMCORDER_MINIMUM_FRAME && info->audio_frame_count) {
-					break;
-				} else if (count == _MMCAMCORDER_RETRIAL_COUNT) {
-					_mmcam_dbg_err("Commit fail, VIDEO[%" G_GUINT64_FORMAT "], AUDIO [%" G_GUINT64_FORMAT "]",
-					               info->video_frame_count, info->audio_frame_count);
-
-					info->b_commiting = FALSE;
-					return MM_ERROR_CAMCORDER_INVALID_CONDITION;
-				} else {
-					_mmcam_dbg_warn("Waiting for enough frames, retrial [%d], VIDEO[%" G_GUINT64_FORMAT "], AUDIO [%" G_GUINT64_FORMAT "]",
-					                count, info->video_frame_count, info->audio_frame_count);
-				}
-
-				usleep(_MMCAMCORDER_FRAME_WAIT_TIME);
-			}
+		/* wait until data probes signal that enough frames are recorded */
+		if (!_mmcamcorder_frame_notifier_wait(&(sc->frame_notifier), __mmcamcorder_check_enough_frames,
+		                                      sc, _MMCAMCORDER_FRAME_WAIT_TIMEOUT)) {
+			_mmcam_dbg_err("Commit fail, VIDEO[%" G_GUINT64_FORMAT "], AUDIO [%" G_GUINT64_FORMAT "]",
+			               info->video_frame_count, info->audio_frame_count);
+			info->b_commiting = FALSE;
+			return MM_ERROR_CAMCORDER_INVALID_CONDITION;
 		}
 
 		MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_VIDEOSRC_SRC].gst, "hold-af-after-capturing", FALSE);
 
+		/* hand location tags to muxer before EOS, then it's written with trailer */
+		info->location_by_mux = __mmcamcorder_set_locationinfo_to_mux(handle, info->fileformat);
+
 		if (sc->error_occurs) {
 			GstPad *video= NULL;
 			GstPad *audio = NULL;
@@ -806,6 +865,11 @@ int _mmcamcorder_video_command(MMHandleType handle, int command)
 		                            MMCAM_CAMERA_FOCUS_MODE, focus_mode,
 		                            NULL);
 
+		ret = __mmcamcorder_start_pre_record(handle);
+		if (ret != MM_ERROR_NONE) {
+			goto _ERR_CAMCORDER_VIDEO_COMMAND;
+		}
+
 		__ta__("        _MMCamcorder_CMD_PREVIEW_START:GST_STATE_PLAYING",
 		ret =_mmcamcorder_gst_set_state(handle, pipeline, GST_STATE_PLAYING);
 		);
@@ -825,6 +889,8 @@ int _mmcamcorder_video_command(MMHandleType handle, int command)
 			goto _ERR_CAMCORDER_VIDEO_COMMAND;
 		}
 
+		__mmcamcorder_stop_pre_record(handle);
+
 		if (sc->element[_MMCAMCORDER_VIDEOSRC_SRC].gst) {
 			int op_status = 0;
 			MMCAMCORDER_G_OBJECT_GET(sc->element[_MMCAMCORDER_VIDEOSRC_SRC].gst, "operation-status", &op_status);
@@ -914,7 +980,16 @@ int _mmcamcorder_video_handle_eos(MMHandleType handle)
 		_mmcam_dbg_warn("_MMCamcorder_CMD_COMMIT:__mmcamcorder_remove_recorder_pipeline failed. error[%x]", ret);
 	}
 
-	if (enabletag && !(sc->ferror_send)) {
+	/* muxer wrote the last segment before EOS */
+	if (info->segment_duration > 0 && !(sc->ferror_send)) {
+		MMCamcorderRecordingSegmentInfo segment;
+
+		_mmcamcorder_segment_tracker_finish(&sc->segment, info->segment_input_time, &segment);
+		__mmcamcorder_send_segment_message(hcamcorder, &segment);
+	}
+
+	/* muxer already wrote location tags, so file doesn't need to be rewritten */
+	if (enabletag && !(sc->ferror_send) && !(info->location_by_mux)) {
 		__ta__( "        _MMCamcorder_CMD_COMMIT:__mmcamcorder_add_locationinfo",
 		ret = __mmcamcorder_add_locationinfo((MMHandleType)hcamcorder, info->fileformat);
 		);
@@ -940,6 +1015,11 @@ int _mmcamcorder_video_handle_eos(MMHandleType handle)
 	gst_object_unref(pad);
 	pad = NULL;
 
+	/* keep frames for next recording */
+	if (__mmcamcorder_start_pre_record(handle) != MM_ERROR_NONE) {
+		_mmcam_dbg_warn("Failed to start pre-recording");
+	}
+
 	_mmcam_dbg_log("Set state as PLAYING");
 	__ta__("        _MMCamcorder_CMD_COMMIT:GST_STATE_PLAYING",
 	ret =_mmcamcorder_gst_set_state(handle, pipeline, GST_STATE_PLAYING);
@@ -984,8 +1064,11 @@ int _mmcamcorder_video_handle_eos(MMHandleType handle)
 	info->video_frame_count = 0;
 	info->audio_frame_count = 0;
 	info->filesize = 0;
+	info->location_by_mux = FALSE;
+	info->segment_duration = 0;
 	g_free(info->filename);
 	info->filename = NULL;
+	_mmcamcorder_storage_monitor_set_path(&(sc->storage_monitor), NULL);
 	info->b_commiting = FALSE;
 
 	MMTA_ACUM_ITEM_END("    _mmcamcorder_video_handle_eos", 0);
@@ -1005,7 +1088,7 @@ void _mmcamcorder_video_snapshot_capture_cb(GstElement *element, GstBuffer *buff
 	int attr_index = 0;
 	int tag_enable = FALSE;
 	int provide_exif = FALSE;
-	unsigned char *exif_raw_data = NULL;
+	int exif_raw_data_set = FALSE;
 
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(u_data);
 	_MMCamcorderVideoInfo *info = NULL;
@@ -1080,38 +1163,26 @@ void _mmcamcorder_video_snapshot_capture_cb(GstElement *element, GstBuffer *buff
 	/* commit attribute */
 	mmf_attribute_commit(item_screennail);
 
-	/* create EXIF info */
-	__ta__("                    mm_exif_create_exif_info",
-	ret = mm_exif_create_exif_info(&(hcamcorder->exif_info));
+	/* add basic exif info. EXIF info is created at first, and reused for next image */
+	_mmcam_dbg_log("add basic exif info");
+	__ta__("                    __mmcamcorder_set_exif_basic_info",
+	ret = __mmcamcorder_set_exif_basic_info((MMHandleType)hcamcorder, dest.width, dest.height);
 	);
 	if (ret != MM_ERROR_NONE) {
-		_mmcam_dbg_err("Failed to create exif_info [%x], but keep going...", ret);
-	} else {
-		/* add basic exif info */
-		_mmcam_dbg_log("add basic exif info");
-		__ta__("                    __mmcamcorder_set_exif_basic_info",
-		ret = __mmcamcorder_set_exif_basic_info((MMHandleType)hcamcorder, dest.width, dest.height);
-		);
-		if (ret != MM_ERROR_NONE) {
-			_mmcam_dbg_warn("Failed set_exif_basic_info [%x], but keep going...", ret);
-			ret = MM_ERROR_NONE;
-		}
+		_mmcam_dbg_warn("Failed set_exif_basic_info [%x], but keep going...", ret);
+		ret = MM_ERROR_NONE;
 	}
 
 	/* get attribute item for EXIF data */
 	mm_attrs_get_index((MMHandleType)attrs, MMCAM_CAPTURED_EXIF_RAW_DATA, &attr_index);
 	item_exif_raw_data = &attrs->items[attr_index];
 
-	/* set EXIF data to attribute */
+	/* set EXIF data to attribute without copy. it's valid only in capture callback,
+	   and EXIF info of handle is not changed until the callback returns. */
 	if (hcamcorder->exif_info && hcamcorder->exif_info->data) {
-		exif_raw_data = (unsigned char *)malloc(hcamcorder->exif_info->size);
-		if (exif_raw_data) {
-			memcpy(exif_raw_data, hcamcorder->exif_info->data, hcamcorder->exif_info->size);
-			mmf_attribute_set_data(item_exif_raw_data, exif_raw_data, hcamcorder->exif_info->size);
-			_mmcam_dbg_log("set EXIF raw data %p, size %d", exif_raw_data, hcamcorder->exif_info->size);
-		} else {
-			_mmcam_dbg_warn("failed to alloc for EXIF, size %d", hcamcorder->exif_info->size);
-		}
+		mmf_attribute_set_data(item_exif_raw_data, hcamcorder->exif_info->data, hcamcorder->exif_info->size);
+		exif_raw_data_set = TRUE;
+		_mmcam_dbg_log("set EXIF raw data %p, size %d", hcamcorder->exif_info->data, hcamcorder->exif_info->size);
 	} else {
 		_mmcam_dbg_warn("failed to create EXIF. set EXIF as NULL");
 		mmf_attribute_set_data(item_exif_raw_data, NULL, 0);
@@ -1138,6 +1209,9 @@ void _mmcamcorder_video_snapshot_capture_cb(GstElement *element, GstBuffer *buff
 		}
 	}
 
+	/* set segment if captured image is delivered by segments */
+	__mmcamcorder_set_capture_segment((MMHandleType)hcamcorder, &dest);
+
 	/* Handle Capture Callback */
 	_MMCAMCORDER_LOCK_VCAPTURE_CALLBACK(hcamcorder);
 
@@ -1165,19 +1239,6 @@ void _mmcamcorder_video_snapshot_capture_cb(GstElement *element, GstBuffer *buff
 err_release_exif:
 	_MMCAMCORDER_UNLOCK_VCAPTURE_CALLBACK(hcamcorder);
 
-	/* init screennail and EXIF raw data */
-	__ta__("                init attributes:scrnl and EXIF",
-	mmf_attribute_set_data(item_screennail, NULL, 0);
-	mmf_attribute_commit(item_screennail);
-	if (exif_raw_data) {
-		free(exif_raw_data);
-		exif_raw_data = NULL;
-
-		mmf_attribute_set_data(item_exif_raw_data, NULL, 0);
-		mmf_attribute_commit(item_exif_raw_data);
-	}
-	);
-
 	/* Release jpeg data */
 	if (pixtype == MM_PIXEL_FORMAT_ENCODED) {
 		__ta__( "                VideoSnapshot:__mmcamcorder_release_jpeg_data",
@@ -1186,6 +1247,18 @@ err_release_exif:
 	}
 
 error:
+	/* init screennail and EXIF raw data */
+	__ta__("                init attributes:scrnl and EXIF",
+	if (item_screennail) {
+		mmf_attribute_set_data(item_screennail, NULL, 0);
+		mmf_attribute_commit(item_screennail);
+	}
+	if (exif_raw_data_set) {
+		mmf_attribute_set_data(item_exif_raw_data, NULL, 0);
+		mmf_attribute_commit(item_exif_raw_data);
+	}
+	);
+
 	/* send message - captured or error with error code */
 	_mmcam_dbg_log("msg id : %x, code : %x", msg.id, msg.param.code);
 	_mmcamcroder_send_message((MMHandleType)hcamcorder, &msg);
@@ -1201,12 +1274,6 @@ error:
 		gst_buffer_unref(buffer3);
 	}
 
-	/* destroy exif info */
-	__ta__("                mm_exif_destory_exif_info",
-	mm_exif_destory_exif_info(hcamcorder->exif_info);
-	);
-	hcamcorder->exif_info = NULL;
-
 	MMTA_ACUM_ITEM_END("            VideoSnapshot:MSL capture callback", FALSE);
 
 	_mmcam_dbg_err("END");
@@ -1214,6 +1281,29 @@ error:
 	return;
 }
 
+
+static gboolean __mmcamcorder_check_enough_frames(gpointer data)
+{
+	_MMCamcorderSubContext *sc = (_MMCamcorderSubContext *)data;
+	_MMCamcorderVideoInfo *info = NULL;
+
+	mmf_return_val_if_fail(sc && sc->info, FALSE);
+
+	info = sc->info;
+
+	if (info->video_frame_count < _MMCAMCORDER_MINIMUM_FRAME) {
+		return FALSE;
+	}
+
+	/* check audio frame too if audio is enabled */
+	if (!sc->audio_disable && info->audio_frame_count == 0) {
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+
 /**
  * This function is record video data probing function.
  * If this function is linked with certain pad by gst_pad_add_buffer_probe(),
@@ -1276,6 +1366,7 @@ static gboolean __mmcamcorder_audio_dataprobe_check(GstPad *pad, GstBuffer *buff
 	if (info->audio_frame_count == 0) {
 		info->filesize += (guint64)GST_BUFFER_SIZE(buffer);
 		info->audio_frame_count++;
+		_mmcamcorder_frame_notifier_signal(&(sc->frame_notifier));
 		return TRUE;
 	}
 
@@ -1293,20 +1384,17 @@ static gboolean __mmcamcorder_audio_dataprobe_check(GstPad *pad, GstBuffer *buff
 
 static gboolean __mmcamcorder_video_dataprobe_record(GstPad *pad, GstBuffer *buffer, gpointer u_data)
 {
-	static int count = 0;
-	gint ret = 0;
 	guint vq_size = 0;
 	guint aq_size = 0;
-	guint64 free_space = 0;
 	guint64 buffer_size = 0;
 	guint64 trailer_size = 0;
 	guint64 queued_buffer = 0;
-	char *filename = NULL;
 
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(u_data);
 	_MMCamcorderMsgItem msg;
 	_MMCamcorderSubContext *sc = NULL;
 	_MMCamcorderVideoInfo *info = NULL;
+	_MMCamcorderStorageInfo storage;
 
 	mmf_return_val_if_fail(hcamcorder, TRUE);
 	mmf_return_val_if_fail(buffer, FALSE);
@@ -1322,6 +1410,10 @@ static gboolean __mmcamcorder_video_dataprobe_record(GstPad *pad, GstBuffer *buf
 	}
 
 	info->video_frame_count++;
+	if (info->video_frame_count == (guint64)_MMCAMCORDER_MINIMUM_FRAME) {
+		_mmcamcorder_frame_notifier_signal(&(sc->frame_notifier));
+	}
+
 	if (info->video_frame_count <= (guint64)_MMCAMCORDER_MINIMUM_FRAME) {
 		/* _mmcam_dbg_log("Pass minimum frame: info->video_frame_count: %" G_GUINT64_FORMAT " ",
 		                info->video_frame_count); */
@@ -1331,29 +1423,29 @@ static gboolean __mmcamcorder_video_dataprobe_record(GstPad *pad, GstBuffer *buf
 
 	buffer_size = GST_BUFFER_SIZE(buffer);
 
-	/* get trailer size */
-	if (info->fileformat == MM_FILE_FORMAT_3GP || info->fileformat == MM_FILE_FORMAT_MP4) {
-		MMCAMCORDER_G_OBJECT_GET(sc->element[_MMCAMCORDER_ENCSINK_MUX].gst, "expected-trailer-size", &trailer_size);
-	} else {
-		trailer_size = 0;
+	/* segment boundary is decided by muxer, this is used as time when muxer writes fragment */
+	if (info->segment_duration > 0 && GST_BUFFER_TIMESTAMP_IS_VALID(buffer)) {
+		info->segment_input_time = GST_TIME_AS_MSECONDS(GST_BUFFER_TIMESTAMP(buffer));
 	}
 
-	/* to minimizing free space check overhead */
-	count = count % _MMCAMCORDER_FREE_SPACE_CHECK_INTERVAL;
-	if (count++ == 0) {
-		filename = info->filename;
-		ret = _mmcamcorder_get_freespace(filename, &free_space);
+	/* get free space which is published by storage monitor thread */
+	_mmcamcorder_storage_monitor_get_info(&(sc->storage_monitor), &storage);
 
-		/*_mmcam_dbg_log("check free space for recording");*/
+	/* check free space which is predicted with write rate for every buffer */
+	switch (storage.status) {
+	case 0: /* not checked yet */
+		break;
+	case -2: /* file not exist */
+	case -1: /* failed to get free space */
+		/* count error only once for each check of storage monitor */
+		if (storage.sequence != sc->storage_sequence) {
+			sc->storage_sequence = storage.sequence;
 
-		switch (ret) {
-		case -2: /* file not exist */
-		case -1: /* failed to get free space */
-			_mmcam_dbg_err("Error occured. [%d]", ret);
+			_mmcam_dbg_err("Error occured. [%d]", storage.status);
 			if (sc->ferror_count == 2 && sc->ferror_send == FALSE) {
 				sc->ferror_send = TRUE;
 				msg.id = MM_MESSAGE_CAMCORDER_ERROR;
-				if (ret == -2) {
+				if (storage.status == -2) {
 					msg.param.code = MM_ERROR_FILE_NOT_FOUND;
 				} else {
 					msg.param.code = MM_ERROR_FILE_READ;
@@ -1362,40 +1454,42 @@ static gboolean __mmcamcorder_video_dataprobe_record(GstPad *pad, GstBuffer *buf
 			} else {
 				sc->ferror_count++;
 			}
+		}
 
-			return FALSE; /* skip this buffer */
-			break;
-		default: /* succeeded to get free space */
-			/* check free space for recording */
-			/* get queued buffer size */
-			if (sc->element[_MMCAMCORDER_ENCSINK_AENC_QUE].gst) {
-				MMCAMCORDER_G_OBJECT_GET(sc->element[_MMCAMCORDER_ENCSINK_AENC_QUE].gst, "current-level-bytes", &aq_size);
-			}
-			if (sc->element[_MMCAMCORDER_ENCSINK_VENC_QUE].gst) {
-				MMCAMCORDER_G_OBJECT_GET(sc->element[_MMCAMCORDER_ENCSINK_VENC_QUE].gst, "current-level-bytes", &vq_size);
-			}
+		return FALSE; /* skip this buffer */
+		break;
+	default: /* succeeded to get free space */
+		/* get trailer size */
+		trailer_size = __mmcamcorder_get_trailer_size(sc, info);
 
-			queued_buffer = aq_size + vq_size;
+		/* get queued buffer size */
+		if (sc->element[_MMCAMCORDER_ENCSINK_AENC_QUE].gst) {
+			MMCAMCORDER_G_OBJECT_GET(sc->element[_MMCAMCORDER_ENCSINK_AENC_QUE].gst, "current-level-bytes", &aq_size);
+		}
+		if (sc->element[_MMCAMCORDER_ENCSINK_VENC_QUE].gst) {
+			MMCAMCORDER_G_OBJECT_GET(sc->element[_MMCAMCORDER_ENCSINK_VENC_QUE].gst, "current-level-bytes", &vq_size);
+		}
 
-			/* check free space */
-			if (free_space < (_MMCAMCORDER_MINIMUM_SPACE + buffer_size + trailer_size + queued_buffer)) {
-				_mmcam_dbg_warn("No more space for recording!!! Recording is paused.");
-				_mmcam_dbg_warn("Free Space : [%" G_GUINT64_FORMAT "], trailer size : [%" G_GUINT64_FORMAT "]," \
-				                " buffer size : [%" G_GUINT64_FORMAT "], queued buffer size : [%" G_GUINT64_FORMAT "]", \
-				                free_space, trailer_size, buffer_size, queued_buffer);
+		queued_buffer = aq_size + vq_size;
 
-				if (!sc->isMaxsizePausing) {
-					MMCAMCORDER_G_OBJECT_SET( sc->element[_MMCAMCORDER_ENCSINK_ENCBIN].gst, "block", TRUE);
-					sc->isMaxsizePausing = TRUE;
+		/* check free space which is predicted with write rate */
+		if (storage.free_space < (_MMCAMCORDER_MINIMUM_SPACE + buffer_size + trailer_size + queued_buffer)) {
+			_mmcam_dbg_warn("No more space for recording!!! Recording is paused.");
+			_mmcam_dbg_warn("Free Space : [%" G_GUINT64_FORMAT "], trailer size : [%" G_GUINT64_FORMAT "]," \
+			                " buffer size : [%" G_GUINT64_FORMAT "], queued buffer size : [%" G_GUINT64_FORMAT "]", \
+			                storage.free_space, trailer_size, buffer_size, queued_buffer);
 
-					msg.id = MM_MESSAGE_CAMCORDER_NO_FREE_SPACE;
-					_mmcamcroder_send_message((MMHandleType)hcamcorder, &msg);
-				}
+			if (!sc->isMaxsizePausing) {
+				MMCAMCORDER_G_OBJECT_SET( sc->element[_MMCAMCORDER_ENCSINK_ENCBIN].gst, "block", TRUE);
+				sc->isMaxsizePausing = TRUE;
 
-				return FALSE;
+				msg.id = MM_MESSAGE_CAMCORDER_NO_FREE_SPACE;
+				_mmcamcroder_send_message((MMHandleType)hcamcorder, &msg);
 			}
-			break;
+
+			return FALSE;
 		}
+		break;
 	}
 
 	info->filesize += (guint64)buffer_size;
@@ -1428,16 +1522,22 @@ static gboolean __mmcamcorder_video_dataprobe_audio_disable(GstPad *pad, GstBuff
 
 	info = sc->info;
 
-	b_time = GST_BUFFER_TIMESTAMP(buffer);
+	/* frames are not recorded yet */
+	if (g_atomic_int_get(&(info->pre_recording))) {
+		return TRUE;
+	}
 
-	rec_pipe_time = GST_TIME_AS_MSECONDS(b_time);
+	b_time = GST_BUFFER_TIMESTAMP(buffer);
 
-	if (info->fileformat == MM_FILE_FORMAT_3GP || info->fileformat == MM_FILE_FORMAT_MP4) {
-		MMCAMCORDER_G_OBJECT_GET(sc->element[_MMCAMCORDER_ENCSINK_MUX].gst, "expected-trailer-size", &trailer_size);
-	} else {
-		trailer_size = 0;
+	/* elapsed time includes frames which were kept before recording */
+	if (b_time < info->pre_record_base) {
+		return TRUE;
 	}
 
+	rec_pipe_time = GST_TIME_AS_MSECONDS(b_time - info->pre_record_base);
+
+	trailer_size = __mmcamcorder_get_trailer_size(sc, info);
+
 	/* check max time */
 	if (info->max_time > 0 && rec_pipe_time > info->max_time) {
 		_mmcam_dbg_warn("Current time : [%" G_GUINT64_FORMAT "], Maximum time : [%" G_GUINT64_FORMAT "]", \
@@ -1461,8 +1561,11 @@ static gboolean __mmcamcorder_video_dataprobe_audio_disable(GstPad *pad, GstBuff
 		return FALSE;
 	}
 
-	if (info->max_time > 0 && info->max_time < (remained_time + rec_pipe_time)) {
-		remained_time = info->max_time - rec_pipe_time;
+	/* time remained until storage is full or time limit */
+	remained_time = _mmcamcorder_storage_monitor_get_remained_time(&(sc->storage_monitor), _MMCAMCORDER_MINIMUM_SPACE + trailer_size);
+	if (info->max_time > 0 && rec_pipe_time < info->max_time &&
+	    (remained_time == 0 || info->max_time - rec_pipe_time < remained_time)) {
+		remained_time = (unsigned int)(info->max_time - rec_pipe_time);
 	}
 
 	msg.id = MM_MESSAGE_CAMCORDER_RECORDING_STATUS;
@@ -1509,16 +1612,25 @@ static gboolean __mmcamcorder_audioque_dataprobe(GstPad *pad, GstBuffer *buffer,
 		return TRUE;
 	}
 
-	rec_pipe_time = GST_TIME_AS_MSECONDS(GST_BUFFER_TIMESTAMP(buffer));
+	/* frames are not recorded yet */
+	if (g_atomic_int_get(&(info->pre_recording))) {
+		return TRUE;
+	}
 
-	if (info->fileformat == MM_FILE_FORMAT_3GP || info->fileformat == MM_FILE_FORMAT_MP4) {
-		MMCAMCORDER_G_OBJECT_GET(sc->element[_MMCAMCORDER_ENCSINK_MUX].gst, "expected-trailer-size", &trailer_size);
-	} else {
-		trailer_size = 0;
+	/* elapsed time includes frames which were kept before recording */
+	if (GST_BUFFER_TIMESTAMP(buffer) < info->pre_record_base) {
+		return TRUE;
 	}
 
-	if (info->max_time > 0 && info->max_time < (remained_time + rec_pipe_time)) {
-		remained_time = info->max_time - rec_pipe_time;
+	rec_pipe_time = GST_TIME_AS_MSECONDS(GST_BUFFER_TIMESTAMP(buffer) - info->pre_record_base);
+
+	trailer_size = __mmcamcorder_get_trailer_size(sc, info);
+
+	/* time remained until storage is full or time limit */
+	remained_time = _mmcamcorder_storage_monitor_get_remained_time(&(sc->storage_monitor), _MMCAMCORDER_MINIMUM_SPACE + trailer_size);
+	if (info->max_time > 0 && rec_pipe_time < info->max_time &&
+	    (remained_time == 0 || info->max_time - rec_pipe_time < remained_time)) {
+		remained_time = (unsigned int)(info->max_time - rec_pipe_time);
 	}
 
 	if (info->max_time > 0 && rec_pipe_time > info->max_time) {
@@ -1559,30 +1671,24 @@ static gboolean __mmcamcorder_audioque_dataprobe(GstPad *pad, GstBuffer *buffer,
 static gboolean __mmcamcorder_audio_dataprobe_audio_mute(GstPad *pad, GstBuffer *buffer, gpointer u_data)
 {
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(u_data);
-	double volume = 0.0;
+	_MMCamcorderSubContext *sc = NULL;
 	int format = 0;
 	int channel = 0;
-	int err = MM_ERROR_UNKNOWN;
-	char *err_name = NULL;
 
 	mmf_return_val_if_fail(buffer, FALSE);
 	mmf_return_val_if_fail(hcamcorder, FALSE);
 
+	sc = MMF_CAMCORDER_SUBCONTEXT(hcamcorder);
+	mmf_return_val_if_fail(sc, FALSE);
+
 	/*_mmcam_dbg_log("AUDIO SRC time stamp : [%" GST_TIME_FORMAT "] \n", GST_TIME_ARGS(GST_BUFFER_TIMESTAMP(buffer)));*/
-	err = mm_camcorder_get_attributes((MMHandleType)hcamcorder, &err_name,
-	                                  MMCAM_AUDIO_VOLUME, &volume,
-	                                  MMCAM_AUDIO_FORMAT, &format,
-	                                  MMCAM_AUDIO_CHANNEL, &channel,
-	                                  NULL);
-	if (err != MM_ERROR_NONE) {
-		_mmcam_dbg_warn("Get attrs fail. (%s:%x)", err_name, err);
-		SAFE_FREE(err_name);
-		return err;
-	}
+	/* Get attributes from snapshot without lock */
+	format = g_atomic_int_get(&(hcamcorder->hot_attrs.audio_format));
+	channel = g_atomic_int_get(&(hcamcorder->hot_attrs.audio_channel));
 
-	/* Set audio stream NULL */
-	if (volume == 0.0) {
-		memset(GST_BUFFER_DATA(buffer), 0, GST_BUFFER_SIZE(buffer));
+	/* Set audio stream NULL - replace data with shared silence data, source buffer is not touched */
+	if (g_atomic_int_get(&(hcamcorder->hot_attrs.audio_mute))) {
+		_mmcamcorder_silence_buffer_apply(&(sc->silence), buffer);
 	}
 
 	/* CALL audio stream callback */
@@ -1616,6 +1722,430 @@ static gboolean __mmcamcorder_audio_dataprobe_audio_mute(GstPad *pad, GstBuffer
 }
 
 
+static gboolean __mmcamcorder_set_fragment_to_mux(_MMCamcorderSubContext *sc, _MMCamcorderVideoInfo *info)
+{
+	GstElement *mux = sc->element[_MMCAMCORDER_ENCSINK_MUX].gst;
+
+	if (info->fileformat != MM_FILE_FORMAT_3GP && info->fileformat != MM_FILE_FORMAT_MP4) {
+		_mmcam_dbg_warn("Unsupported fileformat for segmented recording (%d)", info->fileformat);
+		return FALSE;
+	}
+
+	if (mux == NULL ||
+	    !g_object_class_find_property(G_OBJECT_GET_CLASS(G_OBJECT(mux)), "fragment-duration")) {
+		_mmcam_dbg_warn("muxer does not support fragment, record as one file");
+		return FALSE;
+	}
+
+	MMCAMCORDER_G_OBJECT_SET(mux, "fragment-duration", (guint)info->segment_duration);
+
+	_mmcam_dbg_log("segmented recording : duration %" G_GUINT64_FORMAT " ms", info->segment_duration);
+
+	return TRUE;
+}
+
+
+static void __mmcamcorder_send_segment_message(mmf_camcorder_t *hcamcorder, MMCamcorderRecordingSegmentInfo *info)
+{
+	_MMCamcorderMsgItem msg;
+	MMCamcorderRecordingSegmentInfo *segment = NULL;
+
+	_mmcam_dbg_log("segment[%d] written : %u ~ %u ms, offset %llu, size %llu",
+	               info->index, info->start_time, info->end_time, info->offset, info->size);
+
+	/* released by message queue after callback */
+	segment = (MMCamcorderRecordingSegmentInfo *)malloc(sizeof(MMCamcorderRecordingSegmentInfo));
+	if (segment == NULL) {
+		_mmcam_dbg_err("failed to alloc segment info");
+		return;
+	}
+
+	memcpy(segment, info, sizeof(MMCamcorderRecordingSegmentInfo));
+
+	memset(&msg, 0x00, sizeof(_MMCamcorderMsgItem));
+	msg.id = MM_MESSAGE_CAMCORDER_RECORDING_SEGMENT;
+	msg.param.data = (void *)segment;
+	msg.param.size = sizeof(MMCamcorderRecordingSegmentInfo);
+	_mmcamcroder_send_message((MMHandleType)hcamcorder, &msg);
+}
+
+
+static gboolean __mmcamcorder_dataprobe_mux_output(GstPad *pad, GstBuffer *buffer, gpointer u_data)
+{
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(u_data);
+	_MMCamcorderSubContext *sc = NULL;
+	_MMCamcorderVideoInfo *info = NULL;
+	MMCamcorderRecordingSegmentInfo segment;
+
+	mmf_return_val_if_fail(hcamcorder, TRUE);
+	mmf_return_val_if_fail(buffer, FALSE);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(hcamcorder);
+	mmf_return_val_if_fail(sc && sc->info, TRUE);
+
+	info = sc->info;
+	if (info->segment_duration == 0) {
+		return TRUE;
+	}
+
+	if (_mmcamcorder_segment_tracker_write(&sc->segment, GST_BUFFER_DATA(buffer), GST_BUFFER_SIZE(buffer),
+	                                       info->segment_input_time, &segment)) {
+		__mmcamcorder_send_segment_message(hcamcorder, &segment);
+	}
+
+	return TRUE;
+}
+
+
+static gboolean __mmcamcorder_eventprobe_mux_output(GstPad *pad, GstEvent *event, gpointer u_data)
+{
+	gboolean update = FALSE;
+	gdouble rate = 1.0;
+	GstFormat format = GST_FORMAT_UNDEFINED;
+	gint64 start = 0;
+	gint64 stop = 0;
+	gint64 position = 0;
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(u_data);
+	_MMCamcorderSubContext *sc = NULL;
+	_MMCamcorderVideoInfo *info = NULL;
+
+	mmf_return_val_if_fail(hcamcorder, TRUE);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(hcamcorder);
+	mmf_return_val_if_fail(sc && sc->info, TRUE);
+
+	info = sc->info;
+	if (info->segment_duration == 0) {
+		return TRUE;
+	}
+
+	/* muxer seeks with byte segment to rewrite header */
+	if (GST_EVENT_TYPE(event) == GST_EVENT_NEWSEGMENT) {
+		gst_event_parse_new_segment(event, &update, &rate, &format, &start, &stop, &position);
+		if (format == GST_FORMAT_BYTES && start >= 0) {
+			_mmcamcorder_segment_tracker_seek(&sc->segment, (guint64)start);
+		}
+	}
+
+	return TRUE;
+}
+
+
+static guint64 __mmcamcorder_get_trailer_size(_MMCamcorderSubContext *sc, _MMCamcorderVideoInfo *info)
+{
+	guint64 trailer_size = 0;
+
+	if (info->fileformat != MM_FILE_FORMAT_3GP && info->fileformat != MM_FILE_FORMAT_MP4) {
+		return 0; /* no trailer */
+	}
+
+	/* moov is written ahead of fragments, only small index is left for EOS */
+	if (info->segment_duration > 0) {
+		return 0;
+	}
+
+	MMCAMCORDER_G_OBJECT_GET(sc->element[_MMCAMCORDER_ENCSINK_MUX].gst, "expected-trailer-size", &trailer_size);
+
+	return trailer_size;
+}
+
+
+static int __mmcamcorder_start_pre_record(MMHandleType handle)
+{
+	int ret = MM_ERROR_NONE;
+	int pre_record_time = 0;
+	int memory_limit = _MMCAMCORDER_PRE_RECORD_MEMORY_LIMIT;
+
+	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
+	_MMCamcorderSubContext *sc = NULL;
+	_MMCamcorderVideoInfo *info = NULL;
+
+	mmf_return_val_if_fail(hcamcorder, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
+	mmf_return_val_if_fail(sc && sc->info, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+
+	info = sc->info;
+
+	mm_camcorder_get_attributes(handle, NULL,
+	                            MMCAM_TARGET_PRE_RECORD_TIME, &pre_record_time,
+	                            NULL);
+	if (pre_record_time <= 0) {
+		return MM_ERROR_NONE;
+	}
+
+	if (sc->is_modified_rate) {
+		_mmcam_dbg_warn("pre-recording is not supported in slow motion recording");
+		return MM_ERROR_NONE;
+	}
+
+	_mmcamcorder_conf_get_value_int(hcamcorder->conf_main,
+	                                CONFIGURE_CATEGORY_MAIN_RECORD,
+	                                "PreRecordMemoryLimit",
+	                                &memory_limit);
+
+	_mmcam_dbg_log("pre-record time %d sec, memory limit %d KB", pre_record_time, memory_limit);
+
+	if (!_mmcamcorder_pre_record_buffer_init(&(sc->pre_record), pre_record_time * 1000, (unsigned int)memory_limit << 10)) {
+		return MM_ERROR_CAMCORDER_LOW_MEMORY;
+	}
+
+	info->pre_record_base = 0;
+	g_atomic_int_set(&(info->pre_record_wait_key), FALSE);
+	g_atomic_int_set(&(info->pre_record_flush_video), FALSE);
+	g_atomic_int_set(&(info->pre_record_flush_audio), FALSE);
+	g_atomic_int_set(&(info->pre_recording), TRUE);
+
+	ret = _mmcamcorder_add_recorder_pipeline(handle);
+	if (ret != MM_ERROR_NONE) {
+		g_atomic_int_set(&(info->pre_recording), FALSE);
+		_mmcamcorder_pre_record_buffer_deinit(&(sc->pre_record));
+		return ret;
+	}
+
+	/* muxer gets nothing until recording starts, so nothing is written to this location.
+	   sink should not wait preroll when it's reopened with target file while pipeline is running */
+	MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_ENCSINK_SINK].gst, "async", FALSE);
+	MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_ENCSINK_SINK].gst, "location", _MMCAMCORDER_PRE_RECORD_LOCATION);
+	MMCAMCORDER_G_OBJECT_SET(sc->element[_MMCAMCORDER_ENCSINK_ENCBIN].gst, "block", FALSE);
+
+	return MM_ERROR_NONE;
+}
+
+
+static void __mmcamcorder_stop_pre_record(MMHandleType handle)
+{
+	_MMCamcorderSubContext *sc = NULL;
+	_MMCamcorderVideoInfo *info = NULL;
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
+	mmf_return_if_fail(sc && sc->info);
+
+	info = sc->info;
+
+	if (!g_atomic_int_get(&(info->pre_recording))) {
+		return;
+	}
+
+	_mmcam_dbg_log("stop pre-recording");
+
+	g_atomic_int_set(&(info->pre_recording), FALSE);
+
+	_mmcamcorder_remove_recorder_pipeline(handle);
+	_mmcamcorder_pre_record_buffer_deinit(&(sc->pre_record));
+
+	return;
+}
+
+
+static int __mmcamcorder_set_pre_record_location(_MMCamcorderSubContext *sc, const char *filename)
+{
+	GstElement *sink = sc->element[_MMCAMCORDER_ENCSINK_SINK].gst;
+
+	mmf_return_val_if_fail(sink, MM_ERROR_CAMCORDER_NOT_INITIALIZED);
+
+	/* sink has not received any data yet, so it can be reopened with target file */
+	if (gst_element_set_state(sink, GST_STATE_NULL) == GST_STATE_CHANGE_FAILURE) {
+		_mmcam_dbg_err("failed to close sink");
+		return MM_ERROR_CAMCORDER_GST_STATECHANGE;
+	}
+
+	MMCAMCORDER_G_OBJECT_SET(sink, "location", filename);
+
+	if (!gst_element_sync_state_with_parent(sink)) {
+		_mmcam_dbg_err("failed to open sink with %s", filename);
+		return MM_ERROR_CAMCORDER_GST_STATECHANGE;
+	}
+
+	return MM_ERROR_NONE;
+}
+
+
+static void __mmcamcorder_release_pre_record(_MMCamcorderSubContext *sc, _MMCamcorderVideoInfo *info)
+{
+	GstClock *clock = NULL;
+	GstClockTime start_time = GST_CLOCK_TIME_NONE;
+	GstElement *pipeline = sc->element[_MMCAMCORDER_MAIN_PIPE].gst;
+
+	start_time = _mmcamcorder_pre_record_buffer_get_start_time(&(sc->pre_record));
+	if (!GST_CLOCK_TIME_IS_VALID(start_time)) {
+		/* nothing is kept yet, recording starts from now */
+		clock = gst_element_get_clock(pipeline);
+		if (clock) {
+			start_time = gst_clock_get_time(clock) - gst_element_get_base_time(pipeline);
+			gst_object_unref(clock);
+		} else {
+			start_time = 0;
+		}
+	}
+
+	_mmcam_dbg_log("recording starts from %" GST_TIME_FORMAT, GST_TIME_ARGS(start_time));
+
+	/* timestamp base should be visible before probes stop holding frames.
+	   file should be started with key frame even if no video frame was kept. */
+	info->pre_record_base = start_time;
+	info->pre_record_key_requested = FALSE;
+	g_atomic_int_set(&(info->pre_record_wait_key), TRUE);
+	g_atomic_int_set(&(info->pre_record_flush_video), TRUE);
+	g_atomic_int_set(&(info->pre_record_flush_audio), TRUE);
+	g_atomic_int_set(&(info->pre_recording), FALSE);
+
+	return;
+}
+
+
+static gboolean __mmcamcorder_video_dataprobe_pre_record(GstPad *pad, GstBuffer *buffer, gpointer u_data)
+{
+	return __mmcamcorder_pre_record_dataprobe(pad, buffer, MMF_CAMCORDER(u_data), _MMCAMCORDER_PRE_RECORD_VIDEO);
+}
+
+
+static gboolean __mmcamcorder_audio_dataprobe_pre_record(GstPad *pad, GstBuffer *buffer, gpointer u_data)
+{
+	return __mmcamcorder_pre_record_dataprobe(pad, buffer, MMF_CAMCORDER(u_data), _MMCAMCORDER_PRE_RECORD_AUDIO);
+}
+
+
+static gboolean __mmcamcorder_pre_record_dataprobe(GstPad *pad, GstBuffer *buffer, mmf_camcorder_t *hcamcorder, _MMCamcorderPreRecordStream stream)
+{
+	volatile gint *flush = NULL;
+	GstBuffer *kept = NULL;
+	_MMCamcorderSubContext *sc = NULL;
+	_MMCamcorderVideoInfo *info = NULL;
+
+	mmf_return_val_if_fail(hcamcorder, TRUE);
+	mmf_return_val_if_fail(buffer, FALSE);
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(hcamcorder);
+	mmf_return_val_if_fail(sc && sc->info, TRUE);
+
+	info = sc->info;
+
+	/* keep frame and do not send it to muxer */
+	if (g_atomic_int_get(&(info->pre_recording))) {
+		_mmcamcorder_pre_record_buffer_push(&(sc->pre_record), stream, buffer);
+		return FALSE;
+	}
+
+	/* kept frames are pushed before current frame, and they come back to this probe */
+	if (stream == _MMCAMCORDER_PRE_RECORD_VIDEO) {
+		flush = &(info->pre_record_flush_video);
+	} else {
+		flush = &(info->pre_record_flush_audio);
+	}
+
+	if (g_atomic_int_compare_and_exchange(flush, TRUE, FALSE)) {
+		while ((kept = _mmcamcorder_pre_record_buffer_pop(&(sc->pre_record), stream))) {
+			gst_pad_push(pad, kept);
+		}
+	}
+
+	/* kept video starts with key frame, but live frames could be delta if nothing was kept */
+	if (stream == _MMCAMCORDER_PRE_RECORD_VIDEO && g_atomic_int_get(&(info->pre_record_wait_key))) {
+		if (GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+			if (!info->pre_record_key_requested) {
+				_mmcam_dbg_log("request key frame to start recording file");
+				info->pre_record_key_requested = TRUE;
+				gst_pad_send_event(pad, gst_event_new_custom(GST_EVENT_CUSTOM_UPSTREAM,
+				                   gst_structure_new("GstForceKeyUnit", "all-headers", G_TYPE_BOOLEAN, TRUE, NULL)));
+			}
+			return FALSE;
+		}
+
+		g_atomic_int_set(&(info->pre_record_wait_key), FALSE);
+	}
+
+	if (GST_BUFFER_TIMESTAMP_IS_VALID(buffer)) {
+		/* frame before the first key frame of recording */
+		if (GST_BUFFER_TIMESTAMP(buffer) < info->pre_record_base) {
+			return FALSE;
+		}
+
+		GST_BUFFER_TIMESTAMP(buffer) -= info->pre_record_base;
+	}
+
+	return TRUE;
+}
+
+
+static gboolean __mmcamcorder_set_locationinfo_to_mux(MMHandleType handle, int fileformat)
+{
+	int err = 0;
+	int enabletag = 0;
+	int i = 0;
+	char *err_name = NULL;
+	const gchar *mux_name = NULL;
+	gdouble longitude = 0;
+	gdouble latitude = 0;
+	gdouble altitude = 0;
+	GstElement *mux = NULL;
+	GstElementFactory *factory = NULL;
+
+	/* muxers which write geo location tags to 3GPP loci box, same as the box written after EOS.
+	   being tag setter is not enough, some muxers ignore location tags. */
+	static const char *loci_muxers[] = { "gppmux", "3gppmux", NULL };
+
+	_MMCamcorderSubContext *sc = NULL;
+
+	sc = MMF_CAMCORDER_SUBCONTEXT(handle);
+	mmf_return_val_if_fail(sc && sc->element, FALSE);
+
+	if (fileformat != MM_FILE_FORMAT_3GP) {
+		return FALSE;
+	}
+
+	mux = sc->element[_MMCAMCORDER_ENCSINK_MUX].gst;
+	if (mux == NULL || !GST_IS_TAG_SETTER(mux)) {
+		_mmcam_dbg_log("muxer can not set tag, location info will be added after EOS");
+		return FALSE;
+	}
+
+	factory = gst_element_get_factory(mux);
+	if (factory) {
+		mux_name = gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory));
+	}
+
+	for (i = 0 ; mux_name && loci_muxers[i] ; i++) {
+		if (!strcmp(mux_name, loci_muxers[i])) {
+			break;
+		}
+	}
+
+	if (mux_name == NULL || loci_muxers[i] == NULL) {
+		_mmcam_dbg_log("muxer %s does not write loci, location info will be added after EOS",
+		               mux_name ? mux_name : "NULL");
+		return FALSE;
+	}
+
+	err = mm_camcorder_get_attributes(handle, &err_name,
+	                                  MMCAM_TAG_ENABLE, &enabletag,
+	                                  MMCAM_TAG_LATITUDE, &latitude,
+	                                  MMCAM_TAG_LONGITUDE, &longitude,
+	                                  MMCAM_TAG_ALTITUDE, &altitude,
+	                                  NULL);
+	if (err != MM_ERROR_NONE) {
+		_mmcam_dbg_warn("Get tag attrs fail. (%s:%x)", err_name, err);
+		SAFE_FREE (err_name);
+		return FALSE;
+	}
+
+	if (!enabletag) {
+		return FALSE;
+	}
+
+	/* muxer writes these tags to loci in udta of moov with trailer */
+	gst_tag_setter_add_tags(GST_TAG_SETTER(mux), GST_TAG_MERGE_REPLACE,
+	                        GST_TAG_GEO_LOCATION_LATITUDE, latitude,
+	                        GST_TAG_GEO_LOCATION_LONGITUDE, longitude,
+	                        GST_TAG_GEO_LOCATION_ELEVATION, altitude,
+	                        NULL);
+
+	_mmcam_dbg_log("set location tags to muxer [%f,%f,%f]", latitude, longitude, altitude);
+
+	return TRUE;
+}
+
+
 static gboolean __mmcamcorder_add_locationinfo(MMHandleType handle, int fileformat)
 {
 	gboolean bret = FALSE;
@@ -1636,18 +2166,16 @@ static gboolean __mmcamcorder_add_locationinfo(MMHandleType handle, int fileform
 
 static gboolean __mmcamcorder_add_locationinfo_mp4(MMHandleType handle)
 {
-	FILE *f = NULL;
-	guchar buf[4];
-	guint64 udta_size = 0;
-	gint64 current_pos = 0;
-	gint64 moov_pos = 0;
-	gint64 udta_pos = 0;
+	int moov = -1;
+	int udta = -1;
+	gboolean bret = FALSE;
 	gdouble longitude = 0;
 	gdouble latitude = 0;
 	gdouble altitude = 0;
 	int err = 0;
 	char *err_name = NULL;
 	_MMCamcorderLocationInfo location_info = {0,};
+	_MMCamcorderBoxIndex box_index;
 
 	_MMCamcorderVideoInfo *info = NULL;
 	mmf_camcorder_t *hcamcorder = MMF_CAMCORDER(handle);
@@ -1663,11 +2191,6 @@ static gboolean __mmcamcorder_add_locationinfo_mp4(MMHandleType handle)
 
 	info = sc->info;
 
-	f = fopen(info->filename, "rb+");
-	if (f == NULL) {
-		return FALSE;
-	}
-
 	err = mm_camcorder_get_attributes(handle, &err_name,
 	                                  MMCAM_TAG_LATITUDE, &latitude,
 	                                  MMCAM_TAG_LONGITUDE, &longitude,
@@ -1676,8 +2199,6 @@ static gboolean __mmcamcorder_add_locationinfo_mp4(MMHandleType handle)
 	if (err != MM_ERROR_NONE) {
 		_mmcam_dbg_warn("Get tag attrs fail. (%s:%x)", err_name, err);
 		SAFE_FREE (err_name);
-		fclose(f);
-		f = NULL;
 		return FALSE;
 	}
 
@@ -1685,86 +2206,30 @@ static gboolean __mmcamcorder_add_locationinfo_mp4(MMHandleType handle)
 	location_info.latitude = _mmcamcorder_double_to_fix(latitude);
 	location_info.altitude = _mmcamcorder_double_to_fix(altitude);
 
-	/* find udta container.
-	   if, there are udta container, write loci box after that
-	   else, make udta container and write loci box. */
-	if (_mmcamcorder_find_tag(f, MMCAM_FOURCC('u','d','t','a'))) {
-		_mmcam_dbg_log("find udta container");
-
-		/* read size */
-		if (fseek(f, -8L, SEEK_CUR) != 0) {
-			goto fail;
-		}
-
-		udta_pos = ftell(f);
-		if (udta_pos < 0) {
-			goto ftell_fail;
-		}
-
-		fread(&buf, sizeof(char), sizeof(buf), f);
-		udta_size = _mmcamcorder_get_container_size(buf);
-
-		/* goto end of udta and write 'loci' box */
-		if (fseek(f, (udta_size-4L), SEEK_CUR) != 0) {
-			goto fail;
-		}
-
-		if (!_mmcamcorder_write_loci(f, location_info)) {
-			goto fail;
-		}
-
-		current_pos = ftell(f);
-		if (current_pos < 0) {
-			goto ftell_fail;
-		}
-
-		if (!_mmcamcorder_update_size(f, udta_pos, current_pos)) {
-			goto fail;
-		}
-	} else {
-		_mmcam_dbg_log("No udta container");
-		if (fseek(f, 0, SEEK_END) != 0) {
-			goto fail;
-		}
-
-		if (!_mmcamcorder_write_udta(f, location_info)) {
-			goto fail;
-		}
+	/* index boxes of file at once, then sizes are patched in place */
+	if (!_mmcamcorder_box_index_open(&box_index, info->filename)) {
+		return FALSE;
 	}
 
-	/* find moov container.
-	   update moov container size. */
-	if((current_pos = ftell(f))<0)
-		goto ftell_fail;
-	
-	if (_mmcamcorder_find_tag(f, MMCAM_FOURCC('m','o','o','v'))) {
-		_mmcam_dbg_log("find moov container");
-		if (fseek(f, -8L, SEEK_CUR) !=0) {
-			goto fail;
-		}
-
-		moov_pos = ftell(f);
-		if (moov_pos < 0) {
-			goto ftell_fail;
-		}
-
-		if (!_mmcamcorder_update_size(f, moov_pos, current_pos)) {
-			goto fail;
-		}
-	} else {
+	moov = _mmcamcorder_box_index_find(&box_index, -1, MMCAM_FOURCC('m','o','o','v'));
+	if (moov < 0) {
 		_mmcam_dbg_err("No 'moov' container");
-		goto fail;
+		_mmcamcorder_box_index_close(&box_index);
+		return FALSE;
 	}
 
-	fclose(f);
-	return TRUE;
+	/* find udta container in moov.
+	   if, there are udta container, write loci box at the end of it
+	   else, make udta container and write loci box. */
+	udta = _mmcamcorder_box_index_find(&box_index, moov, MMCAM_FOURCC('u','d','t','a'));
+	if (udta >= 0) {
+		bret = _mmcamcorder_write_loci(&box_index, udta, location_info);
+	} else {
+		_mmcam_dbg_log("No udta container");
+		bret = _mmcamcorder_write_udta(&box_index, moov, location_info);
+	}
 
-fail:
-	fclose(f);
-	return FALSE;
+	_mmcamcorder_box_index_close(&box_index);
 
-ftell_fail:
-	_mmcam_dbg_err("ftell() returns negative value.");
-	fclose(f);
-	return FALSE;
+	return bret;
 }
@@ -0,0 +1,265 @@
+/*
+ * mm_camcorder_configure_test
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jeongmo Yang <jm80.yang@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <utime.h>
+#include <glib.h>
+#include "mm_camcorder_internal.h"
+
+/*---------------------------------------------------------------------------
+|    LOCAL VARIABLE DEFINITIONS:											|
+---------------------------------------------------------------------------*/
+#define TEST_MTIME		1300000000
+
+#define TEST_CHECK(cond, ...) \
+do { \
+	if (!(cond)) { \
+		printf("FAIL %s:%d : ", __FUNCTION__, __LINE__); \
+		printf(__VA_ARGS__); \
+		printf("\n"); \
+		return 0; \
+	} \
+} while (0)
+
+/*---------------------------------------------------------------------------
+|    LOCAL FUNCTION DEFINITIONS:											|
+---------------------------------------------------------------------------*/
+/* write ini file and set its modified time, so the test doesn't depend on time resolution of file system */
+static int test_write_ini(const char *path, const char *contents, time_t mtime)
+{
+	struct utimbuf times;
+
+	if (!g_file_set_contents(path, contents, -1, NULL)) {
+		printf("failed to write %s\n", path);
+		return 0;
+	}
+
+	times.actime = mtime;
+	times.modtime = mtime;
+	if (utime(path, &times) != 0) {
+		printf("failed to set time of %s\n", path);
+		return 0;
+	}
+
+	return 1;
+}
+
+
+static int test_get_sync_state_change(camera_conf *conf)
+{
+	int value = -1;
+
+	if (!_mmcamcorder_conf_get_value_int(conf, CONFIGURE_CATEGORY_MAIN_GENERAL, (char *)"SyncStateChange", &value)) {
+		return -1;
+	}
+
+	return value;
+}
+
+
+/* parsed configure is shared while file is not changed, and kept after the last handle releases it */
+static int test_cache_hit(const char *path)
+{
+	camera_conf *conf1 = NULL;
+	camera_conf *conf2 = NULL;
+	camera_conf *conf3 = NULL;
+	camera_conf *cached = NULL;
+
+	TEST_CHECK(test_write_ini(path, "[General]\nSyncStateChange = 1\n", TEST_MTIME), "failed to write ini");
+
+	TEST_CHECK(_mmcamcorder_conf_get_info_from_path(CONFIGURE_TYPE_MAIN, path, &conf1) == MM_ERROR_NONE, "get 1");
+	TEST_CHECK(_mmcamcorder_conf_get_info_from_path(CONFIGURE_TYPE_MAIN, path, &conf2) == MM_ERROR_NONE, "get 2");
+	TEST_CHECK(conf1 == conf2, "configure of unchanged file is parsed again");
+	TEST_CHECK(test_get_sync_state_change(conf1) == 1, "value %d", test_get_sync_state_change(conf1));
+
+	_mmcamcorder_conf_release_info(&conf1);
+	TEST_CHECK(conf1 == NULL, "released pointer is not cleared");
+	TEST_CHECK(test_get_sync_state_change(conf2) == 1, "value %d after other handle released it",
+	           test_get_sync_state_change(conf2));
+	cached = conf2;
+	_mmcamcorder_conf_release_info(&conf2);
+
+	TEST_CHECK(_mmcamcorder_conf_get_info_from_path(CONFIGURE_TYPE_MAIN, path, &conf3) == MM_ERROR_NONE, "get 3");
+	TEST_CHECK(conf3 == cached, "unreferenced configure is not kept in cache");
+	_mmcamcorder_conf_release_info(&conf3);
+
+	return 1;
+}
+
+
+/* changed file is parsed again, and configure which is still used keeps old values */
+static int test_invalidate(const char *path)
+{
+	camera_conf *conf_old = NULL;
+	camera_conf *conf_size = NULL;
+	camera_conf *conf_mtime = NULL;
+	camera_conf *conf_same = NULL;
+
+	TEST_CHECK(test_write_ini(path, "[General]\nSyncStateChange = 1\n", TEST_MTIME), "failed to write ini");
+	TEST_CHECK(_mmcamcorder_conf_get_info_from_path(CONFIGURE_TYPE_MAIN, path, &conf_old) == MM_ERROR_NONE, "get old");
+
+	/* size is changed, but modified time is the same */
+	TEST_CHECK(test_write_ini(path, "[General]\nSyncStateChange = 12\n", TEST_MTIME), "failed to write ini");
+	TEST_CHECK(_mmcamcorder_conf_get_info_from_path(CONFIGURE_TYPE_MAIN, path, &conf_size) == MM_ERROR_NONE, "get size");
+	TEST_CHECK(conf_size != conf_old, "cached configure is used after size is changed");
+	TEST_CHECK(test_get_sync_state_change(conf_size) == 12, "value %d after size is changed",
+	           test_get_sync_state_change(conf_size));
+	TEST_CHECK(test_get_sync_state_change(conf_old) == 1, "value %d of old configure which is still used",
+	           test_get_sync_state_change(conf_old));
+
+	/* stale configure is released with its last reference */
+	_mmcamcorder_conf_release_info(&conf_old);
+
+	/* modified time is changed, but size is the same */
+	TEST_CHECK(test_write_ini(path, "[General]\nSyncStateChange = 34\n", TEST_MTIME + 10), "failed to write ini");
+	TEST_CHECK(_mmcamcorder_conf_get_info_from_path(CONFIGURE_TYPE_MAIN, path, &conf_mtime) == MM_ERROR_NONE, "get mtime");
+	TEST_CHECK(conf_mtime != conf_size, "cached configure is used after modified time is changed");
+	TEST_CHECK(test_get_sync_state_change(conf_mtime) == 34, "value %d after modified time is changed",
+	           test_get_sync_state_change(conf_mtime));
+
+	/* new one is cached again */
+	TEST_CHECK(_mmcamcorder_conf_get_info_from_path(CONFIGURE_TYPE_MAIN, path, &conf_same) == MM_ERROR_NONE, "get same");
+	TEST_CHECK(conf_same == conf_mtime, "new configure is not cached");
+
+	_mmcamcorder_conf_release_info(&conf_size);
+	_mmcamcorder_conf_release_info(&conf_mtime);
+	_mmcamcorder_conf_release_info(&conf_same);
+
+	return 1;
+}
+
+
+/* removed file is not served from cache */
+static int test_removed_file(const char *path)
+{
+	camera_conf *conf = NULL;
+
+	TEST_CHECK(test_write_ini(path, "[General]\nSyncStateChange = 1\n", TEST_MTIME), "failed to write ini");
+	TEST_CHECK(_mmcamcorder_conf_get_info_from_path(CONFIGURE_TYPE_MAIN, path, &conf) == MM_ERROR_NONE, "get");
+	_mmcamcorder_conf_release_info(&conf);
+
+	unlink(path);
+
+	TEST_CHECK(_mmcamcorder_conf_get_info_from_path(CONFIGURE_TYPE_MAIN, path, &conf) != MM_ERROR_NONE,
+	           "configure of removed file is returned");
+
+	return 1;
+}
+
+
+/* when a name appears more than once, the first entry is found as linear search did */
+static int test_first_entry_wins(const char *path)
+{
+	int value = 0;
+	int value_type = -1;
+	char *string = NULL;
+	camera_conf *conf = NULL;
+
+	TEST_CHECK(test_write_ini(path,
+	                          "[General]\n"
+	                          "SyncStateChange = 3\n"
+	                          "ModelName = FirstCamera\n"
+	                          "SyncStateChange = 7\n"
+	                          "ModelName = SecondCamera\n"
+	                          "SyncStateChange = 9\n",
+	                          TEST_MTIME + 20), "failed to write ini");
+	TEST_CHECK(_mmcamcorder_conf_get_info_from_path(CONFIGURE_TYPE_MAIN, path, &conf) == MM_ERROR_NONE, "get");
+
+	TEST_CHECK(_mmcamcorder_conf_get_value_int(conf, CONFIGURE_CATEGORY_MAIN_GENERAL, (char *)"SyncStateChange", &value),
+	           "failed to get int");
+	TEST_CHECK(value == 3, "int value %d, expected the first one", value);
+
+	TEST_CHECK(_mmcamcorder_conf_get_value_string(conf, CONFIGURE_CATEGORY_MAIN_GENERAL, (char *)"ModelName", &string),
+	           "failed to get string");
+	TEST_CHECK(string && !strcmp(string, "FirstCamera"), "string value %s, expected the first one", string);
+
+	/* value type comes from default table */
+	TEST_CHECK(_mmcamcorder_conf_get_value_type(CONFIGURE_TYPE_MAIN, CONFIGURE_CATEGORY_MAIN_GENERAL,
+	                                            (char *)"ModelName", &value_type), "failed to get value type");
+	TEST_CHECK(value_type == CONFIGURE_VALUE_STRING, "value type %d", value_type);
+
+	/* unknown name is not found in index of file nor default table */
+	TEST_CHECK(!_mmcamcorder_conf_get_value_int(conf, CONFIGURE_CATEGORY_MAIN_GENERAL, (char *)"NoSuchName", &value),
+	           "unknown name is found");
+
+	_mmcamcorder_conf_release_info(&conf);
+
+	return 1;
+}
+
+
+/* name which is not in file is found in default table */
+static int test_default_value(const char *path)
+{
+	char *string = NULL;
+	camera_conf *conf = NULL;
+
+	TEST_CHECK(test_write_ini(path, "[General]\nSyncStateChange = 1\n", TEST_MTIME + 30), "failed to write ini");
+	TEST_CHECK(_mmcamcorder_conf_get_info_from_path(CONFIGURE_TYPE_MAIN, path, &conf) == MM_ERROR_NONE, "get");
+
+	TEST_CHECK(_mmcamcorder_conf_get_value_string(conf, CONFIGURE_CATEGORY_MAIN_GENERAL, (char *)"ModelName", &string),
+	           "failed to get default string");
+	TEST_CHECK(string && !strcmp(string, "Samsung Camera"), "default string %s", string);
+
+	_mmcamcorder_conf_release_info(&conf);
+
+	return 1;
+}
+
+
+int main(int argc, char **argv)
+{
+	int failed = 0;
+	gchar *path = NULL;
+	gint fd = -1;
+
+	if (!g_thread_supported()) {
+		g_thread_init(NULL);
+	}
+
+	fd = g_file_open_tmp("mm_camcorder_configure_test_XXXXXX.ini", &path, NULL);
+	if (fd < 0) {
+		printf("failed to make temporary file\n");
+		return 1;
+	}
+	close(fd);
+
+	failed += !test_cache_hit(path);
+	failed += !test_invalidate(path);
+	failed += !test_first_entry_wins(path);
+	failed += !test_default_value(path);
+	failed += !test_removed_file(path);
+
+	unlink(path);
+	g_free(path);
+
+	printf("configure test : %d failed\n", failed);
+
+	return failed ? 1 : 0;
+}
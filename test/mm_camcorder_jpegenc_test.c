@@ -0,0 +1,367 @@
+/*
+ * mm_camcorder_jpegenc_test
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jeongmo Yang <jm80.yang@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <setjmp.h>
+#include <jpeglib.h>
+#include <mm_types.h>
+#include "mm_camcorder_jpegenc.h"
+
+/*---------------------------------------------------------------------------
+|    LOCAL VARIABLE DEFINITIONS:											|
+---------------------------------------------------------------------------*/
+#define TEST_QUALITY		90
+#define TEST_MIN_PSNR		30.0
+
+typedef struct {
+	struct jpeg_error_mgr pub;
+	jmp_buf jump;
+	int warning_count;
+} test_error_mgr;
+
+static const int test_size[][2] = {
+	{1, 1}, {16, 16}, {17, 9}, {33, 31}, {64, 48}, {130, 129}, {321, 243},
+};
+
+static const int test_format[] = {
+	MM_PIXEL_FORMAT_NV12, MM_PIXEL_FORMAT_I420, MM_PIXEL_FORMAT_YUYV, MM_PIXEL_FORMAT_UYVY,
+};
+
+static const int test_slice[] = {1, 2, 3, 5, 8, 16};
+
+/*---------------------------------------------------------------------------
+|    LOCAL FUNCTION DEFINITIONS:											|
+---------------------------------------------------------------------------*/
+static unsigned char test_pixel_y(int x, int y)
+{
+	/* gradient with edges, so that AC coefficients are not empty */
+	return (unsigned char)(((x * 255) / 64 + ((y & 8) ? 48 : 0) + y) & 0xff);
+}
+
+
+static unsigned char test_pixel_c(int x, int y, int plane)
+{
+	return (unsigned char)(plane ? 128 + ((x - y) & 0x3f) : 96 + ((x + y) & 0x3f));
+}
+
+
+/* make frame of format, Y plane is returned in y_ref for comparison */
+static unsigned char *test_make_frame(int format, int width, int height, unsigned int *length, unsigned char *y_ref)
+{
+	int x = 0;
+	int y = 0;
+	int c_width = (width + 1) >> 1;
+	int c_height = (height + 1) >> 1;
+	int stride = 0;
+	unsigned char *data = NULL;
+	unsigned char *plane = NULL;
+
+	for (y = 0 ; y < height ; y++) {
+		for (x = 0 ; x < width ; x++) {
+			y_ref[y * width + x] = test_pixel_y(x, y);
+		}
+	}
+
+	switch (format) {
+	case MM_PIXEL_FORMAT_NV12:
+		*length = width * height + c_width * 2 * c_height;
+		data = (unsigned char *)malloc(*length);
+		memcpy(data, y_ref, width * height);
+		plane = data + width * height;
+		for (y = 0 ; y < c_height ; y++) {
+			for (x = 0 ; x < c_width ; x++) {
+				plane[y * c_width * 2 + x * 2] = test_pixel_c(x, y, 0);
+				plane[y * c_width * 2 + x * 2 + 1] = test_pixel_c(x, y, 1);
+			}
+		}
+		break;
+	case MM_PIXEL_FORMAT_I420:
+		*length = width * height + c_width * c_height * 2;
+		data = (unsigned char *)malloc(*length);
+		memcpy(data, y_ref, width * height);
+		plane = data + width * height;
+		for (y = 0 ; y < c_height ; y++) {
+			for (x = 0 ; x < c_width ; x++) {
+				plane[y * c_width + x] = test_pixel_c(x, y, 0);
+				plane[c_width * c_height + y * c_width + x] = test_pixel_c(x, y, 1);
+			}
+		}
+		break;
+	case MM_PIXEL_FORMAT_YUYV:
+	case MM_PIXEL_FORMAT_UYVY:
+		stride = c_width * 4;
+		*length = stride * height;
+		data = (unsigned char *)calloc(1, *length);
+		for (y = 0 ; y < height ; y++) {
+			unsigned char *line = data + y * stride;
+			int y_offset = (format == MM_PIXEL_FORMAT_YUYV) ? 0 : 1;
+			int c_offset = (format == MM_PIXEL_FORMAT_YUYV) ? 1 : 0;
+
+			for (x = 0 ; x < c_width ; x++) {
+				line[x * 4 + y_offset] = test_pixel_y(x * 2, y);
+				line[x * 4 + y_offset + 2] = (x * 2 + 1 < width) ? test_pixel_y(x * 2 + 1, y) : 0;
+				line[x * 4 + c_offset] = test_pixel_c(x, y >> 1, 0);
+				line[x * 4 + c_offset + 2] = test_pixel_c(x, y >> 1, 1);
+			}
+		}
+		break;
+	default:
+		return NULL;
+	}
+
+	return data;
+}
+
+
+static void test_error_exit(j_common_ptr cinfo)
+{
+	test_error_mgr *err = (test_error_mgr *)cinfo->err;
+
+	(*cinfo->err->output_message)(cinfo);
+	longjmp(err->jump, 1);
+}
+
+
+static void test_emit_message(j_common_ptr cinfo, int msg_level)
+{
+	test_error_mgr *err = (test_error_mgr *)cinfo->err;
+
+	/* corrupt data or wrong restart marker is reported as warning */
+	if (msg_level < 0) {
+		err->warning_count++;
+		(*cinfo->err->output_message)(cinfo);
+	}
+}
+
+
+/* decode with libjpeg and return PSNR of Y, negative on error */
+static double test_decode(const unsigned char *jpeg, unsigned int jpeg_length, int width, int height, const unsigned char *y_ref)
+{
+	int y = 0;
+	int x = 0;
+	double mse = 0.0;
+	double diff = 0.0;
+	unsigned char *line = NULL;
+	struct jpeg_decompress_struct cinfo;
+	test_error_mgr jerr;
+
+	memset(&cinfo, 0x00, sizeof(cinfo));
+	cinfo.err = jpeg_std_error(&jerr.pub);
+	jerr.pub.error_exit = test_error_exit;
+	jerr.pub.emit_message = test_emit_message;
+	jerr.warning_count = 0;
+
+	if (setjmp(jerr.jump)) {
+		jpeg_destroy_decompress(&cinfo);
+		free(line);
+		return -1.0;
+	}
+
+	jpeg_create_decompress(&cinfo);
+	jpeg_mem_src(&cinfo, (unsigned char *)jpeg, jpeg_length);
+	jpeg_read_header(&cinfo, TRUE);
+
+	if ((int)cinfo.image_width != width || (int)cinfo.image_height != height) {
+		printf("  size mismatch %dx%d\n", cinfo.image_width, cinfo.image_height);
+		jpeg_destroy_decompress(&cinfo);
+		return -1.0;
+	}
+
+	cinfo.out_color_space = JCS_YCbCr;
+	jpeg_start_decompress(&cinfo);
+
+	line = (unsigned char *)malloc(width * cinfo.output_components);
+	for (y = 0 ; y < height ; y++) {
+		jpeg_read_scanlines(&cinfo, &line, 1);
+		for (x = 0 ; x < width ; x++) {
+			diff = (double)line[x * cinfo.output_components] - (double)y_ref[y * width + x];
+			mse += diff * diff;
+		}
+	}
+
+	jpeg_finish_decompress(&cinfo);
+	jpeg_destroy_decompress(&cinfo);
+	free(line);
+
+	if (jerr.warning_count > 0) {
+		printf("  %d warnings while decoding\n", jerr.warning_count);
+		return -1.0;
+	}
+
+	mse /= (double)(width * height);
+	if (mse == 0.0) {
+		return 99.0;
+	}
+
+	return 10.0 * log10((255.0 * 255.0) / mse);
+}
+
+
+/* check DRI is one MCU row and RST markers are numbered by row */
+static int test_check_restart(const unsigned char *jpeg, unsigned int jpeg_length, int width, int height)
+{
+	unsigned int pos = 2;
+	unsigned int seg_length = 0;
+	int interval = -1;
+	int rst_count = 0;
+	int mcu_cols = (width + 15) >> 4;
+	int mcu_rows = (height + 15) >> 4;
+
+	if (jpeg_length < 4 || jpeg[0] != 0xff || jpeg[1] != 0xd8) {
+		printf("  no SOI\n");
+		return 0;
+	}
+
+	/* header segments */
+	while (pos + 4 <= jpeg_length) {
+		if (jpeg[pos] != 0xff) {
+			printf("  broken header at %u\n", pos);
+			return 0;
+		}
+
+		seg_length = (jpeg[pos + 2] << 8) | jpeg[pos + 3];
+		if (jpeg[pos + 1] == 0xdd) {
+			interval = (jpeg[pos + 4] << 8) | jpeg[pos + 5];
+		}
+		if (jpeg[pos + 1] == 0xda) {
+			pos += 2 + seg_length;
+			break;
+		}
+		pos += 2 + seg_length;
+	}
+
+	if (interval != mcu_cols) {
+		printf("  restart interval %d, it should be %d\n", interval, mcu_cols);
+		return 0;
+	}
+
+	/* entropy coded data */
+	for ( ; pos + 1 < jpeg_length ; pos++) {
+		if (jpeg[pos] != 0xff || jpeg[pos + 1] == 0x00) {
+			continue;
+		}
+		if (jpeg[pos + 1] == 0xd9) {
+			break;
+		}
+		if (jpeg[pos + 1] != 0xd0 + (rst_count & 7)) {
+			printf("  marker 0x%02x at %u, RST%d is expected\n", jpeg[pos + 1], pos, rst_count & 7);
+			return 0;
+		}
+		rst_count++;
+		pos++;
+	}
+
+	if (rst_count != mcu_rows - 1) {
+		printf("  %d restart markers, it should be %d\n", rst_count, mcu_rows - 1);
+		return 0;
+	}
+
+	return 1;
+}
+
+
+static int test_run(int format, int width, int height)
+{
+	int i = 0;
+	int passed = 1;
+	double psnr = 0.0;
+	unsigned int src_length = 0;
+	unsigned int jpeg_length = 0;
+	unsigned int ref_length = 0;
+	unsigned char *src = NULL;
+	unsigned char *y_ref = NULL;
+	void *jpeg = NULL;
+	void *ref = NULL;
+
+	y_ref = (unsigned char *)malloc(width * height);
+	src = test_make_frame(format, width, height, &src_length, y_ref);
+
+	for (i = 0 ; i < (int)(sizeof(test_slice) / sizeof(test_slice[0])) ; i++) {
+		jpeg = NULL;
+		jpeg_length = 0;
+
+		if (!_mmcamcorder_jpegenc_encode(src, width, height, format, src_length,
+		                                 TEST_QUALITY, test_slice[i], &jpeg, &jpeg_length)) {
+			printf("FAIL format %d, %dx%d, slice %d : encode failed\n", format, width, height, test_slice[i]);
+			passed = 0;
+			continue;
+		}
+
+		psnr = test_decode((unsigned char *)jpeg, jpeg_length, width, height, y_ref);
+		if (psnr < TEST_MIN_PSNR) {
+			printf("FAIL format %d, %dx%d, slice %d : decode failed or PSNR %.2f\n",
+			       format, width, height, test_slice[i], psnr);
+			passed = 0;
+		} else if (!test_check_restart((unsigned char *)jpeg, jpeg_length, width, height)) {
+			printf("FAIL format %d, %dx%d, slice %d : restart layout\n", format, width, height, test_slice[i]);
+			passed = 0;
+		}
+
+		/* slices are joined without rewriting, so output should not depend on slice count */
+		if (ref == NULL) {
+			ref = jpeg;
+			ref_length = jpeg_length;
+			jpeg = NULL;
+		} else {
+			if (jpeg_length != ref_length || memcmp(jpeg, ref, ref_length)) {
+				printf("FAIL format %d, %dx%d, slice %d : differs from 1 slice\n",
+				       format, width, height, test_slice[i]);
+				passed = 0;
+			}
+			free(jpeg);
+			jpeg = NULL;
+		}
+	}
+
+	free(ref);
+	free(src);
+	free(y_ref);
+
+	return passed;
+}
+
+
+int main(int argc, char **argv)
+{
+	int i = 0;
+	int j = 0;
+	int failed = 0;
+
+	for (i = 0 ; i < (int)(sizeof(test_format) / sizeof(test_format[0])) ; i++) {
+		for (j = 0 ; j < (int)(sizeof(test_size) / sizeof(test_size[0])) ; j++) {
+			if (!test_run(test_format[i], test_size[j][0], test_size[j][1])) {
+				failed++;
+			}
+		}
+	}
+
+	printf("jpegenc test : %d failed\n", failed);
+
+	return failed ? 1 : 0;
+}
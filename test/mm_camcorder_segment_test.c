@@ -0,0 +1,392 @@
+/*
+ * mm_camcorder_segment_test
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jeongmo Yang <jm80.yang@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib.h>
+#include <gst/gst.h>
+#include "mm_camcorder_internal.h"
+
+/*---------------------------------------------------------------------------
+|    LOCAL VARIABLE DEFINITIONS:											|
+---------------------------------------------------------------------------*/
+#define TEST_SEGMENT_MAX		64
+#define TEST_FRAGMENT_DURATION		500	/* msec */
+#define TEST_FRAME_NUM			75	/* 2.5 seconds at 30 fps */
+#define TEST_SKIP			77	/* automake skips test with this exit code */
+
+#define TEST_CHECK(cond, ...) \
+do { \
+	if (!(cond)) { \
+		printf("FAIL %s:%d : ", __FUNCTION__, __LINE__); \
+		printf(__VA_ARGS__); \
+		printf("\n"); \
+		return 0; \
+	} \
+} while (0)
+
+typedef struct {
+	_MMCamcorderSegmentTracker tracker;
+	guint64 input_time;
+	int count;
+	MMCamcorderRecordingSegmentInfo segments[TEST_SEGMENT_MAX];
+} TestSegmentRecorder;
+
+/*---------------------------------------------------------------------------
+|    LOCAL FUNCTION DEFINITIONS:											|
+---------------------------------------------------------------------------*/
+static void test_write_box(TestSegmentRecorder *recorder, const char *type, unsigned int size)
+{
+	guint8 *data = NULL;
+	MMCamcorderRecordingSegmentInfo segment;
+
+	data = (guint8 *)g_malloc0(size);
+	GST_WRITE_UINT32_BE(data, size);
+	memcpy(data + 4, type, 4);
+
+	if (_mmcamcorder_segment_tracker_write(&recorder->tracker, data, size, recorder->input_time, &segment) &&
+	    recorder->count < TEST_SEGMENT_MAX) {
+		recorder->segments[recorder->count++] = segment;
+	}
+
+	g_free(data);
+}
+
+
+static void test_finish(TestSegmentRecorder *recorder)
+{
+	if (recorder->count < TEST_SEGMENT_MAX) {
+		_mmcamcorder_segment_tracker_finish(&recorder->tracker, recorder->input_time,
+		                                    &recorder->segments[recorder->count++]);
+	}
+}
+
+
+/* segments should cover whole file without gap, and have continuous time */
+static int test_check_continuous(TestSegmentRecorder *recorder, guint64 file_size)
+{
+	int i = 0;
+	guint64 total = 0;
+
+	TEST_CHECK(recorder->count > 0, "no segment");
+
+	for (i = 0 ; i < recorder->count ; i++) {
+		MMCamcorderRecordingSegmentInfo *segment = &recorder->segments[i];
+
+		TEST_CHECK(segment->index == i, "segment[%d] has index %d", i, segment->index);
+		TEST_CHECK(segment->offset == total, "segment[%d] offset %llu, expected %llu",
+		           i, segment->offset, (unsigned long long)total);
+		TEST_CHECK(segment->size > 0, "segment[%d] is empty", i);
+		TEST_CHECK(segment->start_time <= segment->end_time, "segment[%d] time %u ~ %u",
+		           i, segment->start_time, segment->end_time);
+		if (i > 0) {
+			TEST_CHECK(segment->start_time == recorder->segments[i - 1].end_time,
+			           "segment[%d] starts at %u, previous one ends at %u",
+			           i, segment->start_time, recorder->segments[i - 1].end_time);
+		}
+
+		total += segment->size;
+	}
+
+	TEST_CHECK(total == file_size, "sum of segments %llu, file size %llu",
+	           (unsigned long long)total, (unsigned long long)file_size);
+
+	return 1;
+}
+
+
+/* boxes which are written by fragmented muxer, and header is rewritten at the end */
+static int test_synthetic_boxes(void)
+{
+	TestSegmentRecorder recorder;
+
+	memset(&recorder, 0x00, sizeof(TestSegmentRecorder));
+	_mmcamcorder_segment_tracker_reset(&recorder.tracker);
+
+	/* header */
+	test_write_box(&recorder, "ftyp", 24);
+	test_write_box(&recorder, "moov", 700);
+
+	/* 3 fragments, moof is written when all samples of fragment are collected */
+	recorder.input_time = 500;
+	test_write_box(&recorder, "moof", 100);
+	test_write_box(&recorder, "mdat", 5000);
+	recorder.input_time = 1000;
+	test_write_box(&recorder, "moof", 120);
+	test_write_box(&recorder, "mdat", 6000);
+	recorder.input_time = 1500;
+	test_write_box(&recorder, "moof", 90);
+	test_write_box(&recorder, "mdat", 4000);
+
+	/* mfra at the end, and muxer seeks to rewrite moov with the same size */
+	test_write_box(&recorder, "mfra", 60);
+	recorder.input_time = 1530;
+	_mmcamcorder_segment_tracker_seek(&recorder.tracker, 24);
+	test_write_box(&recorder, "moov", 700);
+
+	test_finish(&recorder);
+
+	TEST_CHECK(recorder.count == 3, "%d segments", recorder.count);
+
+	/* the first segment includes header and the first fragment */
+	TEST_CHECK(recorder.segments[0].offset == 0 && recorder.segments[0].size == 24 + 700 + 100 + 5000,
+	           "segment[0] offset %llu size %llu", recorder.segments[0].offset, recorder.segments[0].size);
+	TEST_CHECK(recorder.segments[0].start_time == 0 && recorder.segments[0].end_time == 500,
+	           "segment[0] time %u ~ %u", recorder.segments[0].start_time, recorder.segments[0].end_time);
+
+	/* segment starts with its moof */
+	TEST_CHECK(recorder.segments[1].offset == 24 + 700 + 100 + 5000 && recorder.segments[1].size == 120 + 6000,
+	           "segment[1] offset %llu size %llu", recorder.segments[1].offset, recorder.segments[1].size);
+	TEST_CHECK(recorder.segments[1].start_time == 500 && recorder.segments[1].end_time == 1000,
+	           "segment[1] time %u ~ %u", recorder.segments[1].start_time, recorder.segments[1].end_time);
+
+	/* the last one is written until the end of file, rewritten header doesn't change it */
+	TEST_CHECK(recorder.segments[2].size == 90 + 4000 + 60,
+	           "segment[2] offset %llu size %llu", recorder.segments[2].offset, recorder.segments[2].size);
+	TEST_CHECK(recorder.segments[2].start_time == 1000 && recorder.segments[2].end_time == 1530,
+	           "segment[2] time %u ~ %u", recorder.segments[2].start_time, recorder.segments[2].end_time);
+
+	return test_check_continuous(&recorder, 24 + 700 + 100 + 5000 + 120 + 6000 + 90 + 4000 + 60);
+}
+
+
+/* buffer which is smaller than box header is not moof */
+static int test_short_buffer(void)
+{
+	TestSegmentRecorder recorder;
+	MMCamcorderRecordingSegmentInfo segment;
+	const guint8 data[4] = {0x00, 0x00, 0x00, 0x08};
+
+	memset(&recorder, 0x00, sizeof(TestSegmentRecorder));
+
+	test_write_box(&recorder, "ftyp", 24);
+	test_write_box(&recorder, "moof", 100);
+
+	TEST_CHECK(_mmcamcorder_segment_tracker_write(&recorder.tracker, data, sizeof(data), 0, &segment) == FALSE,
+	           "short buffer closed segment");
+	TEST_CHECK(_mmcamcorder_segment_tracker_write(&recorder.tracker, NULL, 0, 0, &segment) == FALSE,
+	           "empty buffer closed segment");
+
+	test_finish(&recorder);
+
+	return test_check_continuous(&recorder, 24 + 100 + sizeof(data));
+}
+
+
+static gboolean test_probe_input(GstPad *pad, GstBuffer *buffer, gpointer u_data)
+{
+	TestSegmentRecorder *recorder = (TestSegmentRecorder *)u_data;
+
+	if (GST_BUFFER_TIMESTAMP_IS_VALID(buffer)) {
+		recorder->input_time = GST_TIME_AS_MSECONDS(GST_BUFFER_TIMESTAMP(buffer));
+	}
+
+	return TRUE;
+}
+
+
+static gboolean test_probe_output(GstPad *pad, GstBuffer *buffer, gpointer u_data)
+{
+	TestSegmentRecorder *recorder = (TestSegmentRecorder *)u_data;
+	MMCamcorderRecordingSegmentInfo segment;
+
+	if (_mmcamcorder_segment_tracker_write(&recorder->tracker, GST_BUFFER_DATA(buffer), GST_BUFFER_SIZE(buffer),
+	                                       recorder->input_time, &segment) &&
+	    recorder->count < TEST_SEGMENT_MAX) {
+		recorder->segments[recorder->count++] = segment;
+	}
+
+	return TRUE;
+}
+
+
+static gboolean test_probe_output_event(GstPad *pad, GstEvent *event, gpointer u_data)
+{
+	TestSegmentRecorder *recorder = (TestSegmentRecorder *)u_data;
+	gboolean update = FALSE;
+	gdouble rate = 1.0;
+	GstFormat format = GST_FORMAT_UNDEFINED;
+	gint64 start = 0;
+	gint64 stop = 0;
+	gint64 position = 0;
+
+	if (GST_EVENT_TYPE(event) == GST_EVENT_NEWSEGMENT) {
+		gst_event_parse_new_segment(event, &update, &rate, &format, &start, &stop, &position);
+		if (format == GST_FORMAT_BYTES && start >= 0) {
+			_mmcamcorder_segment_tracker_seek(&recorder->tracker, (guint64)start);
+		}
+	}
+
+	return TRUE;
+}
+
+
+/* record with fragment-duration of muxer, and check that segments point to moof in file.
+   returns -1 if elements are not available. */
+static int test_fragmented_muxer(const char *filename)
+{
+	int i = 0;
+	int ret = 1;
+	gchar *desc = NULL;
+	gchar *contents = NULL;
+	gsize length = 0;
+	GError *error = NULL;
+	GstElement *pipeline = NULL;
+	GstElement *encoder = NULL;
+	GstElement *mux = NULL;
+	GstPad *pad = NULL;
+	GstBus *bus = NULL;
+	GstMessage *message = NULL;
+	TestSegmentRecorder recorder;
+
+	memset(&recorder, 0x00, sizeof(TestSegmentRecorder));
+
+	desc = g_strdup_printf("videotestsrc num-buffers=%d ! video/x-raw-yuv,width=176,height=144,framerate=30/1 ! "
+	                       "ffenc_mpeg4 name=encoder ! mp4mux name=mux fragment-duration=%d ! filesink location=%s",
+	                       TEST_FRAME_NUM, TEST_FRAGMENT_DURATION, filename);
+	pipeline = gst_parse_launch(desc, &error);
+	g_free(desc);
+	if (pipeline == NULL || error) {
+		printf("skip fragmented muxer : %s\n", error ? error->message : "unknown");
+		if (error) {
+			g_error_free(error);
+		}
+		if (pipeline) {
+			gst_object_unref(pipeline);
+		}
+		return -1;
+	}
+
+	encoder = gst_bin_get_by_name(GST_BIN(pipeline), "encoder");
+	mux = gst_bin_get_by_name(GST_BIN(pipeline), "mux");
+
+	pad = gst_element_get_static_pad(encoder, "src");
+	gst_pad_add_buffer_probe(pad, G_CALLBACK(test_probe_input), &recorder);
+	gst_object_unref(pad);
+
+	pad = gst_element_get_static_pad(mux, "src");
+	gst_pad_add_buffer_probe(pad, G_CALLBACK(test_probe_output), &recorder);
+	gst_pad_add_event_probe(pad, G_CALLBACK(test_probe_output_event), &recorder);
+	gst_object_unref(pad);
+
+	gst_object_unref(encoder);
+	gst_object_unref(mux);
+
+	gst_element_set_state(pipeline, GST_STATE_PLAYING);
+
+	bus = gst_element_get_bus(pipeline);
+	message = gst_bus_timed_pop_filtered(bus, 30 * GST_SECOND, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+	if (message == NULL || GST_MESSAGE_TYPE(message) != GST_MESSAGE_EOS) {
+		printf("FAIL %s:%d : pipeline is not finished\n", __FUNCTION__, __LINE__);
+		ret = 0;
+	}
+	if (message) {
+		gst_message_unref(message);
+	}
+	gst_object_unref(bus);
+
+	gst_element_set_state(pipeline, GST_STATE_NULL);
+	gst_object_unref(pipeline);
+
+	if (ret == 0) {
+		return 0;
+	}
+
+	test_finish(&recorder);
+
+	TEST_CHECK(g_file_get_contents(filename, &contents, &length, NULL), "failed to read %s", filename);
+
+	if (!test_check_continuous(&recorder, length)) {
+		g_free(contents);
+		return 0;
+	}
+
+	/* fragments of 0.5 sec in 2.5 sec recording */
+	if (recorder.count < 2) {
+		printf("FAIL %s:%d : %d segments\n", __FUNCTION__, __LINE__, recorder.count);
+		g_free(contents);
+		return 0;
+	}
+
+	for (i = 1 ; i < recorder.count ; i++) {
+		MMCamcorderRecordingSegmentInfo *segment = &recorder.segments[i];
+
+		if (segment->offset + 8 > length || memcmp(contents + segment->offset + 4, "moof", 4)) {
+			printf("FAIL %s:%d : segment[%d] at %llu doesn't start with moof\n",
+			       __FUNCTION__, __LINE__, i, segment->offset);
+			ret = 0;
+			break;
+		}
+	}
+
+	g_free(contents);
+
+	return ret;
+}
+
+
+int main(int argc, char **argv)
+{
+	int failed = 0;
+	int ret = 0;
+	gchar *filename = NULL;
+	gint fd = -1;
+
+	if (!g_thread_supported()) {
+		g_thread_init(NULL);
+	}
+
+	gst_init(&argc, &argv);
+
+	failed += !test_synthetic_boxes();
+	failed += !test_short_buffer();
+
+	fd = g_file_open_tmp("mm_camcorder_segment_test_XXXXXX.mp4", &filename, NULL);
+	if (fd >= 0) {
+		close(fd);
+
+		ret = test_fragmented_muxer(filename);
+		if (ret >= 0) {
+			failed += !ret;
+		}
+
+		unlink(filename);
+		g_free(filename);
+	} else {
+		printf("failed to make temporary file\n");
+		failed++;
+	}
+
+	printf("segment tracker test : %d failed\n", failed);
+
+	if (failed) {
+		return 1;
+	}
+
+	return (ret < 0) ? TEST_SKIP : 0;
+}
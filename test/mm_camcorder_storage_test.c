@@ -0,0 +1,189 @@
+/*
+ * mm_camcorder_storage_test
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jeongmo Yang <jm80.yang@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*===========================================================================================
+|																							|
+|  INCLUDE FILES																			|
+|  																							|
+========================================================================================== */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib.h>
+#include "mm_camcorder_internal.h"
+
+/*---------------------------------------------------------------------------
+|    LOCAL VARIABLE DEFINITIONS:											|
+---------------------------------------------------------------------------*/
+#define TEST_WAIT_MAX_MS	2000
+
+#define TEST_CHECK(cond, ...) \
+do { \
+	if (!(cond)) { \
+		printf("FAIL %s:%d : ", __FUNCTION__, __LINE__); \
+		printf(__VA_ARGS__); \
+		printf("\n"); \
+		return 0; \
+	} \
+} while (0)
+
+/*---------------------------------------------------------------------------
+|    LOCAL FUNCTION DEFINITIONS:											|
+---------------------------------------------------------------------------*/
+/* wait until monitor publishes result of check */
+static int test_wait_checked(_MMCamcorderStorageMonitor *monitor, _MMCamcorderStorageInfo *info)
+{
+	int waited = 0;
+
+	for (waited = 0 ; waited < TEST_WAIT_MAX_MS ; waited += 10) {
+		_mmcamcorder_storage_monitor_get_info(monitor, info);
+		if (info->status != 0) {
+			return 1;
+		}
+		g_usleep(10 * 1000);
+	}
+
+	return 0;
+}
+
+
+/* recording file is not created until pipeline starts, it should not be reported as error */
+static int test_file_not_created(const char *dir)
+{
+	gchar *filename = NULL;
+	_MMCamcorderStorageMonitor monitor;
+	_MMCamcorderStorageInfo info;
+
+	memset(&monitor, 0x00, sizeof(_MMCamcorderStorageMonitor));
+
+	filename = g_build_filename(dir, "not_created_yet.mp4", NULL);
+	unlink(filename);
+
+	TEST_CHECK(_mmcamcorder_storage_monitor_start(&monitor), "failed to start monitor");
+
+	_mmcamcorder_storage_monitor_set_path(&monitor, filename);
+
+	/* nothing is published until the first check, then probes don't treat it as error */
+	_mmcamcorder_storage_monitor_get_info(&monitor, &info);
+	TEST_CHECK(info.status >= 0, "status %d right after path is set", info.status);
+
+	TEST_CHECK(test_wait_checked(&monitor, &info), "not checked in %d ms", TEST_WAIT_MAX_MS);
+	TEST_CHECK(info.status > 0, "status %d for file which is not created yet", info.status);
+	TEST_CHECK(info.free_space > 0, "no free space is reported");
+	TEST_CHECK(g_file_test(filename, G_FILE_TEST_EXISTS) == FALSE, "monitor created file");
+
+	/* it's forgotten when recording is finished */
+	_mmcamcorder_storage_monitor_set_path(&monitor, NULL);
+	_mmcamcorder_storage_monitor_get_info(&monitor, &info);
+	TEST_CHECK(info.status == 0, "status %d after path is cleared", info.status);
+
+	_mmcamcorder_storage_monitor_stop(&monitor);
+	g_free(filename);
+
+	return 1;
+}
+
+
+/* directory which doesn't exist is still reported as error */
+static int test_invalid_directory(const char *dir)
+{
+	gchar *filename = NULL;
+	_MMCamcorderStorageMonitor monitor;
+	_MMCamcorderStorageInfo info;
+
+	memset(&monitor, 0x00, sizeof(_MMCamcorderStorageMonitor));
+
+	filename = g_build_filename(dir, "no_such_directory", "file.mp4", NULL);
+
+	TEST_CHECK(_mmcamcorder_storage_monitor_start(&monitor), "failed to start monitor");
+
+	_mmcamcorder_storage_monitor_set_path(&monitor, filename);
+
+	TEST_CHECK(test_wait_checked(&monitor, &info), "not checked in %d ms", TEST_WAIT_MAX_MS);
+	TEST_CHECK(info.status < 0, "status %d for directory which doesn't exist", info.status);
+
+	_mmcamcorder_storage_monitor_stop(&monitor);
+	g_free(filename);
+
+	return 1;
+}
+
+
+/* monitor keeps checking while recording */
+static int test_periodic_check(const char *dir)
+{
+	gchar *filename = NULL;
+	unsigned int sequence = 0;
+	_MMCamcorderStorageMonitor monitor;
+	_MMCamcorderStorageInfo info;
+
+	memset(&monitor, 0x00, sizeof(_MMCamcorderStorageMonitor));
+
+	filename = g_build_filename(dir, "periodic.mp4", NULL);
+
+	TEST_CHECK(_mmcamcorder_storage_monitor_start(&monitor), "failed to start monitor");
+
+	_mmcamcorder_storage_monitor_set_path(&monitor, filename);
+
+	TEST_CHECK(test_wait_checked(&monitor, &info), "not checked in %d ms", TEST_WAIT_MAX_MS);
+	sequence = info.sequence;
+
+	g_usleep((_MMCAMCORDER_STORAGE_CHECK_INTERVAL * 3) * 1000);
+
+	_mmcamcorder_storage_monitor_get_info(&monitor, &info);
+	TEST_CHECK(info.status > 0, "status %d", info.status);
+	TEST_CHECK(info.sequence > sequence, "sequence is not increased (%u -> %u)", sequence, info.sequence);
+
+	_mmcamcorder_storage_monitor_stop(&monitor);
+	g_free(filename);
+
+	return 1;
+}
+
+
+int main(int argc, char **argv)
+{
+	int failed = 0;
+	gchar *dir = NULL;
+
+	if (!g_thread_supported()) {
+		g_thread_init(NULL);
+	}
+
+	dir = g_strdup("/tmp/mm_camcorder_storage_test_XXXXXX");
+	if (mkdtemp(dir) == NULL) {
+		printf("failed to make temporary directory\n");
+		g_free(dir);
+		return 1;
+	}
+
+	failed += !test_file_not_created(dir);
+	failed += !test_invalid_directory(dir);
+	failed += !test_periodic_check(dir);
+
+	rmdir(dir);
+	g_free(dir);
+
+	printf("storage monitor test : %d failed\n", failed);
+
+	return failed ? 1 : 0;
+}